@@ -130,6 +130,8 @@ bool AppDelegate::applicationDidFinishLaunching() {
 // This function will be called when the app is inactive. Note, when receiving a phone call it is invoked.
 void AppDelegate::applicationDidEnterBackground() {
     Director::getInstance()->stopAnimation();
+    // the app can be killed while in the background, save the pending settings
+    UserDefault::getInstance()->flush();
 
 #if USE_AUDIO_ENGINE
     AudioEngine::pauseAll();
@@ -77,6 +77,7 @@ bool Board::initWithSizeAndTileInfo(const Size& size, int tilesX, int tilesY, in
     {
         return onTouchBegan(touch, event);
     };
+    touchListener->setBoundsCheckEnabled(true);
     director->getEventDispatcher()->addEventListenerWithSceneGraphPriority(touchListener, _backbone);
     
     return true;
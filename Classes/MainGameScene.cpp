@@ -110,7 +110,11 @@ void MainGameScene::onBoardRemoveTiles(const Board::TilesRemoveCallbackData& til
 void MainGameScene::updateScore(int newScore)
 {
     _scoreValue = newScore;
-    _scoreLabel->setString("Score: " + std::to_string(newScore));
+
+    // formatted in place, the label copies the text anyway
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "Score: %d", newScore);
+    _scoreLabel->setString(buffer);
 }
 
 void MainGameScene::onGameStateChange(MainGameState newState)
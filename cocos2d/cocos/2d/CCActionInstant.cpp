@@ -332,6 +332,8 @@ void Place::update(float time)
 // CallFunc
 //
 
+CC_DEFINE_ALLOCATOR_POOL(CallFunc, 64);
+
 CallFunc * CallFunc::create(const std::function<void()> &func)
 {
     CallFunc *ret = new (std::nothrow) CallFunc();
@@ -166,6 +166,8 @@ void ActionInterval::startWithTarget(Node *target)
 // Sequence
 //
 
+CC_DEFINE_ALLOCATOR_POOL(Sequence, 64);
+
 Sequence* Sequence::createWithTwoActions(FiniteTimeAction *actionOne, FiniteTimeAction *actionTwo)
 {
     Sequence *sequence = new (std::nothrow) Sequence();
@@ -1173,6 +1175,8 @@ RotateBy* RotateBy::reverse() const
 // MoveBy
 //
 
+CC_DEFINE_ALLOCATOR_POOL(MoveBy, 64);
+
 MoveBy* MoveBy::create(float duration, const Vec2& deltaPosition)
 {
     return MoveBy::create(duration, Vec3(deltaPosition.x, deltaPosition.y, 0));
@@ -1249,6 +1253,8 @@ void MoveBy::update(float t)
 // MoveTo
 //
 
+CC_DEFINE_ALLOCATOR_POOL(MoveTo, 64);
+
 MoveTo* MoveTo::create(float duration, const Vec2& position)
 {
     return MoveTo::create(duration, Vec3(position.x, position.y, 0));
@@ -2406,6 +2412,9 @@ TintBy* TintBy::reverse() const
 //
 // DelayTime
 //
+
+CC_DEFINE_ALLOCATOR_POOL(DelayTime, 64);
+
 DelayTime* DelayTime::create(float d)
 {
     DelayTime* action = new (std::nothrow) DelayTime();
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "2d/CCAnimation.h"
 #include "base/CCProtocols.h"
 #include "base/CCVector.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 NS_CC_BEGIN
 
@@ -128,6 +129,8 @@ protected:
 class CC_DLL Sequence : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Sequence);
+
     /** Helper constructor to create an array of sequenceable actions.
      *
      * @return An autoreleased Sequence object.
@@ -588,6 +591,8 @@ private:
 class CC_DLL MoveBy : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(MoveBy);
+
     /** 
      * Creates the action.
      *
@@ -643,6 +648,8 @@ private:
 class CC_DLL MoveTo : public MoveBy
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(MoveTo);
+
     /** 
      * Creates the action.
      * @param duration Duration time, in seconds.
@@ -1441,6 +1448,8 @@ private:
 class CC_DLL DelayTime : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(DelayTime);
+
     /** 
      * Creates the action.
      * @param d Duration time, in seconds.
@@ -27,13 +27,21 @@
  */
 
 #include "2d/CCClippingNode.h"
+#include <typeinfo>
+#include <algorithm>
+#include "2d/CCCamera.h"
 #include "2d/CCDrawingPrimitives.h"
+#include "2d/CCDrawNode.h"
+#include "2d/CCSprite.h"
+#include "platform/CCGLView.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
 #include "base/CCDirector.h"
+#include "base/CCFrameArena.h"
 #include "base/CCStencilStateManager.h"
+#include "xxhash.h"
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
 #define CC_CLIPPING_NODE_OPENGLES 0
@@ -55,10 +63,134 @@ static void setProgram(Node *n, GLProgram *p)
 }
 #endif
 
+// stencils with more triangles always use the stencil buffer
+static const int MAX_FAST_STENCIL_TRIANGLES = 1024;
+
+static ClippingNode* s_visitingClippingNode = nullptr;
+
+// whether the transform keeps the xy plane, so clipping in the plane of a node clips its content too
+static bool isPlanarTransform(const Mat4& m)
+{
+    const float epsilon = 1e-5f;
+    return fabsf(m.m[2]) < epsilon && fabsf(m.m[6]) < epsilon && fabsf(m.m[8]) < epsilon && fabsf(m.m[9]) < epsilon
+        && m.m[3] == 0 && m.m[7] == 0 && m.m[11] == 0;
+}
+
+static float cross(const Vec2& o, const Vec2& a, const Vec2& b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// whether the interiors of two counterclockwise triangles overlap, triangles sharing an edge or a vertex don't
+static bool trianglesOverlap(const Vec2* a, const Vec2* b, float epsilon)
+{
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        // separated when the other triangle is on the outer side of one of the edges
+        for (int i = 0; i < 3; ++i)
+        {
+            const Vec2& p = a[i];
+            const Vec2& q = a[(i + 1) % 3];
+            if (cross(p, q, b[0]) <= epsilon && cross(p, q, b[1]) <= epsilon && cross(p, q, b[2]) <= epsilon)
+                return false;
+        }
+        std::swap(a, b);
+    }
+    return true;
+}
+
+// whether any two of the triangles, 3 points each, overlap. Degenerate triangles cover nothing and are skipped
+static bool anyTrianglesOverlap(const std::vector<Vec2>& points, float epsilon)
+{
+    struct Triangle
+    {
+        Vec2 p[3];
+        float minX, maxX, minY, maxY;
+    };
+    std::vector<Triangle> triangles;
+    triangles.reserve(points.size() / 3);
+    for (size_t i = 0; i + 2 < points.size(); i += 3)
+    {
+        float area = cross(points[i], points[i + 1], points[i + 2]);
+        if (fabsf(area) <= epsilon)
+            continue;
+
+        Triangle t;
+        t.p[0] = points[i];
+        t.p[1] = area > 0 ? points[i + 1] : points[i + 2];
+        t.p[2] = area > 0 ? points[i + 2] : points[i + 1];
+        t.minX = std::min({ t.p[0].x, t.p[1].x, t.p[2].x });
+        t.maxX = std::max({ t.p[0].x, t.p[1].x, t.p[2].x });
+        t.minY = std::min({ t.p[0].y, t.p[1].y, t.p[2].y });
+        t.maxY = std::max({ t.p[0].y, t.p[1].y, t.p[2].y });
+        triangles.push_back(t);
+    }
+
+    // sweep along x, only the triangles whose bounds overlap are tested
+    std::sort(triangles.begin(), triangles.end(), [](const Triangle& a, const Triangle& b) { return a.minX < b.minX; });
+    for (size_t i = 0; i < triangles.size(); ++i)
+    {
+        const auto& a = triangles[i];
+        for (size_t j = i + 1; j < triangles.size() && triangles[j].minX < a.maxX; ++j)
+        {
+            const auto& b = triangles[j];
+            if (b.minY < a.maxY && a.minY < b.maxY && trianglesOverlap(a.p, b.p, epsilon))
+                return true;
+        }
+    }
+    return false;
+}
+
+// counterclockwise convex hull with Andrew's monotone chain, nearly collinear points are dropped
+static void convexHull(std::vector<Vec2>& points, std::vector<Vec2>* hull)
+{
+    hull->clear();
+    if (points.size() < 3)
+        return;
+
+    std::sort(points.begin(), points.end(), [](const Vec2& a, const Vec2& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    float epsilon = 1e-6f * points.front().distanceSquared(points.back());
+
+    hull->resize(2 * points.size());
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        while (k >= 2 && cross((*hull)[k - 2], (*hull)[k - 1], points[i]) <= epsilon)
+            --k;
+        (*hull)[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i > 0; --i)
+    {
+        while (k >= lower && cross((*hull)[k - 2], (*hull)[k - 1], points[i - 1]) <= epsilon)
+            --k;
+        (*hull)[k++] = points[i - 1];
+    }
+    hull->resize(k > 0 ? k - 1 : 0);
+}
+
+static V3F_C4B_T2F lerpVertex(const V3F_C4B_T2F& a, const V3F_C4B_T2F& b, float t)
+{
+    V3F_C4B_T2F vertex;
+    vertex.vertices = a.vertices + (b.vertices - a.vertices) * t;
+    vertex.colors.r = (GLubyte)(a.colors.r + (b.colors.r - a.colors.r) * t);
+    vertex.colors.g = (GLubyte)(a.colors.g + (b.colors.g - a.colors.g) * t);
+    vertex.colors.b = (GLubyte)(a.colors.b + (b.colors.b - a.colors.b) * t);
+    vertex.colors.a = (GLubyte)(a.colors.a + (b.colors.a - a.colors.a) * t);
+    vertex.texCoords.u = a.texCoords.u + (b.texCoords.u - a.texCoords.u) * t;
+    vertex.texCoords.v = a.texCoords.v + (b.texCoords.v - a.texCoords.v) * t;
+    return vertex;
+}
+
 ClippingNode::ClippingNode()
 : _stencil(nullptr)
 , _originStencilProgram(nullptr)
 , _stencilStateManager(new StencilStateManager())
+, _fastClippingEnabled(false)
+, _clippingStencilHash(0)
+, _clippingStencilConvex(false)
+, _scissorRestored(false)
 {
 }
 
@@ -205,40 +337,85 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
 
-    //Add group command
-        
-    _groupCommand.init(_globalZOrder);
-    renderer->addCommand(&_groupCommand);
+    bool convexStencil = _fastClippingEnabled && updateClippingPolygon();
+    if (convexStencil && canClipContent(this))
+    {
+        // the sprites cut their triangles in Sprite::draw, no command separates them from the nodes around
+        auto visitingClippingNode = s_visitingClippingNode;
+        s_visitingClippingNode = this;
+        _clippingTransform = _modelViewTransform;
+        visitContent(renderer, flags);
+        s_visitingClippingNode = visitingClippingNode;
+    }
+    else if (convexStencil && updateScissorRect())
+    {
+        _groupCommand.init(_globalZOrder);
+        renderer->addCommand(&_groupCommand);
 
-    renderer->pushGroup(_groupCommand.getRenderQueueID());
+        renderer->pushGroup(_groupCommand.getRenderQueueID());
 
-    _beforeVisitCmd.init(_globalZOrder);
-    _beforeVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onBeforeVisit, _stencilStateManager);
-    renderer->addCommand(&_beforeVisitCmd);
-    
-    auto alphaThreshold = this->getAlphaThreshold();
-    if (alphaThreshold < 1)
+        _beforeVisitCmd.init(_globalZOrder);
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisitScissor, this);
+        renderer->addCommand(&_beforeVisitCmd);
+
+        visitContent(renderer, flags);
+
+        _afterVisitCmd.init(_globalZOrder);
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisitScissor, this);
+        renderer->addCommand(&_afterVisitCmd);
+
+        renderer->popGroup();
+    }
+    else
     {
+        //Add group command
+        
+        _groupCommand.init(_globalZOrder);
+        renderer->addCommand(&_groupCommand);
+
+        renderer->pushGroup(_groupCommand.getRenderQueueID());
+
+        _beforeVisitCmd.init(_globalZOrder);
+        _beforeVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onBeforeVisit, _stencilStateManager);
+        renderer->addCommand(&_beforeVisitCmd);
+        
+        auto alphaThreshold = this->getAlphaThreshold();
+        if (alphaThreshold < 1)
+        {
 #if CC_CLIPPING_NODE_OPENGLES
-        // since glAlphaTest do not exists in OES, use a shader that writes
-        // pixel only if greater than an alpha threshold
-        GLProgram *program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
-        GLint alphaValueLocation = glGetUniformLocation(program->getProgram(), GLProgram::UNIFORM_NAME_ALPHA_TEST_VALUE);
-        // set our alphaThreshold
-        program->use();
-        program->setUniformLocationWith1f(alphaValueLocation, alphaThreshold);
-        // we need to recursively apply this shader to all the nodes in the stencil node
-        // FIXME: we should have a way to apply shader to all nodes without having to do this
-        setProgram(_stencil, program);
+            // since glAlphaTest do not exists in OES, use a shader that writes
+            // pixel only if greater than an alpha threshold
+            GLProgram *program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
+            GLint alphaValueLocation = glGetUniformLocation(program->getProgram(), GLProgram::UNIFORM_NAME_ALPHA_TEST_VALUE);
+            // set our alphaThreshold
+            program->use();
+            program->setUniformLocationWith1f(alphaValueLocation, alphaThreshold);
+            // we need to recursively apply this shader to all the nodes in the stencil node
+            // FIXME: we should have a way to apply shader to all nodes without having to do this
+            setProgram(_stencil, program);
 #endif
 
-    }
-    _stencil->visit(renderer, _modelViewTransform, flags);
+        }
+        _stencil->visit(renderer, _modelViewTransform, flags);
+
+        _afterDrawStencilCmd.init(_globalZOrder);
+        _afterDrawStencilCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterDrawStencil, _stencilStateManager);
+        renderer->addCommand(&_afterDrawStencilCmd);
+
+        visitContent(renderer, flags);
 
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterDrawStencil, _stencilStateManager);
-    renderer->addCommand(&_afterDrawStencilCmd);
+        _afterVisitCmd.init(_globalZOrder);
+        _afterVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterVisit, _stencilStateManager);
+        renderer->addCommand(&_afterVisitCmd);
+
+        renderer->popGroup();
+    }
+    
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
 
+void ClippingNode::visitContent(Renderer *renderer, uint32_t flags)
+{
     int i = 0;
     bool visibleByCamera = isVisitableByVisitingCamera();
     
@@ -266,14 +443,316 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
+}
 
-    _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterVisit, _stencilStateManager);
-    renderer->addCommand(&_afterVisitCmd);
+bool ClippingNode::canClipContent(Node* node) const
+{
+    for (const auto& child : node->getChildren())
+    {
+        if (!child->isVisible())
+            continue;
 
-    renderer->popGroup();
-    
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        // subclasses may draw more than the triangles of the sprite
+        const auto& type = typeid(*child);
+        if (type != typeid(Sprite) && type != typeid(Node))
+            return false;
+
+        // out of the group command, content with another global Z order would move relative to the other nodes
+        if (child->getGlobalZOrder() != _globalZOrder)
+            return false;
+
+        if (!isPlanarTransform(child->getNodeToParentTransform()) || !canClipContent(child))
+            return false;
+    }
+    return true;
+}
+
+bool ClippingNode::updateClippingPolygon()
+{
+    // with an alpha threshold the transparent pixels of the stencil don't count, the triangles alone don't tell its shape
+    if (!_stencil || !_stencil->isVisible() || !_stencil->getChildren().empty() || isInverted() || getAlphaThreshold() < 1)
+        return false;
+
+    const Mat4& stencilTransform = _stencil->getNodeToParentTransform();
+    if (!isPlanarTransform(stencilTransform))
+        return false;
+
+    // the hull is only computed again when the stencil, its triangles or its transform change
+    const auto& type = typeid(*_stencil);
+    unsigned int hash = XXH32(&_stencil, sizeof(_stencil), 0);
+    if (type == typeid(Sprite))
+    {
+        auto sprite = static_cast<Sprite*>(_stencil);
+        const auto& triangles = sprite->getPolygonInfo().triangles;
+        if (!sprite->getTexture() || triangles.indexCount > 3 * MAX_FAST_STENCIL_TRIANGLES)
+            return false;
+
+        hash = XXH32(triangles.verts, triangles.vertCount * sizeof(*triangles.verts), hash);
+        hash = XXH32(triangles.indices, triangles.indexCount * sizeof(*triangles.indices), hash);
+    }
+    else if (type == typeid(DrawNode))
+    {
+        // points and lines are not part of a shape
+        auto drawNode = static_cast<DrawNode*>(_stencil);
+        if (drawNode->_bufferCountGLPoint > 0 || drawNode->_bufferCountGLLine > 0 || drawNode->_bufferCount > 3 * MAX_FAST_STENCIL_TRIANGLES)
+            return false;
+
+        hash = XXH32(drawNode->_buffer, drawNode->_bufferCount * sizeof(*drawNode->_buffer), hash);
+    }
+    else
+    {
+        return false;
+    }
+    if (hash == _clippingStencilHash && memcmp(stencilTransform.m, _clippingStencilTransform.m, sizeof(stencilTransform.m)) == 0)
+        return _clippingStencilConvex;
+
+    _clippingStencilHash = hash;
+    _clippingStencilTransform = stencilTransform;
+    _clippingStencilConvex = false;
+    _clippingPolygon.clear();
+
+    auto& points = _clippingPoints;
+    points.clear();
+    float trianglesArea = 0;
+    auto addTriangle = [&](const Vec3& a, const Vec3& b, const Vec3& c) {
+        Vec3 p[3] = { a, b, c };
+        for (auto& point : p)
+        {
+            stencilTransform.transformPoint(&point);
+            points.push_back(Vec2(point.x, point.y));
+        }
+        trianglesArea += fabsf(cross(points[points.size() - 3], points[points.size() - 2], points.back())) / 2;
+    };
+
+    if (type == typeid(Sprite))
+    {
+        const auto& triangles = static_cast<Sprite*>(_stencil)->getPolygonInfo().triangles;
+        for (int i = 0; i + 2 < triangles.indexCount; i += 3)
+        {
+            addTriangle(triangles.verts[triangles.indices[i]].vertices,
+                        triangles.verts[triangles.indices[i + 1]].vertices,
+                        triangles.verts[triangles.indices[i + 2]].vertices);
+        }
+    }
+    else
+    {
+        auto drawNode = static_cast<DrawNode*>(_stencil);
+        const V2F_C4B_T2F* buffer = drawNode->_buffer;
+        for (GLsizei i = 0; i + 2 < drawNode->_bufferCount; i += 3)
+        {
+            addTriangle(Vec3(buffer[i].vertices.x, buffer[i].vertices.y, 0),
+                        Vec3(buffer[i + 1].vertices.x, buffer[i + 1].vertices.y, 0),
+                        Vec3(buffer[i + 2].vertices.x, buffer[i + 2].vertices.y, 0));
+        }
+    }
+
+    // Triangles which don't overlap cover their hull only if their total area is the area of the hull, holes or
+    // concave parts make it smaller. Overlapping triangles could leave a hole of the same area, they are rejected first
+    if (anyTrianglesOverlap(points, trianglesArea * 1e-5f))
+        return false;
+
+    convexHull(points, &_clippingPolygon);
+
+    float hullArea = 0;
+    for (size_t i = 2; i < _clippingPolygon.size(); ++i)
+        hullArea += cross(_clippingPolygon[0], _clippingPolygon[i - 1], _clippingPolygon[i]) / 2;
+    if (_clippingPolygon.size() < 3 || hullArea <= 0 || fabsf(hullArea - trianglesArea) > hullArea * 1e-3f)
+    {
+        _clippingPolygon.clear();
+        return false;
+    }
+    _clippingStencilConvex = true;
+    return true;
+}
+
+bool ClippingNode::updateScissorRect()
+{
+    auto director = Director::getInstance();
+    auto camera = Camera::getVisitingCamera();
+    if (_clippingPolygon.size() != 4 || !camera || director->getOpenGLView()->getVR())
+        return false;
+
+    // screen coordinates are only known when drawing with the camera, not inside a RenderTexture for example
+    const Mat4& viewProjection = camera->getViewProjectionMatrix();
+    if (memcmp(director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION).m, viewProjection.m, sizeof(viewProjection.m)) != 0)
+        return false;
+
+    Mat4 transform = viewProjection * _modelViewTransform;
+    auto winSize = director->getWinSize();
+    Vec2 corners[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        Vec4 clipPos;
+        transform.transformVector(Vec4(_clippingPolygon[i].x, _clippingPolygon[i].y, 0, 1), &clipPos);
+        if (clipPos.w <= 0)
+            return false;
+        corners[i].x = (clipPos.x / clipPos.w + 1.0f) * 0.5f * winSize.width;
+        corners[i].y = (clipPos.y / clipPos.w + 1.0f) * 0.5f * winSize.height;
+    }
+
+    float minX = std::min(std::min(corners[0].x, corners[1].x), std::min(corners[2].x, corners[3].x));
+    float maxX = std::max(std::max(corners[0].x, corners[1].x), std::max(corners[2].x, corners[3].x));
+    float minY = std::min(std::min(corners[0].y, corners[1].y), std::min(corners[2].y, corners[3].y));
+    float maxY = std::max(std::max(corners[0].y, corners[1].y), std::max(corners[2].y, corners[3].y));
+
+    // a rectangle on screen if every corner is on a corner of the bounds
+    const float epsilon = 0.01f;
+    for (const auto& corner : corners)
+    {
+        if ((fabsf(corner.x - minX) > epsilon && fabsf(corner.x - maxX) > epsilon)
+            || (fabsf(corner.y - minY) > epsilon && fabsf(corner.y - maxY) > epsilon))
+            return false;
+    }
+
+    _scissorRect.setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
+void ClippingNode::onBeforeVisitScissor()
+{
+    auto glview = Director::getInstance()->getOpenGLView();
+    Rect rect = _scissorRect;
+
+    _scissorRestored = glview->isScissorEnabled();
+    if (_scissorRestored)
+    {
+        // already clipped by a parent, keep the intersection
+        _parentScissorRect = glview->getScissorRect();
+        float x = MAX(rect.getMinX(), _parentScissorRect.getMinX());
+        float y = MAX(rect.getMinY(), _parentScissorRect.getMinY());
+        float xx = MIN(rect.getMaxX(), _parentScissorRect.getMaxX());
+        float yy = MIN(rect.getMaxY(), _parentScissorRect.getMaxY());
+        rect.setRect(x, y, MAX(xx - x, 0.0f), MAX(yy - y, 0.0f));
+    }
+    else
+    {
+        glEnable(GL_SCISSOR_TEST);
+    }
+    glview->setScissorInPoints(rect.origin.x, rect.origin.y, rect.size.width, rect.size.height);
+}
+
+void ClippingNode::onAfterVisitScissor()
+{
+    if (_scissorRestored)
+    {
+        auto glview = Director::getInstance()->getOpenGLView();
+        glview->setScissorInPoints(_parentScissorRect.origin.x, _parentScissorRect.origin.y, _parentScissorRect.size.width, _parentScissorRect.size.height);
+    }
+    else
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+}
+
+ClippingNode* ClippingNode::getVisitingClippingNode()
+{
+    return s_visitingClippingNode;
+}
+
+bool ClippingNode::clipTriangles(const Mat4& transform, const TrianglesCommand::Triangles& triangles, TrianglesCommand::Triangles* clipped)
+{
+    // the edges of the stencil in the coordinates of the triangles, as lines giving the distance to the inside
+    Mat4 toTriangles = transform.getInversed() * _clippingTransform;
+    float orientation = toTriangles.m[0] * toTriangles.m[5] - toTriangles.m[1] * toTriangles.m[4] < 0 ? -1.0f : 1.0f;
+    _clippingEdges.clear();
+    for (size_t i = 0, count = _clippingPolygon.size(); i < count; ++i)
+    {
+        Vec3 from(_clippingPolygon[i].x, _clippingPolygon[i].y, 0);
+        Vec3 to(_clippingPolygon[(i + 1) % count].x, _clippingPolygon[(i + 1) % count].y, 0);
+        toTriangles.transformPoint(&from);
+        toTriangles.transformPoint(&to);
+        Vec2 normal(from.y - to.y, to.x - from.x);
+        float length = normal.length();
+        if (length == 0)
+            continue;
+        normal *= orientation / length;
+        _clippingEdges.push_back(Vec3(normal.x, normal.y, -(normal.x * from.x + normal.y * from.y)));
+    }
+
+    // most triangles are entirely inside or outside
+    const float epsilon = 1e-3f;
+    bool inside = true;
+    for (const auto& edge : _clippingEdges)
+    {
+        int outside = 0;
+        for (int i = 0; i < triangles.vertCount; ++i)
+        {
+            const Vec3& vertex = triangles.verts[i].vertices;
+            if (edge.x * vertex.x + edge.y * vertex.y + edge.z < -epsilon)
+                ++outside;
+        }
+        if (outside == triangles.vertCount)
+            return false;
+        if (outside > 0)
+            inside = false;
+    }
+    if (inside)
+    {
+        *clipped = triangles;
+        return true;
+    }
+
+    // Sutherland-Hodgman on every triangle, the convex pieces left are drawn as fans
+    auto& vertices = _clippedVertices;
+    auto& indices = _clippedIndices;
+    vertices.clear();
+    indices.clear();
+    auto& polygon = _clippingScratch[0];
+    auto& cut = _clippingScratch[1];
+    for (int i = 0; i + 2 < triangles.indexCount; i += 3)
+    {
+        polygon.clear();
+        polygon.push_back(triangles.verts[triangles.indices[i]]);
+        polygon.push_back(triangles.verts[triangles.indices[i + 1]]);
+        polygon.push_back(triangles.verts[triangles.indices[i + 2]]);
+
+        for (const auto& edge : _clippingEdges)
+        {
+            cut.clear();
+            for (size_t j = 0, count = polygon.size(); j < count; ++j)
+            {
+                const auto& previous = polygon[(j + count - 1) % count];
+                const auto& current = polygon[j];
+                float previousDistance = edge.x * previous.vertices.x + edge.y * previous.vertices.y + edge.z;
+                float currentDistance = edge.x * current.vertices.x + edge.y * current.vertices.y + edge.z;
+                if ((previousDistance < 0) != (currentDistance < 0))
+                    cut.push_back(lerpVertex(previous, current, previousDistance / (previousDistance - currentDistance)));
+                if (currentDistance >= 0)
+                    cut.push_back(current);
+            }
+            polygon.swap(cut);
+            if (polygon.size() < 3)
+                break;
+        }
+
+        if (polygon.size() < 3)
+            continue;
+
+        auto first = (unsigned short)vertices.size();
+        vertices.insert(vertices.end(), polygon.begin(), polygon.end());
+        for (size_t j = 1; j + 1 < polygon.size(); ++j)
+        {
+            indices.push_back(first);
+            indices.push_back((unsigned short)(first + j));
+            indices.push_back((unsigned short)(first + j + 1));
+        }
+    }
+
+    if (indices.empty())
+        return false;
+
+    // the command drawing them is queued until the frame is rendered, and the node may be drawn again before that
+    auto arena = FrameArena::getInstance();
+    auto clippedVertices = static_cast<V3F_C4B_T2F*>(arena->allocate(vertices.size() * sizeof(V3F_C4B_T2F), alignof(V3F_C4B_T2F)));
+    auto clippedIndices = static_cast<unsigned short*>(arena->allocate(indices.size() * sizeof(unsigned short), alignof(unsigned short)));
+    memcpy(clippedVertices, vertices.data(), vertices.size() * sizeof(V3F_C4B_T2F));
+    memcpy(clippedIndices, indices.data(), indices.size() * sizeof(unsigned short));
+
+    clipped->verts = clippedVertices;
+    clipped->vertCount = (int)vertices.size();
+    clipped->indices = clippedIndices;
+    clipped->indexCount = (int)indices.size();
+    return true;
 }
 
 void ClippingNode::setCameraMask(unsigned short mask, bool applyChildren)
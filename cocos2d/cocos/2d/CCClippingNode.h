@@ -33,6 +33,7 @@
 #include "platform/CCGL.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 
 NS_CC_BEGIN
 
@@ -45,6 +46,12 @@ class StencilStateManager;
  * It draws its content (children) clipped using a stencil.
  * The stencil is an other Node that will not be drawn.
  * The clipping is done using the alpha part of the stencil (adjusted with an alphaThreshold).
+ *
+ * With fast clipping enabled, see setFastClippingEnabled(), when the stencil is a convex Sprite or DrawNode,
+ * the alpha threshold is 1 and the clipping is not inverted, the stencil buffer is not needed:
+ * - if the content only has Sprites (and plain Nodes) with the global Z order of the clipping node, they cut their
+ *   triangles to the stencil themselves, and keep being batched with the nodes around the clipping node.
+ * - otherwise if the stencil is a rectangle on screen, the content is clipped with a scissor, like ClippingRectangleNode.
  */
 class CC_DLL ClippingNode : public Node
 {
@@ -116,6 +123,32 @@ public:
      */
     void setInverted(bool inverted);
 
+    /** Whether the clipping may be done without the stencil buffer when the stencil allows it.
+     * When the Sprites of the content cut their triangles themselves, they are no longer drawn in a group of their
+     * own, so nodes outside the clipping node with a global Z order between theirs may be drawn differently.
+     * This defaults to false.
+     */
+    bool isFastClippingEnabled() const { return _fastClippingEnabled; }
+    void setFastClippingEnabled(bool enabled) { _fastClippingEnabled = enabled; }
+
+    /** The clipping node whose content is being visited and cut to its stencil by the Sprites themselves,
+     * nullptr otherwise.
+     * @js NA
+     * @lua NA
+     */
+    static ClippingNode* getVisitingClippingNode();
+
+    /** Cuts triangles drawn with the given transform to the stencil of the visiting clipping node.
+     * @param transform The model view transform the triangles are drawn with.
+     * @param triangles The triangles to cut.
+     * @param clipped Set to the triangles to draw, the original ones when they are entirely inside the stencil.
+     * The cut triangles are allocated from the FrameArena, so they stay valid until the frame is rendered.
+     * @return False when nothing is left to draw.
+     * @js NA
+     * @lua NA
+     */
+    bool clipTriangles(const Mat4& transform, const TrianglesCommand::Triangles& triangles, TrianglesCommand::Triangles* clipped);
+
     // Overrides
     /**
      * @lua NA
@@ -156,6 +189,16 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool init(Node *stencil);
 
 protected:
+    /** computes _clippingPolygon when the stencil changed, returns false when the stencil is not a convex shape */
+    bool updateClippingPolygon();
+    /** whether everything the children of the node draw are Sprites, which cut their triangles themselves */
+    bool canClipContent(Node* node) const;
+    /** computes _scissorRect, returns false when the stencil is not a rectangle on screen */
+    bool updateScissorRect();
+    void visitContent(Renderer *renderer, uint32_t flags);
+    void onBeforeVisitScissor();
+    void onAfterVisitScissor();
+
     Node* _stencil;
     GLProgram* _originStencilProgram;
    
@@ -166,6 +209,29 @@ protected:
     CustomCommand _afterDrawStencilCmd;
     CustomCommand _afterVisitCmd;
 
+    bool _fastClippingEnabled;
+    /** convex hull of the stencil in node coordinates, counterclockwise */
+    std::vector<Vec2> _clippingPolygon;
+    /** the stencil _clippingPolygon was computed for: its transform and a hash of its triangles */
+    Mat4 _clippingStencilTransform;
+    unsigned int _clippingStencilHash;
+    bool _clippingStencilConvex;
+    /** corners of the stencil triangles, kept to not allocate them again */
+    std::vector<Vec2> _clippingPoints;
+    /** model view transform of the node while its content is cut to _clippingPolygon */
+    Mat4 _clippingTransform;
+    /** the stencil on screen, in points */
+    Rect _scissorRect;
+    /** scissor of a parent clipping, restored after the content */
+    Rect _parentScissorRect;
+    bool _scissorRestored;
+    /** edges of _clippingPolygon in the coordinates of the triangles being cut, their cut polygons and the
+     cut triangles before they are copied to the FrameArena */
+    std::vector<Vec3> _clippingEdges;
+    std::vector<V3F_C4B_T2F> _clippingScratch[2];
+    std::vector<V3F_C4B_T2F> _clippedVertices;
+    std::vector<unsigned short> _clippedIndices;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ClippingNode);
 };
@@ -35,6 +35,8 @@
 #include "2d/CCActionCatmullRom.h"
 #include "platform/CCGL.h"
 
+#include <unordered_map>
+
 NS_CC_BEGIN
 
 static inline Tex2F v2ToTex2F(const Vec2 &v)
@@ -42,6 +44,30 @@ static inline Tex2F v2ToTex2F(const Vec2 &v)
     return {v.x, v.y};
 }
 
+// Unit circle shared by all the circles drawn with the same number of segments, so a circle
+// costs one sinf/cosf pair for its angle instead of one pair per vertex.
+static const Vec2* getUnitCircle(unsigned int segments)
+{
+    static std::unordered_map<unsigned int, std::vector<Vec2>> s_unitCircles;
+
+    auto iter = s_unitCircles.find(segments);
+    if (iter != s_unitCircles.end())
+        return iter->second.data();
+
+    // segment counts are usually a handful of constants, don't let odd callers grow the cache forever
+    if (s_unitCircles.size() >= 32)
+        s_unitCircles.clear();
+
+    auto& points = s_unitCircles[segments];
+    points.resize(segments + 1);
+    const float coef = 2.0f * (float)M_PI/segments;
+    for (unsigned int i = 0; i <= segments; i++)
+    {
+        points[i].set(cosf(i*coef), sinf(i*coef));
+    }
+    return points.data();
+}
+
 static const float EPSILON=0.0000000001f;
 float Triangulate::computeArea(const Vec2 *verts,int n)
 {
@@ -200,9 +226,13 @@ DrawNode::~DrawNode()
     glDeleteBuffers(1, &_vbo);
     glDeleteBuffers(1, &_vboGLLine);
     glDeleteBuffers(1, &_vboGLPoint);
+    glDeleteBuffers(1, &_vboStatic);
+    glDeleteBuffers(1, &_vboStaticGLLine);
+    glDeleteBuffers(1, &_vboStaticGLPoint);
     _vbo = 0;
     _vboGLPoint = 0;
     _vboGLLine = 0;
+    _vboStatic = _vboStaticGLLine = _vboStaticGLPoint = 0;
 
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -332,9 +362,52 @@ void DrawNode::setupBuffer()
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
+    // the static layer is drawn without a VAO, its buffers are bound when it is drawn
+    glGenBuffers(1, &_vboStatic);
+    glGenBuffers(1, &_vboStaticGLLine);
+    glGenBuffers(1, &_vboStaticGLPoint);
+
+    // the dynamic buffers only hold what was drawn after the static layer
+    _dirty = _dirtyGLLine = _dirtyGLPoint = true;
+    _dirtyStatic = _dirtyStaticGLLine = _dirtyStaticGLPoint = true;
+
     CHECK_GL_ERROR_DEBUG();
 }
 
+void DrawNode::updateBuffer(GLuint vbo, const V2F_C4B_T2F *buffer, GLsizei count, GLenum usage)
+{
+    // new storage on every upload, so the driver orphans the one the previous frames may still
+    // be drawing from instead of waiting for the GPU
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*count, buffer, usage);
+}
+
+void DrawNode::drawBuffer(GLuint vao, GLuint vbo, GLenum mode, GLsizei count)
+{
+    if (vao)
+    {
+        GL::bindVAO(vao);
+    }
+    else
+    {
+        if (Configuration::getInstance()->supportsShareableVAO())
+        {
+            GL::bindVAO(0);
+        }
+        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        // vertex
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
+        // color
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
+        // texcoord
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
+    }
+
+    glDrawArrays(mode, 0, count);
+}
+
 bool DrawNode::init()
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
@@ -384,31 +457,25 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t /*flags*/)
     glProgram->setUniformLocationWith1f(glProgram->getUniformLocation("u_alpha"), _displayedOpacity / 255.0);
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
+    if (_dirtyStatic)
+    {
+        updateBuffer(_vboStatic, _buffer, _staticCount, GL_STATIC_DRAW);
+        _dirtyStatic = false;
+    }
     if (_dirty)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
-
+        updateBuffer(_vbo, _buffer + _staticCount, _bufferCount - _staticCount, GL_STREAM_DRAW);
         _dirty = false;
     }
-    if (Configuration::getInstance()->supportsShareableVAO())
+
+    if (_staticCount)
     {
-        GL::bindVAO(_vao);
+        drawBuffer(0, _vboStatic, GL_TRIANGLES, _staticCount);
     }
-    else
+    if (_bufferCount > _staticCount)
     {
-        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        // vertex
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
-        // color
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
-        // texcoord
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
+        drawBuffer(_vao, _vbo, GL_TRIANGLES, _bufferCount - _staticCount);
     }
-
-    glDrawArrays(GL_TRIANGLES, 0, _bufferCount);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -416,7 +483,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t /*flags*/)
         GL::bindVAO(0);
     }
 
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _bufferCount);
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES((_staticCount > 0) + (_bufferCount > _staticCount), _bufferCount);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -429,39 +496,33 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t /*flags*/)
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
+    if (_dirtyStaticGLLine)
+    {
+        updateBuffer(_vboStaticGLLine, _bufferGLLine, _staticCountGLLine, GL_STATIC_DRAW);
+        _dirtyStaticGLLine = false;
+    }
     if (_dirtyGLLine)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
+        updateBuffer(_vboGLLine, _bufferGLLine + _staticCountGLLine, _bufferCountGLLine - _staticCountGLLine, GL_STREAM_DRAW);
         _dirtyGLLine = false;
     }
-    if (Configuration::getInstance()->supportsShareableVAO())
+    glLineWidth(_lineWidth);
+    if (_staticCountGLLine)
     {
-        GL::bindVAO(_vaoGLLine);
+        drawBuffer(0, _vboStaticGLLine, GL_LINES, _staticCountGLLine);
     }
-    else
+    if (_bufferCountGLLine > _staticCountGLLine)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
-        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-        // vertex
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
-        // color
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
-        // texcoord
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
+        drawBuffer(_vaoGLLine, _vboGLLine, GL_LINES, _bufferCountGLLine - _staticCountGLLine);
     }
-
-    glLineWidth(_lineWidth);
-    glDrawArrays(GL_LINES, 0, _bufferCountGLLine);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         GL::bindVAO(0);
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCountGLLine);
-
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES((_staticCountGLLine > 0) + (_bufferCountGLLine > _staticCountGLLine), _bufferCountGLLine);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -474,37 +535,33 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t /*flags*/)
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
+    if (_dirtyStaticGLPoint)
+    {
+        updateBuffer(_vboStaticGLPoint, _bufferGLPoint, _staticCountGLPoint, GL_STATIC_DRAW);
+        _dirtyStaticGLPoint = false;
+    }
     if (_dirtyGLPoint)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
-
+        updateBuffer(_vboGLPoint, _bufferGLPoint + _staticCountGLPoint, _bufferCountGLPoint - _staticCountGLPoint, GL_STREAM_DRAW);
         _dirtyGLPoint = false;
     }
 
-    if (Configuration::getInstance()->supportsShareableVAO())
+    if (_staticCountGLPoint)
     {
-        GL::bindVAO(_vaoGLPoint);
+        drawBuffer(0, _vboStaticGLPoint, GL_POINTS, _staticCountGLPoint);
     }
-    else
+    if (_bufferCountGLPoint > _staticCountGLPoint)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
-        GL::enableVertexAttribs( GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
+        drawBuffer(_vaoGLPoint, _vboGLPoint, GL_POINTS, _bufferCountGLPoint - _staticCountGLPoint);
     }
-
-    glDrawArrays(GL_POINTS, 0, _bufferCountGLPoint);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         GL::bindVAO(0);
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCountGLPoint);
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES((_staticCountGLPoint > 0) + (_bufferCountGLPoint > _staticCountGLPoint), _bufferCountGLPoint);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -591,34 +648,43 @@ void DrawNode::drawPoly(const Vec2 *poli, unsigned int numberOfPoints, bool clos
     }
 
     _bufferCountGLLine += vertex_count;
+    _dirtyGLLine = true;
 }
 
 void DrawNode::drawCircle(const Vec2& center, float radius, float angle, unsigned int segments, bool drawLineToCenter, float scaleX, float scaleY, const Color4F &color)
 {
-    const float coef = 2.0f * (float)M_PI/segments;
-
-    Vec2 *vertices = new (std::nothrow) Vec2[segments+2];
-    if( ! vertices )
+    if (segments == 0)
         return;
 
-    for(unsigned int i = 0;i <= segments; i++) {
-        float rads = i*coef;
-        GLfloat j = radius * cosf(rads + angle) * scaleX + center.x;
-        GLfloat k = radius * sinf(rads + angle) * scaleY + center.y;
+    const Vec2 *unit = getUnitCircle(segments);
+    const float cosA = cosf(angle), sinA = sinf(angle);
+    const float rx = radius * scaleX, ry = radius * scaleY;
+    auto vertexAt = [&](unsigned int i) -> Vec2 {
+        if (i > segments)
+            return center;
+        return Vec2(rx * (unit[i].x * cosA - unit[i].y * sinA) + center.x,
+                    ry * (unit[i].y * cosA + unit[i].x * sinA) + center.y);
+    };
+
+    // same lines as drawPoly() with a closed polygon, written without the temporary vertex array
+    unsigned int numberOfPoints = drawLineToCenter ? segments + 2 : segments + 1;
+    unsigned int vertex_count = 2 * numberOfPoints;
+    ensureCapacityGLLine(vertex_count);
 
-        vertices[i].x = j;
-        vertices[i].y = k;
-    }
-    if(drawLineToCenter)
+    V2F_C4B_T2F *point = _bufferGLLine + _bufferCountGLLine;
+    Color4B col(color);
+    Vec2 first = vertexAt(0);
+    Vec2 from = first;
+    for (unsigned int i = 1; i <= numberOfPoints; i++, point += 2)
     {
-        vertices[segments+1].x = center.x;
-        vertices[segments+1].y = center.y;
-        drawPoly(vertices, segments+2, true, color);
+        Vec2 to = i < numberOfPoints ? vertexAt(i) : first;
+        *point = {from, col, Tex2F(0.0, 0.0)};
+        *(point + 1) = {to, col, Tex2F(0.0, 0.0)};
+        from = to;
     }
-    else
-        drawPoly(vertices, segments+1, true, color);
 
-    CC_SAFE_DELETE_ARRAY(vertices);
+    _bufferCountGLLine += vertex_count;
+    _dirtyGLLine = true;
 }
 
 void DrawNode::drawCircle(const Vec2 &center, float radius, float angle, unsigned int segments, bool drawLineToCenter, const Color4F &color)
@@ -905,25 +971,35 @@ void DrawNode::drawSolidPoly(const Vec2 *poli, unsigned int numberOfPoints, cons
 
 void DrawNode::drawSolidCircle(const Vec2& center, float radius, float angle, unsigned int segments, float scaleX, float scaleY, const Color4F &color)
 {
-    const float coef = 2.0f * (float)M_PI/segments;
-    
-    Vec2 *vertices = new (std::nothrow) Vec2[segments];
-    if( ! vertices )
+    if (segments < 3)
         return;
-    
-    for(unsigned int i = 0;i < segments; i++)
+
+    const Vec2 *unit = getUnitCircle(segments);
+    const float cosA = cosf(angle), sinA = sinf(angle);
+    const float rx = radius * scaleX, ry = radius * scaleY;
+    auto vertexAt = [&](unsigned int i) -> Vec2 {
+        return Vec2(rx * (unit[i].x * cosA - unit[i].y * sinA) + center.x,
+                    ry * (unit[i].y * cosA + unit[i].x * sinA) + center.y);
+    };
+
+    // a circle is convex, fan it from its first vertex instead of going through Triangulate
+    unsigned int vertex_count = 3 * (segments - 2);
+    ensureCapacity(vertex_count);
+
+    V2F_C4B_T2F_Triangle *triangles = (V2F_C4B_T2F_Triangle *)(_buffer + _bufferCount);
+    Color4B col(color);
+    V2F_C4B_T2F first = {vertexAt(0), col, v2ToTex2F(Vec2::ZERO)};
+    V2F_C4B_T2F prev = {vertexAt(1), col, v2ToTex2F(Vec2::ZERO)};
+    for (unsigned int i = 2; i < segments; i++)
     {
-        float rads = i*coef;
-        GLfloat j = radius * cosf(rads + angle) * scaleX + center.x;
-        GLfloat k = radius * sinf(rads + angle) * scaleY + center.y;
-        
-        vertices[i].x = j;
-        vertices[i].y = k;
+        V2F_C4B_T2F next = {vertexAt(i), col, v2ToTex2F(Vec2::ZERO)};
+        V2F_C4B_T2F_Triangle triangle = {first, prev, next};
+        *triangles++ = triangle;
+        prev = next;
     }
-    
-    drawSolidPoly(vertices, segments, color);
-    
-    CC_SAFE_DELETE_ARRAY(vertices);
+
+    _bufferCount += vertex_count;
+    _dirty = true;
 }
 
 void DrawNode::drawSolidCircle( const Vec2& center, float radius, float angle, unsigned int segments, const Color4F& color)
@@ -956,15 +1032,34 @@ void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const
 
 void DrawNode::clear()
 {
-    _bufferCount = 0;
+    _bufferCount = _staticCount;
     _dirty = true;
-    _bufferCountGLLine = 0;
+    _bufferCountGLLine = _staticCountGLLine;
     _dirtyGLLine = true;
-    _bufferCountGLPoint = 0;
+    _bufferCountGLPoint = _staticCountGLPoint;
     _dirtyGLPoint = true;
     _lineWidth = _defaultLineWidth;
 }
 
+void DrawNode::freezeStaticLayer()
+{
+    _staticCount = _bufferCount;
+    _staticCountGLLine = _bufferCountGLLine;
+    _staticCountGLPoint = _bufferCountGLPoint;
+
+    // what was dynamic moves to the static buffers
+    _dirty = _dirtyGLLine = _dirtyGLPoint = true;
+    _dirtyStatic = _dirtyStaticGLLine = _dirtyStaticGLPoint = true;
+}
+
+void DrawNode::clearStaticLayer()
+{
+    _staticCount = 0;
+    _staticCountGLLine = 0;
+    _staticCountGLPoint = 0;
+    clear();
+}
+
 const BlendFunc& DrawNode::getBlendFunc() const
 {
     return _blendFunc;
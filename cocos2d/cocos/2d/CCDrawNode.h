@@ -309,8 +309,24 @@ public:
      */
     CC_DEPRECATED_ATTRIBUTE void drawQuadraticBezier(const Vec2& from, const Vec2& control, const Vec2& to, unsigned int segments, const Color4F &color);
     
-    /** Clear the geometry in the node's buffer. */
+    /** Clear the geometry in the node's buffer.
+     * Geometry kept by freezeStaticLayer() is not cleared.
+     */
     void clear();
+
+    /** Keeps everything drawn so far as a static layer.
+     * The static layer survives clear() and is uploaded to the GPU only once, in buffers of its own, so a
+     * node that redraws a few moving shapes on top of a large fixed background only pays for the moving
+     * shapes every frame.
+     */
+    void freezeStaticLayer();
+
+    /** Drops the static layer and clears all the geometry of the node. */
+    void clearStaticLayer();
+
+    /** Whether the node has a static layer. */
+    bool hasStaticLayer() const { return _staticCount > 0 || _staticCountGLPoint > 0 || _staticCountGLLine > 0; }
+
     /** Get the color mixed mode.
     * @lua NA
     */
@@ -361,11 +377,16 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool init() override;
 
 protected:
+    // reads the triangles of stencils to clip without the stencil buffer
+    friend class ClippingNode;
+
     void ensureCapacity(int count);
     void ensureCapacityGLPoint(int count);
     void ensureCapacityGLLine(int count);
 
     void setupBuffer();
+    void updateBuffer(GLuint vbo, const V2F_C4B_T2F *buffer, GLsizei count, GLenum usage);
+    void drawBuffer(GLuint vao, GLuint vbo, GLenum mode, GLsizei count);
 
     GLuint      _vao = 0;
     GLuint      _vbo = 0;
@@ -374,6 +395,11 @@ protected:
     GLuint      _vaoGLLine = 0;
     GLuint      _vboGLLine = 0;
 
+    // the static layer has its own buffers, uploaded once, see freezeStaticLayer()
+    GLuint      _vboStatic = 0;
+    GLuint      _vboStaticGLPoint = 0;
+    GLuint      _vboStaticGLLine = 0;
+
     int         _bufferCapacity = 0;
     GLsizei     _bufferCount = 0;
     V2F_C4B_T2F *_buffer = nullptr;
@@ -388,6 +414,11 @@ protected:
     GLsizei     _bufferCountGLLine = 0;
     V2F_C4B_T2F *_bufferGLLine = nullptr;
 
+    // vertices kept across clear() at the start of the buffers, see freezeStaticLayer()
+    GLsizei     _staticCount = 0;
+    GLsizei     _staticCountGLPoint = 0;
+    GLsizei     _staticCountGLLine = 0;
+
     BlendFunc   _blendFunc;
     CustomCommand _customCommand;
     CustomCommand _customCommandGLPoint;
@@ -396,6 +427,9 @@ protected:
     bool        _dirty = false;
     bool        _dirtyGLPoint = false;
     bool        _dirtyGLLine = false;
+    bool        _dirtyStatic = false;
+    bool        _dirtyStaticGLPoint = false;
+    bool        _dirtyStaticGLLine = false;
     bool        _isolated = false;
     
     GLfloat         _lineWidth = 0.0f;
@@ -46,11 +46,18 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "renderer/CCVertexIndexBuffer.h"
 #include "base/CCDirector.h"
+#include "base/CCFrameArena.h"
 #include "base/ccUTF8.h"
 
 NS_CC_BEGIN
 namespace experimental {
 
+#if !defined(CC_FAST_TILEMAP_32_BIT_INDICES) && CC_FAST_TILEMAP_CHUNK_SIZE * CC_FAST_TILEMAP_CHUNK_SIZE * 4 > 65536
+#error "CC_FAST_TILEMAP_CHUNK_SIZE is too big for 16-bit indices, define CC_FAST_TILEMAP_32_BIT_INDICES"
+#endif
+
+static const int CHUNK_TILES = CC_FAST_TILEMAP_CHUNK_SIZE * CC_FAST_TILEMAP_CHUNK_SIZE;
+
 const int TMXLayer::FAST_TMX_ORIENTATION_ORTHO = 0;
 const int TMXLayer::FAST_TMX_ORIENTATION_HEX = 1;
 const int TMXLayer::FAST_TMX_ORIENTATION_ISO = 2;
@@ -81,6 +88,9 @@ bool TMXLayer::initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *la
     _layerName = layerInfo->_name;
     _layerSize = layerInfo->_layerSize;
     _tiles = layerInfo->_tiles;
+    // keep the tile data file mapped for as long as _tiles points into it
+    _tileData = std::move(layerInfo->_tileData);
+    _chunksPerRow = ((int)_layerSize.width + CC_FAST_TILEMAP_CHUNK_SIZE - 1) / CC_FAST_TILEMAP_CHUNK_SIZE;
     _quadsDirty = true;
     setOpacity( layerInfo->_opacity );
     setProperties(layerInfo->getProperties());
@@ -122,8 +132,12 @@ TMXLayer::TMXLayer()
 , _useAutomaticVertexZ(false)
 , _quadsDirty(true)
 , _dirty(true)
-, _vertexBuffer(nullptr)
-, _vData(nullptr)
+, _chunksPerRow(0)
+, _chunkBeginX(0)
+, _chunkEndX(0)
+, _chunkBeginY(0)
+, _chunkEndY(0)
+, _evictionFrame(0)
 , _indexBuffer(nullptr)
 {
 }
@@ -132,17 +146,36 @@ TMXLayer::~TMXLayer()
 {
     CC_SAFE_RELEASE(_tileSet);
     CC_SAFE_RELEASE(_texture);
-    CC_SAFE_FREE(_tiles);
-    CC_SAFE_RELEASE(_vData);
-    CC_SAFE_RELEASE(_vertexBuffer);
+    if (_tileData.isNull())
+    {
+        CC_SAFE_FREE(_tiles);
+    }
+    removeChunks();
     CC_SAFE_RELEASE(_indexBuffer);
     
 }
 
-void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
+TMXLayer::Chunk::~Chunk()
 {
-    updateTotalQuads();
+    for (auto& primitive : primitives)
+    {
+        primitive.second->release();
+    }
+    CC_SAFE_RELEASE(vertexData);
+    CC_SAFE_RELEASE(vertexBuffer);
+}
 
+void TMXLayer::removeChunks()
+{
+    for (auto& chunk : _chunks)
+    {
+        delete chunk.second;
+    }
+    _chunks.clear();
+}
+
+void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
+{
     bool isViewProjectionUpdated = true;
     auto visitingCamera = Camera::getVisitingCamera();
     auto defaultCamera = Camera::getDefaultCamera();
@@ -164,25 +197,47 @@ void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
         rect = RectApplyTransform(rect, inv);
         
         updateTiles(rect);
-        updateIndexBuffer();
-        updatePrimitives();
         _dirty = false;
     }
     
-    if(_renderCommands.size() < static_cast<size_t>(_primitives.size()))
+    if (_quadsDirty)
     {
-        _renderCommands.resize(_primitives.size());
+        for (auto& chunk : _chunks)
+        {
+            chunk.second->dirty = true;
+        }
+        _quadsDirty = false;
     }
     
-    int index = 0;
-    for(const auto& iter : _primitives)
+    updateIndexBuffer();
+    
+    auto frame = Director::getInstance()->getTotalFrames();
+    auto arena = FrameArena::getInstance();
+    auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+    for (int chunkY = _chunkBeginY; chunkY < _chunkEndY; ++chunkY)
     {
-        if(iter.second->getCount() > 0)
+        for (int chunkX = _chunkBeginX; chunkX < _chunkEndX; ++chunkX)
         {
-            auto& cmd = _renderCommands[index++];
-            auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
-            cmd.init(iter.first, _texture->getName(), getGLProgramState(), blendfunc, iter.second, _modelViewTransform, flags);
-            renderer->addCommand(&cmd);
+            auto& chunk = _chunks[chunkX + chunkY * _chunksPerRow];
+            if (!chunk)
+            {
+                chunk = new (std::nothrow) Chunk();
+            }
+            // a chunk already drawn in this frame, by another camera or a RenderTexture, is rebuilt
+            // in the next one: the commands queued for it still use its primitives and vertex buffer
+            if (chunk->dirty && (chunk->drawnFrame != frame || chunk->primitives.empty()))
+            {
+                updateChunk(chunk, chunkX, chunkY);
+            }
+            chunk->drawnFrame = frame;
+            
+            // the layer can be drawn more than once in a frame, each draw queues commands of its own
+            for (const auto& iter : chunk->primitives)
+            {
+                auto cmd = arena->create<PrimitiveCommand>();
+                cmd->init(iter.first, _texture->getName(), getGLProgramState(), blendfunc, iter.second, _modelViewTransform, flags);
+                renderer->addCommand(cmd);
+            }
         }
     }
 }
@@ -245,71 +300,41 @@ void TMXLayer::updateTiles(const Rect& culledRect)
         //CCASSERT(0, "TMX invalid value");
     }
     
-    _indicesVertexZNumber.clear();
-    
-    for(const auto& iter : _indicesVertexZOffsets)
-    {
-        _indicesVertexZNumber[iter.first] = iter.second;
-    }
-    
     int yBegin = std::max(0.f,visibleTiles.origin.y - tilesOverY);
     int yEnd = std::min(_layerSize.height,visibleTiles.origin.y + visibleTiles.size.height + tilesOverY);
     int xBegin = std::max(0.f,visibleTiles.origin.x - tilesOverX);
     int xEnd = std::min(_layerSize.width,visibleTiles.origin.x + visibleTiles.size.width + tilesOverX);
     
-    for (int y =  yBegin; y < yEnd; ++y)
-    {
-        for (int x = xBegin; x < xEnd; ++x)
-        {
-            int tileIndex = getTileIndexByPos(x, y);
-            if(_tiles[tileIndex] == 0) continue;
-            
-            int vertexZ = getVertexZForPos(Vec2(x,y));
-            auto iter = _indicesVertexZNumber.find(vertexZ);
-            int offset = iter->second;
-            iter->second++;
-            
-            int quadIndex = _tileToQuadIndex[tileIndex];
-            CC_ASSERT(-1 != quadIndex);
-            _indices[6 * offset + 0] = quadIndex * 4 + 0;
-            _indices[6 * offset + 1] = quadIndex * 4 + 1;
-            _indices[6 * offset + 2] = quadIndex * 4 + 2;
-            _indices[6 * offset + 3] = quadIndex * 4 + 3;
-            _indices[6 * offset + 4] = quadIndex * 4 + 2;
-            _indices[6 * offset + 5] = quadIndex * 4 + 1;
-            
-        } // for x
-    } // for y
-    
-    for(const auto& iter : _indicesVertexZOffsets)
+    if (xBegin >= xEnd || yBegin >= yEnd)
     {
-        _indicesVertexZNumber[iter.first] -= iter.second;
-        if(_indicesVertexZNumber[iter.first] == 0)
-        {
-            _indicesVertexZNumber.erase(iter.first);
-        }
+        _chunkBeginX = _chunkEndX = _chunkBeginY = _chunkEndY = 0;
     }
-    
-}
-
-void TMXLayer::updateVertexBuffer()
-{
-    GL::bindVAO(0);
-    if(nullptr == _vData)
+    else
     {
-        _vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), (int)_totalQuads.size() * 4);
-        _vData = VertexData::create();
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
-        CC_SAFE_RETAIN(_vData);
-        CC_SAFE_RETAIN(_vertexBuffer);
-    }
-    if(_vertexBuffer)
+        _chunkBeginX = xBegin / CC_FAST_TILEMAP_CHUNK_SIZE;
+        _chunkEndX = (xEnd - 1) / CC_FAST_TILEMAP_CHUNK_SIZE + 1;
+        _chunkBeginY = yBegin / CC_FAST_TILEMAP_CHUNK_SIZE;
+        _chunkEndY = (yEnd - 1) / CC_FAST_TILEMAP_CHUNK_SIZE + 1;
+    }
+    
+    // free the chunks no camera drew in this frame or the previous one. The visible ones of every camera
+    // stay, and the commands already queued in this frame never lose their chunk
+    auto frame = Director::getInstance()->getTotalFrames();
+    if (frame == _evictionFrame)
+        return;
+    _evictionFrame = frame;
+    for (auto iter = _chunks.begin(); iter != _chunks.end(); )
     {
-        _vertexBuffer->updateVertices((void*)&_totalQuads[0], (int)_totalQuads.size() * 4, 0);
+        if (iter->second->drawnFrame + 1 < frame)
+        {
+            delete iter->second;
+            iter = _chunks.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
     }
-    
 }
 
 void TMXLayer::updateIndexBuffer()
@@ -317,14 +342,25 @@ void TMXLayer::updateIndexBuffer()
     if(nullptr == _indexBuffer)
     {
 #ifdef CC_FAST_TILEMAP_32_BIT_INDICES
-        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_UINT_32, (int)_indices.size());
+        std::vector<GLuint> indices(6 * CHUNK_TILES);
+        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_UINT_32, (int)indices.size());
 #else
-        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)_indices.size());
+        std::vector<GLushort> indices(6 * CHUNK_TILES);
+        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)indices.size());
 #endif
         CC_SAFE_RETAIN(_indexBuffer);
+        
+        for (int quadIndex = 0; quadIndex < CHUNK_TILES; ++quadIndex)
+        {
+            indices[6 * quadIndex + 0] = quadIndex * 4 + 0;
+            indices[6 * quadIndex + 1] = quadIndex * 4 + 1;
+            indices[6 * quadIndex + 2] = quadIndex * 4 + 2;
+            indices[6 * quadIndex + 3] = quadIndex * 4 + 3;
+            indices[6 * quadIndex + 4] = quadIndex * 4 + 2;
+            indices[6 * quadIndex + 5] = quadIndex * 4 + 1;
+        }
+        _indexBuffer->updateIndices(&indices[0], (int)indices.size(), 0);
     }
-    _indexBuffer->updateIndices(&_indices[0], (int)_indices.size(), 0);
-    
 }
 
 // FastTMXLayer - setup Tiles
@@ -420,171 +456,169 @@ Mat4 TMXLayer::tileToNodeTransform()
     
 }
 
-void TMXLayer::updatePrimitives()
-{
-    for(const auto& iter : _indicesVertexZNumber)
-    {
-        int start = _indicesVertexZOffsets.at(iter.first);
-        
-        auto primitiveIter= _primitives.find(iter.first);
-        if(primitiveIter == _primitives.end())
-        {
-            auto primitive = Primitive::create(_vData, _indexBuffer, GL_TRIANGLES);
-            primitive->setCount(iter.second * 6);
-            primitive->setStart(start * 6);
-            
-            _primitives.insert(iter.first, primitive);
-        }
-        else
-        {
-            primitiveIter->second->setCount(iter.second * 6);
-            primitiveIter->second->setStart(start * 6);
-        }
-    }
-}
-
 void TMXLayer::setOpacity(GLubyte opacity) {
     Node::setOpacity(opacity);
     _quadsDirty = true;
 }
 
-void TMXLayer::updateTotalQuads()
+void TMXLayer::setupQuad(V3F_C4B_T2F_Quad& quad, int x, int y, uint32_t tileGID, float z, const Color4B& color)
 {
-    if(_quadsDirty)
-    {
-        Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
-        Size texSize = _tileSet->_imageSize;
-        _tileToQuadIndex.clear();
-        _totalQuads.resize(int(_layerSize.width * _layerSize.height));
-        _indices.resize(6 * int(_layerSize.width * _layerSize.height));
-        _tileToQuadIndex.resize(int(_layerSize.width * _layerSize.height),-1);
-        _indicesVertexZOffsets.clear();
-
-        auto color = Color4B::WHITE;
-        color.a = getDisplayedOpacity();
-
-        if (_texture->hasPremultipliedAlpha()) {
-            color.r *= color.a / 255.0f;
-            color.g *= color.a / 255.0f;
-            color.b *= color.a / 255.0f;
-        }
-        
-        int quadIndex = 0;
-        for(int y = 0; y < _layerSize.height; ++y)
-        {
-            for(int x =0; x < _layerSize.width; ++x)
-            {
-                int tileIndex = getTileIndexByPos(x, y);
-                int tileGID = _tiles[tileIndex];
-                
-                if(tileGID == 0) continue;
-                
-                _tileToQuadIndex[tileIndex] = quadIndex;
-                
-                auto& quad = _totalQuads[quadIndex];
-                
-                Vec3 nodePos(float(x), float(y), 0);
-                _tileToNodeTransform.transformPoint(&nodePos);
-                
-                float left, right, top, bottom, z;
-                
-                z = getVertexZForPos(Vec2(x, y));
-                auto iter = _indicesVertexZOffsets.find(z);
-                if(iter == _indicesVertexZOffsets.end())
-                {
-                    _indicesVertexZOffsets[z] = 1;
-                }
-                else
-                {
-                    iter->second++;
-                }
-                // vertices
-                if (tileGID & kTMXTileDiagonalFlag)
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.height;
-                    bottom = nodePos.y + tileSize.width;
-                    top = nodePos.y;
-                }
-                else
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.width;
-                    bottom = nodePos.y + tileSize.height;
-                    top = nodePos.y;
-                }
-                
-                if(tileGID & kTMXTileVerticalFlag)
-                    std::swap(top, bottom);
-                if(tileGID & kTMXTileHorizontalFlag)
-                    std::swap(left, right);
-                
-                if(tileGID & kTMXTileDiagonalFlag)
-                {
-                    // FIXME: not working correctly
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = left;
-                    quad.br.vertices.y = top;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = right;
-                    quad.tl.vertices.y = bottom;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                else
-                {
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = right;
-                    quad.br.vertices.y = bottom;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = left;
-                    quad.tl.vertices.y = top;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                
-                // texcoords
-                Rect tileTexture = _tileSet->getRectForGID(tileGID);
-                left   = (tileTexture.origin.x / texSize.width);
-                right  = left + (tileTexture.size.width / texSize.width);
-                bottom = (tileTexture.origin.y / texSize.height);
-                top    = bottom + (tileTexture.size.height / texSize.height);
-                
-                quad.bl.texCoords.u = left;
-                quad.bl.texCoords.v = bottom;
-                quad.br.texCoords.u = right;
-                quad.br.texCoords.v = bottom;
-                quad.tl.texCoords.u = left;
-                quad.tl.texCoords.v = top;
-                quad.tr.texCoords.u = right;
-                quad.tr.texCoords.v = top;
-
-                quad.bl.colors = color;
-                quad.br.colors = color;
-                quad.tl.colors = color;
-                quad.tr.colors = color;
-                
-                ++quadIndex;
-            }
-        }
-        
-        int offset = 0;
-        for(auto& vertexZOffset : _indicesVertexZOffsets)
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+    Size texSize = _tileSet->_imageSize;
+    
+    Vec3 nodePos(float(x), float(y), 0);
+    _tileToNodeTransform.transformPoint(&nodePos);
+    
+    float left, right, top, bottom;
+    
+    // vertices
+    if (tileGID & kTMXTileDiagonalFlag)
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.height;
+        bottom = nodePos.y + tileSize.width;
+        top = nodePos.y;
+    }
+    else
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.width;
+        bottom = nodePos.y + tileSize.height;
+        top = nodePos.y;
+    }
+    
+    if(tileGID & kTMXTileVerticalFlag)
+        std::swap(top, bottom);
+    if(tileGID & kTMXTileHorizontalFlag)
+        std::swap(left, right);
+    
+    if(tileGID & kTMXTileDiagonalFlag)
+    {
+        // FIXME: not working correctly
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = left;
+        quad.br.vertices.y = top;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = right;
+        quad.tl.vertices.y = bottom;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
+    }
+    else
+    {
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = right;
+        quad.br.vertices.y = bottom;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = left;
+        quad.tl.vertices.y = top;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
+    }
+    
+    // texcoords
+    Rect tileTexture = _tileSet->getRectForGID(tileGID);
+    left   = (tileTexture.origin.x / texSize.width);
+    right  = left + (tileTexture.size.width / texSize.width);
+    bottom = (tileTexture.origin.y / texSize.height);
+    top    = bottom + (tileTexture.size.height / texSize.height);
+    
+    quad.bl.texCoords.u = left;
+    quad.bl.texCoords.v = bottom;
+    quad.br.texCoords.u = right;
+    quad.br.texCoords.v = bottom;
+    quad.tl.texCoords.u = left;
+    quad.tl.texCoords.v = top;
+    quad.tr.texCoords.u = right;
+    quad.tr.texCoords.v = top;
+    
+    quad.bl.colors = color;
+    quad.br.colors = color;
+    quad.tl.colors = color;
+    quad.tr.colors = color;
+}
+
+void TMXLayer::updateChunk(Chunk* chunk, int chunkX, int chunkY)
+{
+    auto color = Color4B::WHITE;
+    color.a = getDisplayedOpacity();
+    
+    if (_texture->hasPremultipliedAlpha()) {
+        color.r *= color.a / 255.0f;
+        color.g *= color.a / 255.0f;
+        color.b *= color.a / 255.0f;
+    }
+    
+    // quads of the same vertex Z must be contiguous to be drawn by one primitive
+    std::map<int/*vertexZ*/, std::vector<V3F_C4B_T2F_Quad>> quadsByVertexZ;
+    int quadCount = 0;
+    
+    int xBegin = chunkX * CC_FAST_TILEMAP_CHUNK_SIZE;
+    int yBegin = chunkY * CC_FAST_TILEMAP_CHUNK_SIZE;
+    int xEnd = std::min(xBegin + CC_FAST_TILEMAP_CHUNK_SIZE, (int)_layerSize.width);
+    int yEnd = std::min(yBegin + CC_FAST_TILEMAP_CHUNK_SIZE, (int)_layerSize.height);
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+        // a mapped tile data file is read here, the first time its pages are touched
+        const uint32_t* row = _tiles + getTileIndexByPos(0, y);
+        for (int x = xBegin; x < xEnd; ++x)
         {
-            std::swap(offset, vertexZOffset.second);
-            offset += vertexZOffset.second;
+            uint32_t tileGID = row[x];
+            if (tileGID == 0) continue;
+            
+            int z = getVertexZForPos(Vec2(x, y));
+            auto& quads = quadsByVertexZ[z];
+            quads.resize(quads.size() + 1);
+            setupQuad(quads.back(), x, y, tileGID, z, color);
+            ++quadCount;
         }
-        updateVertexBuffer();
+    }
+    
+    for (auto& primitive : chunk->primitives)
+    {
+        primitive.second->release();
+    }
+    chunk->primitives.clear();
+    chunk->dirty = false;
+    
+    if (quadCount == 0)
+        return;
+    
+    if (chunk->capacity < quadCount)
+    {
+        CC_SAFE_RELEASE(chunk->vertexData);
+        CC_SAFE_RELEASE(chunk->vertexBuffer);
+        chunk->vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), quadCount * 4);
+        chunk->vertexData = VertexData::create();
+        chunk->vertexData->setStream(chunk->vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
+        chunk->vertexData->setStream(chunk->vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
+        chunk->vertexData->setStream(chunk->vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
+        CC_SAFE_RETAIN(chunk->vertexData);
+        CC_SAFE_RETAIN(chunk->vertexBuffer);
+        chunk->capacity = quadCount;
+    }
+    
+    GL::bindVAO(0);
+    int start = 0;
+    for (const auto& iter : quadsByVertexZ)
+    {
+        int count = (int)iter.second.size();
+        chunk->vertexBuffer->updateVertices((void*)&iter.second[0], count * 4, start * 4);
         
-        _quadsDirty = false;
+        auto primitive = Primitive::create(chunk->vertexData, _indexBuffer, GL_TRIANGLES);
+        primitive->setStart(start * 6);
+        primitive->setCount(count * 6);
+        primitive->retain();
+        chunk->primitives.push_back(std::make_pair(iter.first, primitive));
+        start += count;
     }
 }
 
@@ -718,8 +752,15 @@ void TMXLayer::setFlaggedTileGIDByIndex(int index, uint32_t gid)
 {
     if(gid == _tiles[index]) return;
     _tiles[index] = gid;
-    _quadsDirty = true;
-    _dirty = true;
+    
+    // only the chunk of the tile is rebuilt, the one it doesn't have yet will read the new gid
+    int x = index % (int)_layerSize.width;
+    int y = index / (int)_layerSize.width;
+    auto iter = _chunks.find(getChunkIndexByPos(x, y));
+    if (iter != _chunks.end())
+    {
+        iter->second->dirty = true;
+    }
 }
 
 void TMXLayer::removeChild(Node* node, bool cleanup)
@@ -69,6 +69,10 @@ namespace experimental{
  * "value" by default is 0, but you can change it from Tiled by adding the "cc_alpha_func" property to the layer.
  * The value 0 should work for most cases, but if you have tiles that are semi-transparent, then you might want to use a different
  * value, like 0.5.
+
+ * The tiles are built in chunks of CC_FAST_TILEMAP_CHUNK_SIZE x CC_FAST_TILEMAP_CHUNK_SIZE tiles, only around the
+ * visible area, so very large layers don't need vertices for every tile. Their gids can also come from a binary
+ * file named by the "cc_tile_data" property, which is memory mapped instead of decoded, see TMXLayerInfo::loadTileData.
  
  * For further information, please see the programming guide:
  * http://www.cocos2d-iphone.org/wiki/doku.php/prog_guide:tiled_maps
@@ -195,7 +199,7 @@ public:
      *
      * @param tiles The pointer to the map of tiles.
      */
-    void setTiles(uint32_t* tiles) { _tiles = tiles; _quadsDirty = true;};
+    void setTiles(uint32_t* tiles) { _tiles = tiles; _tileData.clear(); _quadsDirty = true;};
     
     /** Tileset information for the layer.
      *
@@ -288,15 +292,30 @@ protected:
     //Flip flags is packed into gid
     void setFlaggedTileGIDByIndex(int index, uint32_t gid);
     
-    //
-    void updateTotalQuads();
+    /** a square of tiles with its own vertex buffer, the quads are sorted by vertex Z */
+    struct Chunk
+    {
+        ~Chunk();
+
+        VertexBuffer* vertexBuffer = nullptr;
+        VertexData* vertexData = nullptr;
+        /** number of quads the vertex buffer has room for */
+        int capacity = 0;
+        std::vector<std::pair<int/*vertexZ*/, Primitive*>> primitives;
+        bool dirty = true;
+        /** last frame the chunk was drawn in, it isn't rebuilt again in that frame and is freed two frames later */
+        unsigned int drawnFrame = 0;
+    };
+
+    void setupQuad(V3F_C4B_T2F_Quad& quad, int x, int y, uint32_t gid, float z, const Color4B& color);
+    void updateChunk(Chunk* chunk, int chunkX, int chunkY);
+    void removeChunks();
     
     void onDraw(Primitive* primitive);
     int getTileIndexByPos(int x, int y) const { return x + y * (int) _layerSize.width; }
+    int getChunkIndexByPos(int x, int y) const { return x / CC_FAST_TILEMAP_CHUNK_SIZE + y / CC_FAST_TILEMAP_CHUNK_SIZE * _chunksPerRow; }
     
-    void updateVertexBuffer();
     void updateIndexBuffer();
-    void updatePrimitives();
 
     virtual void setOpacity(GLubyte opacity) override;
 protected:
@@ -335,25 +354,20 @@ protected:
     Mat4 _tileToNodeTransform;
     /** data for rendering */
     bool _quadsDirty;
-    std::vector<int> _tileToQuadIndex;
-    std::vector<V3F_C4B_T2F_Quad> _totalQuads;
-#ifdef CC_FAST_TILEMAP_32_BIT_INDICES
-    std::vector<GLuint> _indices;
-#else
-    std::vector<GLushort> _indices;
-#endif
-    std::map<int/*vertexZ*/, int/*offset to _indices by quads*/> _indicesVertexZOffsets;
-    std::unordered_map<int/*vertexZ*/, int/*number to quads*/> _indicesVertexZNumber;
-    std::vector<PrimitiveCommand> _renderCommands;
     bool _dirty;
     
-    VertexBuffer* _vertexBuffer;
-    
-    VertexData* _vData;
+    /** built chunks by chunk index, only the ones around the visible area are kept */
+    std::unordered_map<int, Chunk*> _chunks;
+    int _chunksPerRow;
+    /** visible chunks, end excluded */
+    int _chunkBeginX, _chunkEndX, _chunkBeginY, _chunkEndY;
+    unsigned int _evictionFrame;
     
+    /** shared by all the chunks, the same 6 indices for every quad */
     IndexBuffer* _indexBuffer;
     
-    Map<int , Primitive*> _primitives;
+    /** the tile data file _tiles points into, if any */
+    Data _tileData;
     
 public:
     /** Possible orientations of the TMX map */
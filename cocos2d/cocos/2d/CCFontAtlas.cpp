@@ -36,23 +36,38 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCConfiguration.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/ccUtils.h"
+#include "renderer/CCTexture2D.h"
+#include "platform/CCGL.h"
+
+#include <algorithm>
 
 NS_CC_BEGIN
 
-const int FontAtlas::CacheTextureWidth = 512;
-const int FontAtlas::CacheTextureHeight = 512;
+const int FontAtlas::CacheTextureWidth = CC_FONT_ATLAS_PAGE_SIZE;
+const int FontAtlas::CacheTextureHeight = CC_FONT_ATLAS_PAGE_SIZE;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
 
+// letters rasterized by a task of prepareLetterDefinitionsAsync, so they reach the atlas in several frames
+static const size_t ASYNC_LETTERS_PER_TASK = 64;
+
+static int s_pageSize = CC_FONT_ATLAS_PAGE_SIZE;
+
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
 , _fontFreeType(nullptr)
 , _iconv(nullptr)
-, _currentPageData(nullptr)
+, _pageWidth(0)
+, _pageHeight(0)
+, _bytesPerPixel(1)
 , _fontAscender(0)
 , _rendererRecreatedListener(nullptr)
 , _antialiasEnabled(true)
-, _currLineHeight(0)
+, _rasterizationTime(0.0)
+, _pendingLetterCount(0)
 {
     _font->retain();
 
@@ -61,21 +76,31 @@ FontAtlas::FontAtlas(Font &theFont)
     {
         _lineHeight = _font->getFontMaxHeight();
         _fontAscender = _fontFreeType->getFontAscender();
-        _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
         _letterEdgeExtend = 2;
         _letterPadding = 0;
 
+        _pageWidth = _pageHeight = s_pageSize;
+        int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+        if (maxTextureSize > 0 && _pageWidth > maxTextureSize)
+        {
+            _pageWidth = _pageHeight = maxTextureSize;
+        }
+
         if (_fontFreeType->isDistanceFieldEnabled())
         {
             _letterPadding += 2 * FontFreeType::DistanceMapSpread;    
         }
+        else if (_fontFreeType->isMSDFEnabled())
+        {
+            _letterPadding += 2 * FontFreeType::MSDFSpread;
+            _bytesPerPixel = 3;
+        }
 
         auto outlineSize = _fontFreeType->getOutlineSize();
         if (outlineSize > 0)
         {
             _lineHeight += 2 * outlineSize;
+            _bytesPerPixel = 2;
         }
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -87,33 +112,64 @@ FontAtlas::FontAtlas(Font &theFont)
     }
 }
 
+void FontAtlas::setPageSize(int size)
+{
+    s_pageSize = size;
+}
+
+int FontAtlas::getPageSize()
+{
+    return s_pageSize;
+}
+
 void FontAtlas::reinit()
 {
-    if (_currentPageData)
+    _pages.clear();
+
+    addPage();
+}
+
+void FontAtlas::addPage()
+{
+    Page page;
+    page.packer.reset(_pageWidth, _pageHeight);
+
+    // the page is cleared once, the letters are uploaded into it one by one by addLetter
+    ssize_t dataSize = (ssize_t)_pageWidth * _pageHeight * _bytesPerPixel;
+    std::vector<unsigned char> blank(dataSize, 0);
+
+    auto texture = new (std::nothrow) Texture2D;
+    if (_antialiasEnabled)
     {
-        delete []_currentPageData;
-        _currentPageData = nullptr;
+        texture->setAntiAliasTexParameters();
     }
-    
-    auto texture = new (std::nothrow) Texture2D;
-    
-    _currentPageDataSize = CacheTextureWidth * CacheTextureHeight;
-    
-    auto outlineSize = _fontFreeType->getOutlineSize();
-    if(outlineSize > 0)
+    else
     {
-        _currentPageDataSize *= 2;
+        texture->setAliasTexParameters();
     }
-    
-    _currentPageData = new (std::nothrow) unsigned char[_currentPageDataSize];
-    memset(_currentPageData, 0, _currentPageDataSize);
-    
-    auto  pixelFormat = outlineSize > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
-    texture->initWithData(_currentPageData, _currentPageDataSize,
-                          pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-    
-    addTexture(texture,0);
+    auto pixelFormat = Texture2D::PixelFormat::A8;
+    if (_bytesPerPixel == 2)
+        pixelFormat = Texture2D::PixelFormat::AI88;
+    else if (_bytesPerPixel == 3)
+        pixelFormat = Texture2D::PixelFormat::RGB888;
+    texture->initWithData(blank.data(), dataSize, pixelFormat, _pageWidth, _pageHeight, Size(_pageWidth, _pageHeight));
+
+    addTexture(texture, static_cast<int>(_pages.size()));
     texture->release();
+    _pages.push_back(page);
+}
+
+float FontAtlas::getFillRatio() const
+{
+    if (_pages.empty())
+        return 0.0f;
+
+    double usedArea = 0;
+    for (const auto& page : _pages)
+    {
+        usedArea += page.packer.getUsedArea();
+    }
+    return static_cast<float>(usedArea / ((double)_pageWidth * _pageHeight * _pages.size()));
 }
 
 FontAtlas::~FontAtlas()
@@ -130,8 +186,6 @@ FontAtlas::~FontAtlas()
     _font->release();
     releaseTextures();
 
-    delete []_currentPageData;
-
 #if CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
     if (_iconv)
     {
@@ -145,10 +199,6 @@ void FontAtlas::reset()
 {
     releaseTextures();
     
-    _currLineHeight = 0;
-    _currentPage = 0;
-    _currentPageOrigX = 0;
-    _currentPageOrigY = 0;
     _letterDefinitions.clear();
     
     reinit();
@@ -347,7 +397,7 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     } 
  
-    if (!_currentPageData)
+    if (_pages.empty())
         reinit();     
  
     std::unordered_map<unsigned int, unsigned int> codeMapOfNewChar;
@@ -357,120 +407,178 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     }
 
-    int adjustForDistanceMap = _letterPadding / 2;
-    int adjustForExtend = _letterEdgeExtend / 2;
-    long bitmapWidth;
-    long bitmapHeight;
-    int glyphHeight;
-    Rect tempRect;
-    FontLetterDefinition tempDef;
+    auto start = utils::gettime();
+    LetterImage image;
+    for (auto&& it : codeMapOfNewChar)
+    {
+        rasterizeLetter(_fontFreeType, it.first, it.second, image);
+        addLetter(image);
+    }
+    _rasterizationTime += utils::gettime() - start;
 
-    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    return true;
+}
 
-    float startY = _currentPageOrigY;
+void FontAtlas::prepareLetterDefinitionsAsync(const std::u32string& utf32Text, const std::function<void(FontAtlas*)>& callback)
+{
+    std::unordered_map<unsigned int, unsigned int> codeMapOfNewChar;
+    if (_fontFreeType)
+    {
+        findNewCharacters(utf32Text, codeMapOfNewChar);
+    }
 
-    for (auto&& it : codeMapOfNewChar)
+    FontFreeType* rasterizer = codeMapOfNewChar.empty() ? nullptr : _fontFreeType->clone();
+    if (rasterizer == nullptr)
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
-        {
-            tempDef.validDefinition = true;
-            tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
-            tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
-            tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
-            tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
+        // nothing new, or the font can't be opened a second time
+        prepareLetterDefinitions(utf32Text);
+        if (callback)
+            callback(this);
+        return;
+    }
+
+    // released by the last task, on the main thread
+    rasterizer->retain();
+    this->retain();
+
+    auto letters = std::make_shared<std::vector<std::pair<char32_t, unsigned int>>>(codeMapOfNewChar.begin(), codeMapOfNewChar.end());
+    _pendingLetterCount += static_cast<int>(letters->size());
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+    for (size_t first = 0; first < letters->size(); first += ASYNC_LETTERS_PER_TASK)
+    {
+        auto images = std::make_shared<std::vector<LetterImage>>(std::min(ASYNC_LETTERS_PER_TASK, letters->size() - first));
+        auto seconds = std::make_shared<double>(0.0);
+        bool isLastTask = first + images->size() == letters->size();
+
+        auto rasterize = [this, rasterizer, letters, images, seconds, first]() {
+            auto start = utils::gettime();
+            for (size_t i = 0; i < images->size(); ++i)
+            {
+                const auto& letter = (*letters)[first + i];
+                rasterizeLetter(rasterizer, letter.first, letter.second, (*images)[i]);
+            }
+            *seconds = utils::gettime() - start;
+        };
+
+        auto addToAtlas = [this, rasterizer, images, seconds, isLastTask, callback](void*) {
+            if (_pages.empty())
+                reinit();
+
+            for (const auto& image : *images)
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
+                // a label may have needed it in the meantime
+                if (_letterDefinitions.find(image.utf32Char) == _letterDefinitions.end())
                 {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == Texture2D::PixelFormat::AI88)
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                    }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    tex->initWithData(_currentPageData, _currentPageDataSize,
-                        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-                    addTexture(tex, _currentPage);
-                    tex->release();
+                    addLetter(image);
                 }
             }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+
+            _pendingLetterCount -= static_cast<int>(images->size());
+            _rasterizationTime += *seconds;
+            if (isLastTask)
             {
-                _currLineHeight = glyphHeight;
+                rasterizer->release();
+                if (callback)
+                    callback(this);
+                this->release();
             }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
-
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
-            // take from pixels to points
-            tempDef.width = tempDef.width / scaleFactor;
-            tempDef.height = tempDef.height / scaleFactor;
-            tempDef.U = tempDef.U / scaleFactor;
-            tempDef.V = tempDef.V / scaleFactor;
-            tempDef.rotated = false;
+        };
+
+        AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, addToAtlas, nullptr, rasterize);
+    }
+}
+
+void FontAtlas::rasterizeLetter(FontFreeType* font, char32_t utf32Char, unsigned int charCode, LetterImage& image) const
+{
+    long bitmapWidth;
+    long bitmapHeight;
+    image.utf32Char = utf32Char;
+    image.xAdvance = 0;
+
+    auto bitmap = font->getGlyphBitmap(charCode, bitmapWidth, bitmapHeight, image.rect, image.xAdvance);
+    if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+    {
+        // the bitmap can be a pixel bigger than the metrics the definition uses, the image holds both
+        int border = _letterPadding + _letterEdgeExtend;
+        image.width = static_cast<int>(std::max(bitmapWidth, static_cast<long>(image.rect.size.width))) + border;
+        image.height = static_cast<int>(std::max(bitmapHeight, static_cast<long>(image.rect.size.height))) + border;
+        image.pixels.assign((size_t)image.width * image.height * _bytesPerPixel, 0);
+
+        int adjustForExtend = _letterEdgeExtend / 2;
+        font->renderCharAt(image.pixels.data(), image.width, adjustForExtend, adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
+    }
+    else
+    {
+        delete[] bitmap;
+        image.width = 0;
+        image.height = 0;
+        image.pixels.clear();
+    }
+}
+
+void FontAtlas::addLetter(const LetterImage& image)
+{
+    FontLetterDefinition tempDef;
+    tempDef.xAdvance = image.xAdvance;
+    tempDef.rotated = false;
+
+    int page = -1;
+    int x = 0;
+    int y = 0;
+    if (image.width > 0)
+    {
+        // a pixel apart, so the linear filtering doesn't bleed into the neighbours
+        for (size_t i = 0; i < _pages.size() && page < 0; ++i)
+        {
+            if (_pages[i].packer.insert(image.width + 1, image.height + 1, x, y))
+                page = static_cast<int>(i);
         }
-        else{
-            delete[] bitmap;
-            if (tempDef.xAdvance)
-                tempDef.validDefinition = true;
-            else
-                tempDef.validDefinition = false;
-
-            tempDef.width = 0;
-            tempDef.height = 0;
-            tempDef.U = 0;
-            tempDef.V = 0;
-            tempDef.offsetX = 0;
-            tempDef.offsetY = 0;
-            tempDef.textureID = 0;
-            tempDef.rotated = false;
-            _currentPageOrigX += 1;
+        if (page < 0 && image.width < _pageWidth && image.height < _pageHeight)
+        {
+            addPage();
+            if (_pages.back().packer.insert(image.width + 1, image.height + 1, x, y))
+                page = static_cast<int>(_pages.size()) - 1;
+        }
+        if (page < 0)
+        {
+            CCLOG("FontAtlas: the letter %u doesn't fit in a %dx%d page", (unsigned int)image.utf32Char, _pageWidth, _pageHeight);
         }
-
-        _letterDefinitions[it.first] = tempDef;
     }
 
-    unsigned char *data = nullptr;
-    if (pixelFormat == Texture2D::PixelFormat::AI88)
+    if (page >= 0)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        // the rows of the letter are tightly packed, whatever its width
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        _atlasTextures[page]->updateWithData(image.pixels.data(), x, y, image.width, image.height);
+
+        int adjustForDistanceMap = _letterPadding / 2;
+        int adjustForExtend = _letterEdgeExtend / 2;
+        auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+
+        tempDef.validDefinition = true;
+        tempDef.offsetX = image.rect.origin.x - adjustForDistanceMap - adjustForExtend;
+        tempDef.offsetY = _fontAscender + image.rect.origin.y - adjustForDistanceMap - adjustForExtend;
+        tempDef.textureID = page;
+        // take from pixels to points
+        tempDef.width = (image.rect.size.width + _letterPadding + _letterEdgeExtend) / scaleFactor;
+        tempDef.height = (image.rect.size.height + _letterPadding + _letterEdgeExtend) / scaleFactor;
+        tempDef.U = x / scaleFactor;
+        tempDef.V = y / scaleFactor;
     }
     else
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        // blank letters like spaces only advance
+        tempDef.validDefinition = tempDef.xAdvance != 0;
+        tempDef.width = 0;
+        tempDef.height = 0;
+        tempDef.U = 0;
+        tempDef.V = 0;
+        tempDef.offsetX = 0;
+        tempDef.offsetY = 0;
+        tempDef.textureID = 0;
     }
-    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
 
-    return true;
+    _letterDefinitions[image.utf32Char] = tempDef;
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
@@ -29,12 +29,16 @@
 
 /// @cond DO_NOT_SHOW
 
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
 #include "platform/CCStdC.h" // ssize_t on windows
+#include "math/CCGeometry.h"
+#include "2d/CCSkylinePacker.h"
 
 NS_CC_BEGIN
 
@@ -61,6 +65,7 @@ struct FontLetterDefinition
 class CC_DLL FontAtlas : public Ref
 {
 public:
+    /** Default size of the pages, CC_FONT_ATLAS_PAGE_SIZE. */
     static const int CacheTextureWidth;
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
@@ -80,6 +85,31 @@ public:
     
     bool prepareLetterDefinitions(const std::u32string& utf16String);
 
+    /** Rasterizes the missing letters of a text on a worker thread, then adds them to the atlas a chunk at a time on
+     * the main thread. Only the rows of the pages that changed are uploaded. A label needing one of the letters before
+     * it arrives renders it right away, as usual.
+     * @param callback Called on the main thread once every letter is in the atlas.
+     */
+    void prepareLetterDefinitionsAsync(const std::u32string& utf32Text, const std::function<void(FontAtlas*)>& callback = nullptr);
+
+    /** Sets the width and height of the pages of the TTF atlases created or purged from now on.
+     * Defaults to CC_FONT_ATLAS_PAGE_SIZE, clamped to the maximum texture size.
+     */
+    static void setPageSize(int size);
+    static int getPageSize();
+
+    /** Number of texture pages. */
+    int getPageCount() const { return static_cast<int>(_pages.size()); }
+
+    /** Part of the pages covered by letters, between 0 and 1. */
+    float getFillRatio() const;
+
+    /** Seconds spent rasterizing letters, on the main thread and on the worker. */
+    double getRasterizationTime() const { return _rasterizationTime; }
+
+    /** Letters given to prepareLetterDefinitionsAsync not in the atlas yet. */
+    int getPendingLetterCount() const { return _pendingLetterCount; }
+
     const std::unordered_map<ssize_t, Texture2D*>& getTextures() const { return _atlasTextures; }
     void  addTexture(Texture2D *texture, int slot);
     float getLineHeight() const { return _lineHeight; }
@@ -113,6 +143,23 @@ public:
      void setAliasTexParameters();
 
 protected:
+    // a rasterized letter, with its padding
+    struct LetterImage
+    {
+        char32_t utf32Char;
+        Rect rect;
+        int xAdvance;
+        int width;
+        int height;
+        std::vector<unsigned char> pixels;
+    };
+
+    // the pixels of a page only live in its texture
+    struct Page
+    {
+        SkylinePacker packer;
+    };
+
     void reset();
     
     void reinit();
@@ -123,6 +170,14 @@ protected:
 
     void conversionU32TOGB2312(const std::u32string& u32Text, std::unordered_map<unsigned int, unsigned int>& charCodeMap);
 
+    /** Renders a letter with the given face, which may be a clone on a worker thread. */
+    void rasterizeLetter(FontFreeType* font, char32_t utf32Char, unsigned int charCode, LetterImage& image) const;
+
+    /** Packs a rasterized letter into a page and defines it. */
+    void addLetter(const LetterImage& image);
+
+    void addPage();
+
     /**
      * Scale each font letter by scaleFactor.
      *
@@ -138,18 +193,19 @@ protected:
     void* _iconv;
 
     // Dynamic GlyphCollection related stuff
-    int _currentPage;
-    unsigned char *_currentPageData;
-    int _currentPageDataSize;
-    float _currentPageOrigX;
-    float _currentPageOrigY;
+    std::vector<Page> _pages;
+    int _pageWidth;
+    int _pageHeight;
+    int _bytesPerPixel;
     int _letterPadding;
     int _letterEdgeExtend;
 
     int _fontAscender;
     EventListenerCustom* _rendererRecreatedListener;
     bool _antialiasEnabled;
-    int _currLineHeight;
+
+    double _rasterizationTime;
+    int _pendingLetterCount;
 
     friend class Label;
 };
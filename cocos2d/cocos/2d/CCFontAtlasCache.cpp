@@ -32,6 +32,9 @@
 #include "2d/CCFontCharMap.h"
 #include "2d/CCLabel.h"
 #include "platform/CCFileUtils.h"
+#include "base/ccUTF8.h"
+
+#include <algorithm>
 
 NS_CC_BEGIN
 
@@ -54,6 +57,11 @@ void FontAtlasCache::purgeCachedData()
 FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
 {
     auto realFontFilename = FileUtils::getInstance()->getNewFilename(config->fontFilePath);  // resolves real file path, to prevent storing multiple atlases for the same file.
+    if (config->multiChannelDistanceFieldEnabled)
+    {
+        return getFontAtlasMSDF(realFontFilename, config);
+    }
+
     bool useDistanceField = config->distanceFieldEnabled;
     if(config->outlineSize > 0)
     {
@@ -88,6 +96,53 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
     return nullptr;
 }
 
+FontAtlas* FontAtlasCache::getFontAtlasMSDF(const std::string& realFontFilename, const _ttfConfig* config)
+{
+    // the labels scale the glyphs, so one atlas serves every size, outline and glow of the font
+    std::string atlasName = "msdf " + realFontFilename;
+
+    auto it = _atlasMap.find(atlasName);
+    if (it != _atlasMap.end())
+        return it->second;
+
+    auto font = FontFreeType::create(realFontFilename, CC_FONT_MSDF_GLYPH_SIZE, config->glyphs,
+        config->customGlyphs, false, 0, true);
+    if (font)
+    {
+        auto tempAtlas = font->createFontAtlas();
+        if (tempAtlas)
+        {
+            _atlasMap[atlasName] = tempAtlas;
+            return tempAtlas;
+        }
+    }
+
+    return nullptr;
+}
+
+bool FontAtlasCache::precacheGlyphs(const _ttfConfig* config, const std::string& charsetFile, const std::function<void(FontAtlas*)>& callback)
+{
+    std::string charset = FileUtils::getInstance()->getStringFromFile(charsetFile);
+    std::u32string utf32Charset;
+    if (charset.empty() || !StringUtils::UTF8ToUTF32(charset, utf32Charset))
+    {
+        CCLOG("FontAtlasCache: can't read the charset %s", charsetFile.c_str());
+        return false;
+    }
+
+    // line breaks and other control characters have no letter
+    utf32Charset.erase(std::remove_if(utf32Charset.begin(), utf32Charset.end(), [](char32_t ch) {
+        return ch < 0x20;
+    }), utf32Charset.end());
+
+    auto atlas = getFontAtlasTTF(config);
+    if (atlas == nullptr)
+        return false;
+
+    atlas->prepareLetterDefinitionsAsync(utf32Charset, callback);
+    return true;
+}
+
 FontAtlas* FontAtlasCache::getFontAtlasFNT(const std::string& fontFileName)
 {
     return getFontAtlasFNT(fontFileName, Rect::ZERO, false);
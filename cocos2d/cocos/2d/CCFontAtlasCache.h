@@ -29,6 +29,7 @@
 
 /// @cond DO_NOT_SHOW
 
+#include <functional>
 #include <unordered_map>
 #include "base/ccTypes.h"
 
@@ -43,6 +44,13 @@ class CC_DLL FontAtlasCache
 public:
     static FontAtlas* getFontAtlasTTF(const _ttfConfig* config);
 
+    /** Rasterizes every character of a UTF-8 text file into the atlas of a TTF config, on a worker thread.
+     The letters reach the atlas a few at a time, labels using the atlas meanwhile render their own letters at once.
+     The callback is invoked on the main thread once every letter is in the atlas.
+     @return false if the file or the font can't be loaded.
+    */
+    static bool precacheGlyphs(const _ttfConfig* config, const std::string& charsetFile, const std::function<void(FontAtlas*)>& callback = nullptr);
+
     static FontAtlas* getFontAtlasFNT(const std::string& fontFileName);
     static FontAtlas* getFontAtlasFNT(const std::string& fontFileName, const std::string& subTextureKey);
     static FontAtlas* getFontAtlasFNT(const std::string& fontFileName, const Rect& imageRect, bool imageRotated);
@@ -74,6 +82,8 @@ public:
     static void unloadFontAtlasTTF(const std::string& fontFileName);
 
 private:
+    static FontAtlas* getFontAtlasMSDF(const std::string& realFontFilename, const _ttfConfig* config);
+
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
 };
 
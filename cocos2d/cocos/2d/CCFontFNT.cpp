@@ -610,7 +610,7 @@ int * FontFNT::getHorizontalKerningForTextUTF32(const std::u32string& text, int
 {
     outNumLetters = static_cast<int>(text.length());
     
-    if (!outNumLetters)
+    if (!outNumLetters || _configuration->_kerningDictionary.empty())
         return nullptr;
     
     int *sizes = new (std::nothrow) int[outNumLetters];
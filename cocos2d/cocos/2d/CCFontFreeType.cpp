@@ -26,8 +26,10 @@ THE SOFTWARE.
 
 #include "2d/CCFontFreeType.h"
 #include FT_BBOX_H
+#include FT_OUTLINE_H
 #include "edtaa3func.h"
 #include "2d/CCFontAtlas.h"
+#include "2d/CCMSDFGenerator.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
@@ -38,6 +40,7 @@ NS_CC_BEGIN
 FT_Library FontFreeType::_FTlibrary;
 bool       FontFreeType::_FTInitialized = false;
 const int  FontFreeType::DistanceMapSpread = 3;
+const int  FontFreeType::MSDFSpread = 4;
 
 const char* FontFreeType::_glyphASCII = "\"!#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~¡¢£¤¥¦§¨©ª«¬­®¯°±²³´µ¶·¸¹º»¼½¾¿ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖ×ØÙÚÛÜÝÞßàáâãäåæçèéêëìíîïðñòóôõö÷øùúûüýþ ";
 const char* FontFreeType::_glyphNEHE = "!\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~ ";
@@ -50,13 +53,15 @@ typedef struct _DataRef
 
 static std::unordered_map<std::string, DataRef> s_cacheFontData;
 
-FontFreeType * FontFreeType::create(const std::string &fontName, float fontSize, GlyphCollection glyphs, const char *customGlyphs,bool distanceFieldEnabled /* = false */,float outline /* = 0 */)
+FontFreeType * FontFreeType::create(const std::string &fontName, float fontSize, GlyphCollection glyphs, const char *customGlyphs,bool distanceFieldEnabled /* = false */,float outline /* = 0 */, bool msdfEnabled /* = false */)
 {
-    FontFreeType *tempFont =  new (std::nothrow) FontFreeType(distanceFieldEnabled,outline);
+    // the fields already hold distances, outlines and glows are drawn by the shader
+    FontFreeType *tempFont =  msdfEnabled ? new (std::nothrow) FontFreeType() : new (std::nothrow) FontFreeType(distanceFieldEnabled,outline);
 
     if (!tempFont)
         return nullptr;
     
+    tempFont->_msdfEnabled = msdfEnabled;
     tempFont->setGlyphCollection(glyphs, customGlyphs);
     
     if (!tempFont->createFontObject(fontName, fontSize))
@@ -98,11 +103,15 @@ FT_Library FontFreeType::getFTLibrary()
     return _FTlibrary;
 }
 
-FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outline /* = 0 */)
-: _fontRef(nullptr)
+FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outline /* = 0 */, FT_Library library /* = nullptr */)
+: _library(library ? library : getFTLibrary())
+, _ownsLibrary(library != nullptr)
+, _fontRef(nullptr)
 , _stroker(nullptr)
 , _encoding(FT_ENCODING_UNICODE)
+, _fontSize(0.0f)
 , _distanceFieldEnabled(distanceFieldEnabled)
+, _msdfEnabled(false)
 , _outlineSize(0.0f)
 , _lineHeight(0)
 , _fontAtlas(nullptr)
@@ -111,20 +120,58 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outlin
     if (outline > 0.0f)
     {
         _outlineSize = outline * CC_CONTENT_SCALE_FACTOR();
-        FT_Stroker_New(FontFreeType::getFTLibrary(), &_stroker);
-        FT_Stroker_Set(_stroker,
-            (int)(_outlineSize * 64),
-            FT_STROKER_LINECAP_ROUND,
-            FT_STROKER_LINEJOIN_ROUND,
-            0);
+        initStroker();
     }
 }
 
+void FontFreeType::initStroker()
+{
+    FT_Stroker_New(_library, &_stroker);
+    FT_Stroker_Set(_stroker,
+        (int)(_outlineSize * 64),
+        FT_STROKER_LINECAP_ROUND,
+        FT_STROKER_LINEJOIN_ROUND,
+        0);
+}
+
+FontFreeType* FontFreeType::clone() const
+{
+    // FreeType 2.5 renders through buffers shared by the whole library, so the clone can't use the global one
+    FT_Library library;
+    if (_fontRef == nullptr || FT_Init_FreeType(&library))
+        return nullptr;
+
+    auto font = new (std::nothrow) FontFreeType(_distanceFieldEnabled, 0.0f, library);
+    if (!font)
+    {
+        FT_Done_FreeType(library);
+        return nullptr;
+    }
+
+    // the outline is already in pixels
+    if (_outlineSize > 0.0f)
+    {
+        font->_outlineSize = _outlineSize;
+        font->initStroker();
+    }
+    font->_msdfEnabled = _msdfEnabled;
+    font->setGlyphCollection(GlyphCollection::DYNAMIC);
+
+    if (!font->createFontObject(_fontName, _fontSize))
+    {
+        delete font;
+        return nullptr;
+    }
+    font->autorelease();
+    return font;
+}
+
 bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 {
     FT_Face face;
     // save font name locally
     _fontName = fontName;
+    _fontSize = fontSize;
 
     auto it = s_cacheFontData.find(fontName);
     if (it != s_cacheFontData.end())
@@ -142,7 +189,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
         }
     }
 
-    if (FT_New_Memory_Face(getFTLibrary(), s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
+    if (FT_New_Memory_Face(_library, s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
         return false;
 
     if (FT_Select_Charmap(face, FT_ENCODING_UNICODE))
@@ -185,7 +232,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
 FontFreeType::~FontFreeType()
 {
-    if (_FTInitialized)
+    if (_FTInitialized || _ownsLibrary)
     {
         if (_stroker)
         {
@@ -196,6 +243,10 @@ FontFreeType::~FontFreeType()
             FT_Done_Face(_fontRef);
         }
     }
+    if (_ownsLibrary)
+    {
+        FT_Done_FreeType(_library);
+    }
 
     auto iter = s_cacheFontData.find(_fontName);
     if (iter != s_cacheFontData.end())
@@ -234,7 +285,8 @@ int * FontFreeType::getHorizontalKerningForTextUTF32(const std::u32string& text,
     
     outNumLetters = static_cast<int>(text.length());
 
-    if (!outNumLetters)
+    // without kerning there is nothing to allocate, labels treat a null array as no kerning
+    if (!outNumLetters || !FT_HAS_KERNING(_fontRef))
         return nullptr;
     
     int *sizes = new (std::nothrow) int[outNumLetters];
@@ -242,13 +294,9 @@ int * FontFreeType::getHorizontalKerningForTextUTF32(const std::u32string& text,
         return nullptr;
     memset(sizes,0,outNumLetters * sizeof(int));
 
-    bool hasKerning = FT_HAS_KERNING( _fontRef ) != 0;
-    if (hasKerning)
+    for (int c = 1; c < outNumLetters; ++c)
     {
-        for (int c = 1; c < outNumLetters; ++c)
-        {
-            sizes[c] = getHorizontalKerningForChars(text[c-1], text[c]);
-        }
+        sizes[c] = getHorizontalKerningForChars(text[c-1], text[c]);
     }
     
     return sizes;
@@ -299,6 +347,18 @@ unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, lo
         if (_fontRef == nullptr)
             break;
 
+        if (_msdfEnabled)
+        {
+            // the fields come from the unhinted outlines, FreeType doesn't render anything
+            if (FT_Load_Char(_fontRef, theChar, FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
+                break;
+
+            xAdvance = (static_cast<int>(_fontRef->glyph->metrics.horiAdvance >> 6));
+            ret = getGlyphMSDF(outWidth, outHeight, outRect);
+            invalidChar = false;
+            break;
+        }
+
         if (_distanceFieldEnabled)
         {
             if (FT_Load_Char(_fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
@@ -448,7 +508,7 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBo
                     params.target = &bmp;
                     params.flags = FT_RASTER_FLAG_AA;
                     FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
+                    FT_Outline_Render(_library, outline, &params);
 
                     ret = bmp.buffer;
                 }
@@ -460,6 +520,81 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBo
     return ret;
 }
 
+static int msdfMoveTo(const FT_Vector* to, void* user)
+{
+    static_cast<MSDFGenerator*>(user)->moveTo(to->x / 64.0, to->y / 64.0);
+    return 0;
+}
+
+static int msdfLineTo(const FT_Vector* to, void* user)
+{
+    static_cast<MSDFGenerator*>(user)->lineTo(to->x / 64.0, to->y / 64.0);
+    return 0;
+}
+
+static int msdfConicTo(const FT_Vector* control, const FT_Vector* to, void* user)
+{
+    static_cast<MSDFGenerator*>(user)->quadraticTo(control->x / 64.0, control->y / 64.0, to->x / 64.0, to->y / 64.0);
+    return 0;
+}
+
+static int msdfCubicTo(const FT_Vector* control1, const FT_Vector* control2, const FT_Vector* to, void* user)
+{
+    static_cast<MSDFGenerator*>(user)->cubicTo(control1->x / 64.0, control1->y / 64.0,
+        control2->x / 64.0, control2->y / 64.0, to->x / 64.0, to->y / 64.0);
+    return 0;
+}
+
+unsigned char* FontFreeType::getGlyphMSDF(long &outWidth, long &outHeight, Rect &outRect)
+{
+    outWidth = 0;
+    outHeight = 0;
+    outRect = Rect::ZERO;
+
+    FT_Outline* outline = &_fontRef->glyph->outline;
+    if (_fontRef->glyph->format != FT_GLYPH_FORMAT_OUTLINE || outline->n_contours <= 0)
+        return nullptr;
+
+    FT_BBox bbox;
+    FT_Outline_Get_CBox(outline, &bbox);
+    long xMin = bbox.xMin >> 6;
+    long yMin = bbox.yMin >> 6;
+    long xMax = (bbox.xMax + 63) >> 6;
+    long yMax = (bbox.yMax + 63) >> 6;
+    if (xMax <= xMin || yMax <= yMin)
+        return nullptr;
+
+    MSDFGenerator generator;
+    FT_Outline_Funcs funcs;
+    funcs.move_to = msdfMoveTo;
+    funcs.line_to = msdfLineTo;
+    funcs.conic_to = msdfConicTo;
+    funcs.cubic_to = msdfCubicTo;
+    funcs.shift = 0;
+    funcs.delta = 0;
+    if (FT_Outline_Decompose(outline, &funcs, &generator))
+        return nullptr;
+    generator.colorEdges();
+
+    // the field reaches MSDFSpread pixels past the bounds, the letter reports the bounds and the atlas pads them
+    long width = xMax - xMin + 2 * MSDFSpread;
+    long height = yMax - yMin + 2 * MSDFSpread;
+    auto image = new (std::nothrow) unsigned char[width * height * 3];
+    if (!image)
+        return nullptr;
+
+    bool invert = FT_Outline_Get_Orientation(outline) == FT_ORIENTATION_POSTSCRIPT;
+    generator.generate(image, (int)width, (int)height, xMin - MSDFSpread, yMax + MSDFSpread, MSDFSpread, invert);
+
+    outWidth = xMax - xMin;
+    outHeight = yMax - yMin;
+    outRect.origin.x = xMin;
+    outRect.origin.y = -yMax;
+    outRect.size.width = outWidth;
+    outRect.size.height = outHeight;
+    return image;
+}
+
 unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
 {
     long pixelAmount = (width + 2 * FontFreeType::DistanceMapSpread) * (height + 2 * FontFreeType::DistanceMapSpread);
@@ -542,11 +677,27 @@ unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
 }
 
 void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
+{
+    renderCharAt(dest, FontAtlas::CacheTextureWidth, posX, posY, bitmap, bitmapWidth, bitmapHeight);
+}
+
+void FontFreeType::renderCharAt(unsigned char *dest, int destWidth, int posX, int posY, unsigned char* bitmap, long bitmapWidth, long bitmapHeight)
 {
     int iX = posX;
     int iY = posY;
 
-    if (_distanceFieldEnabled)
+    if (_msdfEnabled)
+    {
+        bitmapWidth += 2 * MSDFSpread;
+        bitmapHeight += 2 * MSDFSpread;
+
+        for (long y = 0; y < bitmapHeight; ++y)
+        {
+            memcpy(dest + (iX + (iY + y) * destWidth) * 3, bitmap + y * bitmapWidth * 3, bitmapWidth * 3);
+        }
+        delete [] bitmap;
+    }
+    else if (_distanceFieldEnabled)
     {
         auto distanceMap = makeDistanceMap(bitmap,bitmapWidth,bitmapHeight);
 
@@ -567,7 +718,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 dest[index + 2] = out[index2 + 2];*/
 
                 //Single channel 8-bit output 
-                dest[iX + ( iY * FontAtlas::CacheTextureWidth )] = distanceMap[bitmap_y + x];
+                dest[iX + ( iY * destWidth )] = distanceMap[bitmap_y + x];
 
                 iX += 1;
             }
@@ -587,9 +738,9 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             for (int x = 0; x < bitmapWidth; ++x)
             {
                 tempChar = bitmap[(bitmap_y + x) * 2];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2] = tempChar;
                 tempChar = bitmap[(bitmap_y + x) * 2 + 1];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2 + 1] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2 + 1] = tempChar;
 
                 iX += 1;
             }
@@ -610,7 +761,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 unsigned char cTemp = bitmap[bitmap_y + x];
 
                 // the final pixel
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) )] = cTemp;
+                dest[(iX + ( iY * destWidth ) )] = cTemp;
 
                 iX += 1;
             }
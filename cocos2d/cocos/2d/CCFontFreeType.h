@@ -53,17 +53,24 @@ class CC_DLL FontFreeType : public Font
 {
 public:
     static const int DistanceMapSpread;
+    /** Pixels the multi-channel distance fields reach on each side of the outlines. */
+    static const int MSDFSpread;
 
     static FontFreeType* create(const std::string &fontName, float fontSize, GlyphCollection glyphs,
-        const char *customGlyphs,bool distanceFieldEnabled = false, float outline = 0);
+        const char *customGlyphs,bool distanceFieldEnabled = false, float outline = 0, bool msdfEnabled = false);
 
     static void shutdownFreeType();
 
     bool isDistanceFieldEnabled() const { return _distanceFieldEnabled;}
 
+    /** Whether the glyphs are multi-channel distance fields generated from the outlines, 3 bytes per pixel. */
+    bool isMSDFEnabled() const { return _msdfEnabled; }
+
     float getOutlineSize() const { return _outlineSize; }
 
     void renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight); 
+    /** Renders a glyph bitmap into an image destWidth pixels wide. */
+    void renderCharAt(unsigned char *dest, int destWidth, int posX, int posY, unsigned char* bitmap, long bitmapWidth, long bitmapHeight);
 
     FT_Encoding getEncoding() const { return _encoding; }
 
@@ -80,32 +87,43 @@ public:
 
     static void releaseFont(const std::string &fontName);
 
+    /** Opens the same font again on its own FreeType library, so it can rasterize glyphs on another thread while this
+     * one is used on the main thread. Create and release it on the main thread.
+     */
+    FontFreeType* clone() const;
+
 private:
     static const char* _glyphASCII;
     static const char* _glyphNEHE;
     static FT_Library _FTlibrary;
     static bool _FTInitialized;
 
-    FontFreeType(bool distanceFieldEnabled = false, float outline = 0);
+    FontFreeType(bool distanceFieldEnabled = false, float outline = 0, FT_Library library = nullptr);
     virtual ~FontFreeType();
 
     bool createFontObject(const std::string &fontName, float fontSize);
 
     bool initFreeType();
     FT_Library getFTLibrary();
+    void initStroker();
     
     int getHorizontalKerningForChars(uint64_t firstChar, uint64_t secondChar) const;
     unsigned char* getGlyphBitmapWithOutline(uint64_t code, FT_BBox &bbox);
+    unsigned char* getGlyphMSDF(long &outWidth, long &outHeight, Rect &outRect);
 
     void setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs = nullptr);
     const char* getGlyphCollection() const;
     
+    FT_Library _library;
+    bool _ownsLibrary;
     FT_Face _fontRef;
     FT_Stroker _stroker;
     FT_Encoding _encoding;
 
     std::string _fontName;
+    float _fontSize;
     bool _distanceFieldEnabled;
+    bool _msdfEnabled;
     float _outlineSize;
     int _lineHeight;
     FontAtlas* _fontAtlas;
@@ -31,12 +31,14 @@
 #include "2d/CCFont.h"
 #include "2d/CCFontAtlasCache.h"
 #include "2d/CCFontAtlas.h"
+#include "2d/CCFontFreeType.h"
 #include "2d/CCSprite.h"
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCDrawNode.h"
 #include "2d/CCCamera.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCGLView.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/ccGLStateCache.h"
 #include "base/CCDirector.h"
@@ -53,6 +55,8 @@ NS_CC_BEGIN
 class LabelLetter : public Sprite
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(LabelLetter);
+
     LabelLetter()
     {
         _textureAtlas = nullptr;
@@ -172,6 +176,46 @@ private:
     bool _letterVisible;
 };
 
+CC_DEFINE_ALLOCATOR_POOL(LabelLetter, 256);
+
+// number of letters two UTF-8 strings share at their start
+static int getCommonLetterCount(const std::string& text1, const std::string& text2)
+{
+    size_t length = std::min(text1.length(), text2.length());
+    size_t bytes = 0;
+    while (bytes < length && text1[bytes] == text2[bytes])
+        ++bytes;
+
+    // a letter differing in its trailing bytes isn't common
+    const std::string& longer = text1.length() > text2.length() ? text1 : text2;
+    while (bytes > 0 && bytes < longer.length() && (longer[bytes] & 0xC0) == 0x80)
+        --bytes;
+
+    int letters = 0;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        if ((text1[i] & 0xC0) != 0x80)
+            ++letters;
+    }
+    return letters;
+}
+
+// counters and timers are ASCII, widen them in place instead of going through a temporary string
+static bool widenASCII(const std::string& text, std::u32string& outUtf32)
+{
+    for (auto ch : text)
+    {
+        if (ch & 0x80)
+            return false;
+    }
+    outUtf32.resize(text.length());
+    for (size_t i = 0; i < text.length(); ++i)
+    {
+        outUtf32[i] = static_cast<char32_t>(text[i]);
+    }
+    return true;
+}
+
 Label* Label::create()
 {
     auto ret = new (std::nothrow) Label;
@@ -559,9 +603,12 @@ void Label::reset()
     _uniformEffectColor = -1;
     _uniformEffectType = -1;
     _uniformTextColor = -1;
+    _uniformEffectWidth = -1;
+    _uniformSmoothing = -1;
 
     _useDistanceField = false;
     _useA8Shader = false;
+    _useMSDF = false;
     _clipEnabled = false;
     _blendFuncDirty = false;
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
@@ -598,6 +645,18 @@ static Texture2D* _getTexture(Label* label)
 
 void Label::updateShaderProgram()
 {
+    if (_useMSDF)
+    {
+        setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_MSDF));
+        auto program = getGLProgram()->getProgram();
+        _uniformTextColor = glGetUniformLocation(program, "u_textColor");
+        _uniformEffectColor = glGetUniformLocation(program, "u_effectColor");
+        _uniformEffectType = glGetUniformLocation(program, "u_effectType");
+        _uniformEffectWidth = glGetUniformLocation(program, "u_effectWidth");
+        _uniformSmoothing = glGetUniformLocation(program, "u_smoothing");
+        return;
+    }
+
     switch (_currLabelEffect)
     {
     case cocos2d::LabelEffect::NORMAL:
@@ -783,13 +842,23 @@ void Label::setString(const std::string& text)
 {
     if (text != _utf8Text)
     {
+        // while the layout is current, the letters the texts share keep it
+        int unchangedLetters = -1;
+        if (!_contentDirty && !_systemFontDirty && _fontAtlas && !_utf8Text.empty())
+        {
+            unchangedLetters = getCommonLetterCount(_utf8Text, text);
+        }
+
         _utf8Text = text;
         _contentDirty = true;
 
-        std::u32string utf32String;
-        if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
+        if (!widenASCII(_utf8Text, _utf32Text))
         {
-            _utf32Text  = utf32String;
+            std::u32string utf32String;
+            if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
+            {
+                _utf32Text  = utf32String;
+            }
         }
 
         CCASSERT(_utf32Text.length() <= CC_LABEL_MAX_LENGTH, "Length of text should be less then 16384");
@@ -798,6 +867,11 @@ void Label::setString(const std::string& text)
             cocos2d::log("Error: Label text is too long %d > %d and it will be truncated!", _utf32Text.length(), CC_LABEL_MAX_LENGTH);
             _utf32Text = _utf32Text.substr(0, CC_LABEL_MAX_LENGTH);
         }
+
+        if (unchangedLetters >= 0 && relayoutFromLetter(unchangedLetters))
+        {
+            _contentDirty = false;
+        }
     }
 }
 
@@ -1001,6 +1075,121 @@ bool Label::alignText()
     return ret;
 }
 
+bool Label::relayoutFromLetter(int firstChangedLetter)
+{
+#if CC_LABEL_DEBUG_DRAW
+    return false;
+#else
+    // a single line without dimensions is never wrapped, clamped or aligned, the letters before the change keep
+    // their position and their quads
+    if (_fontAtlas == nullptr || _utf32Text.empty() || _numberOfLines != 1 || _linesWidth.size() != 1
+        || _labelWidth > 0.f || _labelHeight > 0.f || _maxLineWidth > 0.f || _underlineNode || _batchNodes.size() != 1)
+    {
+        return false;
+    }
+
+    int textLen = getStringLength();
+    bool hasNewLetters = false;
+    for (int index = 0; index < textLen; ++index)
+    {
+        auto character = _utf32Text[index];
+        if (character == StringUtils::UnicodeCharacters::NewLine
+            || character == StringUtils::UnicodeCharacters::CarriageReturn
+            || character == StringUtils::UnicodeCharacters::NextCharNoChangeX)
+        {
+            return false;
+        }
+        if (index >= firstChangedLetter && _fontAtlas->_letterDefinitions.find(character) == _fontAtlas->_letterDefinitions.end())
+        {
+            hasNewLetters = true;
+        }
+    }
+    if (hasNewLetters)
+    {
+        _fontAtlas->prepareLetterDefinitions(_utf32Text);
+        if (_fontAtlas->getTextures().size() != 1)
+            return false;
+    }
+
+    computeHorizontalKernings(_utf32Text);
+    updateBMFontScale();
+
+    // same walk as multilineTextWrap(), the unchanged letters only advance the pen
+    auto contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    FontLetterDefinition letterDef;
+    Vec2 letterPosition;
+    float nextLetterX = 0.f;
+    float letterRight = 0.f;
+    for (int index = 0; index < textLen; ++index)
+    {
+        char32_t character = _utf32Text[index];
+        if (!getFontLetterDef(character, letterDef))
+        {
+            if (index >= firstChangedLetter)
+                recordPlaceholderInfo(index, character);
+            continue;
+        }
+
+        if (index >= firstChangedLetter)
+        {
+            letterPosition.x = (nextLetterX + letterDef.offsetX * _bmfontScale) / contentScaleFactor;
+            letterPosition.y = (0.f - letterDef.offsetY * _bmfontScale) / contentScaleFactor;
+            recordLetterInfo(letterPosition, character, index, 0);
+        }
+
+        float newLetterWidth = 0.f;
+        if (_horizontalKernings && index < textLen - 1)
+            newLetterWidth = _horizontalKernings[index + 1] * _bmfontScale;
+        newLetterWidth += letterDef.xAdvance * _bmfontScale + _additionalKerning;
+        nextLetterX += newLetterWidth;
+        letterRight = nextLetterX / contentScaleFactor;
+    }
+
+    _linesWidth[0] = letterRight;
+    setContentSize(Size(letterRight, _textDesiredHeight));
+    computeAlignmentOffset();
+
+    // the quads of the unchanged letters come first in the atlas
+    auto batchNode = _batchNodes.at(0);
+    auto textureAtlas = batchNode->getTextureAtlas();
+    ssize_t firstQuad = 0;
+    for (int index = std::min(firstChangedLetter, textLen) - 1; index >= 0; --index)
+    {
+        if (_lettersInfo[index].valid && _lettersInfo[index].atlasIndex >= 0)
+        {
+            firstQuad = _lettersInfo[index].atlasIndex + 1;
+            break;
+        }
+    }
+    textureAtlas->removeQuadsAtIndex(firstQuad, textureAtlas->getTotalQuads() - firstQuad);
+    batchNode->reserveCapacity(textLen);
+
+    for (int index = firstChangedLetter; index < textLen; ++index)
+    {
+        auto& letterInfo = _lettersInfo[index];
+        if (!letterInfo.valid)
+            continue;
+
+        auto& definition = _fontAtlas->_letterDefinitions[letterInfo.utf32Char];
+        if (definition.width <= 0.f || definition.height <= 0.f)
+            continue;
+
+        _reusedRect.setRect(definition.U, definition.V, definition.width, definition.height);
+        _reusedLetter->setTextureRect(_reusedRect, definition.rotated, _reusedRect.size);
+        _reusedLetter->setPosition(letterInfo.positionX + _linesOffsetX[0], letterInfo.positionY + _letterOffsetY);
+        letterInfo.atlasIndex = static_cast<int>(textureAtlas->getTotalQuads());
+
+        this->updateLetterSpriteScale(_reusedLetter);
+
+        batchNode->insertQuadFromSprite(_reusedLetter, letterInfo.atlasIndex);
+    }
+
+    updateLabelLetters();
+    updateQuadsColor(textureAtlas, firstQuad);
+    return true;
+#endif
+}
+
 bool Label::computeHorizontalKernings(const std::u32string& stringToRender)
 {
     if (_horizontalKernings)
@@ -1113,9 +1302,14 @@ bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
     }
 
     _currentLabelType = LabelType::TTF;
-    setFontAtlas(newAtlas,ttfConfig.distanceFieldEnabled,true);
+    _useMSDF = ttfConfig.multiChannelDistanceFieldEnabled;
+    setFontAtlas(newAtlas,ttfConfig.distanceFieldEnabled && !_useMSDF,true);
 
     _fontConfig = ttfConfig;
+    if (_useMSDF)
+    {
+        _fontConfig.distanceFieldEnabled = false;
+    }
 
     if (_fontConfig.outlineSize > 0)
     {
@@ -1185,7 +1379,12 @@ void Label::enableGlow(const Color4B& glowColor)
 {
     if (_currentLabelType == LabelType::TTF)
     {
-        if (_fontConfig.distanceFieldEnabled == false)
+        if (_useMSDF)
+        {
+            // the glow replaces the outline, both come from the same atlas
+            _fontConfig.outlineSize = 0;
+        }
+        else if (_fontConfig.distanceFieldEnabled == false)
         {
             auto config = _fontConfig;
             config.outlineSize = 0;
@@ -1618,7 +1817,13 @@ void Label::onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor)
 {
     if (_currentLabelType == LabelType::TTF)
     {
-        if (_currLabelEffect == LabelEffect::OUTLINE)
+        if (_useMSDF)
+        {
+            // the shadow covers the text and its outline or glow
+            glProgram->setUniformLocationWith4f(_uniformTextColor, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
+            glProgram->setUniformLocationWith4f(_uniformEffectColor, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
+        }
+        else if (_currLabelEffect == LabelEffect::OUTLINE)
         {
             glProgram->setUniformLocationWith1i(_uniformEffectType, 2); // 2: shadow
             glProgram->setUniformLocationWith4f(_uniformEffectColor, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
@@ -1664,12 +1869,48 @@ void Label::onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor)
     }
 }
 
+void Label::setMSDFUniforms(GLProgram* glProgram, const Mat4& transform)
+{
+    // framebuffer pixels covered by a pixel of the atlas, the edges are smoothed over one of them
+    float pixelsPerTexel = _bmfontScale / CC_CONTENT_SCALE_FACTOR() * Vec2(transform.m[0], transform.m[1]).length();
+    auto glview = _director->getOpenGLView();
+    if (glview)
+    {
+        pixelsPerTexel *= glview->getScaleX() * glview->getRetinaFactor();
+    }
+    float fieldRange = 2.0f * FontFreeType::MSDFSpread;
+    float smoothing = pixelsPerTexel > 0.0f ? std::min(0.5f / (fieldRange * pixelsPerTexel), 0.5f) : 0.5f;
+
+    int effectType = 0;
+    float effectWidth = 0.0f;
+    if (_currLabelEffect == LabelEffect::OUTLINE)
+    {
+        // the field only reaches MSDFSpread pixels of the atlas past the glyphs, wider outlines are cut there
+        effectType = 1;
+        float outlineTexels = _fontConfig.outlineSize * CC_CONTENT_SCALE_FACTOR() / _bmfontScale;
+        effectWidth = std::min(outlineTexels / fieldRange, 0.5f - smoothing);
+    }
+    else if (_currLabelEffect == LabelEffect::GLOW)
+    {
+        effectType = 2;
+    }
+
+    glProgram->setUniformLocationWith1i(_uniformEffectType, effectType);
+    glProgram->setUniformLocationWith1f(_uniformEffectWidth, effectWidth);
+    glProgram->setUniformLocationWith1f(_uniformSmoothing, smoothing);
+}
+
 void Label::onDraw(const Mat4& transform, bool /*transformUpdated*/)
 {
     auto glprogram = getGLProgram();
     glprogram->use();
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
+    if (_useMSDF)
+    {
+        setMSDFUniforms(glprogram, transform);
+    }
+
     if (_shadowEnabled)
     {
         if (_boldEnabled)
@@ -1684,7 +1925,12 @@ void Label::onDraw(const Mat4& transform, bool /*transformUpdated*/)
         it.second->updateTransform();
     }
 
-    if (_currentLabelType == LabelType::TTF)
+    if (_useMSDF)
+    {
+        glprogram->setUniformLocationWith4f(_uniformTextColor, _textColorF.r, _textColorF.g, _textColorF.b, _textColorF.a);
+        glprogram->setUniformLocationWith4f(_uniformEffectColor, _effectColorF.r, _effectColorF.g, _effectColorF.b, _effectColorF.a);
+    }
+    else if (_currentLabelType == LabelType::TTF)
     {
         switch (_currLabelEffect) {
         case LabelEffect::OUTLINE:
@@ -2117,11 +2363,14 @@ void Label::setTextColor(const Color4B &color)
 
 void Label::updateColor()
 {
-    if (_batchNodes.empty())
+    for (auto&& batchNode : _batchNodes)
     {
-        return;
+        updateQuadsColor(batchNode->getTextureAtlas(), 0);
     }
+}
 
+void Label::updateQuadsColor(TextureAtlas* textureAtlas, ssize_t firstQuad)
+{
     Color4B color4( _displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity );
 
     // special opacity for premultiplied textures
@@ -2132,22 +2381,16 @@ void Label::updateColor()
         color4.b *= _displayedOpacity/255.0f;
     }
 
-    cocos2d::TextureAtlas* textureAtlas;
-    V3F_C4B_T2F_Quad *quads;
-    for (auto&& batchNode:_batchNodes)
-    {
-        textureAtlas = batchNode->getTextureAtlas();
-        quads = textureAtlas->getQuads();
-        auto count = textureAtlas->getTotalQuads();
+    V3F_C4B_T2F_Quad *quads = textureAtlas->getQuads();
+    auto count = textureAtlas->getTotalQuads();
 
-        for (int index = 0; index < count; ++index)
-        {
-            quads[index].bl.colors = color4;
-            quads[index].br.colors = color4;
-            quads[index].tl.colors = color4;
-            quads[index].tr.colors = color4;
-            textureAtlas->updateQuad(&quads[index], index);
-        }
+    for (ssize_t index = firstQuad; index < count; ++index)
+    {
+        quads[index].bl.colors = color4;
+        quads[index].br.colors = color4;
+        quads[index].tl.colors = color4;
+        quads[index].tr.colors = color4;
+        textureAtlas->updateQuad(&quads[index], index);
     }
 }
 
@@ -2341,7 +2584,7 @@ Label::Overflow Label::getOverflow()const
 
 void Label::updateLetterSpriteScale(Sprite* sprite)
 {
-    if (_currentLabelType == LabelType::BMFONT && _bmFontSize > 0)
+    if ((_currentLabelType == LabelType::BMFONT && _bmFontSize > 0) || _useMSDF)
     {
         sprite->setScale(_bmfontScale);
     }
@@ -62,9 +62,15 @@ typedef struct _ttfConfig
     bool underline;
     bool strikethrough;
 
+    /** Draws the glyphs from a multi-channel distance field atlas shared by every size of the font, see
+     * CC_FONT_MSDF_GLYPH_SIZE. Outlines and glows are drawn by the shader from the same atlas.
+     */
+    bool multiChannelDistanceFieldEnabled;
+
     _ttfConfig(const std::string& filePath = "",float size = CC_DEFAULT_FONT_LABEL_SIZE, const GlyphCollection& glyphCollection = GlyphCollection::DYNAMIC,
         const char *customGlyphCollection = nullptr, bool useDistanceField = false, int outline = 0,
-               bool useItalics = false, bool useBold = false, bool useUnderline = false, bool useStrikethrough = false)
+               bool useItalics = false, bool useBold = false, bool useUnderline = false, bool useStrikethrough = false,
+               bool useMultiChannelDistanceField = false)
         : fontFilePath(filePath)
         , fontSize(size)
         , glyphs(glyphCollection)
@@ -75,8 +81,9 @@ typedef struct _ttfConfig
         , bold(useBold)
         , underline(useUnderline)
         , strikethrough(useStrikethrough)
+        , multiChannelDistanceFieldEnabled(useMultiChannelDistanceField)
     {
-        if(outline > 0)
+        if(outline > 0 || useMultiChannelDistanceField)
         {
             distanceFieldEnabled = false;
         }
@@ -85,6 +92,7 @@ typedef struct _ttfConfig
 
 class Sprite;
 class SpriteBatchNode;
+class TextureAtlas;
 class DrawNode;
 class EventListenerCustom;
 
@@ -708,6 +716,7 @@ protected:
 
     void onDraw(const Mat4& transform, bool transformUpdated);
     void onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor);
+    void setMSDFUniforms(GLProgram* glProgram, const Mat4& transform);
     void drawSelf(bool visibleByCamera, Renderer* renderer, uint32_t flags);
 
     bool multilineTextWrapByChar();
@@ -720,6 +729,7 @@ protected:
 
     void updateLabelLetters();
     virtual bool alignText();
+    bool relayoutFromLetter(int firstChangedLetter);
     void computeAlignmentOffset();
     bool computeHorizontalKernings(const std::u32string& stringToRender);
 
@@ -747,6 +757,7 @@ protected:
     FontDefinition _getFontDefinition() const;
 
     virtual void updateColor() override;
+    void updateQuadsColor(TextureAtlas* textureAtlas, ssize_t firstQuad);
 
     LabelType _currentLabelType;
     bool _contentDirty;
@@ -808,8 +819,12 @@ protected:
     GLint _uniformEffectColor;
     GLint _uniformEffectType; // 0: None, 1: Outline, 2: Shadow; Only used when outline is enabled.
     GLint _uniformTextColor;
+    // the multi-channel distance field shader draws every effect in one pass
+    GLint _uniformEffectWidth;
+    GLint _uniformSmoothing;
     bool _useDistanceField;
     bool _useA8Shader;
+    bool _useMSDF;
 
     bool _shadowDirty;
     bool _shadowEnabled;
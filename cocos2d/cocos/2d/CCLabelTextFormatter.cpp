@@ -142,6 +142,9 @@ void Label::updateBMFontScale()
         FontFNT *bmFont = (FontFNT*)font;
         float originalFontSize = bmFont->getOriginalFontSize();
         _bmfontScale = _bmFontSize * CC_CONTENT_SCALE_FACTOR() / originalFontSize;
+    }else if (_useMSDF) {
+        // the atlas is shared by every size of the font
+        _bmfontScale = _fontConfig.fontSize / CC_FONT_MSDF_GLYPH_SIZE;
     }else{
         _bmfontScale = 1.0f;
     }
@@ -238,7 +241,7 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
             {
                 float newLetterWidth = 0.f;
                 if (_horizontalKernings && letterIndex < textLen - 1)
-                    newLetterWidth = _horizontalKernings[letterIndex + 1];
+                    newLetterWidth = _horizontalKernings[letterIndex + 1] * _bmfontScale;
                 newLetterWidth += letterDef.xAdvance * _bmfontScale + _additionalKerning;
 
                 nextLetterX += newLetterWidth;
@@ -0,0 +1,643 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCMSDFGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+NS_CC_BEGIN
+
+namespace {
+
+enum EdgeColor
+{
+    BLACK = 0,
+    RED = 1,
+    GREEN = 2,
+    YELLOW = 3,
+    BLUE = 4,
+    MAGENTA = 5,
+    CYAN = 6,
+    WHITE = 7,
+};
+
+const double EPSILON = 1e-14;
+
+int solveQuadratic(double x[2], double a, double b, double c)
+{
+    if (std::abs(a) < EPSILON)
+    {
+        if (std::abs(b) < EPSILON)
+            return 0;
+        x[0] = -c / b;
+        return 1;
+    }
+
+    double discriminant = b * b - 4 * a * c;
+    if (discriminant > 0)
+    {
+        discriminant = std::sqrt(discriminant);
+        x[0] = (-b + discriminant) / (2 * a);
+        x[1] = (-b - discriminant) / (2 * a);
+        return 2;
+    }
+    if (discriminant == 0)
+    {
+        x[0] = -b / (2 * a);
+        return 1;
+    }
+    return 0;
+}
+
+int solveCubicNormed(double x[3], double a, double b, double c)
+{
+    double a2 = a * a;
+    double q = (a2 - 3 * b) / 9;
+    double r = (a * (2 * a2 - 9 * b) + 27 * c) / 54;
+    double r2 = r * r;
+    double q3 = q * q * q;
+    if (r2 < q3)
+    {
+        double t = std::max(-1.0, std::min(1.0, r / std::sqrt(q3)));
+        t = std::acos(t);
+        a /= 3;
+        q = -2 * std::sqrt(q);
+        x[0] = q * std::cos(t / 3) - a;
+        x[1] = q * std::cos((t + 2 * M_PI) / 3) - a;
+        x[2] = q * std::cos((t - 2 * M_PI) / 3) - a;
+        return 3;
+    }
+
+    double A = -std::pow(std::abs(r) + std::sqrt(r2 - q3), 1 / 3.0);
+    if (r < 0)
+        A = -A;
+    double B = A == 0 ? 0 : q / A;
+    a /= 3;
+    x[0] = (A + B) - a;
+    x[1] = -0.5 * (A + B) - a;
+    x[2] = 0.5 * std::sqrt(3.0) * (A - B);
+    return std::abs(x[2]) < EPSILON ? 2 : 1;
+}
+
+// roots of a x^3 + b x^2 + c x + d
+int solveCubic(double x[3], double a, double b, double c, double d)
+{
+    if (std::abs(a) < EPSILON)
+        return solveQuadratic(x, b, c, d);
+    return solveCubicNormed(x, b / a, c / a, d / a);
+}
+
+double nonZeroSign(double value)
+{
+    return value > 0 ? 1.0 : -1.0;
+}
+
+// the next color of the cycle cyan, magenta, yellow, avoiding banned
+void switchColor(int& color, int banned = BLACK)
+{
+    int combined = color & banned;
+    if (combined == RED || combined == GREEN || combined == BLUE)
+    {
+        color = combined ^ WHITE;
+        return;
+    }
+    if (color == BLACK || color == WHITE)
+    {
+        color = CYAN;
+        return;
+    }
+    int shifted = color << 1;
+    color = (shifted | shifted >> 3) & WHITE;
+}
+
+// -1, 0 or 1 for the first, middle and last third of n edges
+int symmetricalTrichotomy(int position, int n)
+{
+    return int(3 + 2.875 * position / (n - 1) - 1.4375 + 0.5) - 3;
+}
+
+// a distance and how parallel to the edge the closest point is seen, to break ties between edges sharing a corner
+struct SignedDistance
+{
+    double distance;
+    double dot;
+
+    bool operator<(const SignedDistance& other) const
+    {
+        double absolute = std::abs(distance);
+        double otherAbsolute = std::abs(other.distance);
+        return absolute < otherAbsolute || (absolute == otherAbsolute && dot < other.dot);
+    }
+};
+
+// clashes happen when two neighbour pixels interpolate to a false edge, msdfgen then falls back to the median
+bool detectClash(const float* a, const float* b, float threshold)
+{
+    float a0 = a[0], a1 = a[1], a2 = a[2];
+    float b0 = b[0], b1 = b[1], b2 = b[2];
+    if (std::abs(b0 - a0) < std::abs(b1 - a1))
+    {
+        std::swap(a0, a1);
+        std::swap(b0, b1);
+    }
+    if (std::abs(b1 - a1) < std::abs(b2 - a2))
+    {
+        std::swap(a1, a2);
+        std::swap(b1, b2);
+        if (std::abs(b0 - a0) < std::abs(b1 - a1))
+        {
+            std::swap(a0, a1);
+            std::swap(b0, b1);
+        }
+    }
+    return std::abs(b1 - a1) >= threshold
+        && !(b0 == b1 && b0 == b2)
+        && std::abs(a2 - 0.5f) >= std::abs(b2 - 0.5f);
+}
+
+float median(float a, float b, float c)
+{
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+} // namespace
+
+double MSDFGenerator::Point::length() const
+{
+    return std::sqrt(x * x + y * y);
+}
+
+MSDFGenerator::Point MSDFGenerator::Point::normalized() const
+{
+    double len = length();
+    if (len == 0)
+        return Point{0, 1};
+    return Point{x / len, y / len};
+}
+
+MSDFGenerator::Point MSDFGenerator::Edge::pointAt(double t) const
+{
+    const Point* p = points;
+    switch (type)
+    {
+    case EdgeType::LINEAR:
+        return p[0] + (p[1] - p[0]) * t;
+    case EdgeType::QUADRATIC:
+        return p[0] * ((1 - t) * (1 - t)) + p[1] * (2 * t * (1 - t)) + p[2] * (t * t);
+    default:
+        return p[0] * ((1 - t) * (1 - t) * (1 - t)) + p[1] * (3 * t * (1 - t) * (1 - t))
+            + p[2] * (3 * t * t * (1 - t)) + p[3] * (t * t * t);
+    }
+}
+
+MSDFGenerator::Point MSDFGenerator::Edge::direction(double t) const
+{
+    const Point* p = points;
+    switch (type)
+    {
+    case EdgeType::LINEAR:
+        return p[1] - p[0];
+    case EdgeType::QUADRATIC:
+    {
+        Point tangent = (p[1] - p[0]) * (1 - t) + (p[2] - p[1]) * t;
+        if (tangent.x == 0 && tangent.y == 0)
+            return p[2] - p[0];
+        return tangent;
+    }
+    default:
+    {
+        Point a = (p[1] - p[0]) * (1 - t) + (p[2] - p[1]) * t;
+        Point b = (p[2] - p[1]) * (1 - t) + (p[3] - p[2]) * t;
+        Point tangent = a * (1 - t) + b * t;
+        if (tangent.x == 0 && tangent.y == 0)
+        {
+            if (t == 0)
+                return p[2] - p[0];
+            if (t == 1)
+                return p[3] - p[1];
+        }
+        return tangent;
+    }
+    }
+}
+
+void MSDFGenerator::Edge::splitInThirds(Edge parts[3]) const
+{
+    const Point* p = points;
+    for (int i = 0; i < 3; ++i)
+    {
+        parts[i].type = type;
+        parts[i].color = color;
+    }
+
+    switch (type)
+    {
+    case EdgeType::LINEAR:
+        parts[0].points[0] = p[0];
+        parts[0].points[1] = parts[1].points[0] = pointAt(1 / 3.0);
+        parts[1].points[1] = parts[2].points[0] = pointAt(2 / 3.0);
+        parts[2].points[1] = p[1];
+        break;
+    case EdgeType::QUADRATIC:
+    {
+        // control points of the sub-curves, from de Casteljau
+        auto lerp = [](const Point& a, const Point& b, double t) { return a + (b - a) * t; };
+        parts[0].points[0] = p[0];
+        parts[0].points[1] = lerp(p[0], p[1], 1 / 3.0);
+        parts[0].points[2] = parts[1].points[0] = pointAt(1 / 3.0);
+        parts[1].points[1] = lerp(lerp(p[0], p[1], 5 / 9.0), lerp(p[1], p[2], 4 / 9.0), 0.5);
+        parts[1].points[2] = parts[2].points[0] = pointAt(2 / 3.0);
+        parts[2].points[1] = lerp(p[1], p[2], 2 / 3.0);
+        parts[2].points[2] = p[2];
+        break;
+    }
+    default:
+    {
+        auto lerp = [](const Point& a, const Point& b, double t) { return a + (b - a) * t; };
+        parts[0].points[0] = p[0];
+        parts[0].points[1] = p[0] == p[1] ? p[0] : lerp(p[0], p[1], 1 / 3.0);
+        parts[0].points[2] = lerp(lerp(p[0], p[1], 1 / 3.0), lerp(p[1], p[2], 1 / 3.0), 1 / 3.0);
+        parts[0].points[3] = parts[1].points[0] = pointAt(1 / 3.0);
+        parts[1].points[1] = lerp(lerp(lerp(p[0], p[1], 1 / 3.0), lerp(p[1], p[2], 1 / 3.0), 1 / 3.0),
+            lerp(lerp(p[1], p[2], 1 / 3.0), lerp(p[2], p[3], 1 / 3.0), 1 / 3.0), 2 / 3.0);
+        parts[1].points[2] = lerp(lerp(lerp(p[0], p[1], 2 / 3.0), lerp(p[1], p[2], 2 / 3.0), 2 / 3.0),
+            lerp(lerp(p[1], p[2], 2 / 3.0), lerp(p[2], p[3], 2 / 3.0), 2 / 3.0), 1 / 3.0);
+        parts[1].points[3] = parts[2].points[0] = pointAt(2 / 3.0);
+        parts[2].points[1] = lerp(lerp(p[1], p[2], 2 / 3.0), lerp(p[2], p[3], 2 / 3.0), 2 / 3.0);
+        parts[2].points[2] = p[2] == p[3] ? p[3] : lerp(p[2], p[3], 2 / 3.0);
+        parts[2].points[3] = p[3];
+        break;
+    }
+    }
+}
+
+double MSDFGenerator::Edge::signedDistance(const Point& origin, double& outParam, double& outDot) const
+{
+    const Point* p = points;
+    if (type == EdgeType::LINEAR)
+    {
+        Point aq = origin - p[0];
+        Point ab = p[1] - p[0];
+        outParam = aq.dot(ab) / ab.dot(ab);
+        Point eq = (outParam > 0.5 ? p[1] : p[0]) - origin;
+        double endpointDistance = eq.length();
+        if (outParam > 0 && outParam < 1)
+        {
+            double orthoDistance = aq.cross(ab) / ab.length();
+            if (std::abs(orthoDistance) < endpointDistance)
+            {
+                outDot = 0;
+                return orthoDistance;
+            }
+        }
+        outDot = std::abs(ab.normalized().dot(eq.normalized()));
+        return nonZeroSign(aq.cross(ab)) * endpointDistance;
+    }
+
+    Point qa = p[0] - origin;
+    Point ab = p[1] - p[0];
+    Point br = p[2] - p[1] - ab;
+    const Point& end = type == EdgeType::QUADRATIC ? p[2] : p[3];
+
+    // the endpoints first
+    Point startDirection = direction(0);
+    double minDistance = nonZeroSign(startDirection.cross(qa)) * qa.length();
+    outParam = -qa.dot(startDirection) / startDirection.dot(startDirection);
+    {
+        Point endDirection = direction(1);
+        Point eq = end - origin;
+        double distance = eq.length();
+        if (distance < std::abs(minDistance))
+        {
+            minDistance = nonZeroSign(endDirection.cross(eq)) * distance;
+            outParam = (endDirection - eq).dot(endDirection) / endDirection.dot(endDirection);
+        }
+    }
+
+    if (type == EdgeType::QUADRATIC)
+    {
+        // the closest point cancels the derivative of the squared distance, a cubic
+        double t[3];
+        int solutions = solveCubic(t, br.dot(br), 3 * ab.dot(br), 2 * ab.dot(ab) + qa.dot(br), qa.dot(ab));
+        for (int i = 0; i < solutions; ++i)
+        {
+            if (t[i] > 0 && t[i] < 1)
+            {
+                Point qe = qa + ab * (2 * t[i]) + br * (t[i] * t[i]);
+                double distance = qe.length();
+                if (distance <= std::abs(minDistance))
+                {
+                    minDistance = nonZeroSign(direction(t[i]).cross(qe)) * distance;
+                    outParam = t[i];
+                }
+            }
+        }
+    }
+    else
+    {
+        // a quintic for cubics, so Newton iterations from a few starting points
+        const int SEARCH_STARTS = 4;
+        const int SEARCH_STEPS = 4;
+        Point as = (p[3] - p[2]) - (p[2] - p[1]) - br;
+        for (int i = 0; i <= SEARCH_STARTS; ++i)
+        {
+            double t = static_cast<double>(i) / SEARCH_STARTS;
+            Point qe = qa + ab * (3 * t) + br * (3 * t * t) + as * (t * t * t);
+            for (int step = 0; step < SEARCH_STEPS; ++step)
+            {
+                Point d1 = ab * 3 + br * (6 * t) + as * (3 * t * t);
+                Point d2 = br * 6 + as * (6 * t);
+                t -= qe.dot(d1) / (d1.dot(d1) + qe.dot(d2));
+                if (t <= 0 || t >= 1)
+                    break;
+                qe = qa + ab * (3 * t) + br * (3 * t * t) + as * (t * t * t);
+                double distance = qe.length();
+                if (distance < std::abs(minDistance))
+                {
+                    minDistance = nonZeroSign(d1.cross(qe)) * distance;
+                    outParam = t;
+                }
+            }
+        }
+    }
+
+    if (outParam >= 0 && outParam <= 1)
+        outDot = 0;
+    else if (outParam < 0.5)
+        outDot = std::abs(direction(0).normalized().dot(qa.normalized()));
+    else
+        outDot = std::abs(direction(1).normalized().dot((end - origin).normalized()));
+    return minDistance;
+}
+
+void MSDFGenerator::Edge::toPseudoDistance(double& distance, double& dot, const Point& origin, double param) const
+{
+    // past an end, the distance to the tangent line, so the channels of a corner extend beyond it
+    if (param < 0)
+    {
+        Point dir = direction(0).normalized();
+        Point aq = origin - pointAt(0);
+        if (aq.dot(dir) < 0)
+        {
+            double pseudoDistance = aq.cross(dir);
+            if (std::abs(pseudoDistance) <= std::abs(distance))
+            {
+                distance = pseudoDistance;
+                dot = 0;
+            }
+        }
+    }
+    else if (param > 1)
+    {
+        Point dir = direction(1).normalized();
+        Point bq = origin - pointAt(1);
+        if (bq.dot(dir) > 0)
+        {
+            double pseudoDistance = bq.cross(dir);
+            if (std::abs(pseudoDistance) <= std::abs(distance))
+            {
+                distance = pseudoDistance;
+                dot = 0;
+            }
+        }
+    }
+}
+
+void MSDFGenerator::clear()
+{
+    _contours.clear();
+}
+
+void MSDFGenerator::moveTo(double x, double y)
+{
+    _contours.push_back(std::vector<Edge>());
+    _position = Point{x, y};
+}
+
+void MSDFGenerator::addEdge(EdgeType type, const Point* points, int count)
+{
+    if (_contours.empty())
+        _contours.push_back(std::vector<Edge>());
+
+    Edge edge;
+    edge.type = type;
+    edge.color = WHITE;
+    edge.points[0] = _position;
+    for (int i = 0; i < count; ++i)
+    {
+        edge.points[i + 1] = points[i];
+    }
+    _contours.back().push_back(edge);
+    _position = points[count - 1];
+}
+
+void MSDFGenerator::lineTo(double x, double y)
+{
+    Point point{x, y};
+    // closing lines of zero length have no direction
+    if (point.x == _position.x && point.y == _position.y)
+        return;
+    addEdge(EdgeType::LINEAR, &point, 1);
+}
+
+void MSDFGenerator::quadraticTo(double controlX, double controlY, double x, double y)
+{
+    Point points[2] = {{controlX, controlY}, {x, y}};
+    addEdge(EdgeType::QUADRATIC, points, 2);
+}
+
+void MSDFGenerator::cubicTo(double control1X, double control1Y, double control2X, double control2Y, double x, double y)
+{
+    Point points[3] = {{control1X, control1Y}, {control2X, control2Y}, {x, y}};
+    addEdge(EdgeType::CUBIC, points, 3);
+}
+
+void MSDFGenerator::colorEdges(double angleThreshold)
+{
+    double crossThreshold = std::sin(angleThreshold);
+    std::vector<int> corners;
+    for (auto& contour : _contours)
+    {
+        if (contour.empty())
+            continue;
+
+        corners.clear();
+        Point previousDirection = contour.back().direction(1);
+        for (size_t i = 0; i < contour.size(); ++i)
+        {
+            Point a = previousDirection.normalized();
+            Point b = contour[i].direction(0).normalized();
+            if (a.dot(b) <= 0 || std::abs(a.cross(b)) > crossThreshold)
+                corners.push_back(static_cast<int>(i));
+            previousDirection = contour[i].direction(1);
+        }
+
+        if (corners.empty())
+        {
+            // smooth, every channel follows every edge
+            for (auto& edge : contour)
+            {
+                edge.color = WHITE;
+            }
+        }
+        else if (corners.size() == 1)
+        {
+            // a teardrop, the single corner needs three colors around it
+            int colors[3] = {WHITE, WHITE, WHITE};
+            switchColor(colors[0]);
+            colors[2] = colors[0];
+            switchColor(colors[2]);
+
+            if (contour.size() < 3)
+            {
+                std::vector<Edge> parts(3 * contour.size());
+                for (size_t i = 0; i < contour.size(); ++i)
+                {
+                    contour[i].splitInThirds(&parts[3 * i]);
+                }
+                contour.swap(parts);
+            }
+
+            int corner = contour.size() == 3 * corners.size() ? 0 : corners[0];
+            int m = static_cast<int>(contour.size());
+            for (int i = 0; i < m; ++i)
+            {
+                contour[(corner + i) % m].color = colors[1 + symmetricalTrichotomy(i, m)];
+            }
+        }
+        else
+        {
+            // a color per spline between two corners, the last one differs from the first
+            int cornerCount = static_cast<int>(corners.size());
+            int spline = 0;
+            int start = corners[0];
+            int m = static_cast<int>(contour.size());
+            int color = WHITE;
+            switchColor(color);
+            int initialColor = color;
+            for (int i = 0; i < m; ++i)
+            {
+                int index = (start + i) % m;
+                if (spline + 1 < cornerCount && corners[spline + 1] == index)
+                {
+                    ++spline;
+                    switchColor(color, spline == cornerCount - 1 ? initialColor : BLACK);
+                }
+                contour[index].color = color;
+            }
+        }
+    }
+}
+
+void MSDFGenerator::generate(unsigned char* image, int width, int height, double left, double top, double range, bool invert) const
+{
+    std::vector<float> field(static_cast<size_t>(width) * height * 3);
+    double sign = invert ? -1.0 : 1.0;
+
+    struct Channel
+    {
+        SignedDistance minDistance;
+        const Edge* nearEdge;
+        double nearParam;
+    };
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            Point origin{left + x + 0.5, top - y - 0.5};
+            Channel channels[3];
+            for (auto& channel : channels)
+            {
+                channel.minDistance = SignedDistance{-DBL_MAX, 1};
+                channel.nearEdge = nullptr;
+                channel.nearParam = 0;
+            }
+
+            for (const auto& contour : _contours)
+            {
+                for (const auto& edge : contour)
+                {
+                    SignedDistance distance;
+                    double param;
+                    distance.distance = edge.signedDistance(origin, param, distance.dot);
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        if ((edge.color & (1 << c)) && distance < channels[c].minDistance)
+                        {
+                            channels[c].minDistance = distance;
+                            channels[c].nearEdge = &edge;
+                            channels[c].nearParam = param;
+                        }
+                    }
+                }
+            }
+
+            float* pixel = &field[(static_cast<size_t>(y) * width + x) * 3];
+            for (int c = 0; c < 3; ++c)
+            {
+                auto& channel = channels[c];
+                if (channel.nearEdge)
+                {
+                    channel.nearEdge->toPseudoDistance(channel.minDistance.distance, channel.minDistance.dot, origin, channel.nearParam);
+                }
+                pixel[c] = static_cast<float>(sign * channel.minDistance.distance / (2 * range) + 0.5);
+            }
+        }
+    }
+
+    // neighbours interpolating to a false edge get the median in every channel
+    float threshold = static_cast<float>(1.001 / (2 * range));
+    std::vector<size_t> clashes;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            size_t index = static_cast<size_t>(y) * width + x;
+            const float* pixel = &field[index * 3];
+            if ((x > 0 && detectClash(pixel, pixel - 3, threshold))
+                || (x < width - 1 && detectClash(pixel, pixel + 3, threshold))
+                || (y > 0 && detectClash(pixel, pixel - width * 3, threshold))
+                || (y < height - 1 && detectClash(pixel, pixel + width * 3, threshold)))
+            {
+                clashes.push_back(index);
+            }
+        }
+    }
+    for (auto index : clashes)
+    {
+        float* pixel = &field[index * 3];
+        pixel[0] = pixel[1] = pixel[2] = median(pixel[0], pixel[1], pixel[2]);
+    }
+
+    for (size_t i = 0; i < field.size(); ++i)
+    {
+        float value = std::max(0.0f, std::min(1.0f, field[i]));
+        image[i] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCMSDFGENERATOR_H__
+#define __CCMSDFGENERATOR_H__
+
+/// @cond DO_NOT_SHOW
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/** Builds multi-channel signed distance fields from outlines, the way msdfgen does.
+ *
+ * Each edge of the outline is assigned two of the three channels so that the edges meeting at a corner never share
+ * both: a channel then holds the distance to its own edges, and the median of the channels rebuilds the outline
+ * with sharp corners at any scale, where a single channel field rounds them. Contours must not overlap, like in
+ * the outlines of most fonts.
+ *
+ * Coordinates are in pixels, y up. The generator has no state besides the outline, so one generator per thread.
+ */
+class CC_DLL MSDFGenerator
+{
+public:
+    /** Removes the outline. */
+    void clear();
+
+    /** Starts a contour. The contours close themselves, the last edge should end where the contour started. */
+    void moveTo(double x, double y);
+    void lineTo(double x, double y);
+    void quadraticTo(double controlX, double controlY, double x, double y);
+    void cubicTo(double control1X, double control1Y, double control2X, double control2Y, double x, double y);
+
+    /** Assigns the channels to the edges. The joins turning more than angleThreshold (radians) are kept as corners. */
+    void colorEdges(double angleThreshold = 3.0);
+
+    /** Renders the field into an RGB image of width x height pixels, 3 bytes per pixel and rows top to bottom.
+     * The pixel (x, y) samples the outline at (left + x + 0.5, top - y - 0.5). A channel is 128 on the edge and moves
+     * by 127.5 every range pixels, above inside the clockwise contours, below outside. invert flips it, for the
+     * counter-clockwise outlines of PostScript fonts.
+     */
+    void generate(unsigned char* image, int width, int height, double left, double top, double range, bool invert = false) const;
+
+private:
+    struct Point
+    {
+        double x;
+        double y;
+
+        Point operator+(const Point& other) const { return Point{x + other.x, y + other.y}; }
+        Point operator-(const Point& other) const { return Point{x - other.x, y - other.y}; }
+        Point operator*(double value) const { return Point{x * value, y * value}; }
+        bool operator==(const Point& other) const { return x == other.x && y == other.y; }
+        double dot(const Point& other) const { return x * other.x + y * other.y; }
+        double cross(const Point& other) const { return x * other.y - y * other.x; }
+        double length() const;
+        Point normalized() const;
+    };
+
+    enum class EdgeType
+    {
+        LINEAR,
+        QUADRATIC,
+        CUBIC,
+    };
+
+    struct Edge
+    {
+        EdgeType type;
+        Point points[4];
+        int color;
+
+        Point pointAt(double t) const;
+        Point direction(double t) const;
+        void splitInThirds(Edge parts[3]) const;
+        double signedDistance(const Point& origin, double& outParam, double& outDot) const;
+        void toPseudoDistance(double& distance, double& dot, const Point& origin, double param) const;
+    };
+
+    void addEdge(EdgeType type, const Point* points, int count);
+
+    std::vector<std::vector<Edge>> _contours;
+    Point _position;
+};
+
+NS_CC_END
+
+/// @endcond
+
+#endif // __CCMSDFGENERATOR_H__
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCTouchSpatialIndex.h"
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
@@ -56,6 +57,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(Node, 64);
+
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are reordered.
 std::uint32_t Node::s_globalOrderOfArrival = 0;
 int Node::__attachedNodeCount = 0;
@@ -96,6 +99,7 @@ Node::Node()
 , _userData(nullptr)
 , _userObject(nullptr)
 , _glProgramState(nullptr)
+, _touchSpatialIndex(nullptr)
 , _running(false)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
@@ -277,8 +281,10 @@ void Node::setLocalZOrder(std::int32_t z)
     {
         _parent->reorderChild(this, z);
     }
-
-    _eventDispatcher->setDirtyForNode(this);
+    else
+    {
+        _eventDispatcher->setDirtyForNode(this);
+    }
 }
 
 /// zOrder setter : private method
@@ -1177,6 +1183,7 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
+    _eventDispatcher->setDirtyForNode(child);
 }
 
 void Node::sortAllChildren()
@@ -1185,7 +1192,6 @@ void Node::sortAllChildren()
     {
         sortNodes(_children);
         _reorderChildDirty = false;
-        _eventDispatcher->setDirtyForNode(this);
     }
 }
 
@@ -1234,7 +1240,11 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     
 
     if(flags & FLAGS_DIRTY_MASK)
+    {
         _modelViewTransform = this->transform(parentTransform);
+        if (_touchSpatialIndex)
+            _touchSpatialIndex->setNodeDirty(this);
+    }
     
     _transformUpdated = false;
     _contentSizeDirty = false;
@@ -39,6 +39,7 @@
 #include "math/CCMath.h"
 #include "2d/CCComponentContainer.h"
 #include "2d/CCComponent.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 #if CC_USE_PHYSICS
 #include "physics/CCPhysicsBody.h"
@@ -55,6 +56,7 @@ class ActionManager;
 class Component;
 class ComponentContainer;
 class EventDispatcher;
+class TouchSpatialIndex;
 class Scene;
 class Renderer;
 class Director;
@@ -109,6 +111,8 @@ class EventListener;
 class CC_DLL Node : public Ref
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Node);
+
     /** Default tag used for all the nodes */
     static const int INVALID_TAG = -1;
 
@@ -1982,6 +1986,8 @@ protected:
 
     EventDispatcher* _eventDispatcher;  ///< event dispatcher used to dispatch all kinds of events
 
+    TouchSpatialIndex* _touchSpatialIndex;  ///< index of the bounds of touch listener nodes told when the transform changes
+
     bool _running;                  ///< is running
 
     bool _visible;                  ///< is this node visible
@@ -2036,6 +2042,11 @@ public:
 
     static int __attachedNodeCount;
     
+    // reads _localZOrder$Arrival to order scene graph priority listeners without walking the scene
+    friend class EventDispatcher;
+    // sets _touchSpatialIndex and reads the transform dirty flags of the nodes it indexes
+    friend class TouchSpatialIndex;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
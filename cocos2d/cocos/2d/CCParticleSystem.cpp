@@ -46,8 +46,16 @@ THE SOFTWARE.
 #include "2d/CCParticleSystem.h"
 
 #include <string>
+#include <algorithm>
+#include <cfloat>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include "2d/CCParticleBatchNode.h"
+#include "2d/ccParticleKernels.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
@@ -79,36 +87,6 @@ NS_CC_BEGIN
 //
 
 
-inline void normalize_point(float x, float y, particle_point* out)
-{
-    float n = x * x + y * y;
-    // Already normalized.
-    if (n == 1.0f)
-        return;
-    
-    n = sqrt(n);
-    // Too close to zero.
-    if (n < MATH_TOLERANCE)
-        return;
-    
-    n = 1.0f / n;
-    out->x = x * n;
-    out->y = y * n;
-}
-
-/**
- A more effect random number getter function, get from ejoy2d.
- */
-inline static float RANDOM_M11(unsigned int *seed) {
-    *seed = *seed * 134775813 + 1;
-    union {
-        uint32_t d;                                     
-        float f;
-    } u;
-    u.d = (((uint32_t)(*seed) & 0x7fff) << 8) | 0x40000000;
-    return u.f - 3.0f;
-}
-
 ParticleData::ParticleData()
 {
     memset(this, 0, sizeof(ParticleData));
@@ -188,6 +166,118 @@ void ParticleData::release()
 
 Vector<ParticleSystem*> ParticleSystem::__allInstances;
 float ParticleSystem::__totalParticleCountFactor = 1.0f;
+std::vector<ParticleSystem*> ParticleSystem::__stagedSystems;
+unsigned int ParticleSystem::__simulationThreadCount = 0;
+
+namespace
+{
+    // below this number of particles the simulation stage doesn't wake the workers up
+    const int SIMULATION_STAGE_MIN_PARTICLES = 2000;
+
+    /** Threads running the jobs of the simulation stage. The calling thread runs jobs too, and every job is
+     run once by a single thread. */
+    class SimulationWorkers
+    {
+    public:
+        SimulationWorkers()
+        : _job(nullptr)
+        , _jobCount(0)
+        , _nextJob(0)
+        , _busyWorkers(0)
+        , _generation(0)
+        , _quit(false)
+        {}
+
+        unsigned int getCount() const { return static_cast<unsigned int>(_threads.size()); }
+
+        void setCount(unsigned int count)
+        {
+            if (count == _threads.size())
+                return;
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _quit = true;
+            _wakeCondition.notify_all();
+            lock.unlock();
+            for (auto& thread : _threads)
+                thread.join();
+            _threads.clear();
+
+            _quit = false;
+            for (unsigned int i = 0; i < count; ++i)
+                _threads.emplace_back(&SimulationWorkers::work, this);
+        }
+
+        /** Calls job(i) for every i in [0, count) and returns once they are all done. */
+        void run(int count, const std::function<void(int)>& job)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _job = &job;
+            _jobCount = count;
+            _nextJob = 0;
+            ++_generation;
+            lock.unlock();
+            _wakeCondition.notify_all();
+
+            runJobs();
+
+            // the workers which took a job are done once they are no longer busy
+            lock.lock();
+            _doneCondition.wait(lock, [this]() { return _busyWorkers == 0; });
+            _job = nullptr;
+        }
+
+    private:
+        void work()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            unsigned int generation = _generation;
+            while (true)
+            {
+                _wakeCondition.wait(lock, [this, generation]() { return _quit || _generation != generation; });
+                if (_quit)
+                    break;
+                generation = _generation;
+
+                // the calling thread may have run every job already
+                if (_nextJob >= _jobCount)
+                    continue;
+
+                ++_busyWorkers;
+                lock.unlock();
+                runJobs();
+                lock.lock();
+                if (--_busyWorkers == 0)
+                    _doneCondition.notify_one();
+            }
+        }
+
+        void runJobs()
+        {
+            int index;
+            while ((index = _nextJob++) < _jobCount)
+                (*_job)(index);
+        }
+
+        std::vector<std::thread> _threads;
+        std::mutex _mutex;
+        std::condition_variable _wakeCondition;
+        std::condition_variable _doneCondition;
+        const std::function<void(int)>* _job;
+        int _jobCount;
+        std::atomic<int> _nextJob;
+        int _busyWorkers;
+        unsigned int _generation;
+        bool _quit;
+    };
+
+    SimulationWorkers* getSimulationWorkers()
+    {
+        // never destroyed, so the workers aren't joined while the process exits
+        static SimulationWorkers* workers = new (std::nothrow) SimulationWorkers();
+        return workers;
+    }
+}
 
 ParticleSystem::ParticleSystem()
 : _isBlendAdditive(false)
@@ -225,6 +315,8 @@ ParticleSystem::ParticleSystem()
 , _positionType(PositionType::FREE)
 , _paused(false)
 , _sourcePositionCompatible(true) // In the furture this member's default value maybe false or be removed.
+, _stagedDeltaTime(0)
+, _isStaged(false)
 {
     modeA.gravity.setZero();
     modeA.speed = 0;
@@ -273,6 +365,70 @@ Vector<ParticleSystem*>& ParticleSystem::getAllParticleSystems()
     return __allInstances;
 }
 
+void ParticleSystem::setSimulationThreadCount(unsigned int count)
+{
+    if (0 == count)
+        count = CC_PARTICLE_SIMULATION_THREADS;
+    if (0 == count)
+        count = std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+
+    // the systems staged with the previous count are simulated as usual, the workers change on the next stage
+    __simulationThreadCount = count;
+    if (1 == count)
+        getSimulationWorkers()->setCount(0);
+}
+
+unsigned int ParticleSystem::getSimulationThreadCount()
+{
+    if (0 == __simulationThreadCount)
+        setSimulationThreadCount(0);
+    return __simulationThreadCount;
+}
+
+void ParticleSystem::runSimulationStage()
+{
+    if (__stagedSystems.empty())
+        return;
+
+    std::vector<ParticleSystem*> systems;
+    systems.swap(__stagedSystems);
+
+    // the biggest systems first, so the threads run out of jobs together
+    std::stable_sort(systems.begin(), systems.end(), [](const ParticleSystem* a, const ParticleSystem* b) {
+        return a->_particleCount > b->_particleCount;
+    });
+
+    int particleCount = 0;
+    for (auto system : systems)
+        particleCount += system->_particleCount;
+
+    auto simulate = [&systems](int index) {
+        ParticleSystem* system = systems[index];
+        system->simulateParticles(system->_stagedDeltaTime);
+    };
+
+    auto workers = getSimulationWorkers();
+    unsigned int threadCount = getSimulationThreadCount();
+    if (threadCount > 1 && systems.size() > 1 && particleCount >= SIMULATION_STAGE_MIN_PARTICLES)
+    {
+        workers->setCount(threadCount - 1);
+        workers->run(static_cast<int>(systems.size()), simulate);
+    }
+    else
+    {
+        for (int i = 0; i < static_cast<int>(systems.size()); ++i)
+            simulate(i);
+    }
+
+    // the buffers are uploaded on the main thread
+    for (auto system : systems)
+    {
+        system->_isStaged = false;
+        system->finishSimulation();
+        system->release();
+    }
+}
+
 void ParticleSystem::setTotalParticleCountFactor(float factor)
 {
     __totalParticleCountFactor = factor;
@@ -612,35 +768,24 @@ void ParticleSystem::addParticles(int count)
 {
     if (_paused)
         return;
-    uint32_t RANDSEED = rand();
+    ParticleKernels::Random random(rand());
 
     int start = _particleCount;
     _particleCount += count;
     
     //life
-    for (int i = start; i < _particleCount ; ++i)
-    {
-        float theLife = _life + _lifeVar * RANDOM_M11(&RANDSEED);
-        _particleData.timeToLive[i] = MAX(0, theLife);
-    }
+    float* timeToLive = _particleData.timeToLive + start;
+    ParticleKernels::fillRandom(random, timeToLive, count, _life, _lifeVar);
+    ParticleKernels::clamp(timeToLive, count, 0, FLT_MAX);
     
     //position
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posx[i] = _sourcePosition.x + _posVar.x * RANDOM_M11(&RANDSEED);
-    }
-    
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posy[i] = _sourcePosition.y + _posVar.y * RANDOM_M11(&RANDSEED);
-    }
+    ParticleKernels::fillRandom(random, _particleData.posx + start, count, _sourcePosition.x, _posVar.x);
+    ParticleKernels::fillRandom(random, _particleData.posy + start, count, _sourcePosition.y, _posVar.y);
     
     //color
 #define SET_COLOR(c, b, v)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
-}
+ParticleKernels::fillRandom(random, c + start, count, b, v);\
+ParticleKernels::clamp(c + start, count, 0, 1);
     
     SET_COLOR(_particleData.colorR, _startColor.r, _startColorVar.r);
     SET_COLOR(_particleData.colorG, _startColor.g, _startColorVar.g);
@@ -653,10 +798,7 @@ c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
     SET_COLOR(_particleData.deltaColorA, _endColor.a, _endColorVar.a);
     
 #define SET_DELTA_COLOR(c, dc)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
-}
+ParticleKernels::computeDeltas(dc + start, c + start, timeToLive, count);
     
     SET_DELTA_COLOR(_particleData.colorR, _particleData.deltaColorR);
     SET_DELTA_COLOR(_particleData.colorG, _particleData.deltaColorG);
@@ -664,20 +806,14 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     SET_DELTA_COLOR(_particleData.colorA, _particleData.deltaColorA);
     
     //size
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.size[i] = _startSize + _startSizeVar * RANDOM_M11(&RANDSEED);
-        _particleData.size[i] = MAX(0, _particleData.size[i]);
-    }
+    ParticleKernels::fillRandom(random, _particleData.size + start, count, _startSize, _startSizeVar);
+    ParticleKernels::clamp(_particleData.size + start, count, 0, FLT_MAX);
     
     if (_endSize != START_SIZE_EQUAL_TO_END_SIZE)
     {
-        for (int i = start; i < _particleCount; ++i)
-        {
-            float endSize = _endSize + _endSizeVar * RANDOM_M11(&RANDSEED);
-            endSize = MAX(0, endSize);
-            _particleData.deltaSize[i] = (endSize - _particleData.size[i]) / _particleData.timeToLive[i];
-        }
+        ParticleKernels::fillRandom(random, _particleData.deltaSize + start, count, _endSize, _endSizeVar);
+        ParticleKernels::clamp(_particleData.deltaSize + start, count, 0, FLT_MAX);
+        ParticleKernels::computeDeltas(_particleData.deltaSize + start, _particleData.size + start, timeToLive, count);
     }
     else
     {
@@ -688,15 +824,9 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     }
     
     // rotation
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.rotation[i] = _startSpin + _startSpinVar * RANDOM_M11(&RANDSEED);
-    }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        float endA = _endSpin + _endSpinVar * RANDOM_M11(&RANDSEED);
-        _particleData.deltaRotation[i] = (endA - _particleData.rotation[i]) / _particleData.timeToLive[i];
-    }
+    ParticleKernels::fillRandom(random, _particleData.rotation + start, count, _startSpin, _startSpinVar);
+    ParticleKernels::fillRandom(random, _particleData.deltaRotation + start, count, _endSpin, _endSpinVar);
+    ParticleKernels::computeDeltas(_particleData.deltaRotation + start, _particleData.rotation + start, timeToLive, count);
     
     // position
     Vec2 pos;
@@ -722,43 +852,25 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         
         // radial accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::fillRandom(random, _particleData.modeA.radialAccel + start, count, modeA.radialAccel, modeA.radialAccelVar);
         
         // tangential accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::fillRandom(random, _particleData.modeA.tangentialAccel + start, count, modeA.tangentialAccel, modeA.tangentialAccelVar);
+        
+        // direction: the angle goes to dirX and the speed to dirY, then both become the vector
+        ParticleKernels::fillRandom(random, _particleData.modeA.dirX + start, count, CC_DEGREES_TO_RADIANS(_angle), CC_DEGREES_TO_RADIANS(_angleVar));
+        ParticleKernels::fillRandom(random, _particleData.modeA.dirY + start, count, modeA.speed, modeA.speedVar);
+        ParticleKernels::polarToCartesian(_particleData.modeA.dirX + start, _particleData.modeA.dirY + start, count);
         
         // rotation is dir
         if( modeA.rotationIsDir )
         {
             for (int i = start; i < _particleCount; ++i)
             {
-                float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED) );
-                Vec2 v(cosf( a ), sinf( a ));
-                float s = modeA.speed + modeA.speedVar * RANDOM_M11(&RANDSEED);
-                Vec2 dir = v * s;
-                _particleData.modeA.dirX[i] = dir.x;//v * s ;
-                _particleData.modeA.dirY[i] = dir.y;
+                Vec2 dir(_particleData.modeA.dirX[i], _particleData.modeA.dirY[i]);
                 _particleData.rotation[i] = -CC_RADIANS_TO_DEGREES(dir.getAngle());
             }
         }
-        else
-        {
-            for (int i = start; i < _particleCount; ++i)
-            {
-                float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED) );
-                Vec2 v(cosf( a ), sinf( a ));
-                float s = modeA.speed + modeA.speedVar * RANDOM_M11(&RANDSEED);
-                Vec2 dir = v * s;
-                _particleData.modeA.dirX[i] = dir.x;//v * s ;
-                _particleData.modeA.dirY[i] = dir.y;
-            }
-        }
         
     }
     
@@ -767,20 +879,10 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         //Need to check by Jacky
         // Set the default diameter of the particle from the source position
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.radius[i] = modeB.startRadius + modeB.startRadiusVar * RANDOM_M11(&RANDSEED);
-        }
-
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.angle[i] = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED));
-        }
-        
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * RANDOM_M11(&RANDSEED));
-        }
+        ParticleKernels::fillRandom(random, _particleData.modeB.radius + start, count, modeB.startRadius, modeB.startRadiusVar);
+        ParticleKernels::fillRandom(random, _particleData.modeB.angle + start, count, CC_DEGREES_TO_RADIANS(_angle), CC_DEGREES_TO_RADIANS(_angleVar));
+        ParticleKernels::fillRandom(random, _particleData.modeB.degreesPerSecond + start, count,
+                                    CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond), CC_DEGREES_TO_RADIANS(modeB.rotatePerSecondVar));
         
         if(modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
         {
@@ -791,11 +893,8 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
         }
         else
         {
-            for (int i = start; i < _particleCount; ++i)
-            {
-                float endRadius = modeB.endRadius + modeB.endRadiusVar * RANDOM_M11(&RANDSEED);
-                _particleData.modeB.deltaRadius[i] = (endRadius - _particleData.modeB.radius[i]) / _particleData.timeToLive[i];
-            }
+            ParticleKernels::fillRandom(random, _particleData.modeB.deltaRadius + start, count, modeB.endRadius, modeB.endRadiusVar);
+            ParticleKernels::computeDeltas(_particleData.modeB.deltaRadius + start, _particleData.modeB.radius + start, timeToLive, count);
         }
     }
 }
@@ -865,6 +964,40 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    // a staged simulation has to be done before the emitter moves on, when update is called twice in a frame
+    if (_isStaged)
+    {
+        __stagedSystems.erase(std::find(__stagedSystems.begin(), __stagedSystems.end(), this));
+        _isStaged = false;
+        simulateParticles(_stagedDeltaTime);
+        finishSimulation();
+        this->autorelease();
+    }
+
+    if (!updateEmitter(dt))
+        return;
+
+    prepareParticleQuads();
+
+    if (getSimulationThreadCount() > 1)
+    {
+        // moved by runSimulationStage with the other systems of the frame
+        _stagedDeltaTime = dt;
+        _isStaged = true;
+        this->retain();
+        __stagedSystems.push_back(this);
+    }
+    else
+    {
+        simulateParticles(dt);
+        finishSimulation();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+bool ParticleSystem::updateEmitter(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -891,151 +1024,72 @@ void ParticleSystem::update(float dt)
         }
     }
     
+    ParticleKernels::add(_particleData.timeToLive, _particleCount, -dt);
+    
+    for (int i = 0; i < _particleCount; ++i)
     {
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.timeToLive[i] -= dt;
-        }
-        
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            if (_particleData.timeToLive[i] <= 0.0f)
-            {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    //switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
-                }
-                --_particleCount;
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        }
-        
-        if (_emitterMode == Mode::GRAVITY)
-        {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
-        }
-        else
+        if (_particleData.timeToLive[i] <= 0.0f)
         {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
+            int j = _particleCount - 1;
+            while (j > 0 && _particleData.timeToLive[j] <= 0)
             {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
+                _particleCount--;
+                j--;
             }
-            
-            for (int i = 0; i < _particleCount; ++i)
+            _particleData.copyParticle(i, _particleCount - 1);
+            if (_batchNode)
             {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
+                //disable the switched particle
+                int currentIndex = _particleData.atlasIndex[i];
+                _batchNode->disableParticle(_atlasIndex + currentIndex);
+                //switch indexes
+                _particleData.atlasIndex[_particleCount - 1] = currentIndex;
             }
-            for (int i = 0; i < _particleCount; ++i)
+            --_particleCount;
+            if( _particleCount == 0 && _isAutoRemoveOnFinish )
             {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+                this->unscheduleUpdate();
+                _parent->removeChild(this, true);
+                return false;
             }
         }
-        
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
-        //size
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
-        }
-        //angle
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
-        }
-        
-        updateParticleQuads();
-        _transformSystemDirty = false;
     }
+    return true;
+}
+
+void ParticleSystem::simulateParticles(float dt)
+{
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        ParticleKernels::updateGravity(_particleData, _particleCount, modeA.gravity.x, modeA.gravity.y, dt, _yCoordFlipped);
+    }
+    else
+    {
+        ParticleKernels::updateRadius(_particleData, _particleCount, dt, _yCoordFlipped);
+    }
+    
+    //color r,g,b,a
+    ParticleKernels::integrate(_particleData.colorR, _particleData.deltaColorR, _particleCount, dt);
+    ParticleKernels::integrate(_particleData.colorG, _particleData.deltaColorG, _particleCount, dt);
+    ParticleKernels::integrate(_particleData.colorB, _particleData.deltaColorB, _particleCount, dt);
+    ParticleKernels::integrate(_particleData.colorA, _particleData.deltaColorA, _particleCount, dt);
+    //size
+    ParticleKernels::integrate(_particleData.size, _particleData.deltaSize, _particleCount, dt);
+    ParticleKernels::clamp(_particleData.size, _particleCount, 0, FLT_MAX);
+    //angle
+    ParticleKernels::integrate(_particleData.rotation, _particleData.deltaRotation, _particleCount, dt);
+    
+    updateParticleQuads();
+    _transformSystemDirty = false;
+}
 
+void ParticleSystem::finishSimulation()
+{
     // only update gl buffer when visible
     if (_visible && ! _batchNode)
     {
         postStep();
     }
-
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 }
 
 void ParticleSystem::updateWithNoTime()
@@ -1043,6 +1097,11 @@ void ParticleSystem::updateWithNoTime()
     this->update(0.0f);
 }
 
+void ParticleSystem::prepareParticleQuads()
+{
+    // should be overridden
+}
+
 void ParticleSystem::updateParticleQuads()
 {
     //should be overridden
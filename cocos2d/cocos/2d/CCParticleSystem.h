@@ -255,6 +255,38 @@ public:
     /** Gets all ParticleSystem references
      */
     static Vector<ParticleSystem*>& getAllParticleSystems();
+
+    /** Sets the number of threads simulating the particle systems, the main thread included.
+     * With more than one thread, update() only emits and removes particles. The systems updated in a frame are then
+     * moved and their quads built together, across the threads, after the Scheduler update and before the scene is
+     * visited. Each system is simulated by a single thread, so the results don't depend on the number of threads.
+     * The systems updated while the Director is paused, e.g. by updateWithNoTime, are simulated before the scene is
+     * visited too.
+     *
+     * With more than one thread, subclasses have to follow this contract:
+     * - updateParticleQuads may run on a simulation thread, concurrently with the other systems. It may only use the
+     *   state of its own system and what prepareParticleQuads, called on the main thread, read from the scene graph.
+     * - An override of update which calls ParticleSystem::update sees the particles emitted and removed, but not yet
+     *   moved nor their quads built; they are once runSimulationStage has run. Keep the count at 1 if such an
+     *   override reads the particles or the quads.
+     *
+     * @param count The number of threads, 1 to fully update every system in update(), 0 for CC_PARTICLE_SIMULATION_THREADS.
+     * @since v3.17
+     * @js NA
+     */
+    static void setSimulationThreadCount(unsigned int count);
+
+    /** Gets the number of threads simulating the particle systems, the main thread included.
+     * @js NA
+     */
+    static unsigned int getSimulationThreadCount();
+
+    /** Simulates the particle systems staged by update() in this frame.
+     * Called by the Director after the Scheduler update, it does nothing if no system is staged.
+     * @js NA
+     * @lua NA
+     */
+    static void runSimulationStage();
 public:
     void addParticles(int count);
     
@@ -270,6 +302,8 @@ public:
 
     /** Update the verts position data of particle,
      should be overridden by subclasses. 
+     It may be called on a simulation thread, see setSimulationThreadCount, so it should only use the state of the
+     system and what prepareParticleQuads read from the scene graph.
      */
     virtual void updateParticleQuads();
     /** Update the VBO verts buffer which does not use batch node,
@@ -823,6 +857,22 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
     virtual void updateBlendFunc();
+
+    /** Reads from the scene graph what updateParticleQuads needs. It is called on the main thread before the
+     particles are simulated, on a simulation thread or not.
+     */
+    virtual void prepareParticleQuads();
+
+    /** Emits the new particles and removes the dead ones.
+     @return False if the system removed itself from its parent.
+     */
+    bool updateEmitter(float dt);
+
+    /** Moves the particles and builds their quads, it only touches the system so it can run on any thread. */
+    void simulateParticles(float dt);
+
+    /** Uploads the quads, on the main thread. */
+    void finishSimulation();
     
 private:
     friend class EngineDataManager;
@@ -993,6 +1043,15 @@ protected:
     bool _sourcePositionCompatible;
 
     static Vector<ParticleSystem*> __allInstances;
+
+    /** time step of the simulation staged for runSimulationStage */
+    float _stagedDeltaTime;
+    /** whether the system waits for runSimulationStage */
+    bool _isStaged;
+
+    /** systems waiting for runSimulationStage, retained */
+    static std::vector<ParticleSystem*> __stagedSystems;
+    static unsigned int __simulationThreadCount;
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
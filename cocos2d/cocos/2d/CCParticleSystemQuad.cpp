@@ -300,21 +300,27 @@ inline void updatePosWithParticle(V3F_C4B_T2F_Quad *quad, const Vec2& newPositio
     quad->tr.vertices.y = cy;
 }
 
-void ParticleSystemQuad::updateParticleQuads()
+void ParticleSystemQuad::prepareParticleQuads()
 {
-    if (_particleCount <= 0) {
-        return;
-    }
- 
-    Vec2 currentPosition;
+    // the transforms are computed here, on the main thread, since they update the cached ones of the ancestors
     if (_positionType == PositionType::FREE)
     {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        _quadsOrigin = this->convertToWorldSpace(Vec2::ZERO);
+        _quadsWorldToNodeTransform = getWorldToNodeTransform();
     }
     else if (_positionType == PositionType::RELATIVE)
     {
-        currentPosition = _position;
+        _quadsOrigin = _position;
     }
+}
+
+void ParticleSystemQuad::updateParticleQuads()
+{
+    if (_particleCount <= 0) {
+        return;
+    }
+ 
+    const Vec2& currentPosition = _quadsOrigin;
     
     V3F_C4B_T2F_Quad *startQuad;
     Vec2 pos = Vec2::ZERO;
@@ -332,7 +338,7 @@ void ParticleSystemQuad::updateParticleQuads()
     if( _positionType == PositionType::FREE )
     {
         Vec3 p1(currentPosition.x, currentPosition.y, 0);
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
+        const Mat4& worldToNodeTM = _quadsWorldToNodeTransform;
         worldToNodeTM.transformPoint(&p1);
         Vec3 p2;
         Vec2 newPos;
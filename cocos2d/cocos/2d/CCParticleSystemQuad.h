@@ -179,12 +179,17 @@ protected:
     void setupVBO();
     bool allocMemory();
 
+    virtual void prepareParticleQuads() override;
+
     V3F_C4B_T2F_Quad    *_quads;        // quads to be rendered
     GLushort            *_indices;      // indices
     GLuint              _VAOname;
     GLuint              _buffersVBO[2]; //0: vertex  1: indices
 
     QuadCommand _quadCommand;           // quad command
+
+    Vec2 _quadsOrigin;                  // emitter position the quads are built from
+    Mat4 _quadsWorldToNodeTransform;    // world to node transform the free particles are built with
     
 
 
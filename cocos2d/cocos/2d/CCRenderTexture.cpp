@@ -39,9 +39,18 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "2d/CCCamera.h"
 #include "renderer/CCTextureCache.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCScheduler.h"
 
 NS_CC_BEGIN
 
+// glReadPixels() can write into a buffer object which is mapped later, desktop OpenGL only
+#if defined(CC_PLATFORM_PC) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && defined(GL_PIXEL_PACK_BUFFER)
+#define CC_RENDER_TEXTURE_USE_PBO 1
+#else
+#define CC_RENDER_TEXTURE_USE_PBO 0
+#endif
+
 // implementation RenderTexture
 RenderTexture::RenderTexture()
 : _keepMatrix(false)
@@ -640,23 +649,7 @@ Image* RenderTexture::newImage(bool flipImage)
             break;
         }
 
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
-
-        // TODO: move this to configuration, so we don't check it every time
-        /*  Certain Qualcomm Adreno GPU's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
-         */
-        if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
-        {
-            // -- bind a temporary texture so we can clear the render buffer without losing our texture
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _textureCopy->getName(), 0);
-            CHECK_GL_ERROR_DEBUG();
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
-        }
-        glPixelStorei(GL_PACK_ALIGNMENT, 1);
-        glReadPixels(0,0,savedBufferWidth, savedBufferHeight,GL_RGBA,GL_UNSIGNED_BYTE, tempData);
-        glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+        readPixels(tempData, savedBufferWidth, savedBufferHeight);
 
         if ( flipImage ) // -- flip is only required when saving image to file
         {
@@ -684,6 +677,202 @@ Image* RenderTexture::newImage(bool flipImage)
     return image;
 }
 
+void RenderTexture::readPixels(GLvoid* data, int width, int height)
+{
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+
+    // TODO: move this to configuration, so we don't check it every time
+    /*  Certain Qualcomm Adreno GPU's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
+     */
+    if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
+    {
+        // -- bind a temporary texture so we can clear the render buffer without losing our texture
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _textureCopy->getName(), 0);
+        CHECK_GL_ERROR_DEBUG();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0,0,width, height,GL_RGBA,GL_UNSIGNED_BYTE, data);
+    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+}
+
+void RenderTexture::newImageAsync(const std::function<void(RenderTexture*, Image*)>& callback, bool flipImage)
+{
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+
+    auto readback = new (std::nothrow) AsyncReadback();
+    readback->flipImage = flipImage;
+    readback->done = [this, callback](Image* image) {
+        if (callback)
+        {
+            callback(this, image);
+        }
+    };
+    startReadback(readback);
+}
+
+bool RenderTexture::saveToFileAsync(const std::string& fileName, Image::Format format, bool isRGBA, const std::function<void (RenderTexture*, const std::string&)>& callback)
+{
+    CCASSERT(format == Image::Format::JPG || format == Image::Format::PNG,
+             "the image can only be saved as JPG or PNG format");
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+    if (isRGBA && format == Image::Format::JPG) CCLOG("RGBA is not supported for JPG format");
+
+    std::string fullpath = FileUtils::getInstance()->getWritablePath() + fileName;
+
+    auto readback = new (std::nothrow) AsyncReadback();
+    readback->process = [fullpath, isRGBA](Image* image) {
+        image->saveToFile(fullpath, !isRGBA);
+    };
+    readback->done = [this, fullpath, callback](Image* /*image*/) {
+        if (callback)
+        {
+            callback(this, fullpath);
+        }
+    };
+    startReadback(readback);
+    return true;
+}
+
+void RenderTexture::startReadback(AsyncReadback* readback)
+{
+    // released once the callback was called
+    retain();
+
+    readback->command.init(_globalZOrder);
+    readback->command.func = CC_CALLBACK_0(RenderTexture::onReadPixelsAsync, this, readback);
+    Director::getInstance()->getRenderer()->addCommand(&readback->command);
+
+    // the readback is the target, so pausing or cleaning up the render texture doesn't lose it
+    Director::getInstance()->getScheduler()->schedule([this, readback](float /*dt*/) {
+        resolveReadback(readback);
+    }, readback, 0, false, "readback");
+}
+
+void RenderTexture::onReadPixelsAsync(AsyncReadback* readback)
+{
+    readback->issued = true;
+    readback->frame = Director::getInstance()->getTotalFrames();
+
+    if (nullptr == _texture)
+    {
+        return;
+    }
+
+    const Size& s = _texture->getContentSizeInPixels();
+    readback->width = (int)s.width;
+    readback->height = (int)s.height;
+    readback->premultipliedAlpha = _texture->hasPremultipliedAlpha();
+    size_t size = readback->width * readback->height * 4;
+
+#if CC_RENDER_TEXTURE_USE_PBO
+    if (Configuration::getInstance()->supportsPixelBufferObject())
+    {
+        glGenBuffers(1, &readback->pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        // the copy is queued, glReadPixels() returns without waiting for the GPU
+        readPixels(nullptr, readback->width, readback->height);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        CHECK_GL_ERROR_DEBUG();
+        return;
+    }
+#endif
+
+    readback->pixels = (unsigned char*)malloc(size);
+    if (readback->pixels)
+    {
+        readPixels(readback->pixels, readback->width, readback->height);
+    }
+}
+
+void RenderTexture::resolveReadback(AsyncReadback* readback)
+{
+    if (!readback->issued)
+    {
+        return;
+    }
+    if (readback->pbo && Director::getInstance()->getTotalFrames() - readback->frame < CC_RENDER_TEXTURE_READBACK_FRAMES)
+    {
+        return;
+    }
+
+    Director::getInstance()->getScheduler()->unschedule("readback", readback);
+
+#if CC_RENDER_TEXTURE_USE_PBO
+    if (readback->pbo)
+    {
+        size_t size = readback->width * readback->height * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+        auto mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (mapped)
+        {
+            readback->pixels = (unsigned char*)malloc(size);
+            if (readback->pixels)
+            {
+                memcpy(readback->pixels, mapped, size);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glDeleteBuffers(1, &readback->pbo);
+        readback->pbo = 0;
+    }
+#endif
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [this, readback](void* /*param*/) {
+        if (readback->done)
+        {
+            readback->done(readback->image);
+        }
+        CC_SAFE_RELEASE(readback->image);
+        delete readback;
+        release();
+    }, nullptr, [readback]() {
+        unsigned char* pixels = readback->pixels;
+        if (nullptr == pixels)
+        {
+            return;
+        }
+
+        int rowSize = readback->width * 4;
+        if (readback->flipImage)
+        {
+            // #640 the image read from rendertexture is upside down, swap the rows in place
+            unsigned char* row = (unsigned char*)malloc(rowSize);
+            if (row)
+            {
+                for (int top = 0, bottom = readback->height - 1; top < bottom; ++top, --bottom)
+                {
+                    memcpy(row, pixels + top * rowSize, rowSize);
+                    memcpy(pixels + top * rowSize, pixels + bottom * rowSize, rowSize);
+                    memcpy(pixels + bottom * rowSize, row, rowSize);
+                }
+                free(row);
+            }
+        }
+
+        auto image = new (std::nothrow) Image();
+        if (image && image->initWithRawData(pixels, rowSize * readback->height, readback->width, readback->height, 8, readback->premultipliedAlpha))
+        {
+            readback->image = image;
+            if (readback->process)
+            {
+                readback->process(image);
+            }
+        }
+        else
+        {
+            CC_SAFE_RELEASE(image);
+        }
+
+        free(pixels);
+        readback->pixels = nullptr;
+    });
+}
+
 void RenderTexture::onBegin()
 {
     //
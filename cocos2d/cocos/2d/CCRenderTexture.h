@@ -199,6 +199,32 @@ public:
      * @return Returns true if the operation is successful.
      */
     bool saveToFile(const std::string& filename, Image::Format format, bool isRGBA = true, const std::function<void (RenderTexture*, const std::string&)>& callback = nullptr);
+
+    /** Creates a new Image from the texture's data without stalling the rendering.
+     * The pixels are read into a pixel buffer object when the renderer executes the command, and mapped
+     * CC_RENDER_TEXTURE_READBACK_FRAMES frames later when the GPU is done with them. The rows are flipped
+     * and the image is created on a worker thread. Where pixel buffer objects are not supported the pixels
+     * are read right away, only the rest of the work is moved to the worker thread.
+     * Several captures can be in flight at the same time, the render texture is retained until they are done.
+     *
+     * @param callback Called on the main thread with the image, or nullptr if it failed. The image is released
+     * once the callback returns, retain it to keep it.
+     * @param flipImage Whether or not to flip image.
+     * @js NA
+     */
+    void newImageAsync(const std::function<void(RenderTexture*, Image*)>& callback, bool flipImage = true);
+
+    /** Saves the texture into a file like saveToFile, but reads it back like newImageAsync and encodes the file
+     * on a worker thread. The format could be JPG or PNG. The file will be saved in the Documents folder.
+     *
+     * @param fileName The file name.
+     * @param format The image format.
+     * @param isRGBA The file is RGBA or not.
+     * @param callback Called on the main thread when the file is saved.
+     * @return Returns true if the operation is successful.
+     * @js NA
+     */
+    bool saveToFileAsync(const std::string& fileName, Image::Format format, bool isRGBA = true, const std::function<void (RenderTexture*, const std::string&)>& callback = nullptr);
     
     /** Listen "come to background" message, and save render texture.
      * It only has effect on Android.
@@ -380,6 +406,25 @@ protected:
     */
     CustomCommand _saveToFileCommand;
     std::function<void (RenderTexture*, const std::string&)> _saveFileCallback;
+
+    /* a capture started by newImageAsync() or saveToFileAsync() */
+    struct AsyncReadback
+    {
+        CustomCommand command;
+        GLuint pbo = 0;
+        unsigned char* pixels = nullptr;
+        Image* image = nullptr;
+        int width = 0;
+        int height = 0;
+        unsigned int frame = 0;
+        bool issued = false;
+        bool flipImage = true;
+        bool premultipliedAlpha = false;
+        // called on the worker thread once the image is created
+        std::function<void(Image*)> process;
+        // called on the main thread at the end
+        std::function<void(Image*)> done;
+    };
 protected:
     //renderer caches and callbacks
     void onBegin();
@@ -390,6 +435,11 @@ protected:
 
     void onSaveToFile(const std::string& fileName, bool isRGBA = true, bool forceNonPMA = false);
 
+    void readPixels(GLvoid* data, int width, int height);
+    void startReadback(AsyncReadback* readback);
+    void onReadPixelsAsync(AsyncReadback* readback);
+    void resolveReadback(AsyncReadback* readback);
+
     void setupDepthAndStencil(int powW, int powH);
     
     Mat4 _oldTransMatrix, _oldProjMatrix;
@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCSkylinePacker.h"
+
+#include <algorithm>
+#include <climits>
+
+NS_CC_BEGIN
+
+SkylinePacker::SkylinePacker(int width, int height)
+{
+    reset(width, height);
+}
+
+void SkylinePacker::reset(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _usedArea = 0;
+    _skyline.clear();
+    _skyline.push_back(Segment{0, 0, width});
+}
+
+bool SkylinePacker::fits(size_t index, int width, int height, int& outY) const
+{
+    int x = _skyline[index].x;
+    if (x + width > _width)
+        return false;
+
+    // the rectangle rests on the highest segment under it
+    int y = 0;
+    int remaining = width;
+    for (size_t i = index; remaining > 0; ++i)
+    {
+        y = std::max(y, _skyline[i].y);
+        if (y + height > _height)
+            return false;
+        remaining -= _skyline[i].width;
+    }
+    outY = y;
+    return true;
+}
+
+bool SkylinePacker::insert(int width, int height, int& outX, int& outY)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    // lowest bottom edge first, then the narrowest segment so wide gaps stay for wide rectangles
+    size_t bestIndex = _skyline.size();
+    int bestBottom = INT_MAX;
+    int bestWidth = INT_MAX;
+    int bestY = 0;
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        int y;
+        if (fits(i, width, height, y))
+        {
+            int bottom = y + height;
+            if (bottom < bestBottom || (bottom == bestBottom && _skyline[i].width < bestWidth))
+            {
+                bestIndex = i;
+                bestBottom = bottom;
+                bestWidth = _skyline[i].width;
+                bestY = y;
+            }
+        }
+    }
+    if (bestIndex == _skyline.size())
+        return false;
+
+    outX = _skyline[bestIndex].x;
+    outY = bestY;
+    _usedArea += (long)width * height;
+
+    // the new segment covers the start of the ones it rests on
+    _skyline.insert(_skyline.begin() + bestIndex, Segment{outX, bestBottom, width});
+    for (size_t i = bestIndex + 1; i < _skyline.size();)
+    {
+        const Segment& previous = _skyline[i - 1];
+        Segment& segment = _skyline[i];
+        int overlap = previous.x + previous.width - segment.x;
+        if (overlap <= 0)
+            break;
+        if (overlap < segment.width)
+        {
+            segment.x += overlap;
+            segment.width -= overlap;
+            break;
+        }
+        _skyline.erase(_skyline.begin() + i);
+    }
+
+    // neighbours at the same height become one segment
+    for (size_t i = 0; i + 1 < _skyline.size();)
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    return true;
+}
+
+NS_CC_END
@@ -0,0 +1,80 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCSKYLINEPACKER_H__
+#define __CCSKYLINEPACKER_H__
+
+/// @cond DO_NOT_SHOW
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/** Packs rectangles into a fixed size area with the skyline bottom-left rule.
+ *
+ * The packer only keeps the top edge of what has been placed, as a list of horizontal segments, and puts every
+ * rectangle where its bottom ends lowest. It wastes little space on rectangles of similar heights, like glyphs,
+ * and an insertion costs a walk over the segments. Rectangles can't be removed, reset() empties the area.
+ */
+class CC_DLL SkylinePacker
+{
+public:
+    SkylinePacker(int width = 0, int height = 0);
+
+    /** Empties the packer and gives it a new size. */
+    void reset(int width, int height);
+
+    /** Finds room for a width x height rectangle.
+     * @return false if it doesn't fit anywhere, the packer is unchanged then.
+     */
+    bool insert(int width, int height, int& outX, int& outY);
+
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+
+    /** Area covered by the inserted rectangles. */
+    long getUsedArea() const { return _usedArea; }
+
+private:
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    bool fits(size_t index, int width, int height, int& outY) const;
+
+    std::vector<Segment> _skyline;
+    int _width;
+    int _height;
+    long _usedArea;
+};
+
+NS_CC_END
+
+/// @endcond
+#endif // __CCSKYLINEPACKER_H__
@@ -40,9 +40,12 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
+#include "2d/CCClippingNode.h"
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(Sprite, 128);
+
 // MARK: create, init, dealloc
 Sprite* Sprite::createWithTexture(Texture2D *texture)
 {
@@ -1071,11 +1074,17 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if(_insideBounds)
 #endif
     {
+        // inside a clipping node that doesn't use the stencil buffer, only the part inside its stencil is drawn
+        auto triangles = _polyInfo.triangles;
+        auto clippingNode = ClippingNode::getVisitingClippingNode();
+        if (clippingNode && !clippingNode->clipTriangles(transform, _polyInfo.triangles, &triangles))
+            return;
+
         _trianglesCommand.init(_globalZOrder,
                                _texture,
                                getGLProgramState(),
                                _blendFunc,
-                               _polyInfo.triangles,
+                               triangles,
                                transform,
                                flags);
 
@@ -31,11 +31,14 @@ THE SOFTWARE.
 #include "2d/CCSpriteFrameCache.h"
 
 #include <vector>
+#include <algorithm>
+#include <unordered_map>
 
 
 #include "2d/CCSprite.h"
 #include "2d/CCAutoPolygon.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCPlistReader.h"
 #include "base/CCNS.h"
 #include "base/ccMacros.h"
 #include "base/ccUTF8.h"
@@ -51,6 +54,428 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+namespace
+{
+    // binary sprite sheets, see the layout in CCSpriteFrameCache.h
+    const uint32_t BINARY_SHEET_VERSION = 1;
+    const uint32_t BINARY_FRAME_ROTATED = 1;
+    const uint32_t BINARY_FRAME_HAS_ANCHOR = 2;
+
+    struct BinarySheetHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t frameCount;
+        uint32_t aliasCount;
+        uint32_t polygonDataCount;
+        uint32_t stringTableSize;
+        float textureWidth;
+        float textureHeight;
+        uint32_t textureFileNameOffset;
+        uint32_t textureFileNameLength;
+        uint32_t pixelFormatOffset;
+        uint32_t pixelFormatLength;
+    };
+
+    struct BinarySheetFrame
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        float x;
+        float y;
+        float width;
+        float height;
+        float offsetX;
+        float offsetY;
+        float sourceWidth;
+        float sourceHeight;
+        float anchorX;
+        float anchorY;
+        uint32_t flags;
+        uint32_t polygonDataIndex;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+    };
+
+    struct BinarySheetAlias
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t frameIndex;
+    };
+
+    // the records of a binary sprite sheet, pointing into its data
+    struct BinarySheet
+    {
+        const BinarySheetHeader* header;
+        const BinarySheetFrame* frames;
+        const BinarySheetAlias* aliases;
+        const int* polygonData;
+        const char* strings;
+
+        bool init(const Data& data);
+
+        std::string getString(uint32_t offset, uint32_t length) const
+        {
+            return std::string(strings + offset, length);
+        }
+    };
+
+    bool isBinarySheet(const Data& data)
+    {
+        return data.getSize() >= static_cast<ssize_t>(sizeof(BinarySheetHeader)) && memcmp(data.getBytes(), "CCSF", 4) == 0;
+    }
+
+    bool BinarySheet::init(const Data& data)
+    {
+        if (!isBinarySheet(data))
+            return false;
+
+        header = reinterpret_cast<const BinarySheetHeader*>(data.getBytes());
+        const uint64_t size = sizeof(BinarySheetHeader)
+            + static_cast<uint64_t>(header->frameCount) * sizeof(BinarySheetFrame)
+            + static_cast<uint64_t>(header->aliasCount) * sizeof(BinarySheetAlias)
+            + static_cast<uint64_t>(header->polygonDataCount) * sizeof(int32_t)
+            + header->stringTableSize;
+        if (header->version != BINARY_SHEET_VERSION || size > static_cast<uint64_t>(data.getSize()))
+            return false;
+
+        frames = reinterpret_cast<const BinarySheetFrame*>(header + 1);
+        aliases = reinterpret_cast<const BinarySheetAlias*>(frames + header->frameCount);
+        polygonData = reinterpret_cast<const int*>(aliases + header->aliasCount);
+        strings = reinterpret_cast<const char*>(polygonData + header->polygonDataCount);
+
+        auto isString = [this](uint32_t offset, uint32_t length) {
+            return offset <= header->stringTableSize && length <= header->stringTableSize - offset;
+        };
+        if (!isString(header->textureFileNameOffset, header->textureFileNameLength) || !isString(header->pixelFormatOffset, header->pixelFormatLength))
+            return false;
+
+        for (uint32_t i = 0; i < header->frameCount; ++i)
+        {
+            const BinarySheetFrame& frame = frames[i];
+            const uint64_t polygonDataEnd = static_cast<uint64_t>(frame.polygonDataIndex) + 4 * static_cast<uint64_t>(frame.vertexCount) + frame.indexCount;
+            if (!isString(frame.nameOffset, frame.nameLength) || polygonDataEnd > header->polygonDataCount)
+                return false;
+
+            const int* indices = polygonData + frame.polygonDataIndex + 4 * frame.vertexCount;
+            for (uint32_t j = 0; j < frame.indexCount; ++j)
+            {
+                if (indices[j] < 0 || static_cast<uint32_t>(indices[j]) >= frame.vertexCount)
+                    return false;
+            }
+        }
+
+        for (uint32_t i = 0; i < header->aliasCount; ++i)
+        {
+            if (!isString(aliases[i].nameOffset, aliases[i].nameLength) || aliases[i].frameIndex >= header->frameCount)
+                return false;
+        }
+        return true;
+    }
+
+    // the strings of a binary sprite sheet, each one is stored once
+    class BinarySheetStrings
+    {
+    public:
+        void add(const std::string& text, uint32_t& offset, uint32_t& length)
+        {
+            auto iter = _offsets.find(text);
+            if (iter == _offsets.end())
+            {
+                iter = _offsets.emplace(text, static_cast<uint32_t>(_data.size())).first;
+                _data += text;
+            }
+            offset = iter->second;
+            length = static_cast<uint32_t>(text.size());
+        }
+
+        const std::string& getData() const { return _data; }
+
+    private:
+        std::string _data;
+        std::unordered_map<std::string, uint32_t> _offsets;
+    };
+}
+
+struct SpriteFrameCache::PlistSheet
+{
+    struct Frame
+    {
+        std::string name;
+
+        // format 0
+        float x = 0;
+        float y = 0;
+        float width = 0;
+        float height = 0;
+        float offsetX = 0;
+        float offsetY = 0;
+        int originalWidth = 0;
+        int originalHeight = 0;
+
+        // formats 1 and 2
+        Rect frame;
+        bool rotated = false;
+        Vec2 offset;
+        Size sourceSize;
+
+        // format 3
+        Size spriteSize;
+        Vec2 spriteOffset;
+        Size spriteSourceSize;
+        Rect textureRect;
+        bool textureRotated = false;
+        std::vector<std::string> aliases;
+        bool hasPolygon = false;
+        std::vector<int> vertices;
+        std::vector<int> verticesUV;
+        std::vector<int> triangles;
+        bool hasAnchor = false;
+        Vec2 anchor;
+    };
+
+    struct Metadata
+    {
+        int format = 0;
+        Size size;
+        std::string textureFileName;
+        std::string pixelFormat;
+    };
+
+    bool hasFrames = false;
+    std::vector<Frame> frames;
+    Metadata metadata;
+};
+
+bool SpriteFrameCache::readPlistSheet(const char* data, size_t size, PlistSheet& sheet)
+{
+    typedef PlistSheet::Frame Frame;
+    static const PlistSchema<Frame> frameSchema = PlistSchema<Frame>()
+        .field("x", &Frame::x)
+        .field("y", &Frame::y)
+        .field("width", &Frame::width)
+        .field("height", &Frame::height)
+        .field("offsetX", &Frame::offsetX)
+        .field("offsetY", &Frame::offsetY)
+        .field("originalWidth", &Frame::originalWidth)
+        .field("originalHeight", &Frame::originalHeight)
+        .field("frame", &Frame::frame)
+        .field("rotated", &Frame::rotated)
+        .field("offset", &Frame::offset)
+        .field("sourceSize", &Frame::sourceSize)
+        .field("spriteSize", &Frame::spriteSize)
+        .field("spriteOffset", &Frame::spriteOffset)
+        .field("spriteSourceSize", &Frame::spriteSourceSize)
+        .field("textureRect", &Frame::textureRect)
+        .field("textureRotated", &Frame::textureRotated)
+        .field("aliases", &Frame::aliases)
+        .field("vertices", [](PlistReader& reader, Frame& frame) {
+            frame.hasPolygon = true;
+            return reader.readIntegerList(frame.vertices);
+        })
+        .field("verticesUV", &Frame::verticesUV)
+        .field("triangles", &Frame::triangles)
+        .field("anchor", [](PlistReader& reader, Frame& frame) {
+            frame.hasAnchor = true;
+            return reader.readVec2(frame.anchor);
+        });
+
+    typedef PlistSheet::Metadata Metadata;
+    static const PlistSchema<Metadata> metadataSchema = PlistSchema<Metadata>()
+        .field("format", &Metadata::format)
+        .field("size", &Metadata::size)
+        .field("textureFileName", &Metadata::textureFileName)
+        .field("pixelFormat", &Metadata::pixelFormat);
+
+    static const PlistSchema<PlistSheet> sheetSchema = PlistSchema<PlistSheet>()
+        .field("frames", [](PlistReader& reader, PlistSheet& sheet) {
+            if (reader.getToken() != PlistReader::Token::DICT_BEGIN)
+                return reader.skipValue();
+
+            sheet.hasFrames = true;
+            while (reader.next() == PlistReader::Token::KEY)
+            {
+                Frame frame;
+                reader.readString(frame.name);
+                if (reader.next() != PlistReader::Token::DICT_BEGIN)
+                {
+                    if (!reader.skipValue())
+                        return false;
+                    continue;
+                }
+                if (!frameSchema.read(reader, frame))
+                    return false;
+                sheet.frames.push_back(std::move(frame));
+            }
+            return reader.getToken() == PlistReader::Token::DICT_END;
+        })
+        .field("metadata", [](PlistReader& reader, PlistSheet& sheet) {
+            if (reader.getToken() != PlistReader::Token::DICT_BEGIN)
+                return reader.skipValue();
+            return metadataSchema.read(reader, sheet.metadata);
+        });
+
+    PlistReader reader(data, size);
+    reader.next();
+    if (sheetSchema.read(reader, sheet))
+        return true;
+
+    // plists the reader doesn't support, like the binary ones FileUtils reads on Apple platforms
+    ValueMap dictionary = FileUtils::getInstance()->getValueMapFromData(data, static_cast<int>(size));
+    if (dictionary.empty())
+        return false;
+    sheet = PlistSheet();
+    readPlistSheet(dictionary, sheet);
+    return true;
+}
+
+void SpriteFrameCache::readPlistSheet(ValueMap& dictionary, PlistSheet& sheet)
+{
+    auto framesIter = dictionary.find("frames");
+    if (framesIter == dictionary.end() || framesIter->second.getType() != Value::Type::MAP)
+        return;
+
+    sheet.hasFrames = true;
+    ValueMap& framesDict = framesIter->second.asValueMap();
+    sheet.frames.reserve(framesDict.size());
+    for (auto& iter : framesDict)
+    {
+        ValueMap& frameDict = iter.second.asValueMap();
+        PlistSheet::Frame frame;
+        frame.name = iter.first;
+        for (auto& field : frameDict)
+        {
+            const std::string& key = field.first;
+            Value& value = field.second;
+            if (key == "x") frame.x = value.asFloat();
+            else if (key == "y") frame.y = value.asFloat();
+            else if (key == "width") frame.width = value.asFloat();
+            else if (key == "height") frame.height = value.asFloat();
+            else if (key == "offsetX") frame.offsetX = value.asFloat();
+            else if (key == "offsetY") frame.offsetY = value.asFloat();
+            else if (key == "originalWidth") frame.originalWidth = value.asInt();
+            else if (key == "originalHeight") frame.originalHeight = value.asInt();
+            else if (key == "frame") frame.frame = RectFromString(value.asString());
+            else if (key == "rotated") frame.rotated = value.asBool();
+            else if (key == "offset") frame.offset = PointFromString(value.asString());
+            else if (key == "sourceSize") frame.sourceSize = SizeFromString(value.asString());
+            else if (key == "spriteSize") frame.spriteSize = SizeFromString(value.asString());
+            else if (key == "spriteOffset") frame.spriteOffset = PointFromString(value.asString());
+            else if (key == "spriteSourceSize") frame.spriteSourceSize = SizeFromString(value.asString());
+            else if (key == "textureRect") frame.textureRect = RectFromString(value.asString());
+            else if (key == "textureRotated") frame.textureRotated = value.asBool();
+            else if (key == "aliases")
+            {
+                for (const auto& alias : value.asValueVector())
+                    frame.aliases.push_back(alias.asString());
+            }
+            else if (key == "vertices")
+            {
+                frame.hasPolygon = true;
+                frame.vertices = utils::parseIntegerList(value.asString());
+            }
+            else if (key == "verticesUV") frame.verticesUV = utils::parseIntegerList(value.asString());
+            else if (key == "triangles") frame.triangles = utils::parseIntegerList(value.asString());
+            else if (key == "anchor")
+            {
+                frame.hasAnchor = true;
+                frame.anchor = PointFromString(value.asString());
+            }
+        }
+        sheet.frames.push_back(std::move(frame));
+    }
+
+    auto metaIter = dictionary.find("metadata");
+    if (metaIter != dictionary.end() && metaIter->second.getType() == Value::Type::MAP)
+    {
+        ValueMap& metadataDict = metaIter->second.asValueMap();
+        auto valueIter = metadataDict.find("format");
+        if (valueIter != metadataDict.end())
+            sheet.metadata.format = valueIter->second.asInt();
+        valueIter = metadataDict.find("size");
+        if (valueIter != metadataDict.end())
+            sheet.metadata.size = SizeFromString(valueIter->second.asString());
+        valueIter = metadataDict.find("textureFileName");
+        if (valueIter != metadataDict.end())
+            sheet.metadata.textureFileName = valueIter->second.asString();
+        valueIter = metadataDict.find("pixelFormat");
+        if (valueIter != metadataDict.end())
+            sheet.metadata.pixelFormat = valueIter->second.asString();
+    }
+}
+
+static ValueMap getValueMapFromSpriteSheetData(const Data& data)
+{
+    if (data.isNull())
+        return ValueMap();
+    return FileUtils::getInstance()->getValueMapFromData(reinterpret_cast<const char*>(data.getBytes()), static_cast<int>(data.getSize()));
+}
+
+static std::string getSpriteSheetTexturePath(const std::string& textureFileName, const std::string& plist)
+{
+    if (!textureFileName.empty())
+    {
+        // build texture path relative to plist file
+        return FileUtils::getInstance()->fullPathFromRelativeFile(textureFileName, plist);
+    }
+
+    // build texture path by replacing file extension
+    std::string texturePath = plist;
+
+    // remove .xxx
+    size_t startPos = texturePath.find_last_of('.');
+    if(startPos != string::npos)
+    {
+        texturePath = texturePath.erase(startPos);
+    }
+
+    // append .png
+    texturePath = texturePath.append(".png");
+
+    CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    return texturePath;
+}
+
+static Texture2D* addSpriteSheetTexture(const std::string& texturePath, const std::string& pixelFormatName)
+{
+    Texture2D *texture = nullptr;
+    static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
+        {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
+        {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
+        {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
+        {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
+        {"RGB565", Texture2D::PixelFormat::RGB565},
+        {"A8", Texture2D::PixelFormat::A8},
+        {"ALPHA", Texture2D::PixelFormat::A8},
+        {"I8", Texture2D::PixelFormat::I8},
+        {"AI88", Texture2D::PixelFormat::AI88},
+        {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
+        //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
+        {"RGB888", Texture2D::PixelFormat::RGB888}
+    };
+
+    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
+    if (pixelFormatIt != pixelFormats.end())
+    {
+        const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
+        const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
+    }
+    else
+    {
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+    }
+
+    if (!texture)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+    }
+    return texture;
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -85,13 +510,23 @@ void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
                                              const std::vector<int> &triangleIndices,
                                              PolygonInfo &info)
 {
-    size_t vertexCount = vertices.size();
-    size_t indexCount = triangleIndices.size();
-    
+    initializePolygonInfo(textureSize, spriteSize, vertices.data(), verticesUV.data(), vertices.size() / 2,
+                          triangleIndices.data(), triangleIndices.size(), info);
+}
+
+void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
+                                             const Size &spriteSize,
+                                             const int *vertices,
+                                             const int *verticesUV,
+                                             size_t vertexCount,
+                                             const int *triangleIndices,
+                                             size_t indexCount,
+                                             PolygonInfo &info)
+{
     float scaleFactor = CC_CONTENT_SCALE_FACTOR();
 
     V3F_C4B_T2F *vertexData = new (std::nothrow) V3F_C4B_T2F[vertexCount];
-    for (size_t i = 0; i < vertexCount/2; i++)
+    for (size_t i = 0; i < vertexCount; i++)
     {
         vertexData[i].colors = Color4B::WHITE;
         vertexData[i].vertices = Vec3(vertices[i*2] / scaleFactor,
@@ -115,6 +550,13 @@ void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
 }
 
 void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D* texture, const std::string &plist)
+{
+    PlistSheet sheet;
+    readPlistSheet(dictionary, sheet);
+    addSpriteFramesWithPlistSheet(sheet, texture, plist);
+}
+
+void SpriteFrameCache::addSpriteFramesWithPlistSheet(const PlistSheet& sheet, Texture2D* texture, const std::string &plist)
 {
     /*
     Supported Zwoptex Formats:
@@ -127,26 +569,11 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
     Version 3 with TexturePacker 4.0 polygon mesh packing
     */
 
-    if (dictionary["frames"].getType() != cocos2d::Value::Type::MAP)
+    if (!sheet.hasFrames)
         return;
 
-    ValueMap& framesDict = dictionary["frames"].asValueMap();
-    int format = 0;
-
-    Size textureSize;
-
-    // get the format
-    auto metaItr = dictionary.find("metadata");
-    if (metaItr != dictionary.end())
-    {
-        ValueMap& metadataDict = metaItr->second.asValueMap();
-        format = metadataDict["format"].asInt();
-
-        if(metadataDict.find("size") != metadataDict.end())
-        {
-            textureSize = SizeFromString(metadataDict["size"].asString());
-        }
-    }
+    const int format = sheet.metadata.format;
+    const Size& textureSize = sheet.metadata.size;
 
     // check the format
     CCASSERT(format >=0 && format <= 3, "format is not supported for SpriteFrameCache addSpriteFramesWithDictionary:textureFilename:");
@@ -154,10 +581,9 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
     auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
     Image* image = nullptr;
     NinePatchImageParser parser;
-    for (auto& iter : framesDict)
+    for (const auto& frame : sheet.frames)
     {
-        ValueMap& frameDict = iter.second.asValueMap();
-        std::string spriteFrameName = iter.first;
+        const std::string& spriteFrameName = frame.name;
         SpriteFrame* spriteFrame = _spriteFramesCache.at(spriteFrameName);
         if (spriteFrame)
         {
@@ -166,14 +592,8 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
         
         if(format == 0) 
         {
-            float x = frameDict["x"].asFloat();
-            float y = frameDict["y"].asFloat();
-            float w = frameDict["width"].asFloat();
-            float h = frameDict["height"].asFloat();
-            float ox = frameDict["offsetX"].asFloat();
-            float oy = frameDict["offsetY"].asFloat();
-            int ow = frameDict["originalWidth"].asInt();
-            int oh = frameDict["originalHeight"].asInt();
+            int ow = frame.originalWidth;
+            int oh = frame.originalHeight;
             // check ow/oh
             if(!ow || !oh)
             {
@@ -184,48 +604,29 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
             oh = std::abs(oh);
             // create frame
             spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         Rect(x, y, w, h),
+                                                         Rect(frame.x, frame.y, frame.width, frame.height),
                                                          false,
-                                                         Vec2(ox, oy),
+                                                         Vec2(frame.offsetX, frame.offsetY),
                                                          Size((float)ow, (float)oh)
                                                          );
         } 
         else if(format == 1 || format == 2) 
         {
-            Rect frame = RectFromString(frameDict["frame"].asString());
-            bool rotated = false;
-
             // rotation
-            if (format == 2)
-            {
-                rotated = frameDict["rotated"].asBool();
-            }
-
-            Vec2 offset = PointFromString(frameDict["offset"].asString());
-            Size sourceSize = SizeFromString(frameDict["sourceSize"].asString());
+            bool rotated = format == 2 && frame.rotated;
 
             // create frame
             spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         frame,
+                                                         frame.frame,
                                                          rotated,
-                                                         offset,
-                                                         sourceSize
+                                                         frame.offset,
+                                                         frame.sourceSize
                                                          );
         } 
         else if (format == 3)
         {
-            // get values
-            Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
-            Vec2 spriteOffset = PointFromString(frameDict["spriteOffset"].asString());
-            Size spriteSourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
-            Rect textureRect = RectFromString(frameDict["textureRect"].asString());
-            bool textureRotated = frameDict["textureRotated"].asBool();
-
             // get aliases
-            ValueVector& aliases = frameDict["aliases"].asValueVector();
-
-            for(const auto &value : aliases) {
-                std::string oneAlias = value.asString();
+            for(const auto &oneAlias : frame.aliases) {
                 if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
                 {
                     CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
@@ -236,25 +637,20 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
 
             // create frame
             spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height),
-                                                         textureRotated,
-                                                         spriteOffset,
-                                                         spriteSourceSize);
+                                                         Rect(frame.textureRect.origin.x, frame.textureRect.origin.y, frame.spriteSize.width, frame.spriteSize.height),
+                                                         frame.textureRotated,
+                                                         frame.spriteOffset,
+                                                         frame.spriteSourceSize);
 
-            if(frameDict.find("vertices") != frameDict.end())
+            if (frame.hasPolygon)
             {
-                using cocos2d::utils::parseIntegerList;
-                std::vector<int> vertices = parseIntegerList(frameDict["vertices"].asString());
-                std::vector<int> verticesUV = parseIntegerList(frameDict["verticesUV"].asString());
-                std::vector<int> indices = parseIntegerList(frameDict["triangles"].asString());
-
                 PolygonInfo info;
-                initializePolygonInfo(textureSize, spriteSourceSize, vertices, verticesUV, indices, info);
+                initializePolygonInfo(textureSize, frame.spriteSourceSize, frame.vertices, frame.verticesUV, frame.triangles, info);
                 spriteFrame->setPolygonInfo(info);
             }
-            if (frameDict.find("anchor") != frameDict.end())
+            if (frame.hasAnchor)
             {
-                spriteFrame->setAnchorPoint(PointFromString(frameDict["anchor"].asString()));
+                spriteFrame->setAnchorPoint(frame.anchor);
             }
         }
 
@@ -287,66 +683,284 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
         }
     }
     
-    Texture2D *texture = nullptr;
-    static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
-        {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
-        {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
-        {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
-        {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
-        {"RGB565", Texture2D::PixelFormat::RGB565},
-        {"A8", Texture2D::PixelFormat::A8},
-        {"ALPHA", Texture2D::PixelFormat::A8},
-        {"I8", Texture2D::PixelFormat::I8},
-        {"AI88", Texture2D::PixelFormat::AI88},
-        {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
-        //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
-        {"RGB888", Texture2D::PixelFormat::RGB888}
-    };
+    Texture2D *texture = addSpriteSheetTexture(texturePath, pixelFormatName);
+    if (texture)
+    {
+        addSpriteFramesWithDictionary(dict, texture, plist);
+    }
+}
 
-    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
-    if (pixelFormatIt != pixelFormats.end())
+void SpriteFrameCache::addSpriteFramesWithBinaryData(const Data& data, Texture2D* texture, const std::string &sheet)
+{
+    BinarySheet binarySheet;
+    if (!binarySheet.init(data))
     {
-        const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
-        const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
-        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
+        CCLOG("cocos2d: SpriteFrameCache: invalid binary sprite sheet %s", sheet.c_str());
+        return;
     }
-    else
+
+    const BinarySheetHeader* header = binarySheet.header;
+    const Size textureSize(header->textureWidth, header->textureHeight);
+
+    auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+    std::string spriteFrameName;
+    for (uint32_t i = 0; i < header->frameCount; ++i)
     {
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        const BinarySheetFrame& frame = binarySheet.frames[i];
+        spriteFrameName.assign(binarySheet.strings + frame.nameOffset, frame.nameLength);
+        if (_spriteFramesCache.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        const Size sourceSize(frame.sourceWidth, frame.sourceHeight);
+        SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                                  Rect(frame.x, frame.y, frame.width, frame.height),
+                                                                  (frame.flags & BINARY_FRAME_ROTATED) != 0,
+                                                                  Vec2(frame.offsetX, frame.offsetY),
+                                                                  sourceSize);
+
+        if (frame.indexCount > 0)
+        {
+            // vertices, then UVs, then indices
+            const int* vertices = binarySheet.polygonData + frame.polygonDataIndex;
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, sourceSize, vertices, vertices + 2 * frame.vertexCount, frame.vertexCount,
+                                  vertices + 4 * frame.vertexCount, frame.indexCount, info);
+            spriteFrame->setPolygonInfo(info);
+        }
+        if (frame.flags & BINARY_FRAME_HAS_ANCHOR)
+        {
+            spriteFrame->setAnchorPoint(Vec2(frame.anchorX, frame.anchorY));
+        }
+
+        if (NinePatchImageParser::isNinePatchImage(spriteFrameName))
+        {
+            if (image == nullptr) {
+                image = new (std::nothrow) Image();
+                image->initWithImageFile(textureFileName);
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+        }
+        // add sprite frame
+        _spriteFramesCache.insertFrame(sheet, spriteFrameName, spriteFrame);
     }
-    
-    if (texture)
+
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
     {
-        addSpriteFramesWithDictionary(dict, texture, plist);
+        const BinarySheetAlias& alias = binarySheet.aliases[i];
+        const BinarySheetFrame& frame = binarySheet.frames[alias.frameIndex];
+        std::string oneAlias = binarySheet.getString(alias.nameOffset, alias.nameLength);
+        if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+        }
+
+        _spriteFramesAliases[oneAlias] = Value(binarySheet.getString(frame.nameOffset, frame.nameLength));
     }
-    else
+
+    _spriteFramesCache.markPlistFull(sheet, true);
+    CC_SAFE_DELETE(image);
+}
+
+Data SpriteFrameCache::createBinaryDataWithDictionary(ValueMap& dictionary)
+{
+    PlistSheet sheet;
+    readPlistSheet(dictionary, sheet);
+    const int format = sheet.metadata.format;
+    if (!sheet.hasFrames || format < 0 || format > 3)
+        return Data::Null;
+
+    BinarySheetStrings strings;
+    BinarySheetHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "CCSF", 4);
+    header.version = BINARY_SHEET_VERSION;
+    header.textureWidth = sheet.metadata.size.width;
+    header.textureHeight = sheet.metadata.size.height;
+    strings.add(sheet.metadata.textureFileName, header.textureFileNameOffset, header.textureFileNameLength);
+    strings.add(sheet.metadata.pixelFormat, header.pixelFormatOffset, header.pixelFormatLength);
+
+    // sorted by name, like the converter writes them
+    std::vector<const PlistSheet::Frame*> sortedFrames;
+    sortedFrames.reserve(sheet.frames.size());
+    for (const auto& frame : sheet.frames)
+        sortedFrames.push_back(&frame);
+    std::sort(sortedFrames.begin(), sortedFrames.end(), [](const PlistSheet::Frame* a, const PlistSheet::Frame* b) {
+        return a->name < b->name;
+    });
+
+    std::vector<BinarySheetFrame> frames(sortedFrames.size());
+    std::vector<BinarySheetAlias> aliases;
+    std::vector<int32_t> polygonData;
+    for (size_t i = 0; i < sortedFrames.size(); ++i)
     {
-        CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        const PlistSheet::Frame& frame = *sortedFrames[i];
+        BinarySheetFrame& record = frames[i];
+        memset(&record, 0, sizeof(record));
+        strings.add(frame.name, record.nameOffset, record.nameLength);
+        record.polygonDataIndex = static_cast<uint32_t>(polygonData.size());
+
+        // the same values addSpriteFramesWithPlistSheet creates the sprite frame with
+        Rect rect;
+        Vec2 offset;
+        Size sourceSize;
+        bool rotated = false;
+        if (format == 0)
+        {
+            rect.setRect(frame.x, frame.y, frame.width, frame.height);
+            offset.set(frame.offsetX, frame.offsetY);
+            sourceSize.setSize((float)std::abs(frame.originalWidth), (float)std::abs(frame.originalHeight));
+        }
+        else if (format == 1 || format == 2)
+        {
+            rect = frame.frame;
+            rotated = format == 2 && frame.rotated;
+            offset = frame.offset;
+            sourceSize = frame.sourceSize;
+        }
+        else
+        {
+            rect.setRect(frame.textureRect.origin.x, frame.textureRect.origin.y, frame.spriteSize.width, frame.spriteSize.height);
+            rotated = frame.textureRotated;
+            offset = frame.spriteOffset;
+            sourceSize = frame.spriteSourceSize;
+
+            if (frame.hasPolygon)
+            {
+                if (frame.vertices.size() != frame.verticesUV.size() || frame.vertices.size() % 2 != 0)
+                {
+                    CCLOG("cocos2d: SpriteFrameCache: %s has invalid polygon vertices", frame.name.c_str());
+                    return Data::Null;
+                }
+                record.vertexCount = static_cast<uint32_t>(frame.vertices.size() / 2);
+                record.indexCount = static_cast<uint32_t>(frame.triangles.size());
+                polygonData.insert(polygonData.end(), frame.vertices.begin(), frame.vertices.end());
+                polygonData.insert(polygonData.end(), frame.verticesUV.begin(), frame.verticesUV.end());
+                polygonData.insert(polygonData.end(), frame.triangles.begin(), frame.triangles.end());
+            }
+            if (frame.hasAnchor)
+            {
+                record.flags |= BINARY_FRAME_HAS_ANCHOR;
+                record.anchorX = frame.anchor.x;
+                record.anchorY = frame.anchor.y;
+            }
+            for (const auto& oneAlias : frame.aliases)
+            {
+                BinarySheetAlias alias;
+                strings.add(oneAlias, alias.nameOffset, alias.nameLength);
+                alias.frameIndex = static_cast<uint32_t>(i);
+                aliases.push_back(alias);
+            }
+        }
+
+        record.x = rect.origin.x;
+        record.y = rect.origin.y;
+        record.width = rect.size.width;
+        record.height = rect.size.height;
+        record.offsetX = offset.x;
+        record.offsetY = offset.y;
+        record.sourceWidth = sourceSize.width;
+        record.sourceHeight = sourceSize.height;
+        if (rotated)
+            record.flags |= BINARY_FRAME_ROTATED;
     }
+
+    header.frameCount = static_cast<uint32_t>(frames.size());
+    header.aliasCount = static_cast<uint32_t>(aliases.size());
+    header.polygonDataCount = static_cast<uint32_t>(polygonData.size());
+    header.stringTableSize = static_cast<uint32_t>(strings.getData().size());
+
+    // the records are read in place, all the supported platforms are little endian
+    const size_t framesSize = frames.size() * sizeof(BinarySheetFrame);
+    const size_t aliasesSize = aliases.size() * sizeof(BinarySheetAlias);
+    const size_t polygonDataSize = polygonData.size() * sizeof(int32_t);
+    const size_t size = sizeof(header) + framesSize + aliasesSize + polygonDataSize + header.stringTableSize;
+    auto bytes = static_cast<unsigned char*>(malloc(size));
+    if (bytes == nullptr)
+        return Data::Null;
+
+    unsigned char* out = bytes;
+    auto append = [&out](const void* source, size_t sourceSize) {
+        if (sourceSize > 0)
+        {
+            memcpy(out, source, sourceSize);
+            out += sourceSize;
+        }
+    };
+    append(&header, sizeof(header));
+    append(frames.data(), framesSize);
+    append(aliases.data(), aliasesSize);
+    append(polygonData.data(), polygonDataSize);
+    append(strings.getData().data(), header.stringTableSize);
+
+    Data data;
+    data.fastSet(bytes, size);
+    return data;
 }
 
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (isBinarySheet(data))
+    {
+        addSpriteFramesWithBinaryData(data, texture, plist);
+        return;
+    }
 
-    addSpriteFramesWithDictionary(dict, texture, plist);
+    PlistSheet sheet;
+    if (!readPlistSheet(reinterpret_cast<const char*>(data.getBytes()), data.getSize(), sheet))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: invalid sprite sheet %s", plist.c_str());
+        return;
+    }
+    addSpriteFramesWithPlistSheet(sheet, texture, plist);
 }
 
 void SpriteFrameCache::addSpriteFramesWithFileContent(const std::string& plist_content, Texture2D *texture)
 {
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromData(plist_content.c_str(), static_cast<int>(plist_content.size()));
-    addSpriteFramesWithDictionary(dict, texture, "by#addSpriteFramesWithFileContent()");
+    PlistSheet sheet;
+    if (!readPlistSheet(plist_content.c_str(), plist_content.size(), sheet))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: invalid sprite sheet content");
+        return;
+    }
+    addSpriteFramesWithPlistSheet(sheet, texture, "by#addSpriteFramesWithFileContent()");
 }
 
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const std::string& textureFileName)
 {
     CCASSERT(!textureFileName.empty(), "texture name should not be null");
     const std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    addSpriteFramesWithDictionary(dict, textureFileName, plist);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    BinarySheet binarySheet;
+    if (binarySheet.init(data))
+    {
+        const BinarySheetHeader* header = binarySheet.header;
+        Texture2D* texture = addSpriteSheetTexture(textureFileName, binarySheet.getString(header->pixelFormatOffset, header->pixelFormatLength));
+        if (texture)
+        {
+            addSpriteFramesWithBinaryData(data, texture, plist);
+        }
+        return;
+    }
+
+    PlistSheet sheet;
+    if (!readPlistSheet(reinterpret_cast<const char*>(data.getBytes()), data.getSize(), sheet))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: invalid sprite sheet %s", plist.c_str());
+        return;
+    }
+
+    Texture2D *texture = addSpriteSheetTexture(textureFileName, sheet.metadata.pixelFormat);
+    if (texture)
+    {
+        addSpriteFramesWithPlistSheet(sheet, texture, plist);
+    }
 }
 
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
@@ -366,40 +980,39 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
         return;
     }
 
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-
-    string texturePath("");
-
-    if (dict.find("metadata") != dict.end())
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    BinarySheet binarySheet;
+    if (binarySheet.init(data))
+    {
+        const BinarySheetHeader* header = binarySheet.header;
+        std::string texturePath = getSpriteSheetTexturePath(binarySheet.getString(header->textureFileNameOffset, header->textureFileNameLength), plist);
+        Texture2D* texture = addSpriteSheetTexture(texturePath, binarySheet.getString(header->pixelFormatOffset, header->pixelFormatLength));
+        if (texture)
+        {
+            addSpriteFramesWithBinaryData(data, texture, plist);
+        }
+        return;
+    }
+    else if (isBinarySheet(data))
     {
-        ValueMap& metadataDict = dict["metadata"].asValueMap();
-        // try to read  texture file name from meta data
-        texturePath = metadataDict["textureFileName"].asString();
+        CCLOG("cocos2d: SpriteFrameCache: invalid binary sprite sheet %s", plist.c_str());
+        return;
     }
 
-    if (!texturePath.empty())
+    PlistSheet sheet;
+    if (!readPlistSheet(reinterpret_cast<const char*>(data.getBytes()), data.getSize(), sheet))
     {
-        // build texture path relative to plist file
-        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
+        CCLOG("cocos2d: SpriteFrameCache: invalid sprite sheet %s", plist.c_str());
+        return;
     }
-    else
-    {
-        // build texture path by replacing file extension
-        texturePath = plist;
-
-        // remove .xxx
-        size_t startPos = texturePath.find_last_of('.'); 
-        if(startPos != string::npos)
-        {
-            texturePath = texturePath.erase(startPos);
-        }
-
-        // append .png
-        texturePath = texturePath.append(".png");
 
-        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    // try to read texture file name from meta data
+    std::string texturePath = getSpriteSheetTexturePath(sheet.metadata.textureFileName, plist);
+    Texture2D *texture = addSpriteSheetTexture(texturePath, sheet.metadata.pixelFormat);
+    if (texture)
+    {
+        addSpriteFramesWithPlistSheet(sheet, texture, plist);
     }
-    addSpriteFramesWithDictionary(dict, texturePath, plist);
 }
 
 bool SpriteFrameCache::isSpriteFramesWithFileLoaded(const std::string& plist) const
@@ -465,13 +1078,21 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    if (dict.empty())
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (isBinarySheet(data))
     {
-        CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
-        return;
+        removeSpriteFramesFromBinaryData(data);
+    }
+    else
+    {
+        ValueMap dict = getValueMapFromSpriteSheetData(data);
+        if (dict.empty())
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
+            return;
+        }
+        removeSpriteFramesFromDictionary(dict);
     }
-    removeSpriteFramesFromDictionary(dict);
 
     // remove it from the cache
     _spriteFramesCache.erasePlistIndex(plist);
@@ -507,6 +1128,26 @@ void SpriteFrameCache::removeSpriteFramesFromDictionary(ValueMap& dictionary)
     _spriteFramesCache.eraseFrames(keysToRemove);
 }
 
+void SpriteFrameCache::removeSpriteFramesFromBinaryData(const Data& data)
+{
+    BinarySheet binarySheet;
+    if (!binarySheet.init(data))
+        return;
+
+    std::vector<std::string> keysToRemove;
+    for (uint32_t i = 0; i < binarySheet.header->frameCount; ++i)
+    {
+        const BinarySheetFrame& frame = binarySheet.frames[i];
+        std::string name = binarySheet.getString(frame.nameOffset, frame.nameLength);
+        if (_spriteFramesCache.at(name))
+        {
+            keysToRemove.push_back(name);
+        }
+    }
+
+    _spriteFramesCache.eraseFrames(keysToRemove);
+}
+
 void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
 {
     std::vector<std::string> keysToRemove;
@@ -671,43 +1312,41 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
     }
 
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    BinarySheet binarySheet;
+    const bool binary = binarySheet.init(data);
+    ValueMap dict;
 
     string texturePath("");
 
-    if (dict.find("metadata") != dict.end())
-    {
-        ValueMap& metadataDict = dict["metadata"].asValueMap();
-        // try to read  texture file name from meta data
-        texturePath = metadataDict["textureFileName"].asString();
-    }
-
-    if (!texturePath.empty())
+    if (binary)
     {
-        // build texture path relative to plist file
-        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
+        texturePath = binarySheet.getString(binarySheet.header->textureFileNameOffset, binarySheet.header->textureFileNameLength);
     }
     else
     {
-        // build texture path by replacing file extension
-        texturePath = plist;
-
-        // remove .xxx
-        size_t startPos = texturePath.find_last_of('.');
-        if(startPos != string::npos)
+        dict = getValueMapFromSpriteSheetData(data);
+        if (dict.find("metadata") != dict.end())
         {
-            texturePath = texturePath.erase(startPos);
+            ValueMap& metadataDict = dict["metadata"].asValueMap();
+            // try to read  texture file name from meta data
+            texturePath = metadataDict["textureFileName"].asString();
         }
-        
-        // append .png
-        texturePath = texturePath.append(".png");
     }
 
+    texturePath = getSpriteSheetTexturePath(texturePath, plist);
+
     Texture2D *texture = nullptr;
     if (Director::getInstance()->getTextureCache()->reloadTexture(texturePath))
         texture = Director::getInstance()->getTextureCache()->getTextureForKey(texturePath);
 
-    if (texture)
+    if (texture && binary)
+    {
+        // the frames are created again with the reloaded texture
+        removeSpriteFramesFromBinaryData(data);
+        addSpriteFramesWithBinaryData(data, texture, plist);
+    }
+    else if (texture)
     {
         reloadSpriteFramesWithDictionary(dict, texture, plist);
     }
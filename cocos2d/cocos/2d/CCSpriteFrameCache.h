@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "base/CCMap.h"
+#include "base/CCData.h"
 
 NS_CC_BEGIN
 
@@ -82,6 +83,18 @@ class PolygonInfo;
  Use one of the following tools to create the .plist file and sprite sheet:
  - [TexturePacker](https://www.codeandweb.com/texturepacker/cocos2d)
  - [Zwoptex](https://zwopple.com/zwoptex/)
+
+ The methods taking a file name also load binary sprite sheets converted from a .plist file by
+ tools/sprite-sheet/convert_sprite_sheet.py or createBinaryDataWithDictionary(). They hold the same
+ values in fixed size records which are read straight from the file, without parsing XML or building
+ a ValueMap. File layout, all values are 32 bits little endian:
+ - header: "CCSF", version, frame count, alias count, polygon data count, string table size,
+   texture width and height, texture file name and pixel format as string table offset and length
+ - frames: name offset and length, texture rect, offset, source size, anchor, flags (1: rotated,
+   2: has an anchor), polygon data index, vertex count, index count
+ - aliases: name offset and length, frame index
+ - polygon data: the vertices, UVs and triangle indices of the polygon frames
+ - string table
  
  @since v0.9
  @js cc.spriteFrameCache
@@ -287,6 +300,16 @@ public:
 
     bool reloadTexture(const std::string& plist);
 
+    /** Converts a sprite sheet dictionary, as read from a .plist file, into a binary sprite sheet.
+     * It holds the same values as the file tools/sprite-sheet/convert_sprite_sheet.py writes.
+     *
+     * @param dictionary The sprite sheet dictionary.
+     * @return The binary sprite sheet, null if the dictionary has no frames or its format isn't supported.
+     * @js NA
+     * @lua NA
+     */
+    static Data createBinaryDataWithDictionary(ValueMap& dictionary);
+
 protected:
     // MARMALADE: Made this protected not private, as deriving from this class is pretty useful
     SpriteFrameCache(){}
@@ -312,6 +335,36 @@ protected:
                                const std::vector<int> &triangleIndices,
                                PolygonInfo &polygonInfo);
 
+    /** Same as above with x, y pairs of vertexCount vertices. */
+    void initializePolygonInfo(const Size &textureSize,
+                               const Size &spriteSize,
+                               const int *vertices,
+                               const int *verticesUV,
+                               size_t vertexCount,
+                               const int *triangleIndices,
+                               size_t indexCount,
+                               PolygonInfo &polygonInfo);
+
+    /** Adds the Sprite Frames of a binary sprite sheet. The texture will be associated with the created sprite frames. */
+    void addSpriteFramesWithBinaryData(const Data& data, Texture2D *texture, const std::string &sheet);
+
+    /** Removes the Sprite Frames of a binary sprite sheet. */
+    void removeSpriteFramesFromBinaryData(const Data& data);
+
+    /** Fields of a plist sprite sheet, read straight from the file or copied from a dictionary. */
+    struct PlistSheet;
+
+    /** Reads a plist sprite sheet with a PlistReader, without building a ValueMap. The plists it can't read go
+     * through FileUtils::getValueMapFromData.
+     * @return false if the plist is malformed.
+     */
+    static bool readPlistSheet(const char* data, size_t size, PlistSheet& sheet);
+
+    static void readPlistSheet(ValueMap& dictionary, PlistSheet& sheet);
+
+    /** Adds the Sprite Frames of a plist sprite sheet. The texture will be associated with the created sprite frames. */
+    void addSpriteFramesWithPlistSheet(const PlistSheet& sheet, Texture2D *texture, const std::string &plist);
+
     void reloadSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture, const std::string &plist);
 
     ValueMap _spriteFramesAliases;
@@ -72,6 +72,13 @@ bool TMXLayer::initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *la
         _layerName = layerInfo->_name;
         _layerSize = size;
         _tiles = layerInfo->_tiles;
+        if (!layerInfo->_tileData.isNull())
+        {
+            // this layer owns and frees its tiles, make them independent of the tile data file
+            size_t tilesSize = (size_t)(size.width * size.height) * sizeof(uint32_t);
+            _tiles = (uint32_t*)malloc(tilesSize);
+            memcpy(_tiles, layerInfo->_tiles, tilesSize);
+        }
         _opacity = layerInfo->_opacity;
         setProperties(layerInfo->getProperties());
         _contentScaleFactor = Director::getInstance()->getContentScaleFactor();
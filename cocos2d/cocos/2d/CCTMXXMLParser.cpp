@@ -33,6 +33,8 @@ THE SOFTWARE.
 #include "base/ZipUtils.h"
 #include "base/base64.h"
 #include "platform/CCFileUtils.h"
+#include "xxhash.h"
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
 #include <utility>
@@ -52,7 +54,7 @@ TMXLayerInfo::TMXLayerInfo()
 TMXLayerInfo::~TMXLayerInfo()
 {
     CCLOGINFO("deallocing TMXLayerInfo: %p", this);
-    if (_ownTiles && _tiles)
+    if (_ownTiles && _tiles && _tileData.isNull())
     {
         free(_tiles);
         _tiles = nullptr;
@@ -69,6 +71,62 @@ void TMXLayerInfo::setProperties(const ValueMap& var)
     _properties = var;
 }
 
+// tile data files use the byte order of the gids decoded from base64 layers,
+// which every supported platform shares
+static const char TILE_DATA_MAGIC[4] = { 'C', 'C', 'T', 'L' };
+static const uint32_t TILE_DATA_VERSION = 1;
+static const size_t TILE_DATA_HEADER_SIZE = 4 * sizeof(uint32_t);
+
+bool TMXLayerInfo::loadTileData(const std::string& fullPath)
+{
+    // mapped rather than read once the file reaches CC_FILEUTILS_MMAP_THRESHOLD
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (data.getSize() < (ssize_t)TILE_DATA_HEADER_SIZE || memcmp(data.getBytes(), TILE_DATA_MAGIC, 4) != 0)
+    {
+        CCLOG("cocos2d: TMX: %s is not a tile data file", fullPath.c_str());
+        return false;
+    }
+
+    uint32_t header[4];
+    memcpy(header, data.getBytes(), TILE_DATA_HEADER_SIZE);
+    size_t width = (size_t)_layerSize.width;
+    size_t height = (size_t)_layerSize.height;
+    if (header[1] != TILE_DATA_VERSION || header[2] != width || header[3] != height
+        || (size_t)data.getSize() != TILE_DATA_HEADER_SIZE + width * height * sizeof(uint32_t))
+    {
+        CCLOG("cocos2d: TMX: tile data file %s does not match layer '%s'", fullPath.c_str(), _name.c_str());
+        return false;
+    }
+
+    if (_ownTiles && _tiles && _tileData.isNull())
+        free(_tiles);
+    _tileData = std::move(data);
+    _tiles = reinterpret_cast<uint32_t*>(_tileData.getBytes() + TILE_DATA_HEADER_SIZE);
+    return true;
+}
+
+bool TMXLayerInfo::saveTileData(const std::string& fullPath) const
+{
+    if (!_tiles)
+        return false;
+
+    uint32_t width = (uint32_t)_layerSize.width;
+    uint32_t height = (uint32_t)_layerSize.height;
+    size_t tilesSize = (size_t)width * height * sizeof(uint32_t);
+    auto bytes = (unsigned char*)malloc(TILE_DATA_HEADER_SIZE + tilesSize);
+    if (!bytes)
+        return false;
+
+    uint32_t header[4] = { 0, TILE_DATA_VERSION, width, height };
+    memcpy(header, TILE_DATA_MAGIC, 4);
+    memcpy(bytes, header, TILE_DATA_HEADER_SIZE);
+    memcpy(bytes + TILE_DATA_HEADER_SIZE, _tiles, tilesSize);
+
+    Data data;
+    data.fastSet(bytes, TILE_DATA_HEADER_SIZE + tilesSize);
+    return FileUtils::getInstance()->writeDataToFile(data, fullPath);
+}
+
 // implementation TMXTilesetInfo
 TMXTilesetInfo::TMXTilesetInfo()
     :_firstGid(0)
@@ -148,6 +206,7 @@ void TMXMapInfo::internalInit(const std::string& tmxFileName, const std::string&
     _layerAttribs = TMXLayerAttribNone;
     _parentElement = TMXPropertyNone;
     _currentFirstGID = -1;
+    _externalTilesetSources.clear();
 }
 
 bool TMXMapInfo::initWithXML(const std::string& tmxString, const std::string& resourcePath)
@@ -159,7 +218,52 @@ bool TMXMapInfo::initWithXML(const std::string& tmxString, const std::string& re
 bool TMXMapInfo::initWithTMXFile(const std::string& tmxFile)
 {
     internalInit(tmxFile, "");
-    return parseXMLFile(_TMXFileName);
+
+    std::string cachePath = getCachePath(tmxFile);
+    if (!cachePath.empty() && loadCache(cachePath))
+        return true;
+
+    if (!parseXMLFile(_TMXFileName))
+        return false;
+
+    if (!cachePath.empty() && !saveCache(cachePath))
+        CCLOG("cocos2d: TMX: unable to save the cache of %s", tmxFile.c_str());
+    return true;
+}
+
+std::string TMXMapInfo::getExternalTilesetPath(const std::string& source) const
+{
+    // Tileset file will be relative to the map file. So we need to convert it to an absolute path
+    std::string path;
+    if (_TMXFileName.find_last_of('/') != string::npos)
+    {
+        string dir = _TMXFileName.substr(0, _TMXFileName.find_last_of('/') + 1);
+        path = dir + source;
+    }
+    else
+    {
+        path = _resources + "/" + source;
+    }
+    return FileUtils::getInstance()->fullPathForFilename(path);
+}
+
+bool TMXMapInfo::loadLayerTileData(TMXLayerInfo* layer)
+{
+    auto it = layer->getProperties().find("cc_tile_data");
+    if (it == layer->getProperties().end())
+        return false;
+
+    // resolved like tileset images: relative to the TMX file, or to the resource path
+    std::string fileName = it->second.asString();
+    std::string fullPath;
+    if (FileUtils::getInstance()->isAbsolutePath(fileName))
+        fullPath = fileName;
+    else if (_TMXFileName.find_last_of('/') != string::npos)
+        fullPath = _TMXFileName.substr(0, _TMXFileName.find_last_of('/') + 1) + fileName;
+    else
+        fullPath = _resources + (!_resources.empty() ? "/" : "") + fileName;
+
+    return layer->loadTileData(fullPath);
 }
 
 TMXMapInfo::TMXMapInfo()
@@ -297,18 +401,8 @@ void TMXMapInfo::startElement(void* /*ctx*/, const char *name, const char **atts
         if (!externalTilesetFilename.empty())
         {
             _externalTilesetFilename = externalTilesetFilename;
-
-            // Tileset file will be relative to the map file. So we need to convert it to an absolute path
-            if (_TMXFileName.find_last_of('/') != string::npos)
-            {
-                string dir = _TMXFileName.substr(0, _TMXFileName.find_last_of('/') + 1);
-                externalTilesetFilename = dir + externalTilesetFilename;
-            }
-            else 
-            {
-                externalTilesetFilename = _resources + "/" + externalTilesetFilename;
-            }
-            externalTilesetFilename = FileUtils::getInstance()->fullPathForFilename(externalTilesetFilename);
+            _externalTilesetSources.push_back(externalTilesetFilename);
+            externalTilesetFilename = getExternalTilesetPath(externalTilesetFilename);
             
             _currentFirstGID = attributeDict["firstgid"].asInt();
             if (_currentFirstGID < 0)
@@ -355,6 +449,10 @@ void TMXMapInfo::startElement(void* /*ctx*/, const char *name, const char **atts
     {
         if (tmxMapInfo->getParentElement() == TMXPropertyLayer)
         {
+            // the gids of the layer come from its tile data file
+            if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBinary)
+                return;
+
             TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
             Size layerSize = layer->_layerSize;
             uint32_t gid = static_cast<uint32_t>(attributeDict["gid"].asUnsignedInt());
@@ -453,7 +551,14 @@ void TMXMapInfo::startElement(void* /*ctx*/, const char *name, const char **atts
         std::string encoding = attributeDict["encoding"].asString();
         std::string compression = attributeDict["compression"].asString();
 
-        if (encoding.empty())
+        // the encoding flags are never cleared between layers, but the binary one must be
+        tmxMapInfo->setLayerAttribs(tmxMapInfo->getLayerAttribs() & ~TMXLayerAttribBinary);
+
+        if (loadLayerTileData(tmxMapInfo->getLayers().back()))
+        {
+            tmxMapInfo->setLayerAttribs(tmxMapInfo->getLayerAttribs() | TMXLayerAttribBinary);
+        }
+        else if (encoding.empty())
         {
             tmxMapInfo->setLayerAttribs(tmxMapInfo->getLayerAttribs() | TMXLayerAttribNone);
             
@@ -694,7 +799,12 @@ void TMXMapInfo::endElement(void* /*ctx*/, const char *name)
 
     if (elementName == "data")
     {
-        if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBase64)
+        if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBinary)
+        {
+            // already loaded from the tile data file, the inline gids are ignored
+            tmxMapInfo->setCurrentString("");
+        }
+        else if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBase64)
         {
             tmxMapInfo->setStoringCharacters(false);
             
@@ -788,6 +898,11 @@ void TMXMapInfo::endElement(void* /*ctx*/, const char *name)
     }    
     else if (elementName == "layer")
     {
+        // a layer may have no data element at all when its gids only live in a tile data file
+        TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
+        if (!layer->_tiles)
+            loadLayerTileData(layer);
+
         // The layer element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
     }
@@ -847,4 +962,541 @@ TMXTileAnimInfo *TMXTileAnimInfo::create(uint32_t tileID)
     return nullptr;
 }
 
+// TMX map cache
+
+namespace {
+
+// The cache is written in the byte order of the gids decoded from base64 layers, which every supported platform shares.
+// It starts with what it was made from, the TMX file and its external tilesets, so stale caches are never used.
+const char TMX_CACHE_MAGIC[4] = { 'C', 'C', 'T', 'M' };
+const uint32_t TMX_CACHE_VERSION = 1;
+
+enum {
+    TMXCacheTilesNone,
+    TMXCacheTilesInline,
+    TMXCacheTilesDataFile,
+};
+
+std::string s_cacheDirectory;
+
+bool hashFile(const std::string& fullPath, uint32_t* size, uint32_t* hash)
+{
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (data.isNull())
+        return false;
+    *size = (uint32_t)data.getSize();
+    *hash = XXH32(data.getBytes(), (size_t)data.getSize(), 0);
+    return true;
+}
+
+class CacheWriter
+{
+public:
+    void write(const void* bytes, size_t size)
+    {
+        auto begin = static_cast<const unsigned char*>(bytes);
+        _buffer.insert(_buffer.end(), begin, begin + size);
+    }
+    void writeByte(uint8_t value) { write(&value, sizeof(value)); }
+    void writeUInt(uint32_t value) { write(&value, sizeof(value)); }
+    void writeInt(int32_t value) { write(&value, sizeof(value)); }
+    void writeFloat(float value) { write(&value, sizeof(value)); }
+    void writeSize(const Size& value) { writeFloat(value.width); writeFloat(value.height); }
+    void writeVec2(const Vec2& value) { writeFloat(value.x); writeFloat(value.y); }
+    void writeString(const std::string& value)
+    {
+        writeUInt((uint32_t)value.size());
+        write(value.data(), value.size());
+    }
+    /** pads to 4 bytes, so the gids that follow can be used in place */
+    void align() { _buffer.resize((_buffer.size() + 3) & ~(size_t)3); }
+
+    void writeValueVector(const ValueVector& value)
+    {
+        writeUInt((uint32_t)value.size());
+        for (const auto& item : value)
+            writeValue(item);
+    }
+    void writeValueMap(const ValueMap& value)
+    {
+        writeUInt((uint32_t)value.size());
+        for (const auto& item : value)
+        {
+            writeString(item.first);
+            writeValue(item.second);
+        }
+    }
+    void writeValueMapIntKey(const ValueMapIntKey& value)
+    {
+        writeUInt((uint32_t)value.size());
+        for (const auto& item : value)
+        {
+            writeInt(item.first);
+            writeValue(item.second);
+        }
+    }
+    void writeValue(const Value& value)
+    {
+        writeByte((uint8_t)value.getType());
+        switch (value.getType())
+        {
+            case Value::Type::NONE:
+                break;
+            case Value::Type::BYTE:
+                writeByte(value.asByte());
+                break;
+            case Value::Type::INTEGER:
+                writeInt(value.asInt());
+                break;
+            case Value::Type::UNSIGNED:
+                writeUInt(value.asUnsignedInt());
+                break;
+            case Value::Type::FLOAT:
+                writeFloat(value.asFloat());
+                break;
+            case Value::Type::DOUBLE:
+            {
+                double number = value.asDouble();
+                write(&number, sizeof(number));
+                break;
+            }
+            case Value::Type::BOOLEAN:
+                writeByte(value.asBool() ? 1 : 0);
+                break;
+            case Value::Type::STRING:
+                writeString(value.asString());
+                break;
+            case Value::Type::VECTOR:
+                writeValueVector(value.asValueVector());
+                break;
+            case Value::Type::MAP:
+                writeValueMap(value.asValueMap());
+                break;
+            case Value::Type::INT_KEY_MAP:
+                writeValueMapIntKey(value.asIntKeyMap());
+                break;
+        }
+    }
+
+    const std::vector<unsigned char>& getBuffer() const { return _buffer; }
+
+private:
+    std::vector<unsigned char> _buffer;
+};
+
+/** reads what CacheWriter wrote, every read past the end fails the reader and returns zeros */
+class CacheReader
+{
+public:
+    CacheReader(const unsigned char* bytes, size_t size)
+    : _bytes(bytes)
+    , _size(size)
+    , _offset(0)
+    , _failed(false)
+    {
+    }
+
+    const unsigned char* skip(size_t size)
+    {
+        if (_failed || size > _size - _offset)
+        {
+            _failed = true;
+            return nullptr;
+        }
+        auto bytes = _bytes + _offset;
+        _offset += size;
+        return bytes;
+    }
+    void read(void* value, size_t size)
+    {
+        auto bytes = skip(size);
+        if (bytes)
+            memcpy(value, bytes, size);
+        else
+            memset(value, 0, size);
+    }
+    uint8_t readByte() { uint8_t value; read(&value, sizeof(value)); return value; }
+    uint32_t readUInt() { uint32_t value; read(&value, sizeof(value)); return value; }
+    int32_t readInt() { int32_t value; read(&value, sizeof(value)); return value; }
+    /** reads the number of the elements which follow, each at least elementSize bytes long.
+     A count the rest of the data can't hold fails the reader and returns 0, so it is safe to allocate for. */
+    uint32_t readCount(size_t elementSize)
+    {
+        uint32_t count = readUInt();
+        if (_failed || count > (_size - _offset) / elementSize)
+        {
+            _failed = true;
+            return 0;
+        }
+        return count;
+    }
+    float readFloat() { float value; read(&value, sizeof(value)); return value; }
+    Size readSize() { float width = readFloat(); return Size(width, readFloat()); }
+    Vec2 readVec2() { float x = readFloat(); return Vec2(x, readFloat()); }
+    std::string readString()
+    {
+        uint32_t length = readUInt();
+        auto bytes = skip(length);
+        return bytes ? std::string((const char*)bytes, length) : std::string();
+    }
+    void align() { skip(((_offset + 3) & ~(size_t)3) - _offset); }
+
+    ValueVector readValueVector()
+    {
+        ValueVector value;
+        uint32_t count = readUInt();
+        for (uint32_t i = 0; i < count && !_failed; ++i)
+            value.push_back(readValue());
+        return value;
+    }
+    ValueMap readValueMap()
+    {
+        ValueMap value;
+        uint32_t count = readUInt();
+        for (uint32_t i = 0; i < count && !_failed; ++i)
+        {
+            std::string key = readString();
+            value.emplace(std::move(key), readValue());
+        }
+        return value;
+    }
+    ValueMapIntKey readValueMapIntKey()
+    {
+        ValueMapIntKey value;
+        uint32_t count = readUInt();
+        for (uint32_t i = 0; i < count && !_failed; ++i)
+        {
+            int key = readInt();
+            value.emplace(key, readValue());
+        }
+        return value;
+    }
+    Value readValue()
+    {
+        switch ((Value::Type)readByte())
+        {
+            case Value::Type::NONE:
+                return Value::Null;
+            case Value::Type::BYTE:
+                return Value(readByte());
+            case Value::Type::INTEGER:
+                return Value((int)readInt());
+            case Value::Type::UNSIGNED:
+                return Value((unsigned int)readUInt());
+            case Value::Type::FLOAT:
+                return Value(readFloat());
+            case Value::Type::DOUBLE:
+            {
+                double number;
+                read(&number, sizeof(number));
+                return Value(number);
+            }
+            case Value::Type::BOOLEAN:
+                return Value(readByte() != 0);
+            case Value::Type::STRING:
+                return Value(readString());
+            case Value::Type::VECTOR:
+                return Value(readValueVector());
+            case Value::Type::MAP:
+                return Value(readValueMap());
+            case Value::Type::INT_KEY_MAP:
+                return Value(readValueMapIntKey());
+        }
+        _failed = true;
+        return Value::Null;
+    }
+
+    size_t getOffset() const { return _offset; }
+    bool hasFailed() const { return _failed; }
+
+private:
+    const unsigned char* _bytes;
+    size_t _size;
+    size_t _offset;
+    bool _failed;
+};
+
+} // namespace
+
+void TMXMapInfo::setCacheDirectory(const std::string& directory)
+{
+    s_cacheDirectory = directory;
+    if (!s_cacheDirectory.empty() && s_cacheDirectory.back() != '/')
+        s_cacheDirectory += '/';
+}
+
+const std::string& TMXMapInfo::getCacheDirectory()
+{
+    return s_cacheDirectory;
+}
+
+std::string TMXMapInfo::getCachePath(const std::string& tmxFile)
+{
+    if (s_cacheDirectory.empty())
+        return "";
+
+    // named after the path the map is loaded with, which is the same on every device
+    std::string name = tmxFile;
+    std::replace(name.begin(), name.end(), '/', '_');
+    std::replace(name.begin(), name.end(), '\\', '_');
+    std::replace(name.begin(), name.end(), ':', '_');
+    return s_cacheDirectory + name + ".cache";
+}
+
+bool TMXMapInfo::saveCache(const std::string& cachePath) const
+{
+    CacheWriter writer;
+    writer.write(TMX_CACHE_MAGIC, sizeof(TMX_CACHE_MAGIC));
+    writer.writeUInt(TMX_CACHE_VERSION);
+
+    uint32_t size, hash;
+    if (!hashFile(_TMXFileName, &size, &hash))
+        return false;
+    writer.writeUInt(size);
+    writer.writeUInt(hash);
+    writer.writeUInt((uint32_t)_externalTilesetSources.size());
+    for (const auto& source : _externalTilesetSources)
+    {
+        if (!hashFile(getExternalTilesetPath(source), &size, &hash))
+            return false;
+        writer.writeString(source);
+        writer.writeUInt(size);
+        writer.writeUInt(hash);
+    }
+
+    writer.writeInt(_orientation);
+    writer.writeInt(_staggerAxis);
+    writer.writeInt(_staggerIndex);
+    writer.writeInt(_hexSideLength);
+    writer.writeSize(_mapSize);
+    writer.writeSize(_tileSize);
+    writer.writeValueMap(_properties);
+    writer.writeValueMapIntKey(_tileProperties);
+    writer.writeString(_externalTilesetFilename);
+
+    // images are relative to the TMX file when possible, the cache can then be made on another machine
+    std::string dir = _TMXFileName.substr(0, _TMXFileName.find_last_of('/') + 1);
+    writer.writeUInt((uint32_t)_tilesets.size());
+    for (const auto tileset : _tilesets)
+    {
+        writer.writeString(tileset->_name);
+        writer.writeInt(tileset->_firstGid);
+        writer.writeSize(tileset->_tileSize);
+        writer.writeInt(tileset->_spacing);
+        writer.writeInt(tileset->_margin);
+        writer.writeVec2(tileset->_tileOffset);
+        bool relative = tileset->_sourceImage.compare(0, dir.size(), dir) == 0;
+        writer.writeByte(relative ? 1 : 0);
+        writer.writeString(relative ? tileset->_sourceImage.substr(dir.size()) : tileset->_sourceImage);
+        writer.writeSize(tileset->_imageSize);
+        writer.writeString(tileset->_originSourceImage);
+
+        writer.writeUInt((uint32_t)tileset->_animationInfo.size());
+        for (const auto& animation : tileset->_animationInfo)
+        {
+            writer.writeUInt(animation.first);
+            writer.writeUInt(animation.second->_tileID);
+            writer.writeUInt((uint32_t)animation.second->_frames.size());
+            for (const auto& frame : animation.second->_frames)
+            {
+                writer.writeUInt(frame._tileID);
+                writer.writeFloat(frame._duration);
+            }
+        }
+    }
+
+    writer.writeUInt((uint32_t)_layers.size());
+    for (const auto layer : _layers)
+    {
+        writer.writeString(layer->_name);
+        writer.writeSize(layer->_layerSize);
+        writer.writeByte(layer->_visible ? 1 : 0);
+        writer.writeByte(layer->_opacity);
+        writer.writeVec2(layer->_offset);
+        writer.writeValueMap(layer->_properties);
+
+        if (!layer->_tiles)
+        {
+            writer.writeByte(TMXCacheTilesNone);
+        }
+        else if (!layer->_tileData.isNull() && layer->_properties.find("cc_tile_data") != layer->_properties.end())
+        {
+            // the tile data file is loaded again, it may be huge
+            writer.writeByte(TMXCacheTilesDataFile);
+        }
+        else
+        {
+            writer.writeByte(TMXCacheTilesInline);
+            writer.align();
+            writer.write(layer->_tiles, (size_t)(layer->_layerSize.width * layer->_layerSize.height) * sizeof(uint32_t));
+        }
+    }
+
+    writer.writeUInt((uint32_t)_objectGroups.size());
+    for (const auto objectGroup : _objectGroups)
+    {
+        writer.writeString(objectGroup->getGroupName());
+        writer.writeVec2(objectGroup->getPositionOffset());
+        writer.writeValueMap(objectGroup->getProperties());
+        writer.writeValueVector(objectGroup->getObjects());
+    }
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string cacheDir = cachePath.substr(0, cachePath.find_last_of('/') + 1);
+    if (!cacheDir.empty() && !fileUtils->isDirectoryExist(cacheDir))
+        fileUtils->createDirectory(cacheDir);
+
+    Data data;
+    data.copy(writer.getBuffer().data(), (ssize_t)writer.getBuffer().size());
+    return fileUtils->writeDataToFile(data, cachePath);
+}
+
+bool TMXMapInfo::loadCache(const std::string& cachePath)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(cachePath))
+        return false;
+
+    // a single read, or a mapping for big caches
+    std::string fullPath = fileUtils->fullPathForFilename(cachePath);
+    Data data = fileUtils->getDataFromFile(fullPath);
+    CacheReader reader(data.getBytes(), (size_t)data.getSize());
+
+    char magic[sizeof(TMX_CACHE_MAGIC)];
+    reader.read(magic, sizeof(magic));
+    if (memcmp(magic, TMX_CACHE_MAGIC, sizeof(magic)) != 0 || reader.readUInt() != TMX_CACHE_VERSION)
+        return false;
+
+    uint32_t size, hash;
+    if (!hashFile(_TMXFileName, &size, &hash) || reader.readUInt() != size || reader.readUInt() != hash)
+        return false;
+    // source length, size and hash of every external tileset
+    uint32_t externalTilesetCount = reader.readCount(3 * sizeof(uint32_t));
+    if (reader.hasFailed())
+        return false;
+    std::vector<std::string> externalTilesetSources(externalTilesetCount);
+    for (auto& source : externalTilesetSources)
+    {
+        source = reader.readString();
+        if (reader.hasFailed() || !hashFile(getExternalTilesetPath(source), &size, &hash)
+            || reader.readUInt() != size || reader.readUInt() != hash)
+            return false;
+    }
+
+    _orientation = reader.readInt();
+    _staggerAxis = reader.readInt();
+    _staggerIndex = reader.readInt();
+    _hexSideLength = reader.readInt();
+    _mapSize = reader.readSize();
+    _tileSize = reader.readSize();
+    ValueMap properties = reader.readValueMap();
+    ValueMapIntKey tileProperties = reader.readValueMapIntKey();
+    std::string externalTilesetFilename = reader.readString();
+
+    std::string dir = _TMXFileName.substr(0, _TMXFileName.find_last_of('/') + 1);
+    Vector<TMXTilesetInfo*> tilesets;
+    uint32_t tilesetCount = reader.readUInt();
+    for (uint32_t i = 0; i < tilesetCount && !reader.hasFailed(); ++i)
+    {
+        auto tileset = new (std::nothrow) TMXTilesetInfo();
+        tilesets.pushBack(tileset);
+        tileset->release();
+
+        tileset->_name = reader.readString();
+        tileset->_firstGid = reader.readInt();
+        tileset->_tileSize = reader.readSize();
+        tileset->_spacing = reader.readInt();
+        tileset->_margin = reader.readInt();
+        tileset->_tileOffset = reader.readVec2();
+        bool relative = reader.readByte() != 0;
+        tileset->_sourceImage = relative ? dir + reader.readString() : reader.readString();
+        tileset->_imageSize = reader.readSize();
+        tileset->_originSourceImage = reader.readString();
+
+        uint32_t animationCount = reader.readUInt();
+        for (uint32_t j = 0; j < animationCount && !reader.hasFailed(); ++j)
+        {
+            uint32_t gid = reader.readUInt();
+            auto animation = TMXTileAnimInfo::create(reader.readUInt());
+            uint32_t frameCount = reader.readUInt();
+            for (uint32_t k = 0; k < frameCount && !reader.hasFailed(); ++k)
+            {
+                uint32_t tileID = reader.readUInt();
+                animation->_frames.emplace_back(tileID, reader.readFloat());
+            }
+            tileset->_animationInfo.insert(gid, animation);
+        }
+    }
+
+    Vector<TMXLayerInfo*> layers;
+    uint32_t layerCount = reader.readUInt();
+    for (uint32_t i = 0; i < layerCount && !reader.hasFailed(); ++i)
+    {
+        auto layer = new (std::nothrow) TMXLayerInfo();
+        layers.pushBack(layer);
+        layer->release();
+
+        layer->_name = reader.readString();
+        layer->_layerSize = reader.readSize();
+        layer->_visible = reader.readByte() != 0;
+        layer->_opacity = reader.readByte();
+        layer->_offset = reader.readVec2();
+        layer->_properties = reader.readValueMap();
+
+        auto tiles = reader.readByte();
+        if (tiles == TMXCacheTilesDataFile)
+        {
+            if (!loadLayerTileData(layer))
+                return false;
+        }
+        else if (tiles == TMXCacheTilesInline)
+        {
+            reader.align();
+            size_t offset = reader.getOffset();
+            size_t tilesSize = (size_t)(layer->_layerSize.width * layer->_layerSize.height) * sizeof(uint32_t);
+            auto bytes = reader.skip(tilesSize);
+            if (!bytes)
+                return false;
+
+            // big layers get their own mapping of the cache, the rest is copied
+            if (data.isMapped() && tilesSize >= CC_FILEUTILS_MMAP_THRESHOLD
+                && layer->_tileData.mapFile(fullPath, (ssize_t)offset, (ssize_t)tilesSize))
+            {
+                layer->_tiles = reinterpret_cast<uint32_t*>(layer->_tileData.getBytes());
+            }
+            else
+            {
+                layer->_tiles = (uint32_t*)malloc(tilesSize);
+                memcpy(layer->_tiles, bytes, tilesSize);
+            }
+        }
+    }
+
+    Vector<TMXObjectGroup*> objectGroups;
+    uint32_t objectGroupCount = reader.readUInt();
+    for (uint32_t i = 0; i < objectGroupCount && !reader.hasFailed(); ++i)
+    {
+        auto objectGroup = new (std::nothrow) TMXObjectGroup();
+        objectGroups.pushBack(objectGroup);
+        objectGroup->release();
+
+        objectGroup->setGroupName(reader.readString());
+        objectGroup->setPositionOffset(reader.readVec2());
+        objectGroup->setProperties(reader.readValueMap());
+        objectGroup->setObjects(reader.readValueVector());
+    }
+
+    if (reader.hasFailed())
+        return false;
+
+    _properties = std::move(properties);
+    _tileProperties = std::move(tileProperties);
+    _externalTilesetFilename = externalTilesetFilename;
+    _externalTilesetSources = std::move(externalTilesetSources);
+    _tilesets = tilesets;
+    _layers = layers;
+    _objectGroups = objectGroups;
+    return true;
+}
+
 NS_CC_END
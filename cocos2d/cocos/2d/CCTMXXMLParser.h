@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "base/CCVector.h"
 #include "base/CCValue.h"
 #include "base/CCMap.h"
+#include "base/CCData.h"
 #include "2d/CCTMXObjectGroup.h" // needed for Vector<TMXObjectGroup*> for binding
 
 #include <string>
@@ -65,6 +66,7 @@ enum {
     TMXLayerAttribGzip = 1 << 2,
     TMXLayerAttribZlib = 1 << 3,
     TMXLayerAttribCSV = 1 << 4,
+    TMXLayerAttribBinary = 1 << 5,
 };
 
 enum {
@@ -111,6 +113,18 @@ public:
     void setProperties(const ValueMap& properties);
     ValueMap& getProperties();
 
+    /** Uses the gids of a binary tile data file instead of the ones stored in the TMX file.
+     * The file is memory mapped when possible, so the pages of a huge layer are only
+     * read when the tiles on them are first used.
+     * The file must match the layer size; on failure the tiles are left untouched.
+     */
+    bool loadTileData(const std::string& fullPath);
+    /** Writes the gids of the layer as a binary tile data file that loadTileData() accepts.
+     * The file is a 16 bytes header ("CCTL", version, width, height as little endian uint32)
+     * followed by width * height little endian gids, row by row.
+     */
+    bool saveTileData(const std::string& fullPath) const;
+
     ValueMap            _properties;
     std::string         _name;
     Size                _layerSize;
@@ -119,6 +133,8 @@ public:
     unsigned char       _opacity;
     bool                _ownTiles;
     Vec2               _offset;
+    /** the loaded tile data file, _tiles points into it when it is not null */
+    Data                _tileData;
 };
 
 /** @brief TMXTileAnimFrame contains the information about the frame of a animated tile like:
@@ -235,6 +251,23 @@ public:
     /* initializes parsing of an XML string, either a tmx (Map) string or tsx (Tileset) string */
     bool parseXMLString(const std::string& xmlString);
 
+    /** Sets the directory the maps loaded by initWithTMXFile() are cached in.
+     * The first load of a TMX file saves the parsed map there, the next ones load that binary copy instead of
+     * parsing the XML and decoding the layers. A cache is only used while the TMX file and its external tilesets
+     * are unchanged. The directory can also hold caches made offline with saveCache() and shipped with the game.
+     * Empty, the default, disables the cache.
+     */
+    static void setCacheDirectory(const std::string& directory);
+    static const std::string& getCacheDirectory();
+    /** path of the cache of a TMX file in the cache directory, empty when the cache is disabled */
+    static std::string getCachePath(const std::string& tmxFile);
+    /** Saves the map loaded from a TMX file to a cache file. */
+    bool saveCache(const std::string& cachePath) const;
+    /** Loads the map from a cache file instead of the TMX file given to internalInit().
+     * Fails, leaving the map empty, when the cache is invalid or the TMX file changed since it was saved.
+     */
+    bool loadCache(const std::string& cachePath);
+
     ValueMapIntKey& getTileProperties() { return _tileProperties; };
     void setTileProperties(const ValueMapIntKey& tileProperties) {
         _tileProperties = tileProperties;
@@ -334,6 +367,9 @@ public:
 
 protected:
     void internalInit(const std::string& tmxFileName, const std::string& resourcePath);
+    /** loads the file named by the "cc_tile_data" property of the layer, if any */
+    bool loadLayerTileData(TMXLayerInfo* layer);
+    std::string getExternalTilesetPath(const std::string& source) const;
 
     /// map orientation
     int    _orientation;
@@ -378,6 +414,8 @@ protected:
     bool _recordFirstGID;
     std::string _externalTilesetFilename;
     std::string _externalTilesetFullPath;
+    //! "source" of every external tileset, checked before using a cache
+    std::vector<std::string> _externalTilesetSources;
 };
 
 // end of tilemap_parallax_nodes group
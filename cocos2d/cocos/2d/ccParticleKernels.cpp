@@ -0,0 +1,931 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/ccParticleKernels.h"
+#include "2d/CCParticleSystem.h"
+#include "math/CCMathBase.h"
+
+#include <atomic>
+#include <cmath>
+
+//#define INCLUDE_SSE2      : SSE2 kernels included, always usable
+//#define INCLUDE_AVX2      : AVX2 kernels included, used when the cpu supports them
+//#define INCLUDE_NEON      : NEON kernels included, always usable
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INCLUDE_SSE2
+    #if defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+    #define INCLUDE_AVX2
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define INCLUDE_NEON
+#endif
+
+#ifdef INCLUDE_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef INCLUDE_AVX2
+#include <immintrin.h>
+    #ifdef _MSC_VER
+    #define TARGET_AVX2
+    #else
+    #define TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+#ifdef INCLUDE_NEON
+#include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace ParticleKernels {
+
+typedef int (*RandomKernel)(uint32_t* lanes, float* values, int count, float base, float variance);
+typedef int (*ClampKernel)(float* values, int count, float minValue, float maxValue);
+typedef int (*AddKernel)(float* values, int count, float value);
+typedef int (*IntegrateKernel)(float* values, const float* deltas, int count, float dt);
+typedef int (*DeltasKernel)(float* ends, const float* starts, const float* timeToLive, int count);
+typedef int (*PolarKernel)(float* x, float* y, int count);
+typedef int (*GravityKernel)(ParticleData& data, int count, float gravityX, float gravityY, float dt, float yScale);
+typedef int (*RadiusKernel)(ParticleData& data, int count, float dt, float yScale);
+
+namespace {
+
+struct KernelTable
+{
+    RandomKernel fillRandom;
+    ClampKernel clamp;
+    AddKernel add;
+    IntegrateKernel integrate;
+    DeltasKernel computeDeltas;
+    PolarKernel polarToCartesian;
+    GravityKernel updateGravity;
+    RadiusKernel updateRadius;
+};
+
+const KernelTable s_scalarKernels = {};
+
+// xorshift32, the state is never 0
+inline uint32_t nextRandom(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// 23 random mantissa bits under the exponent of 2, minus 3: uniform in [-1, 1)
+inline float randomM11(uint32_t& state)
+{
+    union {
+        uint32_t d;
+        float f;
+    } u;
+    u.d = (nextRandom(state) >> 9) | 0x40000000;
+    return u.f - 3.0f;
+}
+
+// Cephes sinf/cosf, shared by every vector path
+const float SINCOS_FOUR_OVER_PI = 1.27323954473516f;
+const float SINCOS_DP1 = -0.78515625f;
+const float SINCOS_DP2 = -2.4187564849853515625e-4f;
+const float SINCOS_DP3 = -3.77489497744594108e-8f;
+const float SIN_P0 = -1.9515295891e-4f;
+const float SIN_P1 = 8.3321608736e-3f;
+const float SIN_P2 = -1.6666654611e-1f;
+const float COS_P0 = 2.443315711809948e-5f;
+const float COS_P1 = -1.388731625493765e-3f;
+const float COS_P2 = 4.166664568298827e-2f;
+
+#ifdef INCLUDE_SSE2
+
+namespace sse2 {
+
+inline __m128 randomM11(__m128i& state)
+{
+    state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+    state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+    state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+    __m128i bits = _mm_or_si128(_mm_srli_epi32(state, 9), _mm_set1_epi32(0x40000000));
+    return _mm_sub_ps(_mm_castsi128_ps(bits), _mm_set1_ps(3.0f));
+}
+
+inline void sincos(__m128 x, __m128* sine, __m128* cosine)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    __m128 signSin = _mm_and_ps(x, signMask);
+    x = _mm_andnot_ps(signMask, x);
+
+    // octant, rounded up to even
+    __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(SINCOS_FOUR_OVER_PI)));
+    j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128 y = _mm_cvtepi32_ps(j);
+
+    signSin = _mm_xor_ps(signSin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+    __m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    __m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+    // x - y * pi / 4 in extended precision
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(SINCOS_DP1)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(SINCOS_DP2)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(SINCOS_DP3)));
+    __m128 z = _mm_mul_ps(x, x);
+
+    __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(COS_P0), z), _mm_set1_ps(COS_P1));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(COS_P2));
+    c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+    c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+    __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_P0), z), _mm_set1_ps(SIN_P1));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(SIN_P2));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), x), x);
+
+    __m128 sinPoly = _mm_or_ps(_mm_and_ps(polyMask, s), _mm_andnot_ps(polyMask, c));
+    __m128 cosPoly = _mm_or_ps(_mm_and_ps(polyMask, c), _mm_andnot_ps(polyMask, s));
+    *sine = _mm_xor_ps(sinPoly, signSin);
+    *cosine = _mm_xor_ps(cosPoly, signCos);
+}
+
+int fillRandom(uint32_t* lanes, float* values, int count, float base, float variance)
+{
+    __m128i low = _mm_loadu_si128((const __m128i*)lanes);
+    __m128i high = _mm_loadu_si128((const __m128i*)(lanes + 4));
+    const __m128 b = _mm_set1_ps(base);
+    const __m128 v = _mm_set1_ps(variance);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm_storeu_ps(values + i, _mm_add_ps(b, _mm_mul_ps(v, randomM11(low))));
+        _mm_storeu_ps(values + i + 4, _mm_add_ps(b, _mm_mul_ps(v, randomM11(high))));
+    }
+    _mm_storeu_si128((__m128i*)lanes, low);
+    _mm_storeu_si128((__m128i*)(lanes + 4), high);
+    return i;
+}
+
+int clamp(float* values, int count, float minValue, float maxValue)
+{
+    const __m128 low = _mm_set1_ps(minValue);
+    const __m128 high = _mm_set1_ps(maxValue);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(values + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(values + i), low), high));
+    }
+    return i;
+}
+
+int add(float* values, int count, float value)
+{
+    const __m128 v = _mm_set1_ps(value);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), v));
+    }
+    return i;
+}
+
+int integrate(float* values, const float* deltas, int count, float dt)
+{
+    const __m128 t = _mm_set1_ps(dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), t)));
+    }
+    return i;
+}
+
+int computeDeltas(float* ends, const float* starts, const float* timeToLive, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 delta = _mm_sub_ps(_mm_loadu_ps(ends + i), _mm_loadu_ps(starts + i));
+        _mm_storeu_ps(ends + i, _mm_div_ps(delta, _mm_loadu_ps(timeToLive + i)));
+    }
+    return i;
+}
+
+int polarToCartesian(float* x, float* y, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s, c;
+        sincos(_mm_loadu_ps(x + i), &s, &c);
+        __m128 length = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(x + i, _mm_mul_ps(c, length));
+        _mm_storeu_ps(y + i, _mm_mul_ps(s, length));
+    }
+    return i;
+}
+
+int updateGravity(ParticleData& data, int count, float gravityX, float gravityY, float dt, float yScale)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 tolerance = _mm_set1_ps(MATH_TOLERANCE);
+    const __m128 gx = _mm_set1_ps(gravityX);
+    const __m128 gy = _mm_set1_ps(gravityY);
+    const __m128 t = _mm_set1_ps(dt);
+    const __m128 scale = _mm_set1_ps(yScale);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(data.posx + i);
+        __m128 y = _mm_loadu_ps(data.posy + i);
+
+        // like normalize_point, unit and tiny vectors leave the radial direction at zero
+        __m128 squared = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        __m128 length = _mm_sqrt_ps(squared);
+        __m128 normalize = _mm_and_ps(_mm_cmpneq_ps(squared, one), _mm_cmpge_ps(length, tolerance));
+        __m128 inverse = _mm_div_ps(one, length);
+        __m128 radialX = _mm_and_ps(normalize, _mm_mul_ps(x, inverse));
+        __m128 radialY = _mm_and_ps(normalize, _mm_mul_ps(y, inverse));
+
+        __m128 radialAccel = _mm_loadu_ps(data.modeA.radialAccel + i);
+        __m128 tangentialAccel = _mm_loadu_ps(data.modeA.tangentialAccel + i);
+        __m128 tangentialX = _mm_mul_ps(radialY, _mm_xor_ps(tangentialAccel, signMask));
+        __m128 tangentialY = _mm_mul_ps(radialX, tangentialAccel);
+
+        __m128 accelX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(radialX, radialAccel), tangentialX), gx);
+        __m128 accelY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(radialY, radialAccel), tangentialY), gy);
+        __m128 dirX = _mm_add_ps(_mm_loadu_ps(data.modeA.dirX + i), _mm_mul_ps(accelX, t));
+        __m128 dirY = _mm_add_ps(_mm_loadu_ps(data.modeA.dirY + i), _mm_mul_ps(accelY, t));
+        _mm_storeu_ps(data.modeA.dirX + i, dirX);
+        _mm_storeu_ps(data.modeA.dirY + i, dirY);
+
+        _mm_storeu_ps(data.posx + i, _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(dirX, t), scale)));
+        _mm_storeu_ps(data.posy + i, _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(dirY, t), scale)));
+    }
+    return i;
+}
+
+int updateRadius(ParticleData& data, int count, float dt, float yScale)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    const __m128 t = _mm_set1_ps(dt);
+    const __m128 scale = _mm_set1_ps(yScale);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 angle = _mm_add_ps(_mm_loadu_ps(data.modeB.angle + i), _mm_mul_ps(_mm_loadu_ps(data.modeB.degreesPerSecond + i), t));
+        __m128 radius = _mm_add_ps(_mm_loadu_ps(data.modeB.radius + i), _mm_mul_ps(_mm_loadu_ps(data.modeB.deltaRadius + i), t));
+        _mm_storeu_ps(data.modeB.angle + i, angle);
+        _mm_storeu_ps(data.modeB.radius + i, radius);
+
+        __m128 s, c;
+        sincos(angle, &s, &c);
+        _mm_storeu_ps(data.posx + i, _mm_mul_ps(_mm_xor_ps(c, signMask), radius));
+        _mm_storeu_ps(data.posy + i, _mm_mul_ps(_mm_mul_ps(_mm_xor_ps(s, signMask), radius), scale));
+    }
+    return i;
+}
+
+} // namespace sse2
+
+const KernelTable s_sse2Kernels = {
+    sse2::fillRandom,
+    sse2::clamp,
+    sse2::add,
+    sse2::integrate,
+    sse2::computeDeltas,
+    sse2::polarToCartesian,
+    sse2::updateGravity,
+    sse2::updateRadius,
+};
+
+#endif // INCLUDE_SSE2
+
+#ifdef INCLUDE_AVX2
+
+namespace avx2 {
+
+TARGET_AVX2 inline __m256 randomM11(__m256i& state)
+{
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+    state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+    __m256i bits = _mm256_or_si256(_mm256_srli_epi32(state, 9), _mm256_set1_epi32(0x40000000));
+    return _mm256_sub_ps(_mm256_castsi256_ps(bits), _mm256_set1_ps(3.0f));
+}
+
+TARGET_AVX2 inline void sincos(__m256 x, __m256* sine, __m256* cosine)
+{
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+    __m256 signSin = _mm256_and_ps(x, signMask);
+    x = _mm256_andnot_ps(signMask, x);
+
+    // octant, rounded up to even
+    __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(SINCOS_FOUR_OVER_PI)));
+    j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    __m256 y = _mm256_cvtepi32_ps(j);
+
+    signSin = _mm256_xor_ps(signSin, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29)));
+    __m256 signCos = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    __m256 polyMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+    // x - y * pi / 4 in extended precision
+    x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(SINCOS_DP1)));
+    x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(SINCOS_DP2)));
+    x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(SINCOS_DP3)));
+    __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(COS_P0), z), _mm256_set1_ps(COS_P1));
+    c = _mm256_add_ps(_mm256_mul_ps(c, z), _mm256_set1_ps(COS_P2));
+    c = _mm256_mul_ps(_mm256_mul_ps(c, z), z);
+    c = _mm256_add_ps(_mm256_sub_ps(c, _mm256_mul_ps(z, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.0f));
+
+    __m256 s = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(SIN_P0), z), _mm256_set1_ps(SIN_P1));
+    s = _mm256_add_ps(_mm256_mul_ps(s, z), _mm256_set1_ps(SIN_P2));
+    s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, z), x), x);
+
+    *sine = _mm256_xor_ps(_mm256_blendv_ps(c, s, polyMask), signSin);
+    *cosine = _mm256_xor_ps(_mm256_blendv_ps(s, c, polyMask), signCos);
+}
+
+TARGET_AVX2 int fillRandom(uint32_t* lanes, float* values, int count, float base, float variance)
+{
+    __m256i state = _mm256_loadu_si256((const __m256i*)lanes);
+    const __m256 b = _mm256_set1_ps(base);
+    const __m256 v = _mm256_set1_ps(variance);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(values + i, _mm256_add_ps(b, _mm256_mul_ps(v, randomM11(state))));
+    }
+    _mm256_storeu_si256((__m256i*)lanes, state);
+    return i;
+}
+
+TARGET_AVX2 int clamp(float* values, int count, float minValue, float maxValue)
+{
+    const __m256 low = _mm256_set1_ps(minValue);
+    const __m256 high = _mm256_set1_ps(maxValue);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(values + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(values + i), low), high));
+    }
+    return i;
+}
+
+TARGET_AVX2 int add(float* values, int count, float value)
+{
+    const __m256 v = _mm256_set1_ps(value);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), v));
+    }
+    return i;
+}
+
+TARGET_AVX2 int integrate(float* values, const float* deltas, int count, float dt)
+{
+    const __m256 t = _mm256_set1_ps(dt);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), _mm256_mul_ps(_mm256_loadu_ps(deltas + i), t)));
+    }
+    return i;
+}
+
+TARGET_AVX2 int computeDeltas(float* ends, const float* starts, const float* timeToLive, int count)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 delta = _mm256_sub_ps(_mm256_loadu_ps(ends + i), _mm256_loadu_ps(starts + i));
+        _mm256_storeu_ps(ends + i, _mm256_div_ps(delta, _mm256_loadu_ps(timeToLive + i)));
+    }
+    return i;
+}
+
+TARGET_AVX2 int polarToCartesian(float* x, float* y, int count)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 s, c;
+        sincos(_mm256_loadu_ps(x + i), &s, &c);
+        __m256 length = _mm256_loadu_ps(y + i);
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(c, length));
+        _mm256_storeu_ps(y + i, _mm256_mul_ps(s, length));
+    }
+    return i;
+}
+
+TARGET_AVX2 int updateGravity(ParticleData& data, int count, float gravityX, float gravityY, float dt, float yScale)
+{
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 tolerance = _mm256_set1_ps(MATH_TOLERANCE);
+    const __m256 gx = _mm256_set1_ps(gravityX);
+    const __m256 gy = _mm256_set1_ps(gravityY);
+    const __m256 t = _mm256_set1_ps(dt);
+    const __m256 scale = _mm256_set1_ps(yScale);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(data.posx + i);
+        __m256 y = _mm256_loadu_ps(data.posy + i);
+
+        // like normalize_point, unit and tiny vectors leave the radial direction at zero
+        __m256 squared = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+        __m256 length = _mm256_sqrt_ps(squared);
+        __m256 normalize = _mm256_and_ps(_mm256_cmp_ps(squared, one, _CMP_NEQ_UQ), _mm256_cmp_ps(length, tolerance, _CMP_GE_OQ));
+        __m256 inverse = _mm256_div_ps(one, length);
+        __m256 radialX = _mm256_and_ps(normalize, _mm256_mul_ps(x, inverse));
+        __m256 radialY = _mm256_and_ps(normalize, _mm256_mul_ps(y, inverse));
+
+        __m256 radialAccel = _mm256_loadu_ps(data.modeA.radialAccel + i);
+        __m256 tangentialAccel = _mm256_loadu_ps(data.modeA.tangentialAccel + i);
+        __m256 tangentialX = _mm256_mul_ps(radialY, _mm256_xor_ps(tangentialAccel, signMask));
+        __m256 tangentialY = _mm256_mul_ps(radialX, tangentialAccel);
+
+        __m256 accelX = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(radialX, radialAccel), tangentialX), gx);
+        __m256 accelY = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(radialY, radialAccel), tangentialY), gy);
+        __m256 dirX = _mm256_add_ps(_mm256_loadu_ps(data.modeA.dirX + i), _mm256_mul_ps(accelX, t));
+        __m256 dirY = _mm256_add_ps(_mm256_loadu_ps(data.modeA.dirY + i), _mm256_mul_ps(accelY, t));
+        _mm256_storeu_ps(data.modeA.dirX + i, dirX);
+        _mm256_storeu_ps(data.modeA.dirY + i, dirY);
+
+        _mm256_storeu_ps(data.posx + i, _mm256_add_ps(x, _mm256_mul_ps(_mm256_mul_ps(dirX, t), scale)));
+        _mm256_storeu_ps(data.posy + i, _mm256_add_ps(y, _mm256_mul_ps(_mm256_mul_ps(dirY, t), scale)));
+    }
+    return i;
+}
+
+TARGET_AVX2 int updateRadius(ParticleData& data, int count, float dt, float yScale)
+{
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+    const __m256 t = _mm256_set1_ps(dt);
+    const __m256 scale = _mm256_set1_ps(yScale);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 angle = _mm256_add_ps(_mm256_loadu_ps(data.modeB.angle + i), _mm256_mul_ps(_mm256_loadu_ps(data.modeB.degreesPerSecond + i), t));
+        __m256 radius = _mm256_add_ps(_mm256_loadu_ps(data.modeB.radius + i), _mm256_mul_ps(_mm256_loadu_ps(data.modeB.deltaRadius + i), t));
+        _mm256_storeu_ps(data.modeB.angle + i, angle);
+        _mm256_storeu_ps(data.modeB.radius + i, radius);
+
+        __m256 s, c;
+        sincos(angle, &s, &c);
+        _mm256_storeu_ps(data.posx + i, _mm256_mul_ps(_mm256_xor_ps(c, signMask), radius));
+        _mm256_storeu_ps(data.posy + i, _mm256_mul_ps(_mm256_mul_ps(_mm256_xor_ps(s, signMask), radius), scale));
+    }
+    return i;
+}
+
+} // namespace avx2
+
+const KernelTable s_avx2Kernels = {
+    avx2::fillRandom,
+    avx2::clamp,
+    avx2::add,
+    avx2::integrate,
+    avx2::computeDeltas,
+    avx2::polarToCartesian,
+    avx2::updateGravity,
+    avx2::updateRadius,
+};
+
+#endif // INCLUDE_AVX2
+
+#ifdef INCLUDE_NEON
+
+namespace neon {
+
+inline float32x4_t randomM11(uint32x4_t& state)
+{
+    state = veorq_u32(state, vshlq_n_u32(state, 13));
+    state = veorq_u32(state, vshrq_n_u32(state, 17));
+    state = veorq_u32(state, vshlq_n_u32(state, 5));
+    uint32x4_t bits = vorrq_u32(vshrq_n_u32(state, 9), vdupq_n_u32(0x40000000));
+    return vsubq_f32(vreinterpretq_f32_u32(bits), vdupq_n_f32(3.0f));
+}
+
+// armv7 has no vector division, two Newton steps on the estimate are within an ulp or two
+inline float32x4_t divide(float32x4_t a, float32x4_t b)
+{
+#ifdef __aarch64__
+    return vdivq_f32(a, b);
+#else
+    float32x4_t inverse = vrecpeq_f32(b);
+    inverse = vmulq_f32(vrecpsq_f32(b, inverse), inverse);
+    inverse = vmulq_f32(vrecpsq_f32(b, inverse), inverse);
+    return vmulq_f32(a, inverse);
+#endif
+}
+
+inline void sincos(float32x4_t x, float32x4_t* sine, float32x4_t* cosine)
+{
+    uint32x4_t signSin = vcltq_f32(x, vdupq_n_f32(0.0f));
+    x = vabsq_f32(x);
+
+    // octant, rounded up to even
+    uint32x4_t j = vcvtq_u32_f32(vmulq_f32(x, vdupq_n_f32(SINCOS_FOUR_OVER_PI)));
+    j = vandq_u32(vaddq_u32(j, vdupq_n_u32(1)), vdupq_n_u32(~1u));
+    float32x4_t y = vcvtq_f32_u32(j);
+
+    signSin = veorq_u32(signSin, vtstq_u32(j, vdupq_n_u32(4)));
+    uint32x4_t positiveCos = vtstq_u32(vsubq_u32(j, vdupq_n_u32(2)), vdupq_n_u32(4));
+    uint32x4_t polyMask = vtstq_u32(j, vdupq_n_u32(2));
+
+    // x - y * pi / 4 in extended precision
+    x = vaddq_f32(x, vmulq_f32(y, vdupq_n_f32(SINCOS_DP1)));
+    x = vaddq_f32(x, vmulq_f32(y, vdupq_n_f32(SINCOS_DP2)));
+    x = vaddq_f32(x, vmulq_f32(y, vdupq_n_f32(SINCOS_DP3)));
+    float32x4_t z = vmulq_f32(x, x);
+
+    float32x4_t c = vaddq_f32(vmulq_f32(vdupq_n_f32(COS_P0), z), vdupq_n_f32(COS_P1));
+    c = vaddq_f32(vmulq_f32(c, z), vdupq_n_f32(COS_P2));
+    c = vmulq_f32(vmulq_f32(c, z), z);
+    c = vaddq_f32(vsubq_f32(c, vmulq_f32(z, vdupq_n_f32(0.5f))), vdupq_n_f32(1.0f));
+
+    float32x4_t s = vaddq_f32(vmulq_f32(vdupq_n_f32(SIN_P0), z), vdupq_n_f32(SIN_P1));
+    s = vaddq_f32(vmulq_f32(s, z), vdupq_n_f32(SIN_P2));
+    s = vaddq_f32(vmulq_f32(vmulq_f32(s, z), x), x);
+
+    float32x4_t sinPoly = vbslq_f32(polyMask, c, s);
+    float32x4_t cosPoly = vbslq_f32(polyMask, s, c);
+    *sine = vbslq_f32(signSin, vnegq_f32(sinPoly), sinPoly);
+    *cosine = vbslq_f32(positiveCos, cosPoly, vnegq_f32(cosPoly));
+}
+
+int fillRandom(uint32_t* lanes, float* values, int count, float base, float variance)
+{
+    uint32x4_t low = vld1q_u32(lanes);
+    uint32x4_t high = vld1q_u32(lanes + 4);
+    const float32x4_t b = vdupq_n_f32(base);
+    const float32x4_t v = vdupq_n_f32(variance);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_f32(values + i, vaddq_f32(b, vmulq_f32(v, randomM11(low))));
+        vst1q_f32(values + i + 4, vaddq_f32(b, vmulq_f32(v, randomM11(high))));
+    }
+    vst1q_u32(lanes, low);
+    vst1q_u32(lanes + 4, high);
+    return i;
+}
+
+int clamp(float* values, int count, float minValue, float maxValue)
+{
+    const float32x4_t low = vdupq_n_f32(minValue);
+    const float32x4_t high = vdupq_n_f32(maxValue);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(values + i, vminq_f32(vmaxq_f32(vld1q_f32(values + i), low), high));
+    }
+    return i;
+}
+
+int add(float* values, int count, float value)
+{
+    const float32x4_t v = vdupq_n_f32(value);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), v));
+    }
+    return i;
+}
+
+int integrate(float* values, const float* deltas, int count, float dt)
+{
+    const float32x4_t t = vdupq_n_f32(dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), vmulq_f32(vld1q_f32(deltas + i), t)));
+    }
+    return i;
+}
+
+int computeDeltas(float* ends, const float* starts, const float* timeToLive, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t delta = vsubq_f32(vld1q_f32(ends + i), vld1q_f32(starts + i));
+        vst1q_f32(ends + i, divide(delta, vld1q_f32(timeToLive + i)));
+    }
+    return i;
+}
+
+int polarToCartesian(float* x, float* y, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t s, c;
+        sincos(vld1q_f32(x + i), &s, &c);
+        float32x4_t length = vld1q_f32(y + i);
+        vst1q_f32(x + i, vmulq_f32(c, length));
+        vst1q_f32(y + i, vmulq_f32(s, length));
+    }
+    return i;
+}
+
+int updateGravity(ParticleData& data, int count, float gravityX, float gravityY, float dt, float yScale)
+{
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t tolerance = vdupq_n_f32(MATH_TOLERANCE);
+    const float32x4_t gx = vdupq_n_f32(gravityX);
+    const float32x4_t gy = vdupq_n_f32(gravityY);
+    const float32x4_t t = vdupq_n_f32(dt);
+    const float32x4_t scale = vdupq_n_f32(yScale);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t x = vld1q_f32(data.posx + i);
+        float32x4_t y = vld1q_f32(data.posy + i);
+
+        // like normalize_point, unit and tiny vectors leave the radial direction at zero
+        float32x4_t squared = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+#ifdef __aarch64__
+        float32x4_t length = vsqrtq_f32(squared);
+        float32x4_t inverse = vdivq_f32(one, length);
+#else
+        // 0 * inf is a NaN for zero vectors, it fails the tolerance test below
+        float32x4_t inverse = vrsqrteq_f32(squared);
+        inverse = vmulq_f32(vrsqrtsq_f32(vmulq_f32(squared, inverse), inverse), inverse);
+        inverse = vmulq_f32(vrsqrtsq_f32(vmulq_f32(squared, inverse), inverse), inverse);
+        float32x4_t length = vmulq_f32(squared, inverse);
+#endif
+        uint32x4_t normalize = vandq_u32(vmvnq_u32(vceqq_f32(squared, one)), vcgeq_f32(length, tolerance));
+        float32x4_t radialX = vreinterpretq_f32_u32(vandq_u32(normalize, vreinterpretq_u32_f32(vmulq_f32(x, inverse))));
+        float32x4_t radialY = vreinterpretq_f32_u32(vandq_u32(normalize, vreinterpretq_u32_f32(vmulq_f32(y, inverse))));
+
+        float32x4_t radialAccel = vld1q_f32(data.modeA.radialAccel + i);
+        float32x4_t tangentialAccel = vld1q_f32(data.modeA.tangentialAccel + i);
+        float32x4_t tangentialX = vmulq_f32(radialY, vnegq_f32(tangentialAccel));
+        float32x4_t tangentialY = vmulq_f32(radialX, tangentialAccel);
+
+        float32x4_t accelX = vaddq_f32(vaddq_f32(vmulq_f32(radialX, radialAccel), tangentialX), gx);
+        float32x4_t accelY = vaddq_f32(vaddq_f32(vmulq_f32(radialY, radialAccel), tangentialY), gy);
+        float32x4_t dirX = vaddq_f32(vld1q_f32(data.modeA.dirX + i), vmulq_f32(accelX, t));
+        float32x4_t dirY = vaddq_f32(vld1q_f32(data.modeA.dirY + i), vmulq_f32(accelY, t));
+        vst1q_f32(data.modeA.dirX + i, dirX);
+        vst1q_f32(data.modeA.dirY + i, dirY);
+
+        vst1q_f32(data.posx + i, vaddq_f32(x, vmulq_f32(vmulq_f32(dirX, t), scale)));
+        vst1q_f32(data.posy + i, vaddq_f32(y, vmulq_f32(vmulq_f32(dirY, t), scale)));
+    }
+    return i;
+}
+
+int updateRadius(ParticleData& data, int count, float dt, float yScale)
+{
+    const float32x4_t t = vdupq_n_f32(dt);
+    const float32x4_t scale = vdupq_n_f32(yScale);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t angle = vaddq_f32(vld1q_f32(data.modeB.angle + i), vmulq_f32(vld1q_f32(data.modeB.degreesPerSecond + i), t));
+        float32x4_t radius = vaddq_f32(vld1q_f32(data.modeB.radius + i), vmulq_f32(vld1q_f32(data.modeB.deltaRadius + i), t));
+        vst1q_f32(data.modeB.angle + i, angle);
+        vst1q_f32(data.modeB.radius + i, radius);
+
+        float32x4_t s, c;
+        sincos(angle, &s, &c);
+        vst1q_f32(data.posx + i, vmulq_f32(vnegq_f32(c), radius));
+        vst1q_f32(data.posy + i, vmulq_f32(vmulq_f32(vnegq_f32(s), radius), scale));
+    }
+    return i;
+}
+
+} // namespace neon
+
+const KernelTable s_neonKernels = {
+    neon::fillRandom,
+    neon::clamp,
+    neon::add,
+    neon::integrate,
+    neon::computeDeltas,
+    neon::polarToCartesian,
+    neon::updateGravity,
+    neon::updateRadius,
+};
+
+#endif // INCLUDE_NEON
+
+// the kernels run on the particle simulation threads while the level may be changed
+std::atomic<const KernelTable*> s_kernels(nullptr);
+std::atomic<int> s_level(-1);
+
+const KernelTable* kernelsForLevel(SIMDLevel level)
+{
+    switch (level)
+    {
+#ifdef INCLUDE_SSE2
+    case SIMDLevel::SSE2:
+        return &s_sse2Kernels;
+#endif
+#ifdef INCLUDE_AVX2
+    case SIMDLevel::AVX2:
+        return &s_avx2Kernels;
+#endif
+#ifdef INCLUDE_NEON
+    case SIMDLevel::NEON:
+        return &s_neonKernels;
+#endif
+    default:
+        return &s_scalarKernels;
+    }
+}
+
+const KernelTable& kernels()
+{
+    const KernelTable* table = s_kernels.load(std::memory_order_acquire);
+    if (table == nullptr)
+    {
+        SIMDLevel level = PixelConvert::getSupportedSIMDLevel();
+        s_level.store((int)level, std::memory_order_relaxed);
+        table = kernelsForLevel(level);
+        s_kernels.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+} // namespace
+
+SIMDLevel getSIMDLevel()
+{
+    kernels();
+    return (SIMDLevel)s_level.load(std::memory_order_relaxed);
+}
+
+void setSIMDLevel(SIMDLevel level)
+{
+    SIMDLevel supported = PixelConvert::getSupportedSIMDLevel();
+    if (level != SIMDLevel::NONE && level != supported)
+    {
+        // SSE2 is the only level below another one
+        level = (level == SIMDLevel::SSE2 && supported == SIMDLevel::AVX2) ? level : supported;
+    }
+    s_level.store((int)level, std::memory_order_relaxed);
+    s_kernels.store(kernelsForLevel(level), std::memory_order_release);
+}
+
+Random::Random(uint32_t seed)
+{
+    // murmur3 finalizer over consecutive seeds, so close seeds give unrelated lanes
+    for (int i = 0; i < 8; ++i)
+    {
+        uint32_t h = seed + 0x9E3779B9u * (i + 1);
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        lanes[i] = h ? h : 0x6B43A9B5u;
+    }
+}
+
+void fillRandom(Random& random, float* values, int count, float base, float variance)
+{
+    RandomKernel kernel = kernels().fillRandom;
+    int i = kernel ? kernel(random.lanes, values, count, base, variance) : 0;
+    // the kernels stop on a multiple of 8, so value i still comes from lane i % 8
+    for (; i < count; ++i)
+    {
+        values[i] = base + variance * randomM11(random.lanes[i % 8]);
+    }
+}
+
+void clamp(float* values, int count, float minValue, float maxValue)
+{
+    ClampKernel kernel = kernels().clamp;
+    int i = kernel ? kernel(values, count, minValue, maxValue) : 0;
+    for (; i < count; ++i)
+    {
+        values[i] = clampf(values[i], minValue, maxValue);
+    }
+}
+
+void add(float* values, int count, float value)
+{
+    AddKernel kernel = kernels().add;
+    int i = kernel ? kernel(values, count, value) : 0;
+    for (; i < count; ++i)
+    {
+        values[i] += value;
+    }
+}
+
+void integrate(float* values, const float* deltas, int count, float dt)
+{
+    IntegrateKernel kernel = kernels().integrate;
+    int i = kernel ? kernel(values, deltas, count, dt) : 0;
+    for (; i < count; ++i)
+    {
+        values[i] += deltas[i] * dt;
+    }
+}
+
+void computeDeltas(float* ends, const float* starts, const float* timeToLive, int count)
+{
+    DeltasKernel kernel = kernels().computeDeltas;
+    int i = kernel ? kernel(ends, starts, timeToLive, count) : 0;
+    for (; i < count; ++i)
+    {
+        ends[i] = (ends[i] - starts[i]) / timeToLive[i];
+    }
+}
+
+void polarToCartesian(float* x, float* y, int count)
+{
+    PolarKernel kernel = kernels().polarToCartesian;
+    int i = kernel ? kernel(x, y, count) : 0;
+    for (; i < count; ++i)
+    {
+        float angle = x[i];
+        x[i] = cosf(angle) * y[i];
+        y[i] = sinf(angle) * y[i];
+    }
+}
+
+void updateGravity(ParticleData& data, int count, float gravityX, float gravityY, float dt, float yScale)
+{
+    GravityKernel kernel = kernels().updateGravity;
+    int i = kernel ? kernel(data, count, gravityX, gravityY, dt, yScale) : 0;
+    for (; i < count; ++i)
+    {
+        float x = data.posx[i];
+        float y = data.posy[i];
+        float radialX = 0.0f, radialY = 0.0f;
+
+        // radial acceleration, unit and tiny vectors are left as they are by normalize_point
+        float squared = x * x + y * y;
+        if (squared != 1.0f)
+        {
+            float length = sqrtf(squared);
+            if (length >= MATH_TOLERANCE)
+            {
+                float inverse = 1.0f / length;
+                radialX = x * inverse;
+                radialY = y * inverse;
+            }
+        }
+
+        // tangential acceleration, the radial direction turned by 90 degrees
+        float tangentialX = radialY * -data.modeA.tangentialAccel[i];
+        float tangentialY = radialX * data.modeA.tangentialAccel[i];
+
+        // (gravity + radial + tangential) * dt
+        float accelX = radialX * data.modeA.radialAccel[i] + tangentialX + gravityX;
+        float accelY = radialY * data.modeA.radialAccel[i] + tangentialY + gravityY;
+        data.modeA.dirX[i] += accelX * dt;
+        data.modeA.dirY[i] += accelY * dt;
+
+        data.posx[i] = x + data.modeA.dirX[i] * dt * yScale;
+        data.posy[i] = y + data.modeA.dirY[i] * dt * yScale;
+    }
+}
+
+void updateRadius(ParticleData& data, int count, float dt, float yScale)
+{
+    RadiusKernel kernel = kernels().updateRadius;
+    int i = kernel ? kernel(data, count, dt, yScale) : 0;
+    for (; i < count; ++i)
+    {
+        data.modeB.angle[i] += data.modeB.degreesPerSecond[i] * dt;
+        data.modeB.radius[i] += data.modeB.deltaRadius[i] * dt;
+        data.posx[i] = - cosf(data.modeB.angle[i]) * data.modeB.radius[i];
+        data.posy[i] = - sinf(data.modeB.angle[i]) * data.modeB.radius[i] * yScale;
+    }
+}
+
+} // namespace ParticleKernels
+
+NS_CC_END
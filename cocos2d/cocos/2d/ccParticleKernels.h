@@ -0,0 +1,102 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCPARTICLEKERNELS_H__
+#define __CCPARTICLEKERNELS_H__
+
+#include <stdint.h>
+
+#include "platform/CCPlatformMacros.h"
+#include "renderer/ccPixelConvert.h"
+
+NS_CC_BEGIN
+
+class ParticleData;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** Vectorized kernels behind the emission and the update of ParticleSystem.
+ *
+ * The kernels work on the arrays of ParticleData, a few lanes at a time, and finish the elements left over with
+ * the scalar loop of the same function, which is the reference implementation. The sine and cosine of the vector
+ * paths are polynomial approximations, so their results match the scalar ones within a few ulps, not bit for bit.
+ * The kernels have no state and may run on the particle simulation threads.
+ * @js NA
+ * @lua NA
+ */
+namespace ParticleKernels {
+
+typedef PixelConvert::SIMDLevel SIMDLevel;
+
+/** Level the kernels currently use. Defaults to PixelConvert::getSupportedSIMDLevel(). */
+SIMDLevel CC_DLL getSIMDLevel();
+
+/** Selects the level the kernels use, clamped to the supported one. SIMDLevel::NONE forces the scalar loops. */
+void CC_DLL setSIMDLevel(SIMDLevel level);
+
+/** Eight interleaved xorshift32 generators. Value i of a fill comes from generator i % 8, so every SIMD level
+ * draws the same numbers from the same seed.
+ */
+struct CC_DLL Random
+{
+    explicit Random(uint32_t seed);
+
+    uint32_t lanes[8];
+};
+
+/** values[i] = base + variance * r, r uniform in [-1, 1). */
+void CC_DLL fillRandom(Random& random, float* values, int count, float base, float variance);
+
+/** Clamps values to [minValue, maxValue]. */
+void CC_DLL clamp(float* values, int count, float minValue, float maxValue);
+
+/** values[i] += value */
+void CC_DLL add(float* values, int count, float value);
+
+/** values[i] += deltas[i] * dt */
+void CC_DLL integrate(float* values, const float* deltas, int count, float dt);
+
+/** Turns end values into the deltas reaching them at the end of the life: ends[i] = (ends[i] - starts[i]) / timeToLive[i]. */
+void CC_DLL computeDeltas(float* ends, const float* starts, const float* timeToLive, int count);
+
+/** Turns angles in x (radians) and lengths in y into the vectors (cos(x) * y, sin(x) * y). */
+void CC_DLL polarToCartesian(float* x, float* y, int count);
+
+/** Mode A: applies the radial, tangential and gravity accelerations to the directions, then moves the particles. */
+void CC_DLL updateGravity(ParticleData& data, int count, float gravityX, float gravityY, float dt, float yScale);
+
+/** Mode B: rotates the particles around the emitter and moves them to their new radius. */
+void CC_DLL updateRadius(ParticleData& data, int count, float dt, float yScale);
+
+} // namespace ParticleKernels
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPARTICLEKERNELS_H__
@@ -44,6 +44,8 @@ cocos2d.cpp \
 2d/CCFastTMXTiledMap.cpp \
 2d/CCFont.cpp \
 2d/CCFontAtlas.cpp \
+2d/CCSkylinePacker.cpp \
+2d/CCMSDFGenerator.cpp \
 2d/CCFontAtlasCache.cpp \
 2d/CCFontCharMap.cpp \
 2d/CCFontFNT.cpp \
@@ -67,6 +69,7 @@ cocos2d.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
 2d/CCParticleSystem.cpp \
+2d/ccParticleKernels.cpp \
 2d/CCParticleSystemQuad.cpp \
 2d/CCProgressTimer.cpp \
 2d/CCProtectedNode.cpp \
@@ -94,6 +97,9 @@ platform/CCFileUtils.cpp \
 platform/CCGLView.cpp \
 platform/CCImage.cpp \
 platform/CCSAXParser.cpp \
+platform/CCPlistReader.cpp \
+platform/CCAssetManifest.cpp \
+platform/CCAssetPack.cpp \
 platform/CCThread.cpp \
 $(MATHNEONFILE) \
 math/CCAffineTransform.cpp \
@@ -141,6 +147,8 @@ base/CCRef.cpp \
 base/CCScheduler.cpp \
 base/CCScriptSupport.cpp \
 base/CCTouch.cpp \
+base/CCTouchSpatialIndex.cpp \
+base/CCFrameArena.cpp \
 base/CCUserDefault-android.cpp \
 base/CCUserDefault.cpp \
 base/CCValue.cpp \
@@ -148,6 +156,7 @@ base/ObjectFactory.cpp \
 base/TGAlib.cpp \
 base/ZipUtils.cpp \
 base/allocator/CCAllocatorDiagnostics.cpp \
+base/allocator/CCAllocatorStrategyPool.cpp \
 base/allocator/CCAllocatorGlobal.cpp \
 base/allocator/CCAllocatorGlobalNewDelete.cpp \
 base/atitc.cpp \
@@ -159,6 +168,7 @@ base/ccTypes.cpp \
 base/ccUTF8.cpp \
 base/ccUtils.cpp \
 base/etc1.cpp \
+base/etc2.cpp \
 base/pvr.cpp \
 base/s3tc.cpp \
 renderer/CCBatchCommand.cpp \
@@ -187,6 +197,7 @@ renderer/CCVertexAttribBinding.cpp \
 renderer/CCVertexIndexBuffer.cpp \
 renderer/CCVertexIndexData.cpp \
 renderer/ccGLStateCache.cpp \
+renderer/ccPixelConvert.cpp \
 renderer/CCFrameBuffer.cpp \
 renderer/ccShaders.cpp \
 vr/CCVRDistortion.cpp \
@@ -25,6 +25,9 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+#include "platform/CCThread.h"
+#endif
 
 NS_CC_BEGIN
 
@@ -104,6 +107,46 @@ void AutoreleasePool::dump()
 //
 //--------------------------------------------------------------------
 
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+
+// Releases the objects left in the pools of a thread when it exits.
+void PoolManager::destroyThreadInstance(void* instance)
+{
+    // the pools and the objects they release look the pool manager up while it is deleted
+    getThreadInstances().set(instance);
+    destroyInstance();
+}
+
+ThreadLocalPointer& PoolManager::getThreadInstances()
+{
+    // never deleted, threads may still exit after static destruction
+    static ThreadLocalPointer* s_instances = new ThreadLocalPointer(destroyThreadInstance);
+    return *s_instances;
+}
+
+PoolManager* PoolManager::getInstance()
+{
+    auto& instances = getThreadInstances();
+    auto instance = static_cast<PoolManager*>(instances.get());
+    if (instance == nullptr)
+    {
+        instance = new (std::nothrow) PoolManager();
+        instances.set(instance);
+        // Add the first auto release pool
+        new AutoreleasePool("cocos2d autorelease pool");
+    }
+    return instance;
+}
+
+void PoolManager::destroyInstance()
+{
+    auto& instances = getThreadInstances();
+    delete static_cast<PoolManager*>(instances.get());
+    instances.set(nullptr);
+}
+
+#else
+
 PoolManager* PoolManager::s_singleInstance = nullptr;
 
 PoolManager* PoolManager::getInstance()
@@ -123,6 +166,8 @@ void PoolManager::destroyInstance()
     s_singleInstance = nullptr;
 }
 
+#endif
+
 PoolManager::PoolManager()
 {
     _releasePoolStack.reserve(10);
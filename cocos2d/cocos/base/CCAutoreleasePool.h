@@ -36,6 +36,7 @@ THE SOFTWARE.
  */
 NS_CC_BEGIN
 
+class ThreadLocalPointer;
 
 /**
  * A pool for managing autorelease objects.
@@ -155,6 +156,12 @@ class CC_DLL PoolManager
 public:
 
     CC_DEPRECATED_ATTRIBUTE static PoolManager* sharedPoolManager() { return getInstance(); }
+    /**
+     * Get the pool manager.
+     * With CC_ENABLE_ATOMIC_REFERENCE_COUNT every thread has its own pool manager, created on first use
+     * and destroyed when the thread exits. Worker threads should declare an AutoreleasePool on the stack
+     * around the code which autoreleases objects, since nothing clears their default pool every frame.
+     */
     static PoolManager* getInstance();
     
     CC_DEPRECATED_ATTRIBUTE static void purgePoolManager() { destroyInstance(); }
@@ -178,7 +185,12 @@ private:
     void push(AutoreleasePool *pool);
     void pop();
     
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+    static void destroyThreadInstance(void* instance);
+    static ThreadLocalPointer& getThreadInstances();
+#else
     static PoolManager* s_singleInstance;
+#endif
     
     std::vector<AutoreleasePool*> _releasePoolStack;
 };
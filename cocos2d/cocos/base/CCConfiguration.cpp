@@ -46,6 +46,8 @@ Configuration::Configuration()
 , _supportsETC1(false)
 , _supportsS3TC(false)
 , _supportsATITC(false)
+, _supportsETC2(false)
+, _supportsASTC(false)
 , _supportsNPOT(false)
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
@@ -53,6 +55,7 @@ Configuration::Configuration()
 , _supportsOESMapBuffer(false)
 , _supportsOESDepth24(false)
 , _supportsOESPackedDepthStencil(false)
+, _supportsPixelBufferObject(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -139,6 +142,16 @@ void Configuration::gatherGPUInfo()
     _supportsATITC = checkForGLExtension("GL_AMD_compressed_ATC_texture");
     _valueDict["gl.supports_ATITC"] = Value(_supportsATITC);
     
+    // ETC2 is core in OpenGL ES 3 and in desktop OpenGL 4.3
+    const char* glVersion = (const char*)glGetString(GL_VERSION);
+    _supportsETC2 = (glVersion && strncmp(glVersion, "OpenGL ES 3", 11) == 0)
+                    || checkForGLExtension("GL_ARB_ES3_compatibility")
+                    || checkForGLExtension("GL_OES_compressed_ETC2_RGB8_texture");
+    _valueDict["gl.supports_ETC2"] = Value(_supportsETC2);
+    
+    _supportsASTC = checkForGLExtension("GL_KHR_texture_compression_astc_ldr");
+    _valueDict["gl.supports_ASTC"] = Value(_supportsASTC);
+    
     _supportsPVRTC = checkForGLExtension("GL_IMG_texture_compression_pvrtc");
 	_valueDict["gl.supports_PVRTC"] = Value(_supportsPVRTC);
 
@@ -168,6 +181,13 @@ void Configuration::gatherGPUInfo()
     _supportsOESPackedDepthStencil = checkForGLExtension("GL_OES_packed_depth_stencil");
     _valueDict["gl.supports_OES_packed_depth_stencil"] = Value(_supportsOESPackedDepthStencil);
 
+#if defined(CC_PLATFORM_PC) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    _supportsPixelBufferObject = checkForGLExtension("pixel_buffer_object");
+#else
+    _supportsPixelBufferObject = false;
+#endif
+    _valueDict["gl.supports_pixel_buffer_object"] = Value(_supportsPixelBufferObject);
+
 
     CHECK_GL_ERROR_DEBUG();
 }
@@ -259,6 +279,21 @@ bool Configuration::supportsATITC() const
     return _supportsATITC;
 }
 
+bool Configuration::supportsETC2() const
+{
+    return _supportsETC2;
+}
+
+bool Configuration::supportsASTC() const
+{
+    //GL_COMPRESSED_RGBA_ASTC_4x4_KHR is not defined in old opengl headers
+#ifdef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+    return _supportsASTC;
+#else
+    return false;
+#endif
+}
+
 bool Configuration::supportsBGRA8888() const
 {
 	return _supportsBGRA8888;
@@ -295,6 +330,11 @@ bool Configuration::supportsMapBuffer() const
 #endif
 }
 
+bool Configuration::supportsPixelBufferObject() const
+{
+    return _supportsPixelBufferObject;
+}
+
 bool Configuration::supportsOESDepth24() const
 {
     return _supportsOESDepth24;
@@ -127,6 +127,18 @@ public:
      */
     bool supportsATITC() const;
     
+    /** Whether or not ETC2 Texture Compressed is supported, either by an OpenGL ES 3 context or an extension.
+     *
+     * @return Is true if supports ETC2 Texture Compressed.
+     */
+    bool supportsETC2() const;
+    
+    /** Whether or not ASTC (LDR profile) Texture Compressed is supported.
+     *
+     * @return Is true if supports ASTC Texture Compressed.
+     */
+    bool supportsASTC() const;
+    
     /** Whether or not BGRA8888 textures are supported.
      *
      * @return Is true if supports BGRA8888 textures.
@@ -171,6 +183,14 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not pixel buffer objects can be used to read pixels back asynchronously.
+     *
+     * Only desktop OpenGL maps a GL_PIXEL_PACK_BUFFER for reading here, it is always `false` on OpenGL ES.
+     *
+     * @return Whether or not glReadPixels() can write into a GL_PIXEL_PACK_BUFFER.
+     */
+    bool supportsPixelBufferObject() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -263,6 +283,8 @@ protected:
     bool            _supportsETC1;
     bool            _supportsS3TC;
     bool            _supportsATITC;
+    bool            _supportsETC2;
+    bool            _supportsASTC;
     bool            _supportsNPOT;
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
@@ -270,6 +292,7 @@ protected:
     bool            _supportsOESMapBuffer;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
+    bool            _supportsPixelBufferObject;
     
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
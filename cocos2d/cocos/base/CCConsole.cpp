@@ -63,6 +63,7 @@
 #include "base/CCScheduler.h"
 #include "platform/CCPlatformConfig.h"
 #include "base/CCConfiguration.h"
+#include "base/CCFrameArena.h"
 #include "2d/CCScene.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
@@ -509,6 +510,7 @@ Console::Console()
     createCommandExit();
     createCommandFileUtils();
     createCommandFps();
+    createCommandFrameArena();
     createCommandHelp();
     createCommandProjection();
     createCommandResolution();
@@ -1089,6 +1091,12 @@ void Console::createCommandFps()
     addSubCommand("fps", {"off", "Hide the FPS on the bottom-left corner.", CC_CALLBACK_2(Console::commandFpsSubCommandOnOff, this)});
 }
 
+void Console::createCommandFrameArena()
+{
+    addCommand({"framearena", "Print the per frame allocation counters of the FrameArena. Args: [-h | help | ]",
+        CC_CALLBACK_2(Console::commandFrameArena, this)});
+}
+
 void Console::createCommandHelp()
 {
     addCommand({"help", "Print this message. Args: [ ]", CC_CALLBACK_2(Console::commandHelp, this)});
@@ -1122,6 +1130,8 @@ void Console::createCommandTexture()
         CC_CALLBACK_2(Console::commandTextures, this)});
     addSubCommand("texture", {"flush", "Purges the dictionary of loaded textures.",
         CC_CALLBACK_2(Console::commandTexturesSubCommandFlush, this)});
+    addSubCommand("texture", {"budget", "Print or set the memory budget of the textures. Args: [MB], 0 for no limit.",
+        CC_CALLBACK_2(Console::commandTexturesSubCommandBudget, this)});
 }
 
 void Console::createCommandTouch()
@@ -1150,8 +1160,10 @@ void Console::createCommandVersion()
 void Console::commandAllocator(int fd, const std::string& /*args*/)
 {
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+    // count: live objects, highest: high-water mark, capacity: pooled blocks,
+    // fallback: live objects of another size, fragmentation: pool memory not used by live objects
     auto info = allocator::AllocatorDiagnostics::instance()->diagnostics();
-    Console::Utility::mydprintf(fd, info.c_str());
+    Console::Utility::mydprintf(fd, "%s", info.c_str());
 #else
     Console::Utility::mydprintf(fd, "allocator diagnostics not available. CC_ENABLE_ALLOCATOR_DIAGNOSTICS must be set to 1 in ccConfig.h\n");
 #endif
@@ -1247,6 +1259,15 @@ void Console::commandFpsSubCommandOnOff(int /*fd*/, const std::string& args)
     sched->performFunctionInCocosThread( std::bind(&Director::setDisplayStats, dir, state));
 }
 
+void Console::commandFrameArena(int fd, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", FrameArena::getInstance()->getDescription().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
 void Console::commandHelp(int fd, const std::string& /*args*/)
 {
     sendHelp(fd, _commands, "\nAvailable commands:\n");
@@ -1356,6 +1377,34 @@ void Console::commandTexturesSubCommandFlush(int /*fd*/, const std::string& /*ar
     });
 }
 
+void Console::commandTexturesSubCommandBudget(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    if (argv.size() == 2 && !Console::Utility::isFloat(argv[1]))
+    {
+        Console::Utility::mydprintf(fd, "Invalid budget. Use: texture budget [MB]\n");
+        Console::Utility::sendPrompt(fd);
+        return;
+    }
+
+    bool set = argv.size() == 2;
+    float megabytes = set ? utils::atof(argv[1].c_str()) : 0;
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto textureCache = Director::getInstance()->getTextureCache();
+        if (set)
+        {
+            textureCache->setMemoryBudget(static_cast<size_t>(std::max(megabytes, 0.0f) * 1024 * 1024));
+            if (textureCache->getMemoryBudget() > 0)
+                textureCache->evictUnusedTextures(textureCache->getMemoryBudget());
+        }
+        Console::Utility::mydprintf(fd, "budget: %.2f MB, textures: %.2f MB\n",
+                                    textureCache->getMemoryBudget() / (1024.0f * 1024.0f),
+                                    textureCache->getMemoryUsage() / (1024.0f * 1024.0f));
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
 void Console::commandTouchSubCommandTap(int fd, const std::string& args)
 {
     auto argv = Console::Utility::split(args,' ');
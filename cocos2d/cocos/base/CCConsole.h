@@ -233,6 +233,7 @@ protected:
     void createCommandExit();
     void createCommandFileUtils();
     void createCommandFps();
+    void createCommandFrameArena();
     void createCommandHelp();
     void createCommandProjection();
     void createCommandResolution();
@@ -257,6 +258,7 @@ protected:
     void commandFileUtilsSubCommandFlush(int fd, const std::string& args);
     void commandFps(int fd, const std::string& args);
     void commandFpsSubCommandOnOff(int fd, const std::string& args);
+    void commandFrameArena(int fd, const std::string& args);
     void commandHelp(int fd, const std::string& args);
     void commandProjection(int fd, const std::string& args);
     void commandProjectionSubCommand2d(int fd, const std::string& args);
@@ -266,6 +268,7 @@ protected:
     void commandSceneGraph(int fd, const std::string& args);
     void commandTextures(int fd, const std::string& args);
     void commandTexturesSubCommandFlush(int fd, const std::string& args);
+    void commandTexturesSubCommandBudget(int fd, const std::string& args);
     void commandTouchSubCommandTap(int fd, const std::string& args);
     void commandTouchSubCommandSwipe(int fd, const std::string& args);
     void commandUpload(int fd);
@@ -27,20 +27,34 @@
 #include "base/CCData.h"
 #include "base/CCConsole.h"
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CC_DATA_USE_MMAP 1
+#endif
+
 NS_CC_BEGIN
 
 const Data Data::Null;
 
 Data::Data() :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_mapping(nullptr),
+_mappingSize(0)
 {
     CCLOGINFO("In the empty constructor of Data.");
 }
 
 Data::Data(Data&& other) :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_mapping(nullptr),
+_mappingSize(0)
 {
     CCLOGINFO("In the move constructor of Data.");
     move(other);
@@ -48,7 +62,9 @@ _size(0)
 
 Data::Data(const Data& other) :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_mapping(nullptr),
+_mappingSize(0)
 {
     CCLOGINFO("In the copy constructor of Data.");
     copy(other._bytes, other._size);
@@ -86,9 +102,13 @@ void Data::move(Data& other)
     
     _bytes = other._bytes;
     _size = other._size;
+    _mapping = other._mapping;
+    _mappingSize = other._mappingSize;
 
     other._bytes = nullptr;
     other._size = 0;
+    other._mapping = nullptr;
+    other._mappingSize = 0;
 }
 
 bool Data::isNull() const
@@ -128,19 +148,124 @@ void Data::fastSet(unsigned char* bytes, const ssize_t size)
 {
     CCASSERT(size >= 0, "fastSet size should be non-negative");
     //CCASSERT(bytes, "bytes should not be nullptr");
+    if (_mapping) clear();
     _bytes = bytes;
     _size = size;
 }
 
+bool Data::mapFile(const std::string& path, ssize_t offset, ssize_t length)
+{
+    if (offset < 0) return false;
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    int pathLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (pathLength <= 0) return false;
+    std::wstring widePath(pathLength, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], pathLength);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.HighPart != 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    const ssize_t size = static_cast<ssize_t>(fileSize.QuadPart);
+    if (length < 0) length = size - offset;
+    if (length <= 0 || offset + length > size)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // views start at a multiple of the allocation granularity
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const ssize_t start = offset - offset % systemInfo.dwAllocationGranularity;
+
+    // the view keeps the mapping and the file open
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, static_cast<DWORD>(start), static_cast<SIZE_T>(offset - start + length));
+    CloseHandle(mapping);
+    if (!view) return false;
+#elif CC_DATA_USE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) != 0 || !S_ISREG(statBuf.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+    const ssize_t size = static_cast<ssize_t>(statBuf.st_size);
+    if (length < 0) length = size - offset;
+    if (length <= 0 || offset + length > size)
+    {
+        close(fd);
+        return false;
+    }
+
+    // mappings start at a page boundary
+    const ssize_t pageSize = sysconf(_SC_PAGESIZE);
+    const ssize_t start = offset - offset % pageSize;
+
+    // the mapping keeps the file referenced
+    void* view = mmap(nullptr, offset - start + length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, start);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+#else
+    CC_UNUSED_PARAM(path);
+    CC_UNUSED_PARAM(length);
+    return false;
+#endif
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || CC_DATA_USE_MMAP
+    clear();
+    _mapping = static_cast<unsigned char*>(view);
+    _mappingSize = offset - start + length;
+    _bytes = _mapping + (offset - start);
+    _size = length;
+    return true;
+#endif
+}
+
+bool Data::isMapped() const
+{
+    return _mapping != nullptr;
+}
+
 void Data::clear()
 {
-    if(_bytes) free(_bytes);
+    if (_mapping)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        UnmapViewOfFile(_mapping);
+#elif CC_DATA_USE_MMAP
+        munmap(_mapping, _mappingSize);
+#endif
+        _mapping = nullptr;
+        _mappingSize = 0;
+    }
+    else if(_bytes) free(_bytes);
     _bytes = nullptr;
     _size = 0;
 }
 
 unsigned char* Data::takeBuffer(ssize_t* size)
 {
+    if (_mapping)
+    {
+        // the caller frees the buffer, so it gets a heap copy of the mapping
+        Data copied(*this);
+        clear();
+        return copied.takeBuffer(size);
+    }
+
     auto buffer = getBytes();
     if (size)
         *size = getSize();
@@ -106,10 +106,34 @@ public:
      *         since in the destructor of Data, the buffer will be deleted by 'free'.
      *  @note 1. This method will move the ownship of 'bytes'pointer to Data,
      *        2. The pointer should not be used outside after it was passed to this method.
+     *        3. If the data maps a file, the mapping is released first.
      *  @see Data::copy
      */
     void fastSet(unsigned char* bytes, const ssize_t size);
 
+    /**
+     * Maps a file into memory instead of reading it.
+     *
+     * The pages are shared with the file system cache and are only read when they are accessed,
+     * so large assets don't need a heap copy. The mapping is private: writing to the bytes works
+     * and only changes this Data, never the file.
+     * The file must not be truncated while it is mapped, so don't map files which are being downloaded or rewritten.
+     *
+     * @param path The full path of a regular file.
+     * @param offset The first byte to map, for instance of an entry inside an archive.
+     * @param length The number of bytes to map, -1 maps up to the end of the file.
+     * @return True if the file is mapped. False if it can't be mapped (not a regular file, empty range,
+     *         inside an APK or zip, or the platform has no mapping), the data is unchanged then.
+     */
+    bool mapFile(const std::string& path, ssize_t offset = 0, ssize_t length = -1);
+
+    /**
+     * Check whether the bytes are a mapping of a file.
+     *
+     * @return True if the data was filled by mapFile.
+     */
+    bool isMapped() const;
+
     /**
      * Clears data, free buffer and reset data size.
      */
@@ -139,6 +163,8 @@ public:
      *  free(buffer);
      * @endcode
      *
+     * @note A mapped file is copied into a new buffer, since the returned buffer is released by 'free'.
+     *
      * @param size Will fill with the data buffer size in bytes, if you do not care buffer size, pass nullptr.
      * @return the internal data buffer, free it after use.
      */
@@ -149,6 +175,9 @@ private:
 private:
     unsigned char* _bytes;
     ssize_t _size;
+    // start and size of the mapped view, the bytes may start after it
+    unsigned char* _mapping;
+    ssize_t _mappingSize;
 };
 
 
@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "2d/CCTransition.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCLabelAtlas.h"
+#include "2d/CCParticleSystem.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCTextureCache.h"
@@ -59,6 +60,7 @@ THE SOFTWARE.
 #include "base/CCEventCustom.h"
 #include "base/CCConsole.h"
 #include "base/CCAutoreleasePool.h"
+#include "base/CCFrameArena.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
 #include "base/ObjectFactory.h"
@@ -167,6 +169,7 @@ Director::~Director()
     CC_SAFE_RELEASE(_FPSLabel);
     CC_SAFE_RELEASE(_drawnVerticesLabel);
     CC_SAFE_RELEASE(_drawnBatchesLabel);
+    CC_SAFE_RELEASE(_frameArenaLabel);
 
     CC_SAFE_RELEASE(_runningScene);
     CC_SAFE_RELEASE(_notificationNode);
@@ -190,6 +193,7 @@ Director::~Director()
     
     Configuration::destroyInstance();
     ObjectFactory::destroyInstance();
+    FrameArena::destroyInstance();
 
     s_SharedDirector = nullptr;
 
@@ -264,8 +268,15 @@ void Director::drawScene()
     {
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
         _scheduler->update(_deltaTime);
+        // moves the particle systems updated by the scheduler, across the simulation threads
+        ParticleSystem::runSimulationStage();
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
+    else
+    {
+        // the systems updated by hand while paused, e.g. by updateWithNoTime
+        ParticleSystem::runSimulationStage();
+    }
 
     _renderer->clear();
     experimental::FrameBuffer::clearAllFBOs();
@@ -1077,6 +1088,7 @@ void Director::reset()
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    CC_SAFE_RELEASE_NULL(_frameArenaLabel);
     
     // purge bitmap cache
     FontFNT::purgeCachedData();
@@ -1258,11 +1270,12 @@ void Director::showStats()
 
     static unsigned long prevCalls = 0;
     static unsigned long prevVerts = 0;
+    static unsigned long prevArenaBytes = 0;
 
     ++_frames;
     _accumDt += _deltaTime;
     
-    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel)
+    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel && _frameArenaLabel)
     {
         char buffer[30] = {0};
 
@@ -1291,7 +1304,16 @@ void Director::showStats()
             prevVerts = currentVerts;
         }
 
+        // allocations of the previous frame, the current one is still running
+        const auto& arenaStats = FrameArena::getInstance()->getLastFrameStats();
+        if (arenaStats.bytes != prevArenaBytes) {
+            sprintf(buffer, "Arena:%4lu/%7lu", (unsigned long)arenaStats.allocations, (unsigned long)arenaStats.bytes);
+            _frameArenaLabel->setString(buffer);
+            prevArenaBytes = (unsigned long)arenaStats.bytes;
+        }
+
         const Mat4& identity = Mat4::IDENTITY;
+        _frameArenaLabel->visit(_renderer, identity, 0);
         _drawnVerticesLabel->visit(_renderer, identity, 0);
         _drawnBatchesLabel->visit(_renderer, identity, 0);
         _FPSLabel->visit(_renderer, identity, 0);
@@ -1321,15 +1343,18 @@ void Director::createStatsLabel()
     std::string fpsString = "00.0";
     std::string drawBatchString = "000";
     std::string drawVerticesString = "00000";
+    std::string frameArenaString = "0/0";
     if (_FPSLabel)
     {
         fpsString = _FPSLabel->getString();
         drawBatchString = _drawnBatchesLabel->getString();
         drawVerticesString = _drawnVerticesLabel->getString();
+        frameArenaString = _frameArenaLabel->getString();
         
         CC_SAFE_RELEASE_NULL(_FPSLabel);
         CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
         CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+        CC_SAFE_RELEASE_NULL(_frameArenaLabel);
         _textureCache->removeTextureForKey("/cc_fps_images");
         FileUtils::getInstance()->purgeCachedEntries();
     }
@@ -1379,10 +1404,17 @@ void Director::createStatsLabel()
     _drawnVerticesLabel->initWithString(drawVerticesString, texture, 12, 32, '.');
     _drawnVerticesLabel->setScale(scaleFactor);
 
+    _frameArenaLabel = LabelAtlas::create();
+    _frameArenaLabel->retain();
+    _frameArenaLabel->setIgnoreContentScaleFactor(true);
+    _frameArenaLabel->initWithString(frameArenaString, texture, 12, 32, '.');
+    _frameArenaLabel->setScale(scaleFactor);
+
 
     Texture2D::setDefaultAlphaPixelFormat(currentFormat);
 
     const int height_spacing = 22 / CC_CONTENT_SCALE_FACTOR();
+    _frameArenaLabel->setPosition(Vec2(0, height_spacing*3) + CC_DIRECTOR_STATS_POSITION);
     _drawnVerticesLabel->setPosition(Vec2(0, height_spacing*2) + CC_DIRECTOR_STATS_POSITION);
     _drawnBatchesLabel->setPosition(Vec2(0, height_spacing*1) + CC_DIRECTOR_STATS_POSITION);
     _FPSLabel->setPosition(Vec2(0, height_spacing*0)+CC_DIRECTOR_STATS_POSITION);
@@ -1479,6 +1511,9 @@ void Director::mainLoop()
      
         // release the objects
         PoolManager::getInstance()->getCurrentPool()->clear();
+
+        // nothing can reference the transient allocations of the frame anymore
+        FrameArena::getInstance()->reset();
     }
 }
 
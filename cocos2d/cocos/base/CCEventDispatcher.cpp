@@ -26,7 +26,10 @@
 #include <algorithm>
 
 #include "base/CCEventCustom.h"
+#include "base/CCFrameArena.h"
 #include "base/CCEventListenerTouch.h"
+#include "base/CCTouch.h"
+#include "base/CCTouchSpatialIndex.h"
 #include "base/CCEventListenerAcceleration.h"
 #include "base/CCEventListenerMouse.h"
 #include "base/CCEventListenerKeyboard.h"
@@ -67,29 +70,23 @@ private:
 
 NS_CC_BEGIN
 
-static EventListener::ListenerID __getListenerID(Event* event)
+// Returns a reference to the name of the event or to a static ID, dispatching the events of
+// every frame (e.g. the director events) doesn't copy a string.
+static const EventListener::ListenerID& __getListenerID(Event* event)
 {
-    EventListener::ListenerID ret;
+    static const EventListener::ListenerID invalidID;
     switch (event->getType())
     {
         case Event::Type::ACCELERATION:
-            ret = EventListenerAcceleration::LISTENER_ID;
-            break;
+            return EventListenerAcceleration::LISTENER_ID;
         case Event::Type::CUSTOM:
-            {
-                auto customEvent = static_cast<EventCustom*>(event);
-                ret = customEvent->getEventName();
-            }
-            break;
+            return static_cast<EventCustom*>(event)->getEventName();
         case Event::Type::KEYBOARD:
-            ret = EventListenerKeyboard::LISTENER_ID;
-            break;
+            return EventListenerKeyboard::LISTENER_ID;
         case Event::Type::MOUSE:
-            ret = EventListenerMouse::LISTENER_ID;
-            break;
+            return EventListenerMouse::LISTENER_ID;
         case Event::Type::FOCUS:
-            ret = EventListenerFocus::LISTENER_ID;
-            break;
+            return EventListenerFocus::LISTENER_ID;
         case Event::Type::TOUCH:
             // Touch listener is very special, it contains two kinds of listeners, EventListenerTouchOneByOne and EventListenerTouchAllAtOnce.
             // return UNKNOWN instead.
@@ -97,15 +94,14 @@ static EventListener::ListenerID __getListenerID(Event* event)
             break;
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
         case Event::Type::GAME_CONTROLLER:
-            ret = EventListenerController::LISTENER_ID;
-            break;
+            return EventListenerController::LISTENER_ID;
 #endif
         default:
             CCASSERT(false, "Invalid type!");
             break;
     }
     
-    return ret;
+    return invalidID;
 }
 
 EventDispatcher::EventListenerVector::EventListenerVector() :
@@ -202,7 +198,10 @@ void EventDispatcher::EventListenerVector::clear()
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
+, _touchSpatialIndex(nullptr)
+, _spatialQueryTouch(nullptr)
+, _spatialQueryCamera(nullptr)
+, _isSpatialQueryValid(false)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -220,75 +219,82 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+    CC_SAFE_DELETE(_touchSpatialIndex);
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
+const EventDispatcher::NodePriorityKey& EventDispatcher::getNodePriorityKey(Node* node)
 {
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
-    {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
-        }
-    }
-    else
+    auto iter = _nodePriorityMap.find(node);
+    if (iter != _nodePriorityMap.end())
+        return iter->second;
+
+    auto& key = _nodePriorityMap[node];
+    key.globalZOrder = node->getGlobalZOrder();
+    key.path.reserve(8);
+
+    // The node itself is visited after its children with negative local z order and before the others,
+    // the marker sorts between the two groups since children are compared with a second field of 0.
+    key.path.emplace_back(-1, 1);
+
+    Node* root = node;
+    for (Node* parent = node->getParent(); parent != nullptr; parent = parent->getParent())
     {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
+        key.path.emplace_back(root->_localZOrder$Arrival, 0);
+        root = parent;
     }
-    
-    if (isRootNode)
+    key.root = root;
+
+    std::reverse(key.path.begin(), key.path.end());
+    return key;
+}
+
+bool EventDispatcher::isLowerNodePriority(const NodePriorityKey& k1, const NodePriorityKey& k2, Node* rootNode)
+{
+    // Nodes which aren't in the running scene have the lowest priority.
+    if (k1.root != rootNode)
+        return k2.root == rootNode;
+    if (k2.root != rootNode)
+        return false;
+
+    if (k1.globalZOrder != k2.globalZOrder)
+        return k1.globalZOrder < k2.globalZOrder;
+
+    return k1.path < k2.path;
+}
+
+bool EventDispatcher::isTouchInListenerBounds(EventListenerTouchOneByOne* listener, Touch* touch)
+{
+    auto node = listener->getAssociatedNode();
+    if (!listener->_isBoundsCheckEnabled || node == nullptr)
+        return true;
+
+    auto camera = Camera::getVisitingCamera();
+    if (_touchSpatialIndex && camera)
     {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
-        {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::stable_sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
+        if (_spatialQueryTouch != touch || _spatialQueryCamera != camera)
         {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
+            _spatialQueryTouch = touch;
+            _spatialQueryCamera = camera;
+
+            // The index keeps bounds on the z = 0 plane of the world, find where the touch ray crosses it.
+            const auto& pt = touch->getLocation();
+            Vec3 Pn = camera->unprojectGL(Vec3(pt.x, pt.y, -1));
+            Vec3 Pf = camera->unprojectGL(Vec3(pt.x, pt.y, 1));
+            _isSpatialQueryValid = (Pf.z != Pn.z);
+            if (_isSpatialQueryValid)
             {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
+                float t = -Pn.z / (Pf.z - Pn.z);
+                _touchSpatialIndex->query(Vec2(Pn.x + (Pf.x - Pn.x) * t, Pn.y + (Pf.y - Pn.y) * t));
             }
         }
-        
-        _globalZOrderNodeMap.clear();
+
+        if (_isSpatialQueryValid && !_touchSpatialIndex->isCandidate(node))
+            return false;
     }
+
+    Rect rect;
+    rect.size = node->getContentSize();
+    return isScreenPointInRect(touch->getLocation(), Camera::getVisitingCamera(), node->getWorldToNodeTransform(), rect, nullptr);
 }
 
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
@@ -418,6 +424,11 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
     
     listeners->push_back(listener);
+    
+    if (_touchSpatialIndex && listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+    {
+        _touchSpatialIndex->addNode(node);
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
@@ -431,11 +442,17 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (iter != listeners->end())
         {
             listeners->erase(iter);
+            
+            if (_touchSpatialIndex && listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+            {
+                _touchSpatialIndex->removeNode(node);
+            }
         }
         
         if (listeners->empty())
         {
             _nodeListenersMap.erase(found);
+            _nodePriorityMap.erase(node);
             delete listeners;
         }
     }
@@ -835,7 +852,7 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
             // priority == 0, scene graph priority
             
             // first, get all enabled, unPaused and registered listeners
-            std::vector<EventListener*> sceneListeners;
+            FrameVector<EventListener*> sceneListeners;
             for (auto& l : *sceneGraphPriorityListeners)
             {
                 if (l->isEnabled() && !l->isPaused() && l->isRegistered())
@@ -846,7 +863,8 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
             // second, for all camera call all listeners
             // get a copy of cameras, prevent it's been modified in listener callback
             // if camera's depth is greater, process it earlier
-            auto cameras = scene->getCameras();
+            const auto& sceneCameras = scene->getCameras();
+            FrameVector<Camera*> cameras(sceneCameras.begin(), sceneCameras.end());
             for (auto rit = cameras.rbegin(), ritRend = cameras.rend(); rit != ritRend; ++rit)
             {
                 Camera* camera = *rit;
@@ -914,7 +932,7 @@ void EventDispatcher::dispatchEvent(Event* event)
         return;
     }
     
-    auto listenerID = __getListenerID(event);
+    const auto& listenerID = __getListenerID(event);
     
     sortEventListeners(listenerID);
     
@@ -966,8 +984,14 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     bool isNeedsMutableSet = (oneByOneListeners && allAtOnceListeners);
     
     const std::vector<Touch*>& originalTouches = event->getTouches();
-    std::vector<Touch*> mutableTouches(originalTouches.size());
-    std::copy(originalTouches.begin(), originalTouches.end(), mutableTouches.begin());
+    // The touches are only copied when swallowed ones have to be hidden from the all at once listeners,
+    // the listener callbacks take a std::vector so the copy can't live in the frame arena.
+    std::vector<Touch*> mutableTouches;
+    if (isNeedsMutableSet)
+    {
+        mutableTouches = originalTouches;
+    }
+    const std::vector<Touch*>& allAtOnceTouches = isNeedsMutableSet ? mutableTouches : originalTouches;
 
     //
     // process the target handlers 1st
@@ -979,6 +1003,9 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
         for (auto& touches : originalTouches)
         {
             bool isSwallowed = false;
+            
+            // The spatial index is queried again for each touch, even if the Touch object is reused.
+            _spatialQueryTouch = nullptr;
 
             auto onTouchEvent = [&](EventListener* l) -> bool { // Return true to break
                 EventListenerTouchOneByOne* listener = static_cast<EventListenerTouchOneByOne*>(l);
@@ -996,7 +1023,7 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 
                 if (eventCode == EventTouch::EventCode::BEGAN)
                 {
-                    if (listener->onTouchBegan)
+                    if (listener->onTouchBegan && isTouchInListenerBounds(listener, touches))
                     {
                         isClaimed = listener->onTouchBegan(touches, event);
                         if (isClaimed && listener->_isRegistered)
@@ -1051,7 +1078,7 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                     return true;
                 }
                 
-                CCASSERT(touches->getID() == (*mutableTouchesIter)->getID(),
+                CCASSERT(!isNeedsMutableSet || touches->getID() == (*mutableTouchesIter)->getID(),
                          "touches ID should be equal to mutableTouchesIter's ID.");
                 
                 if (isClaimed && listener->_isRegistered && listener->_needSwallow)
@@ -1074,7 +1101,7 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 return;
             }
             
-            if (!isSwallowed)
+            if (isNeedsMutableSet && !isSwallowed)
                 ++mutableTouchesIter;
         }
     }
@@ -1082,7 +1109,7 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     //
     // process standard handlers 2nd
     //
-    if (allAtOnceListeners && !mutableTouches.empty())
+    if (allAtOnceListeners && !allAtOnceTouches.empty())
     {
         
         auto onTouchesEvent = [&](EventListener* l) -> bool{
@@ -1098,25 +1125,25 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 case EventTouch::EventCode::BEGAN:
                     if (listener->onTouchesBegan)
                     {
-                        listener->onTouchesBegan(mutableTouches, event);
+                        listener->onTouchesBegan(allAtOnceTouches, event);
                     }
                     break;
                 case EventTouch::EventCode::MOVED:
                     if (listener->onTouchesMoved)
                     {
-                        listener->onTouchesMoved(mutableTouches, event);
+                        listener->onTouchesMoved(allAtOnceTouches, event);
                     }
                     break;
                 case EventTouch::EventCode::ENDED:
                     if (listener->onTouchesEnded)
                     {
-                        listener->onTouchesEnded(mutableTouches, event);
+                        listener->onTouchesEnded(allAtOnceTouches, event);
                     }
                     break;
                 case EventTouch::EventCode::CANCELLED:
                     if (listener->onTouchesCancelled)
                     {
-                        listener->onTouchesCancelled(mutableTouches, event);
+                        listener->onTouchesCancelled(allAtOnceTouches, event);
                     }
                     break;
                 default:
@@ -1262,6 +1289,8 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     {
         for (auto& node : _dirtyNodes)
         {
+            _nodePriorityMap.erase(node);
+            
             auto iter = _nodeListenersMap.find(node);
             if (iter != _nodeListenersMap.end())
             {
@@ -1322,22 +1351,34 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
-
-    visitTarget(rootNode, true);
+    // Only the keys of dirty nodes were dropped from the cache, the rest of the scene isn't visited.
+    FrameVector<std::pair<const NodePriorityKey*, EventListener*>> sortedListeners;
+    sortedListeners.reserve(sceneGraphListeners->size());
+    for (auto& l : *sceneGraphListeners)
+    {
+        sortedListeners.emplace_back(&getNodePriorityKey(l->getAssociatedNode()), l);
+    }
     
-    // After sort: priority < 0, > 0
-    std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
-    });
+    // After sort: higher priority (visited later) first
+    auto compare = [rootNode](const std::pair<const NodePriorityKey*, EventListener*>& l1, const std::pair<const NodePriorityKey*, EventListener*>& l2) {
+        return isLowerNodePriority(*l2.first, *l1.first, rootNode);
+    };
+    
+    if (!std::is_sorted(sortedListeners.begin(), sortedListeners.end(), compare))
+    {
+        std::stable_sort(sortedListeners.begin(), sortedListeners.end(), compare);
+        
+        for (size_t i = 0, count = sortedListeners.size(); i < count; ++i)
+        {
+            (*sceneGraphListeners)[i] = sortedListeners[i].second;
+        }
+    }
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
-    for (auto& l : *sceneGraphListeners)
+    for (auto& l : sortedListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        log("listener priority: node ([%s]%p), global z (%f), depth (%d)", typeid(*l.second->_node).name(), l.second->_node, l.first->globalZOrder, (int)l.first->path.size());
     }
 #endif
 }
@@ -1527,6 +1568,38 @@ bool EventDispatcher::isEnabled() const
     return _isEnabled;
 }
 
+void EventDispatcher::setTouchSpatialIndexEnabled(bool enabled)
+{
+    if (enabled == (_touchSpatialIndex != nullptr))
+        return;
+    
+    _spatialQueryTouch = nullptr;
+    _spatialQueryCamera = nullptr;
+    
+    if (!enabled)
+    {
+        CC_SAFE_DELETE(_touchSpatialIndex);
+        return;
+    }
+    
+    _touchSpatialIndex = new (std::nothrow) TouchSpatialIndex();
+    for (const auto& e : _nodeListenersMap)
+    {
+        for (auto& l : *e.second)
+        {
+            if (l->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+            {
+                _touchSpatialIndex->addNode(e.first);
+            }
+        }
+    }
+}
+
+bool EventDispatcher::isTouchSpatialIndexEnabled() const
+{
+    return _touchSpatialIndex != nullptr;
+}
+
 void EventDispatcher::setDirtyForNode(Node* node)
 {
     // Mark the node dirty only when there is an eventlistener associated with it. 
@@ -31,6 +31,7 @@
 #include <unordered_map>
 #include <vector>
 #include <set>
+#include <cstdint>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCEventListener.h"
@@ -49,6 +50,10 @@ class EventTouch;
 class Node;
 class EventCustom;
 class EventListenerCustom;
+class EventListenerTouchOneByOne;
+class Touch;
+class Camera;
+class TouchSpatialIndex;
 
 /** @class EventDispatcher
 * @brief This class manages event listener subscriptions
@@ -188,6 +193,29 @@ public:
 
     /////////////////////////////////////////////
     
+    /** Whether to keep a spatial index of the nodes of EventListenerTouchOneByOne listeners.
+     *  When it's enabled, listeners which enabled the bounds check aren't tested one by one,
+     *  only the ones whose node bounds contain the touch are.
+     *
+     * @param enabled True if the spatial index should be used.
+     * @see EventListenerTouchOneByOne::setBoundsCheckEnabled
+     */
+    void setTouchSpatialIndexEnabled(bool enabled);
+
+    /** Checks whether the touch spatial index is enabled.
+     *
+     * @return True if the spatial index is used.
+     */
+    bool isTouchSpatialIndexEnabled() const;
+
+    /** Gets the touch spatial index, which also reports the candidates tested by the last touch.
+     *
+     * @return The spatial index, or nullptr if it's disabled.
+     */
+    const TouchSpatialIndex* getTouchSpatialIndex() const { return _touchSpatialIndex; }
+
+    /////////////////////////////////////////////
+    
     /** Constructor of EventDispatcher.
      */
     EventDispatcher();
@@ -309,8 +337,25 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** The position of a node in the scene graph visiting order.
+     *  Each level of `path` holds the local z order and order of arrival of an ancestor, ending with
+     *  a marker for the node itself, so comparing two paths gives the same result as walking the scene.
+     */
+    struct NodePriorityKey
+    {
+        Node* root;
+        float globalZOrder;
+        std::vector<std::pair<std::int64_t, int>> path;
+    };
+
+    /** Gets the cached priority key of a node, rebuilding it from the node's ancestors if it's missing. */
+    const NodePriorityKey& getNodePriorityKey(Node* node);
+
+    /** Returns true if the node of `k1` is visited before the node of `k2`, i.e. `k1` has the lower priority. */
+    static bool isLowerNodePriority(const NodePriorityKey& k1, const NodePriorityKey& k2, Node* rootNode);
+
+    /** Whether the touch is inside the bounds of the listener's node, for listeners that enabled the bounds check. */
+    bool isTouchInListenerBounds(EventListenerTouchOneByOne* listener, Touch* touch);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -324,11 +369,8 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
-    
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** The map of node and its scene graph position, only rebuilt for nodes which were marked dirty */
+    std::unordered_map<Node*, NodePriorityKey> _nodePriorityMap;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -345,9 +387,15 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
     std::set<std::string> _internalCustomListenerIDs;
+    
+    /** The bounds of the nodes of one by one touch listeners, nullptr if disabled */
+    TouchSpatialIndex* _touchSpatialIndex;
+    
+    /** The touch and camera of the last spatial index query, it's queried once per camera for each touch */
+    Touch* _spatialQueryTouch;
+    const Camera* _spatialQueryCamera;
+    bool _isSpatialQueryValid;
 };
 
 
@@ -28,6 +28,8 @@
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(EventListenerCustom, 32);
+
 EventListenerCustom::EventListenerCustom()
 : _onCustomEvent(nullptr)
 {
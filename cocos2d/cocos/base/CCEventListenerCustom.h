@@ -27,6 +27,7 @@
 #define __cocos2d_libs__CCCustomEventListener__
 
 #include "base/CCEventListener.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 /**
  * @addtogroup base
@@ -61,6 +62,8 @@ class EventCustom;
 class CC_DLL EventListenerCustom : public EventListener
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(EventListenerCustom);
+
     /** Creates an event listener with type and callback.
      * @param eventName The type of the event.
      * @param callback The callback function when the specified event was emitted.
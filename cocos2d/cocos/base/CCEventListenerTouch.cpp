@@ -32,6 +32,8 @@
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(EventListenerTouchOneByOne, 32);
+
 const std::string EventListenerTouchOneByOne::LISTENER_ID = "__cc_touch_one_by_one";
 
 EventListenerTouchOneByOne::EventListenerTouchOneByOne()
@@ -40,6 +42,7 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _isBoundsCheckEnabled(false)
 {
 }
 
@@ -68,6 +71,16 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setBoundsCheckEnabled(bool enabled)
+{
+    _isBoundsCheckEnabled = enabled;
+}
+
+bool EventListenerTouchOneByOne::isBoundsCheckEnabled() const
+{
+    return _isBoundsCheckEnabled;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -109,6 +122,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_isBoundsCheckEnabled = _isBoundsCheckEnabled;
     }
     else
     {
@@ -28,6 +28,7 @@
 #define __cocos2d_libs__CCTouchEventListener__
 
 #include "base/CCEventListener.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 #include <vector>
 
 /**
@@ -46,6 +47,8 @@ class Touch;
 class CC_DLL EventListenerTouchOneByOne : public EventListener
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(EventListenerTouchOneByOne);
+
     static const std::string LISTENER_ID;
     
     /** Create a one by one touch event listener.
@@ -69,6 +72,19 @@ public:
      */
     bool isSwallowTouches();
     
+    /** Whether or not to skip `onTouchBegan` when the touch is outside the content rect of the associated node.
+     *  It saves the callback for listeners which do their own hit testing, but shouldn't be enabled for
+     *  listeners which want touches anywhere on screen, e.g. on nodes without a content size.
+     *
+     * @param enabled True if the touch should be checked against the node bounds before `onTouchBegan`.
+     */
+    void setBoundsCheckEnabled(bool enabled);
+    /** Is the node bounds checked before `onTouchBegan` or not.
+     *
+     * @return True if the node bounds are checked.
+     */
+    bool isBoundsCheckEnabled() const;
+    
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
     virtual bool checkAvailable() override;
@@ -91,6 +107,7 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _isBoundsCheckEnabled;
     
     friend class EventDispatcher;
 };
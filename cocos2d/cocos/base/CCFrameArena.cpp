@@ -0,0 +1,191 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCFrameArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "base/ccMacros.h"
+#include "base/ccUTF8.h"
+
+NS_CC_BEGIN
+
+FrameArena* FrameArena::s_sharedFrameArena = nullptr;
+
+FrameArena* FrameArena::getInstance()
+{
+    if (s_sharedFrameArena == nullptr)
+    {
+        s_sharedFrameArena = new (std::nothrow) FrameArena();
+        CCASSERT(s_sharedFrameArena, "FATAL: Not enough memory");
+    }
+    return s_sharedFrameArena;
+}
+
+void FrameArena::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedFrameArena);
+}
+
+FrameArena::FrameArena(size_t blockSize)
+: _blockSize(std::max(blockSize, (size_t)1024))
+, _currentBlock(0)
+, _offset(0)
+, _destructors(nullptr)
+, _peakBytes(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+    runDestructors();
+    freeBlocks();
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+    CCASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment must be a power of two");
+
+    if (size == 0)
+        size = 1;
+
+    if (!_blocks.empty())
+    {
+        Block& block = _blocks[_currentBlock];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        uintptr_t aligned = (base + _offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t end = (size_t)(aligned - base) + size;
+        if (end <= block.size)
+        {
+            _currentStats.allocations++;
+            _currentStats.bytes += end - _offset;
+            _offset = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+
+    // the current block is full, the frame continues in a new one which is merged with the others on reset
+    addBlock(size + alignment);
+
+    Block& block = _blocks[_currentBlock];
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+    uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    _offset = (size_t)(aligned - base) + size;
+    _currentStats.allocations++;
+    _currentStats.bytes += _offset;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void FrameArena::deallocate(void* p, size_t size)
+{
+    if (p == nullptr || _blocks.empty())
+        return;
+
+    // only the last allocation can be given back, e.g. a temporary vector which didn't grow
+    char* data = _blocks[_currentBlock].data;
+    char* ptr = static_cast<char*>(p);
+    if (ptr >= data && ptr + size == data + _offset)
+        _offset = (size_t)(ptr - data);
+}
+
+void FrameArena::addDestructor(void* object, void (*destroy)(void*))
+{
+    auto destructor = static_cast<Destructor*>(allocate(sizeof(Destructor), alignof(Destructor)));
+    destructor->destroy = destroy;
+    destructor->object = object;
+    destructor->next = _destructors;
+    _destructors = destructor;
+}
+
+void FrameArena::runDestructors()
+{
+    // in the reverse order of creation, like objects on the stack
+    while (_destructors)
+    {
+        Destructor* destructor = _destructors;
+        _destructors = destructor->next;
+        destructor->destroy(destructor->object);
+    }
+}
+
+void FrameArena::reset()
+{
+    runDestructors();
+
+    if (_blocks.size() > 1)
+    {
+        size_t capacity = _currentStats.capacity;
+        freeBlocks();
+        _blockSize = capacity;
+        addBlock(_blockSize);
+    }
+
+    _currentStats.capacity = _blocks.empty() ? 0 : _blocks[0].size;
+    _lastStats = _currentStats;
+    _peakBytes = std::max(_peakBytes, _currentStats.bytes);
+
+    _currentStats = FrameStats();
+    _currentStats.capacity = _lastStats.capacity;
+    _currentBlock = 0;
+    _offset = 0;
+}
+
+std::string FrameArena::getDescription() const
+{
+    return StringUtils::format("FrameArena: last frame %lu allocations, %lu bytes, %lu new blocks\n"
+                               "FrameArena: peak %lu bytes per frame, capacity %lu bytes in %lu blocks\n",
+                               (unsigned long)_lastStats.allocations,
+                               (unsigned long)_lastStats.bytes,
+                               (unsigned long)_lastStats.blockAllocations,
+                               (unsigned long)std::max(_peakBytes, _currentStats.bytes),
+                               (unsigned long)_currentStats.capacity,
+                               (unsigned long)_blocks.size());
+}
+
+void FrameArena::addBlock(size_t minSize)
+{
+    Block block;
+    block.size = std::max(_blockSize, minSize);
+    block.data = static_cast<char*>(malloc(block.size));
+    CCASSERT(block.data, "FATAL: Not enough memory");
+
+    _blocks.push_back(block);
+    _currentBlock = _blocks.size() - 1;
+    _offset = 0;
+
+    _currentStats.blockAllocations++;
+    _currentStats.capacity += block.size;
+}
+
+void FrameArena::freeBlocks()
+{
+    for (auto& block : _blocks)
+        free(block.data);
+    _blocks.clear();
+    _currentBlock = 0;
+    _offset = 0;
+}
+
+NS_CC_END
@@ -0,0 +1,228 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_FRAME_ARENA_H__
+#define __CC_FRAME_ARENA_H__
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/** @class FrameArena
+ * @brief A bump allocator for memory which only lives until the end of the current frame.
+ *
+ * Allocations are never freed one by one, all of them are released at once by reset, which
+ * Director calls at the end of every main loop iteration right after the autorelease pool is cleared.
+ * Memory is taken from blocks which are kept between frames, so a frame which allocates no more than
+ * the previous ones doesn't call the system allocator at all.
+ * The arena is not thread safe and must only be used from the cocos thread.
+ * @js NA
+ */
+class CC_DLL FrameArena
+{
+public:
+    /** Allocation counters of one frame. */
+    struct FrameStats
+    {
+        /** Number of allocations served by the arena. */
+        size_t allocations = 0;
+        /** Number of bytes handed out, including the alignment padding. */
+        size_t bytes = 0;
+        /** Number of times a new block had to be requested from the system allocator. */
+        size_t blockAllocations = 0;
+        /** Total size of the blocks owned by the arena. */
+        size_t capacity = 0;
+    };
+
+    /** Gets the frame arena of the cocos thread. */
+    static FrameArena* getInstance();
+
+    /** Destroys the frame arena, all memory allocated from it becomes invalid. */
+    static void destroyInstance();
+
+    /** Constructor of FrameArena.
+     *
+     * @param blockSize The size in bytes of the first block.
+     */
+    explicit FrameArena(size_t blockSize = 64 * 1024);
+    ~FrameArena();
+
+    /** Allocates memory which stays valid until the next call to reset.
+     *
+     * @param size The number of bytes to allocate.
+     * @param alignment The alignment of the returned pointer, must be a power of two.
+     * @return A pointer to the memory, never nullptr.
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /** Gives back memory allocated from the arena. It is only reused if it was the last allocation. */
+    void deallocate(void* p, size_t size);
+
+    /** Creates an object which is destroyed by the next call to reset, e.g. the user data of an EventCustom
+     * dispatched during the frame or a render command of a node drawn more than once in a frame.
+     *
+     * @return A pointer to the object, never nullptr.
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value)
+            addDestructor(object, [](void* p) { static_cast<T*>(p)->~T(); });
+        return object;
+    }
+
+    /** Destroys the objects made by create, releases all the allocations of the frame and records its counters.
+     * If the frame needed more than one block they are merged into a single block for the next frames.
+     */
+    void reset();
+
+    /** Gets the counters of the current frame. */
+    const FrameStats& getCurrentFrameStats() const { return _currentStats; }
+
+    /** Gets the counters of the last frame which was reset. */
+    const FrameStats& getLastFrameStats() const { return _lastStats; }
+
+    /** Gets the largest number of bytes allocated in a single frame. */
+    size_t getPeakBytes() const { return _peakBytes; }
+
+    /** Gets a description of the counters, used by the `framearena` console command. */
+    std::string getDescription() const;
+
+private:
+    struct Block
+    {
+        char* data;
+        size_t size;
+    };
+
+    // objects made by create which must be destroyed on reset, allocated from the arena too
+    struct Destructor
+    {
+        void (*destroy)(void*);
+        void* object;
+        Destructor* next;
+    };
+
+    void addBlock(size_t minSize);
+    void freeBlocks();
+    void addDestructor(void* object, void (*destroy)(void*));
+    void runDestructors();
+
+    std::vector<Block> _blocks;
+    size_t _blockSize;
+    size_t _currentBlock;
+    size_t _offset;
+    Destructor* _destructors;
+
+    FrameStats _currentStats;
+    FrameStats _lastStats;
+    size_t _peakBytes;
+
+    static FrameArena* s_sharedFrameArena;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(FrameArena);
+};
+
+/** @class FrameAllocator
+ * @brief An STL allocator which takes its memory from FrameArena.
+ *
+ * Containers using it must not outlive the current frame, e.g. temporaries built and consumed
+ * within one event dispatch or one visit.
+ * @js NA
+ */
+template <typename T>
+class FrameAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef FrameAllocator<U> other;
+    };
+
+    FrameAllocator() {}
+
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& /*other*/) {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(FrameArena::getInstance()->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        FrameArena::getInstance()->deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        new (p) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U* p)
+    {
+        p->~U();
+    }
+};
+
+template <typename T, typename U>
+inline bool operator==(const FrameAllocator<T>& /*a*/, const FrameAllocator<U>& /*b*/) { return true; }
+
+template <typename T, typename U>
+inline bool operator!=(const FrameAllocator<T>& /*a*/, const FrameAllocator<U>& /*b*/) { return false; }
+
+/** A std::vector whose storage is released at the end of the frame. */
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif // __CC_FRAME_ARENA_H__
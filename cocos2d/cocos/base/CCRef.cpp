@@ -61,6 +61,16 @@ Ref::Ref()
 #endif
 }
 
+Ref::Ref(const Ref& /*other*/)
+: Ref()
+{
+}
+
+Ref& Ref::operator=(const Ref& /*other*/)
+{
+    return *this;
+}
+
 Ref::~Ref()
 {
 #if CC_ENABLE_SCRIPT_BINDING
@@ -91,15 +101,26 @@ Ref::~Ref()
 void Ref::retain()
 {
     CCASSERT(_referenceCount > 0, "reference count should be greater than 0");
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+    // Whoever retains already owns a reference, so no ordering is needed here.
+    _referenceCount.fetch_add(1, std::memory_order_relaxed);
+#else
     ++_referenceCount;
+#endif
 }
 
 void Ref::release()
 {
     CCASSERT(_referenceCount > 0, "reference count should be greater than 0");
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+    // acq_rel makes the writes of other owners visible to the thread which deletes the object.
+    const bool isLastReference = (_referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1);
+#else
     --_referenceCount;
+    const bool isLastReference = (_referenceCount == 0);
+#endif
 
-    if (_referenceCount == 0)
+    if (isLastReference)
     {
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
         auto poolManager = PoolManager::getInstance();
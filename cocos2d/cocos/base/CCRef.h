@@ -30,6 +30,10 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/ccConfig.h"
 
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+#include <atomic>
+#endif
+
 #define CC_REF_LEAK_DETECTION 0
 
 /**
@@ -134,6 +138,14 @@ protected:
      */
     Ref();
 
+    /**
+     * A copy is a new object with its own reference count of 1 and assigning doesn't change
+     * the reference count, whether or not it is atomic.
+     * @js NA
+     */
+    Ref(const Ref& other);
+    Ref& operator=(const Ref& other);
+
 public:
     /**
      * Destructor
@@ -145,7 +157,11 @@ public:
 
 protected:
     /// count of references
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+    std::atomic<unsigned int> _referenceCount;
+#else
     unsigned int _referenceCount;
+#endif
 
     friend class AutoreleasePool;
 
@@ -153,6 +153,8 @@ bool Timer::isExhausted() const
 
 // TimerTargetSelector
 
+CC_DEFINE_ALLOCATOR_POOL(TimerTargetSelector, 32);
+
 TimerTargetSelector::TimerTargetSelector()
 : _target(nullptr)
 , _selector(nullptr)
@@ -183,6 +185,8 @@ void TimerTargetSelector::cancel()
 
 // TimerTargetCallback
 
+CC_DEFINE_ALLOCATOR_POOL(TimerTargetCallback, 32);
+
 TimerTargetCallback::TimerTargetCallback()
 : _target(nullptr)
 , _callback(nullptr)
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "base/CCRef.h"
 #include "base/CCVector.h"
 #include "base/uthash.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 NS_CC_BEGIN
 
@@ -78,6 +79,8 @@ protected:
 class CC_DLL TimerTargetSelector : public Timer
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(TimerTargetSelector);
+
     TimerTargetSelector();
 
     /** Initializes a timer with a target, a selector and an interval in seconds, repeat in number of times to repeat, delay in seconds. */
@@ -97,6 +100,8 @@ protected:
 class CC_DLL TimerTargetCallback : public Timer
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(TimerTargetCallback);
+
     TimerTargetCallback();
     
     // Initializes a timer with a target, a lambda and an interval in seconds, repeat in number of times to repeat, delay in seconds.
@@ -0,0 +1,302 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCTouchSpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+#include "2d/CCNode.h"
+#include "math/CCAffineTransform.h"
+
+NS_CC_BEGIN
+
+// Bounds spanning more cells than this are tested on every query instead of being put in the grid.
+static const int MAX_CELLS_PER_NODE = 256;
+
+TouchSpatialIndex::TouchSpatialIndex(float cellSize)
+: _cellSize(cellSize)
+, _queryStamp(0)
+, _lastCandidatesTested(0)
+, _lastCandidatesFound(0)
+, _lastBoundsUpdated(0)
+{
+    CCASSERT(cellSize > 0, "Invalid cell size!");
+}
+
+TouchSpatialIndex::~TouchSpatialIndex()
+{
+    clear();
+}
+
+std::int64_t TouchSpatialIndex::getCellKey(int x, int y)
+{
+    return (static_cast<std::int64_t>(x) << 32) | static_cast<std::uint32_t>(y);
+}
+
+void TouchSpatialIndex::addNode(Node* node)
+{
+    auto iter = _entries.find(node);
+    if (iter != _entries.end())
+    {
+        ++iter->second.refCount;
+        return;
+    }
+
+    Entry entry;
+    entry.refCount = 1;
+    entry.dirty = true;
+    entry.unbounded = true;
+    entry.inserted = false;
+    entry.queryStamp = 0;
+    entry.minCellX = entry.minCellY = 0;
+    entry.maxCellX = entry.maxCellY = -1;
+    _entries.emplace(node, entry);
+    _dirtyNodes.push_back(node);
+
+    CCASSERT(node->_touchSpatialIndex == nullptr || node->_touchSpatialIndex == this, "The node is in another index!");
+    node->_touchSpatialIndex = this;
+}
+
+bool TouchSpatialIndex::removeNode(Node* node)
+{
+    auto iter = _entries.find(node);
+    if (iter == _entries.end())
+        return true;
+
+    if (--iter->second.refCount > 0)
+        return false;
+
+    // a node left in the dirty nodes is skipped by the next query as it has no entry
+    removeFromCells(node, iter->second);
+    _entries.erase(iter);
+    node->_touchSpatialIndex = nullptr;
+    return true;
+}
+
+void TouchSpatialIndex::clear()
+{
+    for (auto& e : _entries)
+    {
+        e.first->_touchSpatialIndex = nullptr;
+    }
+    _entries.clear();
+    _cells.clear();
+    _unboundedNodes.clear();
+    _dirtyNodes.clear();
+}
+
+void TouchSpatialIndex::setCellSize(float cellSize)
+{
+    CCASSERT(cellSize > 0, "Invalid cell size!");
+    if (_cellSize == cellSize)
+        return;
+
+    _cellSize = cellSize;
+    _cells.clear();
+    _unboundedNodes.clear();
+    _dirtyNodes.clear();
+    for (auto& e : _entries)
+    {
+        e.second.dirty = true;
+        e.second.inserted = false;
+        _dirtyNodes.push_back(e.first);
+    }
+}
+
+void TouchSpatialIndex::setNodeDirty(Node* node)
+{
+    auto iter = _entries.find(node);
+    if (iter == _entries.end() || iter->second.dirty)
+        return;
+
+    iter->second.dirty = true;
+    _dirtyNodes.push_back(node);
+}
+
+bool TouchSpatialIndex::isStale(Node* node, const Entry& entry) const
+{
+    if (entry.dirty)
+        return true;
+
+    // Changes applied by a visit were told with setNodeDirty, the ones made since the last visit
+    // are still flagged on the node or one of its ancestors.
+    for (Node* n = node; n != nullptr; n = n->getParent())
+    {
+        if (n->_transformUpdated || n->_contentSizeDirty)
+            return true;
+    }
+    return false;
+}
+
+void TouchSpatialIndex::updateEntry(Node* node, Entry& entry)
+{
+    removeFromCells(node, entry);
+
+    const Mat4& transform = node->getNodeToWorldTransform();
+    entry.dirty = false;
+    entry.bounds = RectApplyTransform(Rect(Vec2::ZERO, node->getContentSize()), transform);
+
+    // The touch is unprojected on the z = 0 plane, the bounds are only exact for 2D transforms.
+    const float* m = transform.m;
+    bool is2D = m[2] == 0 && m[3] == 0 && m[6] == 0 && m[7] == 0
+             && m[8] == 0 && m[9] == 0 && m[11] == 0 && m[14] == 0 && m[15] == 1;
+
+    entry.unbounded = !is2D;
+    if (!entry.unbounded)
+    {
+        entry.minCellX = (int)std::floor(entry.bounds.getMinX() / _cellSize);
+        entry.minCellY = (int)std::floor(entry.bounds.getMinY() / _cellSize);
+        entry.maxCellX = (int)std::floor(entry.bounds.getMaxX() / _cellSize);
+        entry.maxCellY = (int)std::floor(entry.bounds.getMaxY() / _cellSize);
+
+        int cellCount = (entry.maxCellX - entry.minCellX + 1) * (entry.maxCellY - entry.minCellY + 1);
+        entry.unbounded = cellCount > MAX_CELLS_PER_NODE;
+    }
+
+    insertIntoCells(node, entry);
+}
+
+void TouchSpatialIndex::insertIntoCells(Node* node, Entry& entry)
+{
+    entry.inserted = true;
+    if (entry.unbounded)
+    {
+        _unboundedNodes.push_back(node);
+        return;
+    }
+
+    for (int y = entry.minCellY; y <= entry.maxCellY; ++y)
+    {
+        for (int x = entry.minCellX; x <= entry.maxCellX; ++x)
+        {
+            _cells[getCellKey(x, y)].push_back(node);
+        }
+    }
+}
+
+static void removeFromNodes(std::vector<Node*>& nodes, Node* node)
+{
+    auto found = std::find(nodes.begin(), nodes.end(), node);
+    if (found != nodes.end())
+    {
+        *found = nodes.back();
+        nodes.pop_back();
+    }
+}
+
+void TouchSpatialIndex::removeFromCells(Node* node, Entry& entry)
+{
+    if (!entry.inserted)
+        return;
+
+    entry.inserted = false;
+    if (entry.unbounded)
+    {
+        removeFromNodes(_unboundedNodes, node);
+        return;
+    }
+
+    for (int y = entry.minCellY; y <= entry.maxCellY; ++y)
+    {
+        for (int x = entry.minCellX; x <= entry.maxCellX; ++x)
+        {
+            auto iter = _cells.find(getCellKey(x, y));
+            if (iter == _cells.end())
+                continue;
+
+            removeFromNodes(iter->second, node);
+            if (iter->second.empty())
+                _cells.erase(iter);
+        }
+    }
+}
+
+void TouchSpatialIndex::query(const Vec2& worldPoint)
+{
+    ++_queryStamp;
+    _lastCandidatesTested = 0;
+    _lastCandidatesFound = 0;
+    _lastBoundsUpdated = 0;
+
+    // nodes moved by a visit, they may have left or entered the cell of the touch
+    for (auto node : _dirtyNodes)
+    {
+        auto iter = _entries.find(node);
+        if (iter != _entries.end() && iter->second.dirty)
+        {
+            updateEntry(node, iter->second);
+            ++_lastBoundsUpdated;
+        }
+    }
+    _dirtyNodes.clear();
+
+    // nodes changed since the last visit may have entered the cell of the touch from any other cell,
+    // all of them are put in the grid again before the cell is looked up
+    _staleNodes.clear();
+    for (auto& e : _entries)
+    {
+        if (isStale(e.first, e.second))
+            _staleNodes.push_back(e.first);
+    }
+    for (auto node : _staleNodes)
+    {
+        updateEntry(node, _entries[node]);
+        ++_lastBoundsUpdated;
+    }
+
+    for (auto node : _unboundedNodes)
+    {
+        _entries[node].queryStamp = _queryStamp;
+        ++_lastCandidatesTested;
+        ++_lastCandidatesFound;
+    }
+
+    int x = (int)std::floor(worldPoint.x / _cellSize);
+    int y = (int)std::floor(worldPoint.y / _cellSize);
+    auto iter = _cells.find(getCellKey(x, y));
+    if (iter == _cells.end())
+        return;
+
+    for (auto node : iter->second)
+    {
+        auto& entry = _entries[node];
+        ++_lastCandidatesTested;
+        if (entry.bounds.containsPoint(worldPoint))
+        {
+            entry.queryStamp = _queryStamp;
+            ++_lastCandidatesFound;
+        }
+    }
+}
+
+bool TouchSpatialIndex::isCandidate(Node* node) const
+{
+    auto iter = _entries.find(node);
+    if (iter == _entries.end())
+        return true;
+
+    return iter->second.queryStamp == _queryStamp;
+}
+
+NS_CC_END
@@ -0,0 +1,140 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_TOUCH_SPATIAL_INDEX_H__
+#define __CC_TOUCH_SPATIAL_INDEX_H__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/CCGeometry.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Node;
+
+/** @class TouchSpatialIndex
+ * @brief A uniform grid of the world space bounds of nodes with touch listeners.
+ *
+ * EventDispatcher uses it to skip `onTouchBegan` of listeners whose node can't contain the touch,
+ * see EventDispatcher::setTouchSpatialIndexEnabled. Nodes tell the index when a visit changes their
+ * transform or content size, and their bounds are recomputed by the next query. Nodes changed since the
+ * last visit are put in the grid again by the query too, which then only tests the grid cell of the touch.
+ * @js NA
+ */
+class CC_DLL TouchSpatialIndex
+{
+public:
+    /** Constructor of TouchSpatialIndex.
+     *
+     * @param cellSize The width and height of a grid cell in points.
+     */
+    explicit TouchSpatialIndex(float cellSize = 128.0f);
+    /** Destructor of TouchSpatialIndex. */
+    ~TouchSpatialIndex();
+
+    /** Adds a node to the index, nodes may be added more than once and are removed after the same number of calls to remove. */
+    void addNode(Node* node);
+
+    /** Removes a node from the index.
+     *
+     * @return True if the node isn't in the index anymore.
+     */
+    bool removeNode(Node* node);
+
+    /** Removes all nodes. */
+    void clear();
+
+    /** Tells the index that the transform or content size of the node changed, called by Node::visit. */
+    void setNodeDirty(Node* node);
+
+    /** Finds the nodes whose bounds contain a point in world space, the result is read with isCandidate. */
+    void query(const Vec2& worldPoint);
+
+    /** Whether the node may contain the point of the last query. Nodes which aren't indexed are always candidates. */
+    bool isCandidate(Node* node) const;
+
+    /** Sets the width and height of a grid cell in points, all nodes are put in the grid again. */
+    void setCellSize(float cellSize);
+    /** Gets the width and height of a grid cell in points. */
+    float getCellSize() const { return _cellSize; }
+
+    /** Gets the number of indexed nodes. */
+    size_t getNodeCount() const { return _entries.size(); }
+    /** Gets the number of nodes looked at by the last query, in the grid cell of the touch or outside the grid. */
+    size_t getLastCandidatesTested() const { return _lastCandidatesTested; }
+    /** Gets the number of candidates found by the last query. */
+    size_t getLastCandidatesFound() const { return _lastCandidatesFound; }
+    /** Gets the number of nodes whose bounds were recomputed by the last query, including the nodes changed since the last visit. */
+    size_t getLastBoundsUpdated() const { return _lastBoundsUpdated; }
+
+protected:
+    struct Entry
+    {
+        int refCount;
+        bool dirty;
+        // Nodes with a 3D transform or too large bounds aren't in the grid and are always candidates.
+        bool unbounded;
+        // Whether the node is in the cells or in the unbounded nodes.
+        bool inserted;
+        unsigned int queryStamp;
+        Rect bounds;
+        int minCellX, minCellY, maxCellX, maxCellY;
+    };
+
+    bool isStale(Node* node, const Entry& entry) const;
+    void updateEntry(Node* node, Entry& entry);
+    void insertIntoCells(Node* node, Entry& entry);
+    void removeFromCells(Node* node, Entry& entry);
+
+    static std::int64_t getCellKey(int x, int y);
+
+    float _cellSize;
+    unsigned int _queryStamp;
+
+    std::unordered_map<Node*, Entry> _entries;
+    std::unordered_map<std::int64_t, std::vector<Node*>> _cells;
+    std::vector<Node*> _unboundedNodes;
+    // nodes whose bounds must be recomputed by the next query
+    std::vector<Node*> _dirtyNodes;
+    std::vector<Node*> _staleNodes;
+
+    size_t _lastCandidatesTested;
+    size_t _lastCandidatesFound;
+    size_t _lastBoundsUpdated;
+};
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif // __CC_TOUCH_SPATIAL_INDEX_H__
@@ -29,6 +29,12 @@ THE SOFTWARE.
 #include "tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/CCAsyncTaskPool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
@@ -42,116 +48,139 @@ using namespace std;
 NS_CC_BEGIN
 
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * The values of UserDefault.xml, loaded once and kept in memory. The setters only change the
+ * map and schedule a save on the IO thread of AsyncTaskPool, which writes a snapshot of every
+ * change made until it runs. The instance owns it through a shared_ptr so a pending save can
+ * outlive it.
  */
+struct UserDefault::Storage
+{
+    std::mutex mutex; // guards values, revision, savedRevision and saveScheduled
+    std::unordered_map<std::string, std::string> values;
+    unsigned int revision = 0;
+    unsigned int savedRevision = 0;
+    bool saveScheduled = false;
+
+    std::mutex fileMutex; // serializes the saves
+
+    void load(const std::string& filePath);
+    bool getValue(const char* key, std::string& value);
+    void setValue(const char* key, const char* value);
+    void deleteValue(const char* key);
+    void scheduleSave(const std::shared_ptr<Storage>& self);
+    void save(const std::string& filePath);
+};
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+void UserDefault::Storage::load(const std::string& filePath)
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+    std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(filePath);
+    if (xmlBuffer.empty())
+        return;
 
-    // check the key value
-    if (! pKey)
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(xmlBuffer.c_str(), xmlBuffer.size()) != tinyxml2::XML_SUCCESS || !doc.RootElement())
     {
-        return nullptr;
+        CCLOG("UserDefault: can't parse %s", filePath.c_str());
+        return;
     }
 
-    do 
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto node = doc.RootElement()->FirstChildElement(); node; node = node->NextSiblingElement())
     {
-        tinyxml2::XMLDocument* xmlDoc = new (std::nothrow) tinyxml2::XMLDocument();
-        *doc = xmlDoc;
-        *rootNode = nullptr;
-
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
-
-        if (!xmlBuffer.empty())
-        {
-            xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
-
-            // get root node
-            *rootNode = xmlDoc->RootElement();
-        }
+        // an element without text was written for an empty string
+        const char* text = node->GetText();
+        values[node->Value()] = text ? text : "";
+    }
+}
 
-        if (nullptr == *rootNode)
-        {
-            // try to insert xml declaration
-            if (!xmlDoc->FirstChild())
-            {
-                tinyxml2::XMLDeclaration *xmlDeclaration = xmlDoc->NewDeclaration(nullptr);
-                if (nullptr != xmlDeclaration)
-                {
-                    xmlDoc->LinkEndChild(xmlDeclaration);
-                }
-            }
-
-            // create root element
-            tinyxml2::XMLElement *rootEle = xmlDoc->NewElement(USERDEFAULT_ROOT_NAME);
-            if (nullptr == rootEle)
-                break;
-
-            xmlDoc->LinkEndChild(rootEle);
-            *rootNode = rootEle;
-        }
+bool UserDefault::Storage::getValue(const char* key, std::string& value)
+{
+    if (!key)
+        return false;
 
-        // find the node
-        curNode = (*rootNode)->FirstChildElement();
-        while (nullptr != curNode)
-        {
-            const char* nodeName = curNode->Value();
-            if (!strcmp(nodeName, pKey))
-            {
-                break;
-            }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = values.find(key);
+    // an empty value reads as a missing key, like it did when the file was parsed on every call
+    if (iter == values.end() || iter->second.empty())
+        return false;
+    value = iter->second;
+    return true;
+}
 
-            curNode = curNode->NextSiblingElement();
-        }
-    } while (0);
+void UserDefault::Storage::setValue(const char* key, const char* value)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = values.find(key);
+    if (iter == values.end())
+        values.emplace(key, value);
+    else if (iter->second != value)
+        iter->second = value;
+    else
+        return;
+    ++revision;
+}
 
-    return curNode;
+void UserDefault::Storage::deleteValue(const char* key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (values.erase(key))
+        ++revision;
 }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+void UserDefault::Storage::scheduleSave(const std::shared_ptr<Storage>& self)
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    // check the params
-    if (! pKey || ! pValue)
     {
-        return;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (saveScheduled || revision == savedRevision)
+            return;
+        saveScheduled = true;
     }
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode, &doc);
-    // if node exist, change the content
-    if (node)
+
+    std::string filePath = UserDefault::getXMLFilePath();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [self, filePath]() {
+        self->save(filePath);
+    });
+}
+
+void UserDefault::Storage::save(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+
+    std::vector<std::pair<std::string, std::string>> snapshot;
+    unsigned int snapshotRevision;
     {
-        if (node->FirstChild())
-        {
-            node->FirstChild()->SetValue(pValue);
-        }
-        else
-        {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
-        }
+        std::lock_guard<std::mutex> lock(mutex);
+        saveScheduled = false;
+        if (revision == savedRevision)
+            return;
+        snapshotRevision = revision;
+        snapshot.assign(values.begin(), values.end());
     }
-    else
+    std::sort(snapshot.begin(), snapshot.end());
+
+    tinyxml2::XMLDocument doc;
+    doc.LinkEndChild(doc.NewDeclaration(nullptr));
+    tinyxml2::XMLElement* rootNode = doc.NewElement(USERDEFAULT_ROOT_NAME);
+    doc.LinkEndChild(rootNode);
+    for (const auto& value : snapshot)
     {
-        if (rootNode)
-        {
-            tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-            rootNode->LinkEndChild(tmpNode);
-            tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-            tmpNode->LinkEndChild(content);
-        }    
+        tinyxml2::XMLElement* node = doc.NewElement(value.first.c_str());
+        node->LinkEndChild(doc.NewText(value.second.c_str()));
+        rootNode->LinkEndChild(node);
     }
 
-    // save file and free doc
-    if (doc)
+    // write a temporary file and rename it, a crash during the save keeps the previous file
+    auto fileUtils = FileUtils::getInstance();
+    std::string tempPath = filePath + ".tmp";
+    if (doc.SaveFile(fileUtils->getSuitableFOpen(tempPath).c_str()) != tinyxml2::XML_SUCCESS
+        || !fileUtils->renameFile(tempPath, filePath))
     {
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        CCLOG("UserDefault: can't save %s", filePath.c_str());
+        return;
     }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    savedRevision = snapshotRevision;
 }
 
 /**
@@ -164,10 +193,26 @@ bool UserDefault::_isFilePathInitialized = false;
 
 UserDefault::~UserDefault()
 {
+    _storage->save(_filePath);
 }
 
 UserDefault::UserDefault()
+: _storage(std::make_shared<Storage>())
+{
+    initXMLFilePath();
+    _storage->load(_filePath);
+}
+
+void UserDefault::setValueForKey(const char* key, const char* value)
 {
+    // check the params
+    if (!key || !value)
+    {
+        return;
+    }
+
+    _storage->setValue(key, value);
+    _storage->scheduleSave(_storage);
 }
 
 bool UserDefault::getBoolForKey(const char* pKey)
@@ -177,27 +222,13 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string value;
+    if (_storage->getValue(pKey, value))
     {
-        value = (const char*)(node->FirstChild()->Value());
+        return value == "true";
     }
 
-    bool ret = defaultValue;
-
-    if (value)
-    {
-        ret = (! strcmp(value, "true"));
-    }
-
-    delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 int UserDefault::getIntegerForKey(const char* pKey)
@@ -207,28 +238,13 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string value;
+    if (_storage->getValue(pKey, value))
     {
-        value = (const char*)(node->FirstChild()->Value());
+        return atoi(value.c_str());
     }
 
-    int ret = defaultValue;
-
-    if (value)
-    {
-        ret = atoi(value);
-    }
-
-    delete doc;
-
-
-    return ret;
+    return defaultValue;
 }
 
 float UserDefault::getFloatForKey(const char* pKey)
@@ -250,27 +266,13 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string value;
+    if (_storage->getValue(pKey, value))
     {
-        value = (const char*)(node->FirstChild()->Value());
+        return utils::atof(value.c_str());
     }
 
-    double ret = defaultValue;
-
-    if (value)
-    {
-        ret = utils::atof(value);
-    }
-
-    delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 std::string UserDefault::getStringForKey(const char* pKey)
@@ -280,27 +282,13 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string value;
+    if (_storage->getValue(pKey, value))
     {
-        value = (const char*)(node->FirstChild()->Value());
+        return value;
     }
 
-    string ret = defaultValue;
-
-    if (value)
-    {
-        ret = string(value);
-    }
-
-    delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 Data UserDefault::getDataForKey(const char* pKey)
@@ -310,38 +298,22 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string encodedData;
+    if (!_storage->getValue(pKey, encodedData))
     {
-        encodedData = (const char*)(node->FirstChild()->Value());
+        return defaultValue;
     }
-    
+
     Data ret;
-    
-    if (encodedData)
-    {
-        unsigned char * decodedData = nullptr;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
-        
-        if (decodedData) {
-            ret.fastSet(decodedData, decodedDataLen);
-        }
-    }
-    else
-    {
-        ret = defaultValue;
+    unsigned char * decodedData = nullptr;
+    int decodedDataLen = base64Decode((unsigned char*)encodedData.c_str(), (unsigned int)encodedData.size(), &decodedData);
+
+    if (decodedData) {
+        ret.fastSet(decodedData, decodedDataLen);
     }
-    
-    delete doc;
-    
-    return ret;    
-}
 
+    return ret;
+}
 
 void UserDefault::setBoolForKey(const char* pKey, bool value)
 {
@@ -517,14 +489,11 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    _storage->save(_filePath);
 }
 
 void UserDefault::deleteValueForKey(const char* key)
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-
     // check the params
     if (!key)
     {
@@ -532,25 +501,8 @@ void UserDefault::deleteValueForKey(const char* key)
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(key, &rootNode, &doc);
-
-    // if node not exist, don't need to delete
-    if (!node)
-    {
-        CC_SAFE_DELETE(doc);
-        return;
-    }
-
-    // save file and free doc
-    if (doc)
-    {
-        doc->DeleteNode(node);
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
-    }
-
-    flush();
+    _storage->deleteValue(key);
+    _storage->scheduleSave(_storage);
 }
 
 NS_CC_END
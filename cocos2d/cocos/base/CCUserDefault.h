@@ -27,6 +27,7 @@ THE SOFTWARE.
 #define __SUPPORT_CCUSERDEFAULT_H__
 
 #include "platform/CCPlatformMacros.h"
+#include <memory>
 #include <string>
 #include "base/CCData.h"
 
@@ -46,7 +47,8 @@ NS_CC_BEGIN
  * bool, int, float, double, string
  *
  * @warning: On windows, linux, use XML to store data, which means there are some limitations of
- * the key string, for example, `/` is not valid.
+ * the key string, for example, `/` is not valid. The file is read once, the getters are served
+ * from memory and the setters write the file on a background thread.
  */
 class CC_DLL UserDefault
 {
@@ -202,6 +204,9 @@ public:
     virtual void setDataForKey(const char* key, const Data& value);
     /**
      * You should invoke this function to save values set by setXXXForKey().
+     * On the platforms that use an XML file, the values are saved in the background after they
+     * change and this function writes the pending changes before returning. Call it when the
+     * application enters the background.
      * @js NA
      */
     virtual void flush();
@@ -259,13 +264,19 @@ protected:
     virtual ~UserDefault();
     
 private:
-    
+    struct Storage;
+
+    void setValueForKey(const char* key, const char* value);
+
     static bool createXMLFile();
     static void initXMLFilePath();
     
     static UserDefault* _userDefault;
     static std::string _filePath;
     static bool _isFilePathInitialized;
+
+    // values of the XML file, only used by the platforms that store them in it
+    std::shared_ptr<Storage> _storage;
 };
 
 
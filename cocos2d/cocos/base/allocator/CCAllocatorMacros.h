@@ -28,6 +28,8 @@
 #define CC_ALLOCATOR_MACROS_H
 /// @cond DO_NOT_SHOW
 
+#include <new>
+
 #include "base/ccConfig.h"
 #include "platform/CCPlatformMacros.h"
 
@@ -78,16 +80,36 @@
 
     // @brief helper macro for overriding new/delete operators for a class.
     // This correctly passes the size in the deallocate method which is needed.
+    // The nothrow and placement forms are declared too since a class operator new hides the global ones.
     #define CC_USE_ALLOCATOR_POOL(T, A) \
         CC_ALLOCATOR_INLINE void* operator new (size_t size) \
         { \
             return (void*)A.allocate(size); \
         } \
+        CC_ALLOCATOR_INLINE void* operator new (size_t size, const std::nothrow_t&) \
+        { \
+            return (void*)A.allocate(size); \
+        } \
+        CC_ALLOCATOR_INLINE void* operator new (size_t, void* address) \
+        { \
+            return address; \
+        } \
         CC_ALLOCATOR_INLINE void operator delete (void* object, size_t size) \
         { \
             A.deallocate((T*)object, size); \
         }
 
+    // @brief helper macros giving a class a thread safe pool of its own.
+    // Declare it in the public section of the class and define it once in its translation unit.
+    // Subclasses of another size inherit the operators but are served by the global allocator.
+    #define CC_DECLARE_ALLOCATOR_POOL(T) \
+        typedef NS_CC_ALLOCATOR::AllocatorStrategyPool<T, NS_CC_ALLOCATOR::RawObjectTraits<T>, NS_CC_ALLOCATOR::locking_semantics> tAllocator; \
+        static tAllocator _allocator; \
+        CC_USE_ALLOCATOR_POOL(T, _allocator)
+
+    #define CC_DEFINE_ALLOCATOR_POOL(T, pageSize) \
+        T::tAllocator T::_allocator(#T, pageSize)
+
 #else
 
     // macros for new/delete
@@ -105,6 +127,8 @@
 
     // throw these away if not enabled
     #define CC_USE_ALLOCATOR_POOL(...)
+    #define CC_DECLARE_ALLOCATOR_POOL(...)
+    #define CC_DEFINE_ALLOCATOR_POOL(...)
     #define CC_OVERRIDE_GLOBAL_NEWDELETE_WITH_ALLOCATOR(...)
 
 #endif
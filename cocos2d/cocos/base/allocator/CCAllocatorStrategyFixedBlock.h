@@ -75,6 +75,7 @@ public:
         : _list(nullptr)
         , _pages(nullptr)
         , _pageSize(pageSize)
+        , _pageCount(0)
         , _allocated(0)
     {
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
@@ -90,6 +91,11 @@ public:
         AllocatorDiagnostics::instance()->untrackAllocator(this);
 #endif
 
+        // Allocators of classes are static, blocks which are still in use when they are destroyed
+        // belong to objects which are released later, so the pages are leaked instead of freed.
+        if (_allocated != 0)
+            return;
+
         while (_pages)
         {
             intptr_t* page = (intptr_t*)_pages;
@@ -159,8 +165,15 @@ public:
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
     std::string diagnostics() const
     {
+        auto self = const_cast<AllocatorStrategyFixedBlock*>(this);
+        self->lock();
+        size_t live = _allocated;
+        size_t highest = _highestCount;
+        size_t capacity = _pageCount * _pageSize;
+        self->unlock();
+        
         std::stringstream s;
-        s << AllocatorBase::tag() << " initial:" << _pageSize << " count:" << _allocated << " highest:" << _highestCount << "\n";
+        s << AllocatorBase::tag() << " initial:" << _pageSize << " count:" << live << " highest:" << highest << " capacity:" << capacity << "\n";
         return s.str();
     }
     size_t _highestCount;
@@ -243,6 +256,7 @@ protected:
             *page = (intptr_t)_pages;
             _pages = page;
         }
+        ++_pageCount;
         
         p += AllocatorBase::kDefaultAlignment; // step past the linked list node
         
@@ -266,6 +280,9 @@ protected:
     // @brief number of blocks per page.
     size_t _pageSize;
     
+    // @brief Number of pages allocated.
+    size_t _pageCount;
+    
     // @brief Number of blocks that are currently allocated.
     size_t _allocated;
 };
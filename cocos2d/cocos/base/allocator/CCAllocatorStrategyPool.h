@@ -36,7 +36,6 @@
 #include "base/allocator/CCAllocatorGlobal.h"
 #include "base/allocator/CCAllocatorStrategyFixedBlock.h"
 #include "base/allocator/CCAllocatorDiagnostics.h"
-#include "base/CCConfiguration.h"
 
 NS_CC_BEGIN
 NS_CC_ALLOCATOR_BEGIN
@@ -82,6 +81,37 @@ public:
     }
 };
 
+/**
+ * ObjectTraits for a pool which backs the operator new and delete of a class.
+ *
+ * The new expression already runs the constructor and the delete expression the destructor,
+ * so the pool must only hand out raw memory.
+ *
+ * @param T Type of object.
+ * @param _alignment Alignment of object T.
+ * @see CC_DECLARE_ALLOCATOR_POOL
+ */
+template <typename T, size_t _alignment = AllocatorBase::kDefaultAlignment>
+class RawObjectTraits : public ObjectTraits<T, _alignment>
+{
+public:
+    
+    /** Does nothing, the new expression constructs the object.*/
+    void construct(T* /*address*/)
+    {}
+    
+    /** Does nothing, the delete expression destroys the object.*/
+    void destroy(T* /*address*/)
+    {}
+};
+
+/**
+ * Returns the page size configured for the pool with the given tag in Configuration,
+ * or poolSize if there is none.
+ * Defined out of line so that class headers can use pools without including Configuration.
+ */
+CC_DLL size_t getConfiguredPoolSize(const char* tag, size_t poolSize);
+
 /**
  * Fixed sized pool allocator strategy for objects of type T.
  *
@@ -108,9 +138,11 @@ public:
     
     AllocatorStrategyPool(const char* tag = nullptr, size_t poolSize = 100)
         : tParentStrategy(tag)
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+        , _fallbackCount(0)
+#endif
     {
-        poolSize = Configuration::getInstance()->getValue(tag, Value((int)poolSize)).asInt();
-        tParentStrategy::_pageSize = poolSize;
+        tParentStrategy::_pageSize = getConfiguredPoolSize(tag, poolSize);
     }
     
     /**
@@ -128,7 +160,13 @@ public:
         }
         else
         {
+            // e.g. a subclass which inherits the operator new of T
             object = (T*)ccAllocatorGlobal.allocate(size);
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+            locking_traits::lock();
+            ++_fallbackCount;
+            locking_traits::unlock();
+#endif
         }
         O::construct(object);
         return object;
@@ -152,6 +190,11 @@ public:
             else
             {
                 ccAllocatorGlobal.deallocate(address, size);
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+                locking_traits::lock();
+                --_fallbackCount;
+                locking_traits::unlock();
+#endif
             }
         }
     }
@@ -159,10 +202,27 @@ public:
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
     std::string diagnostics() const
     {
+        auto self = const_cast<AllocatorStrategyPool*>(this);
+        self->lock();
+        size_t live = tParentStrategy::_allocated;
+        size_t highest = tParentStrategy::_highestCount;
+        size_t capacity = tParentStrategy::_pageCount * tParentStrategy::_pageSize;
+        size_t fallback = _fallbackCount;
+        self->unlock();
+        
+        // share of the pool memory which doesn't hold a live object, the padding of the blocks included
+        size_t reserved = capacity * AllocatorBase::nextPow2BlockSize(sizeof(T));
+        float fragmentation = reserved ? 100.0f * (1.0f - (float)(live * sizeof(T)) / (float)reserved) : 0.0f;
+        
         std::stringstream s;
-        s << AllocatorBase::tag() << " initial:" << tParentStrategy::_pageSize << " count:" << tParentStrategy::_allocated << " highest:" << tParentStrategy::_highestCount << "\n";
+        s << AllocatorBase::tag() << " initial:" << tParentStrategy::_pageSize << " count:" << live << " highest:" << highest
+          << " capacity:" << capacity << " size:" << sizeof(T) << " fallback:" << fallback
+          << " fragmentation:" << (int)fragmentation << "%\n";
         return s.str();
-    }    
+    }
+    
+    /** Number of live objects of another size, allocated by the global allocator.*/
+    size_t _fallbackCount;
 #endif
 };
 
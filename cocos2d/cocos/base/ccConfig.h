@@ -165,6 +165,35 @@ THE SOFTWARE.
 #define CC_TEXTURE_ATLAS_USE_VAO 1
 #endif
 
+/** @def CC_TEXTURE_CACHE_ASYNC_WORKERS
+ * Number of threads TextureCache uses to decode the images of addImageAsync.
+ * If 0, one per available core minus the main thread is used, up to 4.
+ * It can be changed at runtime with TextureCache::setAsyncWorkerCount.
+ */
+#ifndef CC_TEXTURE_CACHE_ASYNC_WORKERS
+#define CC_TEXTURE_CACHE_ASYNC_WORKERS 0
+#endif
+
+/** @def CC_TEXTURE_CACHE_MEMORY_BUDGET
+ * Memory, in bytes, the textures of the TextureCache may take before the unused ones are evicted.
+ * If 0, textures are only removed on request, like removeUnusedTextures.
+ * It can be changed at runtime with TextureCache::setMemoryBudget.
+ */
+#ifndef CC_TEXTURE_CACHE_MEMORY_BUDGET
+#define CC_TEXTURE_CACHE_MEMORY_BUDGET 0
+#endif
+
+/** @def CC_PARTICLE_SIMULATION_THREADS
+ * Number of threads, the main thread included, the particle systems are simulated on after the Scheduler update.
+ * If 1, the default, every system is fully updated in ParticleSystem::update. If 0, one per available core is
+ * used, up to 4. Subclasses of ParticleSystem have to follow the contract of ParticleSystem::setSimulationThreadCount
+ * before this is changed.
+ * It can be changed at runtime with ParticleSystem::setSimulationThreadCount.
+ */
+#ifndef CC_PARTICLE_SIMULATION_THREADS
+#define CC_PARTICLE_SIMULATION_THREADS 1
+#endif
+
 
 /** @def CC_USE_LA88_LABELS
  * If enabled, it will use LA88 (Luminance Alpha 16-bit textures) for LabelTTF objects.
@@ -177,6 +206,41 @@ THE SOFTWARE.
 #define CC_USE_LA88_LABELS 1
 #endif
 
+/** @def CC_FONT_ATLAS_PAGE_SIZE
+ * Width and height, in pixels, of the texture pages the TTF font atlases pack their glyphs into.
+ * Bigger pages mean fewer textures and fewer draw calls for large character sets like CJK, at the cost of memory.
+ * The size is clamped to the maximum texture size. It can be changed at runtime with FontAtlas::setPageSize.
+ */
+#ifndef CC_FONT_ATLAS_PAGE_SIZE
+#define CC_FONT_ATLAS_PAGE_SIZE 512
+#endif
+
+/** @def CC_FONT_MSDF_GLYPH_SIZE
+ * Size, in points, the glyphs of the multi-channel distance field atlases are generated at.
+ * One atlas per font serves the labels of every size, which scale the glyphs from this size: corners stay sharp
+ * far above it, while small labels lose detail the generated glyphs don't have.
+ */
+#ifndef CC_FONT_MSDF_GLYPH_SIZE
+#define CC_FONT_MSDF_GLYPH_SIZE 32
+#endif
+
+/** @def CC_RENDER_TEXTURE_READBACK_FRAMES
+ * Number of frames RenderTexture::newImageAsync and RenderTexture::saveToFileAsync wait before mapping the
+ * pixel buffer the texture was read into. By then the GPU has normally finished the copy and mapping doesn't stall.
+ */
+#ifndef CC_RENDER_TEXTURE_READBACK_FRAMES
+#define CC_RENDER_TEXTURE_READBACK_FRAMES 2
+#endif
+
+/** @def CC_FAST_TILEMAP_CHUNK_SIZE
+ * Width and height, in tiles, of the chunks experimental::TMXLayer builds its vertices in.
+ * Only the chunks around the visible area have vertex buffers, and a tile change rebuilds only its chunk.
+ * With 16-bit indices a chunk can't have more than 16384 tiles, see CC_FAST_TILEMAP_32_BIT_INDICES.
+ */
+#ifndef CC_FAST_TILEMAP_CHUNK_SIZE
+#define CC_FAST_TILEMAP_CHUNK_SIZE 32
+#endif
+
 /** @def CC_SPRITE_DEBUG_DRAW
  * If enabled, all subclasses of Sprite will draw a bounding box.
  * Useful for debugging purposes only. It is recommended to leave it disabled.
@@ -363,6 +427,8 @@ THE SOFTWARE.
 /** @def CC_ENABLE_ALLOCATOR
  * Turn on creation of global allocator and pool allocators
  * as specified by CC_ALLOCATOR_GLOBAL below.
+ * Node, Sprite, label letters, the common actions, timers, touch and custom listeners
+ * and heap allocated render commands then come from pools of their own type.
  */
 #ifndef CC_ENABLE_ALLOCATOR
 # define CC_ENABLE_ALLOCATOR 0
@@ -398,10 +464,31 @@ THE SOFTWARE.
 # define CC_ALLOCATOR_GLOBAL_NEW_DELETE cocos2d::allocator::AllocatorStrategyGlobalSmallBlock
 #endif
 
+/** @def CC_ENABLE_ATOMIC_REFERENCE_COUNT
+ * If enabled, Ref uses an atomic reference count and every thread gets its own autorelease pool stack,
+ * so Ref objects can be created, retained and released on worker threads and handed to the main thread.
+ * It makes retain/release slightly slower, see NodeRetainReleaseTest in performance-tests.
+ * Objects still have to be released on the thread which owns the GL context if their destructor touches GL.
+ * To enable set it to a value different than 0. Disabled by default.
+ */
+#ifndef CC_ENABLE_ATOMIC_REFERENCE_COUNT
+#define CC_ENABLE_ATOMIC_REFERENCE_COUNT 0
+#endif
+
 #ifndef CC_FILEUTILS_APPLE_ENABLE_OBJC
 #define CC_FILEUTILS_APPLE_ENABLE_OBJC  1
 #endif
 
+/** @def CC_FILEUTILS_MMAP_THRESHOLD
+ * FileUtils::getDataFromFile maps files of at least this many bytes into memory instead of reading them,
+ * see Data::mapFile. Smaller files are read, mapping them costs more than the copy.
+ * Files inside the APK or an OBB file are always read.
+ * To disable the mapping set it to 0.
+ */
+#ifndef CC_FILEUTILS_MMAP_THRESHOLD
+#define CC_FILEUTILS_MMAP_THRESHOLD  (64 * 1024)
+#endif
+
 /** @def CC_ENABLE_PREMULTIPLIED_ALPHA
  * If enabled, all textures will be preprocessed to multiply its rgb components
  * by its alpha component.
@@ -0,0 +1,284 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/etc2.h"
+
+#include <string.h>
+
+// Decoder for the ETC2 RGB8 and RGBA8 (EAC alpha) formats of the OpenGL ES 3.0 specification, annex C.
+// Blocks are 4x4 pixels, pixel (x, y) of a block uses the index bits x * 4 + y.
+
+static const int etc1_modifier_table[8][2] =
+{
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 },
+    { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 },
+};
+
+static const int etc2_distance_table[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+static const int eac_modifier_table[16][8] =
+{
+    { -3, -6, -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 },
+    { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 },
+    { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 },
+    { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 },
+    { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 },
+    { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 },
+    { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 },
+    { -3, -5, -7, -9, 2, 4, 6, 8 },
+};
+
+static inline uint8_t etc2_clamp(int value)
+{
+    return (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// replicates the high bits of a bits wide value into the low bits of a byte
+static inline int etc2_extend(int value, int bits)
+{
+    value <<= 8 - bits;
+    return value | (value >> bits);
+}
+
+static inline int etc2_pixel_index(const uint8_t *block, int x, int y)
+{
+    int bit = x * 4 + y;
+    int msb = (block[5 - bit / 8] >> (bit % 8)) & 1;
+    int lsb = (block[7 - bit / 8] >> (bit % 8)) & 1;
+    return (msb << 1) | lsb;
+}
+
+//Decode ETC2 RGB block to 4x4 RGBA32 pixels, alpha is left untouched
+static void etc2_decode_rgb_block(const uint8_t *block, uint8_t *decodeBlockData)
+{
+    int r1 = (block[0] >> 3) & 0x1f;
+    int g1 = (block[1] >> 3) & 0x1f;
+    int b1 = (block[2] >> 3) & 0x1f;
+    int r2 = r1 + ((int8_t)(block[0] << 5) >> 5);
+    int g2 = g1 + ((int8_t)(block[1] << 5) >> 5);
+    int b2 = b1 + ((int8_t)(block[2] << 5) >> 5);
+    bool differential = (block[3] & 0x2) != 0;
+
+    if (differential && (r2 < 0 || r2 > 31 || g2 < 0 || g2 > 31 || b2 < 0 || b2 > 31))
+    {
+        int paint[4][3];
+
+        if (r2 < 0 || r2 > 31)
+        {
+            // T mode
+            int base1[3] = {
+                etc2_extend(((block[0] & 0x18) >> 1) | (block[0] & 0x3), 4),
+                etc2_extend(block[1] >> 4, 4),
+                etc2_extend(block[1] & 0xf, 4) };
+            int base2[3] = {
+                etc2_extend(block[2] >> 4, 4),
+                etc2_extend(block[2] & 0xf, 4),
+                etc2_extend(block[3] >> 4, 4) };
+            int distance = etc2_distance_table[((block[3] >> 1) & 0x6) | (block[3] & 0x1)];
+
+            for (int c = 0; c < 3; ++c)
+            {
+                paint[0][c] = base1[c];
+                paint[1][c] = base2[c] + distance;
+                paint[2][c] = base2[c];
+                paint[3][c] = base2[c] - distance;
+            }
+        }
+        else if (g2 < 0 || g2 > 31)
+        {
+            // H mode
+            int h1[3] = {
+                (block[0] >> 3) & 0xf,
+                ((block[0] & 0x7) << 1) | ((block[1] >> 4) & 0x1),
+                (block[1] & 0x8) | ((block[1] & 0x3) << 1) | (block[2] >> 7) };
+            int h2[3] = {
+                (block[2] >> 3) & 0xf,
+                ((block[2] & 0x7) << 1) | (block[3] >> 7),
+                (block[3] >> 3) & 0xf };
+            int index = (block[3] & 0x4) | ((block[3] & 0x1) << 1);
+            if (((h1[0] << 8) | (h1[1] << 4) | h1[2]) >= ((h2[0] << 8) | (h2[1] << 4) | h2[2]))
+                index |= 1;
+            int distance = etc2_distance_table[index];
+
+            for (int c = 0; c < 3; ++c)
+            {
+                int base1 = etc2_extend(h1[c], 4);
+                int base2 = etc2_extend(h2[c], 4);
+                paint[0][c] = base1 + distance;
+                paint[1][c] = base1 - distance;
+                paint[2][c] = base2 + distance;
+                paint[3][c] = base2 - distance;
+            }
+        }
+        else
+        {
+            // planar mode, the colors are interpolated from the origin, horizontal and vertical ones
+            int origin[3] = {
+                etc2_extend((block[0] >> 1) & 0x3f, 6),
+                etc2_extend(((block[0] & 0x1) << 6) | ((block[1] >> 1) & 0x3f), 7),
+                etc2_extend(((block[1] & 0x1) << 5) | (block[2] & 0x18) | ((block[2] & 0x3) << 1) | (block[3] >> 7), 6) };
+            int horizontal[3] = {
+                etc2_extend(((block[3] >> 1) & 0x3e) | (block[3] & 0x1), 6),
+                etc2_extend(block[4] >> 1, 7),
+                etc2_extend(((block[4] & 0x1) << 5) | (block[5] >> 3), 6) };
+            int vertical[3] = {
+                etc2_extend(((block[5] & 0x7) << 3) | (block[6] >> 5), 6),
+                etc2_extend(((block[6] & 0x1f) << 2) | (block[7] >> 6), 7),
+                etc2_extend(block[7] & 0x3f, 6) };
+
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    uint8_t *pixel = decodeBlockData + (y * 4 + x) * 4;
+                    for (int c = 0; c < 3; ++c)
+                        pixel[c] = etc2_clamp((x * (horizontal[c] - origin[c]) + y * (vertical[c] - origin[c]) + 4 * origin[c] + 2) >> 2);
+                }
+            }
+            return;
+        }
+
+        for (int y = 0; y < 4; ++y)
+        {
+            for (int x = 0; x < 4; ++x)
+            {
+                const int *color = paint[etc2_pixel_index(block, x, y)];
+                uint8_t *pixel = decodeBlockData + (y * 4 + x) * 4;
+                for (int c = 0; c < 3; ++c)
+                    pixel[c] = etc2_clamp(color[c]);
+            }
+        }
+        return;
+    }
+
+    // individual and differential modes, the ones of ETC1
+    int base[2][3];
+    if (differential)
+    {
+        base[0][0] = etc2_extend(r1, 5);
+        base[0][1] = etc2_extend(g1, 5);
+        base[0][2] = etc2_extend(b1, 5);
+        base[1][0] = etc2_extend(r2, 5);
+        base[1][1] = etc2_extend(g2, 5);
+        base[1][2] = etc2_extend(b2, 5);
+    }
+    else
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            base[0][c] = etc2_extend(block[c] >> 4, 4);
+            base[1][c] = etc2_extend(block[c] & 0xf, 4);
+        }
+    }
+
+    const int *modifiers[2] = { etc1_modifier_table[block[3] >> 5], etc1_modifier_table[(block[3] >> 2) & 0x7] };
+    bool flip = (block[3] & 0x1) != 0;
+
+    for (int y = 0; y < 4; ++y)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            int subblock = flip ? (y >= 2) : (x >= 2);
+            int index = etc2_pixel_index(block, x, y);
+            int modifier = modifiers[subblock][index & 1];
+            if (index & 2)
+                modifier = -modifier;
+            uint8_t *pixel = decodeBlockData + (y * 4 + x) * 4;
+            for (int c = 0; c < 3; ++c)
+                pixel[c] = etc2_clamp(base[subblock][c] + modifier);
+        }
+    }
+}
+
+//Decode EAC alpha block to the alpha channel of 4x4 RGBA32 pixels
+static void etc2_decode_alpha_block(const uint8_t *block, uint8_t *decodeBlockData)
+{
+    int base = block[0];
+    int multiplier = block[1] >> 4;
+    const int *modifiers = eac_modifier_table[block[1] & 0xf];
+
+    uint64_t indices = 0;
+    for (int i = 2; i < 8; ++i)
+        indices = (indices << 8) | block[i];
+
+    for (int i = 0; i < 16; ++i)
+    {
+        int index = (int)(indices >> (45 - i * 3)) & 0x7;
+        int x = i / 4;
+        int y = i % 4;
+        decodeBlockData[(y * 4 + x) * 4 + 3] = etc2_clamp(base + modifiers[index] * multiplier);
+    }
+}
+
+int etc2_get_encoded_data_size(const int pixelsWidth, const int pixelsHeight, ETC2DecodeFlag decodeFlag)
+{
+    int blockSize = decodeFlag == ETC2DecodeFlag::ETC2_RGBA ? 16 : 8;
+    return ((pixelsWidth + 3) / 4) * ((pixelsHeight + 3) / 4) * blockSize;
+}
+
+//Decode ETC2 encode data to RGB24 (ETC2_RGB) or RGBA32 (ETC2_RGBA)
+void etc2_decode(const uint8_t *encode_data,
+                 uint8_t *decode_data,
+                 const int pixelsWidth,
+                 const int pixelsHeight,
+                 ETC2DecodeFlag decodeFlag
+                 )
+{
+    const bool hasAlpha = decodeFlag == ETC2DecodeFlag::ETC2_RGBA;
+    const int bytesPerPixel = hasAlpha ? 4 : 3;
+    uint8_t decodeBlockData[16 * 4];
+
+    for (int blockY = 0; blockY < pixelsHeight; blockY += 4)
+    {
+        for (int blockX = 0; blockX < pixelsWidth; blockX += 4)
+        {
+            memset(decodeBlockData, 0xff, sizeof(decodeBlockData));
+            if (hasAlpha)
+            {
+                etc2_decode_alpha_block(encode_data, decodeBlockData);
+                encode_data += 8;
+            }
+            etc2_decode_rgb_block(encode_data, decodeBlockData);
+            encode_data += 8;
+
+            // the blocks on the right and bottom edges may be partially outside of the image
+            for (int y = 0; y < 4 && blockY + y < pixelsHeight; ++y)
+            {
+                uint8_t *row = decode_data + ((blockY + y) * pixelsWidth + blockX) * bytesPerPixel;
+                for (int x = 0; x < 4 && blockX + x < pixelsWidth; ++x)
+                {
+                    memcpy(row + x * bytesPerPixel, decodeBlockData + (y * 4 + x) * 4, bytesPerPixel);
+                }
+            }
+        }
+    }
+}
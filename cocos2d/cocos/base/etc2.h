@@ -0,0 +1,53 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef COCOS2DX_PLATFORM_THIRDPARTY_ETC2_
+#define COCOS2DX_PLATFORM_THIRDPARTY_ETC2_
+/// @cond DO_NOT_SHOW
+
+#include "platform/CCStdC.h"
+
+// GL enums of the ETC2 formats, they are only defined by the OpenGL ES 3.0 headers
+#define CC_GL_COMPRESSED_RGB8_ETC2          0x9274
+#define CC_GL_COMPRESSED_RGBA8_ETC2_EAC     0x9278
+
+enum class ETC2DecodeFlag
+{
+    ETC2_RGB = 1,
+    ETC2_RGBA = 2,
+};
+
+//Size in bytes of the ETC2 encoded data of a pixelsWidth x pixelsHeight image
+int etc2_get_encoded_data_size(const int pixelsWidth, const int pixelsHeight, ETC2DecodeFlag decodeFlag);
+
+//Decode ETC2 encode data to RGB24 (ETC2_RGB) or RGBA32 (ETC2_RGBA)
+void etc2_decode(const uint8_t *encode_data,
+                 uint8_t *decode_data,
+                 const int pixelsWidth,
+                 const int pixelsHeight,
+                 ETC2DecodeFlag decodeFlag
+                 );
+
+/// @endcond
+#endif /* defined(COCOS2DX_PLATFORM_THIRDPARTY_ETC2_) */
@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "base/CCConsole.h"
 #include "base/CCData.h"
 #include "base/CCDirector.h"
+#include "base/CCFrameArena.h"
 #include "base/CCIMEDelegate.h"
 #include "base/CCIMEDispatcher.h"
 #include "base/CCMap.h"
@@ -78,6 +79,7 @@ THE SOFTWARE.
 #include "base/CCEventListenerMouse.h"
 #include "base/CCEventListenerController.h"
 #include "base/CCEventListenerTouch.h"
+#include "base/CCTouchSpatialIndex.h"
 #include "base/CCEventMouse.h"
 #include "base/CCEventController.h"
 #include "base/CCController.h"
@@ -132,6 +134,7 @@ THE SOFTWARE.
 #include "2d/CCParticleExamples.h"
 #include "2d/CCParticleSystem.h"
 #include "2d/CCParticleSystemQuad.h"
+#include "2d/ccParticleKernels.h"
 #include "2d/CCProgressTimer.h"
 #include "2d/CCProtectedNode.h"
 #include "2d/CCRenderTexture.h"
@@ -176,6 +179,7 @@ THE SOFTWARE.
 #include "renderer/CCVertexIndexData.h"
 #include "renderer/CCFrameBuffer.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/ccPixelConvert.h"
 #include "renderer/ccShaders.h"
 
 // physics
@@ -186,12 +190,15 @@ THE SOFTWARE.
 #include "physics/CCPhysicsWorld.h"
 
 // platform
+#include "platform/CCAssetManifest.h"
+#include "platform/CCAssetPack.h"
 #include "platform/CCCommon.h"
 #include "platform/CCDevice.h"
 #include "platform/CCFileUtils.h"
 #include "platform/CCImage.h"
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
+#include "platform/CCPlistReader.h"
 #include "platform/CCSAXParser.h"
 #include "platform/CCThread.h"
 
@@ -0,0 +1,134 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCAssetManifest.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    struct AssetManifestHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t bucketCount;
+        uint32_t stringTableSize;
+    };
+}
+
+AssetManifest::AssetManifest()
+: _seeds(nullptr)
+, _entries(nullptr)
+, _strings(nullptr)
+, _entryCount(0)
+, _bucketCount(0)
+{
+}
+
+bool AssetManifest::initWithData(Data&& data)
+{
+    const size_t dataSize = static_cast<size_t>(data.getSize());
+    if (dataSize < sizeof(AssetManifestHeader))
+        return false;
+
+    const AssetManifestHeader* header = reinterpret_cast<const AssetManifestHeader*>(data.getBytes());
+    if (memcmp(header->magic, "CCAM", 4) != 0 || header->version != VERSION || header->bucketCount == 0)
+    {
+        CCLOG("cocos2d: AssetManifest: invalid header");
+        return false;
+    }
+
+    const size_t expectedSize = sizeof(AssetManifestHeader)
+        + header->bucketCount * sizeof(uint32_t)
+        + header->entryCount * sizeof(Entry)
+        + header->stringTableSize;
+    if (dataSize < expectedSize)
+    {
+        CCLOG("cocos2d: AssetManifest: invalid length");
+        return false;
+    }
+
+    const unsigned char* bytes = data.getBytes() + sizeof(AssetManifestHeader);
+    const uint32_t* seeds = reinterpret_cast<const uint32_t*>(bytes);
+    const Entry* entries = reinterpret_cast<const Entry*>(bytes + header->bucketCount * sizeof(uint32_t));
+    const char* strings = reinterpret_cast<const char*>(entries + header->entryCount);
+
+    for (uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        if (entries[i].pathOffset > header->stringTableSize || entries[i].pathLength > header->stringTableSize - entries[i].pathOffset)
+        {
+            CCLOG("cocos2d: AssetManifest: invalid entry");
+            return false;
+        }
+    }
+
+    _entryCount = header->entryCount;
+    _bucketCount = header->bucketCount;
+    _seeds = seeds;
+    _entries = entries;
+    _strings = strings;
+    _data = std::move(data);
+    return true;
+}
+
+const AssetManifest::Entry* AssetManifest::find(const std::string& path) const
+{
+    if (_entryCount == 0)
+        return nullptr;
+
+    uint32_t seed = _seeds[hash(path.c_str(), path.length(), 0) % _bucketCount];
+    const Entry* entry = &_entries[hash(path.c_str(), path.length(), seed) % _entryCount];
+
+    // paths which are not listed land on some other entry
+    if (entry->pathLength != path.length() || memcmp(_strings + entry->pathOffset, path.c_str(), path.length()) != 0)
+        return nullptr;
+    return entry;
+}
+
+std::string AssetManifest::getPath(const Entry* entry) const
+{
+    return std::string(_strings + entry->pathOffset, entry->pathLength);
+}
+
+uint32_t AssetManifest::hash(const char* str, size_t length, uint32_t seed)
+{
+    uint32_t h = 0x811C9DC5u ^ seed;
+    for (size_t i = 0; i < length; ++i)
+    {
+        h ^= static_cast<unsigned char>(str[i]);
+        h *= 0x01000193u;
+    }
+
+    // the low bits of FNV only depend on the low bits of the input, mix them before the modulo
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+NS_CC_END
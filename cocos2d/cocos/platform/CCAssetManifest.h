@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_ASSET_MANIFEST_H__
+#define __CC_ASSET_MANIFEST_H__
+
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** Index of the files under the resource root, generated at build time by tools/asset-manifest/gen_asset_manifest.py.
+ *
+ * FileUtils answers the lookups inside the resource root from the manifest instead of probing the file system,
+ * see FileUtils::loadAssetManifest. The entries are stored in a minimal perfect hash table, a lookup hashes the
+ * path twice and compares one entry. The manifest is immutable once loaded, so it can be read from any thread.
+ *
+ * File layout, all integers are 32 bits little endian:
+ *  - header: "CCAM", version, entry count, bucket count, string table size
+ *  - bucket seeds: one per bucket
+ *  - entries: path offset, path length, file size, CRC32 of the contents, in slot order
+ *  - string table: the paths relative to the resource root, '/' separated
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL AssetManifest
+{
+public:
+    static const uint32_t VERSION = 2;
+
+    struct Entry
+    {
+        uint32_t pathOffset;
+        uint32_t pathLength;
+        uint32_t size;
+        uint32_t crc32;
+    };
+
+    AssetManifest();
+
+    /** Takes the contents of a manifest file, which can be a mapped file.
+     * @return false if the data is not a valid manifest.
+     */
+    bool initWithData(Data&& data);
+
+    /** Finds the entry of a path relative to the resource root.
+     * @return nullptr if the path is not listed.
+     */
+    const Entry* find(const std::string& path) const;
+
+    /** Path of an entry, relative to the resource root. */
+    std::string getPath(const Entry* entry) const;
+
+    ssize_t getEntryCount() const { return _entryCount; }
+
+    /** Seeded FNV-1a with a final mix, the hash the generator places the entries with. */
+    static uint32_t hash(const char* str, size_t length, uint32_t seed);
+
+private:
+    Data _data;
+    const uint32_t* _seeds;
+    const Entry* _entries;
+    const char* _strings;
+    uint32_t _entryCount;
+    uint32_t _bucketCount;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(AssetManifest);
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_ASSET_MANIFEST_H__
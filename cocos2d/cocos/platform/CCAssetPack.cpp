@@ -0,0 +1,175 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "platform/CCAssetPack.h"
+#include "platform/CCAssetManifest.h"
+#include "platform/CCFileUtils.h"
+#include "base/ccMacros.h"
+
+#include <zlib.h>
+
+NS_CC_BEGIN
+
+namespace
+{
+    struct AssetPackHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t bucketCount;
+        uint32_t stringTableSize;
+        uint32_t alignment;
+    };
+}
+
+AssetPack::AssetPack()
+: _seeds(nullptr)
+, _entries(nullptr)
+, _strings(nullptr)
+, _entryCount(0)
+, _bucketCount(0)
+{
+}
+
+bool AssetPack::initWithFile(const std::string& fullPath)
+{
+    // packs in the APK have no path in the file system, they are read instead
+    Data data;
+    if (!data.mapFile(fullPath) && FileUtils::getInstance()->getContents(fullPath, &data) != FileUtils::Status::OK)
+    {
+        CCLOG("cocos2d: AssetPack: can't read %s", fullPath.c_str());
+        return false;
+    }
+
+    const size_t dataSize = static_cast<size_t>(data.getSize());
+    if (dataSize < sizeof(AssetPackHeader))
+        return false;
+
+    const AssetPackHeader* header = reinterpret_cast<const AssetPackHeader*>(data.getBytes());
+    if (memcmp(header->magic, "CCPK", 4) != 0 || header->version != VERSION || header->bucketCount == 0)
+    {
+        CCLOG("cocos2d: AssetPack: invalid header");
+        return false;
+    }
+
+    const size_t indexSize = sizeof(AssetPackHeader)
+        + header->bucketCount * sizeof(uint32_t)
+        + header->entryCount * sizeof(Entry)
+        + header->stringTableSize;
+    if (dataSize < indexSize)
+    {
+        CCLOG("cocos2d: AssetPack: invalid length");
+        return false;
+    }
+
+    const unsigned char* bytes = data.getBytes() + sizeof(AssetPackHeader);
+    const uint32_t* seeds = reinterpret_cast<const uint32_t*>(bytes);
+    const Entry* entries = reinterpret_cast<const Entry*>(bytes + header->bucketCount * sizeof(uint32_t));
+    const char* strings = reinterpret_cast<const char*>(entries + header->entryCount);
+
+    for (uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        const Entry& entry = entries[i];
+        if (entry.pathOffset > header->stringTableSize || entry.pathLength > header->stringTableSize - entry.pathOffset
+            || entry.dataOffset < indexSize || entry.dataOffset > dataSize || entry.storedSize > dataSize - entry.dataOffset
+            || (entry.method == static_cast<uint32_t>(Method::STORE) && entry.storedSize != entry.size)
+            || (entry.method != static_cast<uint32_t>(Method::STORE) && entry.method != static_cast<uint32_t>(Method::DEFLATE)))
+        {
+            CCLOG("cocos2d: AssetPack: invalid entry");
+            return false;
+        }
+    }
+
+    _filePath = fullPath;
+    _entryCount = header->entryCount;
+    _bucketCount = header->bucketCount;
+    _seeds = seeds;
+    _entries = entries;
+    _strings = strings;
+    _data = std::move(data);
+    return true;
+}
+
+const AssetPack::Entry* AssetPack::find(const std::string& path) const
+{
+    if (_entryCount == 0)
+        return nullptr;
+
+    uint32_t seed = _seeds[AssetManifest::hash(path.c_str(), path.length(), 0) % _bucketCount];
+    const Entry* entry = &_entries[AssetManifest::hash(path.c_str(), path.length(), seed) % _entryCount];
+
+    // paths which are not in the pack land on some other entry
+    if (entry->pathLength != path.length() || memcmp(_strings + entry->pathOffset, path.c_str(), path.length()) != 0)
+        return nullptr;
+    return entry;
+}
+
+std::string AssetPack::getPath(const Entry* entry) const
+{
+    return std::string(_strings + entry->pathOffset, entry->pathLength);
+}
+
+bool AssetPack::readEntry(const Entry* entry, ResizableBuffer* buffer) const
+{
+    const unsigned char* stored = _data.getBytes() + entry->dataOffset;
+
+    buffer->resize(entry->size);
+    if (entry->size == 0)
+        return true;
+
+    unsigned char* contents = static_cast<unsigned char*>(buffer->buffer());
+    if (entry->method == static_cast<uint32_t>(Method::STORE))
+    {
+        memcpy(contents, stored, entry->size);
+    }
+    else
+    {
+        uLongf size = entry->size;
+        if (uncompress(contents, &size, stored, entry->storedSize) != Z_OK || size != entry->size)
+        {
+            CCLOG("cocos2d: AssetPack: can't inflate %s", getPath(entry).c_str());
+            return false;
+        }
+    }
+
+#if COCOS2D_DEBUG > 0
+    if (static_cast<uint32_t>(crc32(0, contents, entry->size)) != entry->crc32)
+    {
+        CCLOG("cocos2d: AssetPack: CRC mismatch in %s", getPath(entry).c_str());
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool AssetPack::mapEntry(const Entry* entry, Data* data) const
+{
+    if (!_data.isMapped() || entry->method != static_cast<uint32_t>(Method::STORE) || entry->size == 0)
+        return false;
+    return data->mapFile(_filePath, entry->dataOffset, entry->size);
+}
+
+NS_CC_END
@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_ASSET_PACK_H__
+#define __CC_ASSET_PACK_H__
+
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+class ResizableBuffer;
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** Archive of resource files, generated by tools/asset-pack/pack_assets.py.
+ *
+ * FileUtils reads the files of a pack added with FileUtils::addAssetPack as if they were loose files in a search path.
+ * The pack is mapped into memory when it is in the file system, stored files are then served without a copy and
+ * deflated files are inflated straight from the mapping. Packs inside the APK are read into memory once. The index is
+ * the minimal perfect hash table of AssetManifest, a lookup hashes the path twice and compares one entry. The pack is
+ * immutable once loaded, so it can be read from any thread.
+ *
+ * File layout, all integers are 32 bits little endian:
+ *  - header: "CCPK", version, entry count, bucket count, string table size, alignment
+ *  - bucket seeds: one per bucket
+ *  - entries: path offset, path length, data offset, stored size, size, method, CRC32 of the contents, in slot order
+ *  - string table: the paths, '/' separated
+ *  - the contents of the files, each one starting at a multiple of the alignment
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL AssetPack
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    /** How the contents of an entry are stored. */
+    enum class Method : uint32_t
+    {
+        STORE = 0,
+        DEFLATE = 1,
+    };
+
+    struct Entry
+    {
+        uint32_t pathOffset;
+        uint32_t pathLength;
+        uint32_t dataOffset;
+        uint32_t storedSize;
+        uint32_t size;
+        uint32_t method;
+        uint32_t crc32;
+    };
+
+    AssetPack();
+
+    /** Opens the pack at a full path.
+     * @return false if the file can't be read or is not a valid pack.
+     */
+    bool initWithFile(const std::string& fullPath);
+
+    /** Full path of the pack file. */
+    const std::string& getFilePath() const { return _filePath; }
+
+    /** Finds the entry of a path inside the pack.
+     * @return nullptr if the pack has no such file.
+     */
+    const Entry* find(const std::string& path) const;
+
+    /** Path of an entry inside the pack. */
+    std::string getPath(const Entry* entry) const;
+
+    ssize_t getEntryCount() const { return _entryCount; }
+
+    /** Whether the pack is mapped, stored entries can be mapped too then. */
+    bool isMapped() const { return _data.isMapped(); }
+
+    /** Copies or inflates the contents of an entry.
+     * @return false if the entry is corrupted.
+     */
+    bool readEntry(const Entry* entry, ResizableBuffer* buffer) const;
+
+    /** Maps the contents of a stored entry, the data points into the page cache without a copy.
+     * @return false if the entry is deflated or the pack can't be mapped.
+     */
+    bool mapEntry(const Entry* entry, Data* data) const;
+
+private:
+    std::string _filePath;
+    Data _data;
+    const uint32_t* _seeds;
+    const Entry* _entries;
+    const char* _strings;
+    uint32_t _entryCount;
+    uint32_t _bucketCount;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(AssetPack);
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_ASSET_PACK_H__
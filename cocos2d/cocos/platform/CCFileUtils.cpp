@@ -26,12 +26,12 @@ THE SOFTWARE.
 
 #include "platform/CCFileUtils.h"
 
-#include <stack>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "platform/CCSAXParser.h"
+#include "platform/CCPlistReader.h"
 //#include "base/ccUtils.h"
 
 #include "tinyxml2/tinyxml2.h"
@@ -46,304 +46,45 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
-// Implement DictMaker
+// Implement the plist readers
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC)
 
-typedef enum
+// reads the root dictionary or array of a plist
+static bool readPlistRoot(const char* filedata, size_t filesize, PlistReader::Token rootToken, Value& root)
 {
-    SAX_NONE = 0,
-    SAX_KEY,
-    SAX_DICT,
-    SAX_INT,
-    SAX_REAL,
-    SAX_STRING,
-    SAX_ARRAY
-}SAXState;
-
-typedef enum
-{
-    SAX_RESULT_NONE = 0,
-    SAX_RESULT_DICT,
-    SAX_RESULT_ARRAY
-}SAXResult;
-
-class DictMaker : public SAXDelegator
-{
-public:
-    SAXResult _resultType;
-    ValueMap _rootDict;
-    ValueVector _rootArray;
-
-    std::string _curKey;   ///< parsed key
-    std::string _curValue; // parsed value
-    SAXState _state;
-
-    ValueMap*  _curDict;
-    ValueVector* _curArray;
-
-    std::stack<ValueMap*> _dictStack;
-    std::stack<ValueVector*> _arrayStack;
-    std::stack<SAXState>  _stateStack;
-
-public:
-    DictMaker()
-        : _resultType(SAX_RESULT_NONE)
-        , _state(SAX_NONE)
+    PlistReader reader(filedata, filesize);
+    if (reader.next() != rootToken || !reader.readValue(root))
     {
+        CCLOG("cocos2d: FileUtils: invalid plist");
+        return false;
     }
-
-    ~DictMaker()
-    {
-    }
-
-    ValueMap dictionaryWithContentsOfFile(const std::string& fileName)
-    {
-        _resultType = SAX_RESULT_DICT;
-        SAXParser parser;
-
-        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-        parser.setDelegator(this);
-
-        parser.parse(fileName);
-        return _rootDict;
-    }
-
-    ValueMap dictionaryWithDataOfFile(const char* filedata, int filesize)
-    {
-        _resultType = SAX_RESULT_DICT;
-        SAXParser parser;
-
-        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-        parser.setDelegator(this);
-
-        parser.parse(filedata, filesize);
-        return _rootDict;
-    }
-
-    ValueVector arrayWithContentsOfFile(const std::string& fileName)
-    {
-        _resultType = SAX_RESULT_ARRAY;
-        SAXParser parser;
-
-        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-        parser.setDelegator(this);
-
-        parser.parse(fileName);
-        return _rootArray;
-    }
-
-    void startElement(void *ctx, const char *name, const char **atts) override
-    {
-        const std::string sName(name);
-        if( sName == "dict" )
-        {
-            if(_resultType == SAX_RESULT_DICT && _rootDict.empty())
-            {
-                _curDict = &_rootDict;
-            }
-
-            _state = SAX_DICT;
-
-            SAXState preState = SAX_NONE;
-            if (! _stateStack.empty())
-            {
-                preState = _stateStack.top();
-            }
-
-            if (SAX_ARRAY == preState)
-            {
-                // add a new dictionary into the array
-                _curArray->push_back(Value(ValueMap()));
-                _curDict = &(_curArray->rbegin())->asValueMap();
-            }
-            else if (SAX_DICT == preState)
-            {
-                // add a new dictionary into the pre dictionary
-                CCASSERT(! _dictStack.empty(), "The state is wrong!");
-                ValueMap* preDict = _dictStack.top();
-                (*preDict)[_curKey] = Value(ValueMap());
-                _curDict = &(*preDict)[_curKey].asValueMap();
-            }
-
-            // record the dict state
-            _stateStack.push(_state);
-            _dictStack.push(_curDict);
-        }
-        else if(sName == "key")
-        {
-            _state = SAX_KEY;
-        }
-        else if(sName == "integer")
-        {
-            _state = SAX_INT;
-        }
-        else if(sName == "real")
-        {
-            _state = SAX_REAL;
-        }
-        else if(sName == "string")
-        {
-            _state = SAX_STRING;
-        }
-        else if (sName == "array")
-        {
-            _state = SAX_ARRAY;
-
-            if (_resultType == SAX_RESULT_ARRAY && _rootArray.empty())
-            {
-                _curArray = &_rootArray;
-            }
-            SAXState preState = SAX_NONE;
-            if (! _stateStack.empty())
-            {
-                preState = _stateStack.top();
-            }
-
-            if (preState == SAX_DICT)
-            {
-                (*_curDict)[_curKey] = Value(ValueVector());
-                _curArray = &(*_curDict)[_curKey].asValueVector();
-            }
-            else if (preState == SAX_ARRAY)
-            {
-                CCASSERT(! _arrayStack.empty(), "The state is wrong!");
-                ValueVector* preArray = _arrayStack.top();
-                preArray->push_back(Value(ValueVector()));
-                _curArray = &(_curArray->rbegin())->asValueVector();
-            }
-            // record the array state
-            _stateStack.push(_state);
-            _arrayStack.push(_curArray);
-        }
-        else
-        {
-            _state = SAX_NONE;
-        }
-    }
-
-    void endElement(void *ctx, const char *name) override
-    {
-        SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string sName((char*)name);
-        if( sName == "dict" )
-        {
-            _stateStack.pop();
-            _dictStack.pop();
-            if ( !_dictStack.empty())
-            {
-                _curDict = _dictStack.top();
-            }
-        }
-        else if (sName == "array")
-        {
-            _stateStack.pop();
-            _arrayStack.pop();
-            if (! _arrayStack.empty())
-            {
-                _curArray = _arrayStack.top();
-            }
-        }
-        else if (sName == "true")
-        {
-            if (SAX_ARRAY == curState)
-            {
-                _curArray->push_back(Value(true));
-            }
-            else if (SAX_DICT == curState)
-            {
-                (*_curDict)[_curKey] = Value(true);
-            }
-        }
-        else if (sName == "false")
-        {
-            if (SAX_ARRAY == curState)
-            {
-                _curArray->push_back(Value(false));
-            }
-            else if (SAX_DICT == curState)
-            {
-                (*_curDict)[_curKey] = Value(false);
-            }
-        }
-        else if (sName == "string" || sName == "integer" || sName == "real")
-        {
-            if (SAX_ARRAY == curState)
-            {
-                if (sName == "string")
-                    _curArray->push_back(Value(_curValue));
-                else if (sName == "integer")
-                    _curArray->push_back(Value(atoi(_curValue.c_str())));
-                else
-                    _curArray->push_back(Value(std::atof(_curValue.c_str())));
-            }
-            else if (SAX_DICT == curState)
-            {
-                if (sName == "string")
-                    (*_curDict)[_curKey] = Value(_curValue);
-                else if (sName == "integer")
-                    (*_curDict)[_curKey] = Value(atoi(_curValue.c_str()));
-                else
-                    (*_curDict)[_curKey] = Value(std::atof(_curValue.c_str()));
-            }
-
-            _curValue.clear();
-        }
-
-        _state = SAX_NONE;
-    }
-
-    void textHandler(void *ctx, const char *ch, size_t len) override
-    {
-        if (_state == SAX_NONE)
-        {
-            return;
-        }
-
-        SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string text = std::string((char*)ch,len);
-
-        switch(_state)
-        {
-        case SAX_KEY:
-            _curKey = text;
-            break;
-        case SAX_INT:
-        case SAX_REAL:
-        case SAX_STRING:
-            {
-                if (curState == SAX_DICT)
-                {
-                    CCASSERT(!_curKey.empty(), "key not found : <integer/real>");
-                }
-
-                _curValue.append(text);
-            }
-            break;
-        default:
-            break;
-        }
-    }
-};
+    return true;
+}
 
 ValueMap FileUtils::getValueMapFromFile(const std::string& filename) const
 {
     const std::string fullPath = fullPathForFilename(filename);
-    DictMaker tMaker;
-    return tMaker.dictionaryWithContentsOfFile(fullPath);
+    Data data = getDataFromFile(fullPath);
+    return getValueMapFromData(reinterpret_cast<const char*>(data.getBytes()), static_cast<int>(data.getSize()));
 }
 
 ValueMap FileUtils::getValueMapFromData(const char* filedata, int filesize) const
 {
-    DictMaker tMaker;
-    return tMaker.dictionaryWithDataOfFile(filedata, filesize);
+    Value root;
+    if (!filedata || filesize <= 0 || !readPlistRoot(filedata, filesize, PlistReader::Token::DICT_BEGIN, root))
+        return ValueMap();
+    return std::move(root.asValueMap());
 }
 
 ValueVector FileUtils::getValueVectorFromFile(const std::string& filename) const
 {
     const std::string fullPath = fullPathForFilename(filename);
-    DictMaker tMaker;
-    return tMaker.arrayWithContentsOfFile(fullPath);
+    Data data = getDataFromFile(fullPath);
+    Value root;
+    if (data.isNull() || !readPlistRoot(reinterpret_cast<const char*>(data.getBytes()), data.getSize(), PlistReader::Token::ARRAY_BEGIN, root))
+        return ValueVector();
+    return std::move(root.asValueVector());
 }
 
 
@@ -396,6 +137,8 @@ bool FileUtils::writeValueMapToFile(const ValueMap& dict, const std::string& ful
     rootEle->LinkEndChild(innerDict);
 
     bool ret = tinyxml2::XML_SUCCESS == doc->SaveFile(getSuitableFOpen(fullPath).c_str());
+    if (ret)
+        clearMissingFileCache();
 
     delete doc;
     return ret;
@@ -436,6 +179,8 @@ bool FileUtils::writeValueVectorToFile(const ValueVector& vecData, const std::st
     rootEle->LinkEndChild(innerDict);
 
     bool ret = tinyxml2::XML_SUCCESS == doc->SaveFile(getSuitableFOpen(fullPath).c_str());
+    if (ret)
+        clearMissingFileCache();
 
     delete doc;
     return ret;
@@ -598,6 +343,7 @@ bool FileUtils::writeDataToFile(const Data& data, const std::string& fullPath) c
 
         fclose(fp);
 
+        clearMissingFileCache();
         return true;
     } while (0);
 
@@ -619,11 +365,18 @@ bool FileUtils::init()
     return true;
 }
 
+void FileUtils::clearMissingFileCache() const
+{
+    DECLARE_GUARD;
+    _missingFileCache.clear();
+}
+
 void FileUtils::purgeCachedEntries()
 {
     DECLARE_GUARD;
     _fullPathCache.clear();
     _fullPathCacheDir.clear();
+    _missingFileCache.clear();
 }
 
 std::string FileUtils::getStringFromFile(const std::string& filename) const
@@ -646,6 +399,10 @@ void FileUtils::getStringFromFile(const std::string &path, std::function<void (s
 Data FileUtils::getDataFromFile(const std::string& filename) const
 {
     Data d;
+#if CC_FILEUTILS_MMAP_THRESHOLD > 0
+    if (getMappedContents(filename, &d) == Status::OK)
+        return d;
+#endif
     getContents(filename, &d);
     return d;
 }
@@ -669,6 +426,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    Status status;
+    if (getContentsFromAssetPack(fullPath, buffer, &status))
+        return status;
+
     std::string suitableFullPath = fs->getSuitableFOpen(fullPath);
 
     struct stat statBuf;
@@ -698,6 +459,34 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     return Status::OK;
 }
 
+FileUtils::Status FileUtils::getMappedContents(const std::string& filename, Data* data) const
+{
+    if (filename.empty())
+        return Status::NotExists;
+
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return Status::NotExists;
+
+    // stored files of a mapped pack are mapped on their own, the others are read from the pack
+    std::string entryPath;
+    if (auto pack = getAssetPackForPath(fullPath, &entryPath))
+    {
+        const AssetPack::Entry* entry = pack->find(entryPath);
+        if (!entry)
+            return Status::NotExists;
+        if (entry->size < CC_FILEUTILS_MMAP_THRESHOLD || !pack->mapEntry(entry, data))
+            return Status::OpenFailed;
+        return Status::OK;
+    }
+
+    // files in the APK or an OBB file have no path in the file system, mapping them fails
+    if (getFileSize(fullPath) < CC_FILEUTILS_MMAP_THRESHOLD || !data->mapFile(fullPath))
+        return Status::OpenFailed;
+
+    return Status::OK;
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size) const
 {
     CCASSERT(!filename.empty() && size != nullptr && mode != nullptr, "Invalid parameters.");
@@ -810,6 +599,46 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
     return path;
 }
 
+static std::string getPathWithResolutionDirectory(const std::string& filename, const std::string& resolutionDirectory)
+{
+    // file_path + resourceDirectory + file, '/' separated
+    std::string path;
+    size_t pos = filename.find_last_of('/');
+    if (pos != std::string::npos)
+    {
+        path += filename.substr(0, pos+1);
+        path += resolutionDirectory;
+        path += filename.substr(pos+1);
+    }
+    else
+    {
+        path += resolutionDirectory;
+        path += filename;
+    }
+    std::replace(path.begin(), path.end(), '\\', '/');
+    return path;
+}
+
+std::string FileUtils::getPathForFilenameInManifest(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath) const
+{
+    // relative to the resource root
+    std::string path = searchPath.substr(_defaultResRootPath.length());
+    path += getPathWithResolutionDirectory(filename, resolutionDirectory);
+
+    if (!_assetManifest->find(path))
+        return "";
+    return _defaultResRootPath + path;
+}
+
+std::string FileUtils::getPathForFilenameInAssetPack(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath, const AssetPack& pack) const
+{
+    std::string path = getPathWithResolutionDirectory(filename, resolutionDirectory);
+
+    if (!pack.find(path))
+        return "";
+    return searchPath + path;
+}
+
 std::string FileUtils::getPathForDirectory(const std::string &dir, const std::string &resolutionDiretory, const std::string &searchPath) const
 {
     return searchPath + resolutionDiretory + dir;
@@ -837,16 +666,42 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return cacheIter->second;
     }
 
+    // Already known to be missing ?
+    if (_missingFileCache.find(filename) != _missingFileCache.end())
+    {
+        return "";
+    }
+
     // Get the new file name.
     const std::string newFilename( getNewFilename(filename) );
 
+    // the manifest only knows normalized paths
+    const bool canUseManifest = _assetManifest && !_defaultResRootPath.empty() && newFilename.find("./") == std::string::npos;
+
     std::string fullpath;
 
     for (const auto& searchIt : _searchPathArray)
     {
+        // the files of an asset pack are looked up in its index
+        const AssetPack* pack = nullptr;
+        if (!_assetPacks.empty())
+        {
+            auto packIter = _assetPacks.find(searchIt);
+            if (packIter != _assetPacks.end())
+                pack = packIter->second.get();
+        }
+
+        // the files of the search paths inside the resource root are looked up in the manifest
+        const bool useManifest = !pack && canUseManifest && searchIt.compare(0, _defaultResRootPath.length(), _defaultResRootPath) == 0;
+
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
         {
-            fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
+            if (pack)
+                fullpath = getPathForFilenameInAssetPack(newFilename, resolutionIt, searchIt, *pack);
+            else if (useManifest)
+                fullpath = getPathForFilenameInManifest(newFilename, resolutionIt, searchIt);
+            else
+                fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
 
             if (!fullpath.empty())
             {
@@ -858,6 +713,8 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         }
     }
 
+    _missingFileCache.insert(filename);
+
     if(isPopupNotify()){
         CCLOG("cocos2d: fullPathForFilename: No file found at %s. Possible missing file.", filename.c_str());
     }
@@ -938,6 +795,7 @@ void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& search
 
     _fullPathCache.clear();
     _fullPathCacheDir.clear();
+    _missingFileCache.clear();
     _searchResolutionsOrderArray.clear();
     for(const auto& iter : searchResolutionsOrder)
     {
@@ -970,6 +828,9 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
     if (!resOrder.empty() && resOrder[resOrder.length()-1] != '/')
         resOrder.append("/");
 
+    // a missing file may be found in the new resolution directory
+    _missingFileCache.clear();
+
     if (front) {
         _searchResolutionsOrderArray.insert(_searchResolutionsOrderArray.begin(), resOrder);
     } else {
@@ -1014,6 +875,7 @@ void FileUtils::setDefaultResourceRootPath(const std::string& path)
     {
         _fullPathCache.clear();
         _fullPathCacheDir.clear();
+        _missingFileCache.clear();
         _defaultResRootPath = path;
         if (!_defaultResRootPath.empty() && _defaultResRootPath[_defaultResRootPath.length()-1] != '/')
         {
@@ -1033,6 +895,7 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 
     _fullPathCache.clear();
     _fullPathCacheDir.clear();
+    _missingFileCache.clear();
     _searchPathArray.clear();
 
     for (const auto& path : _originalSearchPaths)
@@ -1061,6 +924,15 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
         //CCLOG("Default root path doesn't exist, adding it.");
         _searchPathArray.push_back(_defaultResRootPath);
     }
+
+    // the asset packs whose search path was dropped don't serve files anymore
+    for (auto iter = _assetPacks.begin(); iter != _assetPacks.end();)
+    {
+        if (std::find(_searchPathArray.begin(), _searchPathArray.end(), iter->first) == _searchPathArray.end())
+            iter = _assetPacks.erase(iter);
+        else
+            ++iter;
+    }
 }
 
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
@@ -1076,6 +948,9 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
         path += "/";
     }
 
+    // a missing file may be found in the new search path
+    _missingFileCache.clear();
+
     if (front) {
         _originalSearchPaths.insert(_originalSearchPaths.begin(), searchpath);
         _searchPathArray.insert(_searchPathArray.begin(), path);
@@ -1090,9 +965,121 @@ void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
     DECLARE_GUARD;
     _fullPathCache.clear();
     _fullPathCacheDir.clear();
+    _missingFileCache.clear();
     _filenameLookupDict = filenameLookupDict;
 }
 
+bool FileUtils::loadAssetManifest(const std::string& filename)
+{
+    Data data = getDataFromFile(filename);
+    if (data.isNull())
+    {
+        CCLOG("cocos2d: ERROR: Asset manifest %s not found", filename.c_str());
+        return false;
+    }
+
+    std::shared_ptr<AssetManifest> manifest = std::make_shared<AssetManifest>();
+    if (!manifest->initWithData(std::move(data)))
+    {
+        CCLOG("cocos2d: ERROR: Invalid asset manifest %s", filename.c_str());
+        return false;
+    }
+
+    DECLARE_GUARD;
+    _assetManifest = manifest;
+    _fullPathCache.clear();
+    _missingFileCache.clear();
+    return true;
+}
+
+void FileUtils::unloadAssetManifest()
+{
+    DECLARE_GUARD;
+    _assetManifest.reset();
+    _fullPathCache.clear();
+    _missingFileCache.clear();
+}
+
+std::shared_ptr<const AssetManifest> FileUtils::getAssetManifest() const
+{
+    DECLARE_GUARD;
+    return _assetManifest;
+}
+
+bool FileUtils::addAssetPack(const std::string& filename, bool front)
+{
+    const std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+    {
+        CCLOG("cocos2d: ERROR: Asset pack %s not found", filename.c_str());
+        return false;
+    }
+
+    std::shared_ptr<AssetPack> pack = std::make_shared<AssetPack>();
+    if (!pack->initWithFile(fullPath))
+    {
+        CCLOG("cocos2d: ERROR: Invalid asset pack %s", filename.c_str());
+        return false;
+    }
+
+    DECLARE_GUARD;
+    const std::string searchPath = fullPath + '/';
+    const bool added = std::find(_searchPathArray.begin(), _searchPathArray.end(), searchPath) != _searchPathArray.end();
+    _assetPacks[searchPath] = pack;
+    _fullPathCache.clear();
+    _missingFileCache.clear();
+    if (!added)
+        addSearchPath(searchPath, front);
+    return true;
+}
+
+void FileUtils::removeAssetPack(const std::string& filename)
+{
+    const std::string fullPath = fullPathForFilename(filename);
+
+    DECLARE_GUARD;
+    const std::string searchPath = fullPath + '/';
+    if (fullPath.empty() || _assetPacks.erase(searchPath) == 0)
+        return;
+
+    _searchPathArray.erase(std::remove(_searchPathArray.begin(), _searchPathArray.end(), searchPath), _searchPathArray.end());
+    _originalSearchPaths.erase(std::remove(_originalSearchPaths.begin(), _originalSearchPaths.end(), searchPath), _originalSearchPaths.end());
+    _fullPathCache.clear();
+    _missingFileCache.clear();
+}
+
+std::shared_ptr<AssetPack> FileUtils::getAssetPackForPath(const std::string& fullPath, std::string* entryPath) const
+{
+    DECLARE_GUARD;
+    for (const auto& iter : _assetPacks)
+    {
+        const std::string& searchPath = iter.first;
+        if (fullPath.length() > searchPath.length() && fullPath.compare(0, searchPath.length(), searchPath) == 0)
+        {
+            *entryPath = fullPath.substr(searchPath.length());
+            return iter.second;
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::getContentsFromAssetPack(const std::string& fullPath, ResizableBuffer* buffer, Status* status) const
+{
+    std::string entryPath;
+    auto pack = getAssetPackForPath(fullPath, &entryPath);
+    if (!pack)
+        return false;
+
+    const AssetPack::Entry* entry = pack->find(entryPath);
+    if (!entry)
+        *status = Status::NotExists;
+    else if (!pack->readEntry(entry, buffer))
+        *status = Status::ReadFailed;
+    else
+        *status = Status::OK;
+    return true;
+}
+
 void FileUtils::loadFilenameLookupDictionaryFromFile(const std::string &filename)
 {
     const std::string fullPath = fullPathForFilename(filename);
@@ -1132,6 +1119,19 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
+        std::string entryPath;
+        if (auto pack = getAssetPackForPath(filename, &entryPath))
+        {
+            return pack->find(entryPath) != nullptr;
+        }
+
+        // files inside the resource root are looked up in the manifest
+        auto manifest = getAssetManifest();
+        const std::string root = getDefaultResourceRootPath();
+        if (manifest && !root.empty() && filename.compare(0, root.length(), root) == 0 && filename.find("./") == std::string::npos)
+        {
+            return manifest->find(filename.substr(root.length())) != nullptr;
+        }
         return isFileExistInternal(filename);
     }
     else
@@ -1434,6 +1434,7 @@ bool FileUtils::removeFile(const std::string &path) const
     if (remove(path.c_str())) {
         return false;
     } else {
+        clearMissingFileCache();
         return true;
     }
 }
@@ -1450,6 +1451,9 @@ bool FileUtils::renameFile(const std::string &oldfullpath, const std::string &ne
         CCLOGERROR("Fail to rename file %s to %s !Error code is %d", oldfullpath.c_str(), newfullpath.c_str(), errorCode);
         return false;
     }
+
+    // e.g. a download written to a temporary name and renamed to the file which was looked up
+    clearMissingFileCache();
     return true;
 }
 
@@ -1476,7 +1480,14 @@ long FileUtils::getFileSize(const std::string &filepath) const
     {
         fullpath = fullPathForFilename(filepath);
         if (fullpath.empty())
-            return 0;
+            return -1;
+    }
+
+    std::string entryPath;
+    if (auto pack = getAssetPackForPath(fullpath, &entryPath))
+    {
+        const AssetPack::Entry* entry = pack->find(entryPath);
+        return entry ? (long)entry->size : -1;
     }
 
     struct stat info;
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
 #include <type_traits>
 #include <mutex>
 
@@ -36,6 +38,8 @@ THE SOFTWARE.
 #include "base/ccTypes.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "platform/CCAssetManifest.h"
+#include "platform/CCAssetPack.h"
 #include "base/CCAsyncTaskPool.h"
 #include "base/CCScheduler.h"
 #include "base/CCDirector.h"
@@ -105,6 +109,9 @@ class ResizableBufferAdapter<Data> : public ResizableBuffer {
 public:
     explicit ResizableBufferAdapter(BufferType* buffer) : _buffer(buffer) {}
     virtual void resize(size_t size) override {
+        // a mapped file can't be reallocated
+        if (_buffer->isMapped())
+            _buffer->clear();
         size_t oldSize = static_cast<size_t>(_buffer->getSize());
         if (oldSize != size) {
             auto old = _buffer->getBytes();
@@ -161,7 +168,8 @@ public:
     virtual ~FileUtils();
 
     /**
-     *  Purges full path caches.
+     *  Purges full path caches, including the files known to be missing.
+     *  Call it when files were added to the search paths without FileUtils, for instance by a download.
      */
     virtual void purgeCachedEntries();
 
@@ -181,6 +189,7 @@ public:
 
     /**
      *  Creates binary data from a file.
+     *  Files of at least CC_FILEUTILS_MMAP_THRESHOLD bytes are mapped into memory when possible, see getMappedContents.
      *  @return A data object.
      */
     virtual Data getDataFromFile(const std::string& filename) const;
@@ -274,6 +283,20 @@ public:
     }
     virtual Status getContents(const std::string& filename, ResizableBuffer* buffer) const;
 
+    /**
+     *  Maps the file into memory instead of reading it, see Data::mapFile.
+     *  getDataFromFile uses it for files of at least CC_FILEUTILS_MMAP_THRESHOLD bytes.
+     *
+     *  @param[in]  filename The resource file name which contains the path.
+     *  @param[out] data The data which maps the file.
+     *  @return Returns:
+     *      - Status::OK when the file is mapped.
+     *      - Status::NotExists when file not exists, the data will not changed.
+     *      - Status::OpenFailed when the file is smaller than CC_FILEUTILS_MMAP_THRESHOLD or can't be mapped,
+     *        for example inside the APK, the data will not changed. Read it with getContents then.
+     */
+    virtual Status getMappedContents(const std::string& filename, Data* data) const;
+
     /**
      *  Gets resource file data
      *
@@ -379,6 +402,51 @@ public:
      */
     virtual void loadFilenameLookupDictionaryFromFile(const std::string &filename);
 
+    /**
+     *  Loads the asset manifest generated by tools/asset-manifest/gen_asset_manifest.py, see AssetManifest.
+     *
+     *  fullPathForFilename then looks up the files of the search paths inside the default resource root
+     *  in the manifest instead of probing the file system, a file which is not listed doesn't exist there.
+     *  Search paths outside the root, like the writable path of downloaded updates, are still probed.
+     *  The manifest has to be generated again whenever the resources change.
+     *
+     *  @param filename The manifest file name.
+     *  @return true if the manifest is loaded.
+     */
+    virtual bool loadAssetManifest(const std::string& filename);
+
+    /**
+     *  Unloads the asset manifest, the resource root is probed again.
+     */
+    virtual void unloadAssetManifest();
+
+    /**
+     *  Gets the loaded asset manifest, for instance to check the size or CRC32 of a file.
+     *
+     *  @return The manifest, nullptr if there is none.
+     */
+    std::shared_ptr<const AssetManifest> getAssetManifest() const;
+
+    /**
+     *  Adds an asset pack generated by tools/asset-pack/pack_assets.py as a search path, see AssetPack.
+     *
+     *  The files of the pack are found like the files of a search path, their full path is the path of the pack
+     *  followed by '/' and the path inside the pack. getDataFromFile returns the stored files of a pack in the file
+     *  system without a copy. setSearchPaths drops the pack unless the new search paths contain its full path.
+     *
+     *  @param filename The pack file name.
+     *  @param front Whether the pack is searched before the other search paths.
+     *  @return true if the pack is added.
+     */
+    virtual bool addAssetPack(const std::string& filename, bool front = false);
+
+    /**
+     *  Removes an asset pack and its search path.
+     *
+     *  @param filename The pack file name, as passed to addAssetPack.
+     */
+    virtual void removeAssetPack(const std::string& filename);
+
     /**
      *  Sets the filenameLookup dictionary.
      *
@@ -793,7 +861,7 @@ public:
      *
      *  @note If a relative path was passed in, it will be inserted a default root path at the beginning.
      *  @param filepath The path of the file, it could be a relative or absolute path.
-     *  @return The file size.
+     *  @return The file size, -1 if the file doesn't exist.
      */
     virtual long getFileSize(const std::string &filepath) const;
 
@@ -896,6 +964,37 @@ protected:
      */
     virtual std::string getPathForFilename(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath) const;
 
+    /**
+     *  Same as getPathForFilename for a search path inside the resource root, but looks the file up in the asset manifest.
+     */
+    std::string getPathForFilenameInManifest(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath) const;
+
+    /**
+     *  Same as getPathForFilename for the search path of an asset pack, but looks the file up in the pack.
+     */
+    std::string getPathForFilenameInAssetPack(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath, const AssetPack& pack) const;
+
+    /**
+     *  Gets the asset pack a full path points into.
+     *
+     *  @param fullPath The full path of a file.
+     *  @param entryPath Set to the path inside the pack.
+     *  @return The pack, nullptr if the path is not inside an asset pack.
+     */
+    std::shared_ptr<AssetPack> getAssetPackForPath(const std::string& fullPath, std::string* entryPath) const;
+
+    /**
+     *  Reads a file inside an asset pack, the platform getContents call it before reading the file system.
+     *
+     *  @return false if the path is not inside an asset pack, status is set otherwise.
+     */
+    bool getContentsFromAssetPack(const std::string& fullPath, ResizableBuffer* buffer, Status* status) const;
+
+    /**
+     *  Forgets the files known to be missing, after a file was written, renamed or removed.
+     */
+    void clearMissingFileCache() const;
+
     virtual std::string getPathForDirectory(const std::string &dir, const std::string &resolutionDiretory, const std::string &searchPath) const;
     
     
@@ -971,6 +1070,22 @@ protected:
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCacheDir;
 
+    /**
+     *  The files which were not found in any search path, so optional lookups don't probe the file system again.
+     *  It is cleared with the full path caches, when a search path is added and when FileUtils writes a file.
+     */
+    mutable std::unordered_set<std::string> _missingFileCache;
+
+    /**
+     *  The index of the files under the resource root, see loadAssetManifest.
+     */
+    std::shared_ptr<AssetManifest> _assetManifest;
+
+    /**
+     *  The asset packs by search path, the full path of the pack followed by '/', see addAssetPack.
+     */
+    std::unordered_map<std::string, std::shared_ptr<AssetPack>> _assetPacks;
+
     /**
      * Writable path.
      */
@@ -95,6 +95,7 @@ extern "C"
 }
 #include "base/s3tc.h"
 #include "base/atitc.h"
+#include "base/etc2.h"
 #include "base/pvr.h"
 #include "base/TGAlib.h"
 
@@ -109,6 +110,7 @@ extern "C"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "renderer/ccPixelConvert.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "platform/android/CCFileUtils-android.h"
 #endif
@@ -117,6 +119,16 @@ extern "C"
 #define CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD                          0x8C93
 #define CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD                      0x87EE
 
+#define CC_GL_ETC1_RGB8_OES                                        0x8D64
+#define CC_GL_COMPRESSED_SRGB8_ETC2                                0x9275
+#define CC_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC                     0x9279
+#define CC_GL_COMPRESSED_RGBA_ASTC_4x4_KHR                         0x93B0
+#define CC_GL_COMPRESSED_RGBA_ASTC_6x6_KHR                         0x93B4
+#define CC_GL_COMPRESSED_RGBA_ASTC_8x8_KHR                         0x93B7
+#define CC_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR                 0x93D0
+#define CC_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6_KHR                 0x93D4
+#define CC_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR                 0x93D7
+
 NS_CC_BEGIN
 
 //////////////////////////////////////////////////////////////////////////
@@ -428,6 +440,98 @@ namespace
 
 //////////////////////////////////////////////////////////////////////////
 
+//struct and data for ktx struct
+namespace
+{
+    static const unsigned char gKTX1Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    static const unsigned char gKTX2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    static const uint32_t KTX_ENDIANNESS = 0x04030201;
+
+    // ATITC files are KTX 1 files
+    typedef ATITCTexHeader KTX1TexHeader;
+
+    struct KTX2TexHeader
+    {
+        char identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct KTX2LevelIndex
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    // the engine has no sRGB textures, sRGB data is sampled as it is stored like the other image formats
+    Texture2D::PixelFormat getKTXPixelFormat(uint32_t glInternalFormat)
+    {
+        switch (glInternalFormat)
+        {
+            case CC_GL_ETC1_RGB8_OES:
+                return Texture2D::PixelFormat::ETC;
+            case CC_GL_COMPRESSED_RGB8_ETC2:
+            case CC_GL_COMPRESSED_SRGB8_ETC2:
+                return Texture2D::PixelFormat::ETC2_RGB;
+            case CC_GL_COMPRESSED_RGBA8_ETC2_EAC:
+            case CC_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+                return Texture2D::PixelFormat::ETC2_RGBA;
+            case CC_GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+            case CC_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR:
+                return Texture2D::PixelFormat::ASTC_4x4;
+            case CC_GL_COMPRESSED_RGBA_ASTC_6x6_KHR:
+            case CC_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6_KHR:
+                return Texture2D::PixelFormat::ASTC_6x6;
+            case CC_GL_COMPRESSED_RGBA_ASTC_8x8_KHR:
+            case CC_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR:
+                return Texture2D::PixelFormat::ASTC_8x8;
+            default:
+                return Texture2D::PixelFormat::NONE;
+        }
+    }
+
+    Texture2D::PixelFormat getKTX2PixelFormat(uint32_t vkFormat)
+    {
+        switch (vkFormat)
+        {
+            case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+            case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+                return Texture2D::PixelFormat::ETC2_RGB;
+            case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+            case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+                return Texture2D::PixelFormat::ETC2_RGBA;
+            case 157: // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+            case 158: // VK_FORMAT_ASTC_4x4_SRGB_BLOCK
+                return Texture2D::PixelFormat::ASTC_4x4;
+            case 165: // VK_FORMAT_ASTC_6x6_UNORM_BLOCK
+            case 166: // VK_FORMAT_ASTC_6x6_SRGB_BLOCK
+                return Texture2D::PixelFormat::ASTC_6x6;
+            case 171: // VK_FORMAT_ASTC_8x8_UNORM_BLOCK
+            case 172: // VK_FORMAT_ASTC_8x8_SRGB_BLOCK
+                return Texture2D::PixelFormat::ASTC_8x8;
+            default:
+                return Texture2D::PixelFormat::NONE;
+        }
+    }
+}
+//ktx struct end
+
+//////////////////////////////////////////////////////////////////////////
+
 namespace
 {
     typedef struct 
@@ -502,7 +606,7 @@ Image::~Image()
         for (int i = 0; i < _numberOfMipmaps; ++i)
             CC_SAFE_DELETE_ARRAY(_mipmaps[i].address);
     }
-    else
+    else if (_fileData.isNull())
         CC_SAFE_FREE(_data);
 }
 
@@ -515,7 +619,7 @@ bool Image::initWithImageFile(const std::string& path)
 
     if (!data.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageFileData(data);
     }
 
     return ret;
@@ -530,12 +634,24 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
 
     if (!data.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageFileData(data);
     }
 
     return ret;
 }
 
+bool Image::initWithImageFileData(Data& data)
+{
+    if (isKtx(data.getBytes(), data.getSize()))
+    {
+        // the mipmaps of a GPU ready container are uploaded straight from the file contents
+        _fileData = std::move(data);
+        _fileType = Format::KTX;
+        return initWithKTXData(_fileData.getBytes(), _fileData.getSize(), true);
+    }
+    return initWithImageData(data.getBytes(), data.getSize());
+}
+
 bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
 {
     bool ret = false;
@@ -590,6 +706,9 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
         case Format::ATITC:
             ret = initWithATITCData(unpackedData, unpackedLen);
             break;
+        case Format::KTX:
+            ret = initWithKTXData(unpackedData, unpackedLen);
+            break;
         default:
             {
                 // load and detect image format
@@ -660,6 +779,30 @@ bool Image::isATITC(const unsigned char *data, ssize_t /*dataLen*/)
     return true;
 }
 
+bool Image::isKtx(const unsigned char *data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) >= sizeof(KTX2TexHeader) && memcmp(data, gKTX2Identifier, sizeof(gKTX2Identifier)) == 0)
+    {
+        return true;
+    }
+    if (static_cast<size_t>(dataLen) < sizeof(KTX1TexHeader) || memcmp(data, gKTX1Identifier, sizeof(gKTX1Identifier)) != 0)
+    {
+        return false;
+    }
+    
+    // ATC textures keep their own loader
+    const KTX1TexHeader* header = static_cast<const KTX1TexHeader*>(static_cast<const void*>(data));
+    switch (header->glInternalFormat)
+    {
+        case CC_GL_ATC_RGB_AMD:
+        case CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD:
+        case CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD:
+            return false;
+        default:
+            return true;
+    }
+}
+
 bool Image::isJpg(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 4)
@@ -743,6 +886,10 @@ Image::Format Image::detectFormat(const unsigned char * data, ssize_t dataLen)
     {
         return Format::S3TC;
     }
+    else if (isKtx(data, dataLen))
+    {
+        return Format::KTX;
+    }
     else if (isATITC(data, dataLen))
     {
         return Format::ATITC;
@@ -2113,6 +2260,216 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     return true;
 }
 
+bool Image::initWithKTXData(const unsigned char *data, ssize_t dataLen, bool inPlace)
+{
+    Texture2D::PixelFormat format = Texture2D::PixelFormat::NONE;
+    int width = 0;
+    int height = 0;
+    int levelCount = 0;
+    const unsigned char* levelData[MIPMAP_MAX];
+    ssize_t levelLen[MIPMAP_MAX];
+    
+    if (memcmp(data, gKTX1Identifier, sizeof(gKTX1Identifier)) == 0)
+    {
+        const KTX1TexHeader* header = static_cast<const KTX1TexHeader*>(static_cast<const void*>(data));
+        if (header->endianness != KTX_ENDIANNESS || header->numberOfArrayElements > 0 || header->numberOfFaces != 1 || header->pixelDepth > 1)
+        {
+            CCLOG("cocos2d: KTX: only 2D textures with the native byte order are supported");
+            return false;
+        }
+        
+        format = getKTXPixelFormat(header->glInternalFormat);
+        width = header->pixelWidth;
+        height = header->pixelHeight;
+        levelCount = MIN(MAX((int)header->numberOfMipmapLevels, 1), MIPMAP_MAX);
+        
+        // every level is an imageSize field followed by the data, padded to 4 bytes
+        ssize_t offset = sizeof(KTX1TexHeader) + header->bytesOfKeyValueData;
+        for (int i = 0; i < levelCount; ++i)
+        {
+            uint32_t imageSize = 0;
+            if (offset + 4 > dataLen)
+            {
+                CCLOG("cocos2d: KTX: invalid length");
+                return false;
+            }
+            memcpy(&imageSize, data + offset, 4);
+            offset += 4;
+            if (imageSize > dataLen - offset)
+            {
+                CCLOG("cocos2d: KTX: invalid length");
+                return false;
+            }
+            levelData[i] = data + offset;
+            levelLen[i] = imageSize;
+            offset += (imageSize + 3) & ~3;
+        }
+    }
+    else
+    {
+        const KTX2TexHeader* header = static_cast<const KTX2TexHeader*>(static_cast<const void*>(data));
+        if (header->supercompressionScheme != 0)
+        {
+            CCLOG("cocos2d: KTX: supercompressed textures are not supported");
+            return false;
+        }
+        if (header->layerCount > 0 || header->faceCount != 1 || header->pixelDepth > 1)
+        {
+            CCLOG("cocos2d: KTX: only 2D textures are supported");
+            return false;
+        }
+        
+        format = getKTX2PixelFormat(header->vkFormat);
+        width = header->pixelWidth;
+        height = header->pixelHeight;
+        levelCount = MIN(MAX((int)header->levelCount, 1), MIPMAP_MAX);
+        
+        if (static_cast<size_t>(dataLen) < sizeof(KTX2TexHeader) + levelCount * sizeof(KTX2LevelIndex))
+        {
+            CCLOG("cocos2d: KTX: invalid length");
+            return false;
+        }
+        const KTX2LevelIndex* levelIndex = static_cast<const KTX2LevelIndex*>(static_cast<const void*>(data + sizeof(KTX2TexHeader)));
+        for (int i = 0; i < levelCount; ++i)
+        {
+            if (levelIndex[i].byteOffset > static_cast<uint64_t>(dataLen) || levelIndex[i].byteLength > dataLen - levelIndex[i].byteOffset)
+            {
+                CCLOG("cocos2d: KTX: invalid length");
+                return false;
+            }
+            levelData[i] = data + levelIndex[i].byteOffset;
+            levelLen[i] = static_cast<ssize_t>(levelIndex[i].byteLength);
+        }
+    }
+    
+    if (format == Texture2D::PixelFormat::NONE || width <= 0 || height <= 0)
+    {
+        CCLOG("cocos2d: KTX: unsupported texture format");
+        return false;
+    }
+    
+    bool decode = false;
+    switch (format)
+    {
+        case Texture2D::PixelFormat::ETC:
+            decode = !Configuration::getInstance()->supportsETC();
+            break;
+        case Texture2D::PixelFormat::ETC2_RGB:
+        case Texture2D::PixelFormat::ETC2_RGBA:
+            decode = !Configuration::getInstance()->supportsETC2();
+            break;
+        default:
+            // there is no software decoder for ASTC
+            if (!Configuration::getInstance()->supportsASTC())
+            {
+                CCLOG("cocos2d: KTX: ASTC textures are not supported on this device");
+                return false;
+            }
+            break;
+    }
+    
+    _width = width;
+    _height = height;
+    
+    if (!decode)
+    {
+        _renderFormat = format;
+        _dataLen = 0;
+        for (int i = 0; i < levelCount; ++i)
+        {
+            _dataLen += levelLen[i];
+        }
+        
+        if (!inPlace)
+        {
+            _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+            if (!_data)
+            {
+                return false;
+            }
+        }
+        
+        ssize_t offset = 0;
+        for (int i = 0; i < levelCount; ++i)
+        {
+            if (inPlace)
+            {
+                _mipmaps[i].address = const_cast<unsigned char*>(levelData[i]);
+            }
+            else
+            {
+                _mipmaps[i].address = _data + offset;
+                memcpy(_mipmaps[i].address, levelData[i], levelLen[i]);
+                offset += levelLen[i];
+            }
+            _mipmaps[i].len = static_cast<int>(levelLen[i]);
+        }
+        _numberOfMipmaps = levelCount;
+        
+        if (inPlace)
+        {
+            _data = _mipmaps[0].address;
+        }
+        return true;
+    }
+    
+    /* if the device does not support the format, decode texture by software */
+    CCLOG("cocos2d: Hardware ETC decoder not present. Using software decoder");
+    
+    bool hasAlpha = (format == Texture2D::PixelFormat::ETC2_RGBA);
+    int bytePerPixel = hasAlpha ? 4 : 3;
+    _renderFormat = hasAlpha ? Texture2D::PixelFormat::RGBA8888 : Texture2D::PixelFormat::RGB888;
+    _unpack = true;
+    
+    for (int i = 0; i < levelCount; ++i)
+    {
+        int levelWidth = MAX(width >> i, 1);
+        int levelHeight = MAX(height >> i, 1);
+        
+        ssize_t encodedSize = 0;
+        if (format == Texture2D::PixelFormat::ETC)
+        {
+            encodedSize = etc1_get_encoded_data_size(levelWidth, levelHeight);
+        }
+        else
+        {
+            encodedSize = etc2_get_encoded_data_size(levelWidth, levelHeight, hasAlpha ? ETC2DecodeFlag::ETC2_RGBA : ETC2DecodeFlag::ETC2_RGB);
+        }
+        if (levelLen[i] < encodedSize)
+        {
+            CCLOG("cocos2d: KTX: invalid length");
+            return false;
+        }
+        
+        _mipmaps[i].len = levelWidth * levelHeight * bytePerPixel;
+        _mipmaps[i].address = new (std::nothrow) unsigned char[_mipmaps[i].len];
+        if (!_mipmaps[i].address)
+        {
+            return false;
+        }
+        _numberOfMipmaps = i + 1;
+        
+        if (format == Texture2D::PixelFormat::ETC)
+        {
+            if (etc1_decode_image(static_cast<const etc1_byte*>(levelData[i]), static_cast<etc1_byte*>(_mipmaps[i].address), levelWidth, levelHeight, bytePerPixel, levelWidth * bytePerPixel) != 0)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            etc2_decode(levelData[i], _mipmaps[i].address, levelWidth, levelHeight, hasAlpha ? ETC2DecodeFlag::ETC2_RGBA : ETC2DecodeFlag::ETC2_RGB);
+        }
+    }
+    
+    _data = _mipmaps[0].address;
+    _dataLen = _mipmaps[0].len;
+    // the decoded levels do not point into the file contents
+    _fileData.clear();
+    
+    return true;
+}
+
 bool Image::initWithPVRData(const unsigned char * data, ssize_t dataLen)
 {
     return initWithPVRv2Data(data, dataLen) || initWithPVRv3Data(data, dataLen);
@@ -2462,8 +2819,10 @@ void Image::premultiplyAlpha()
 #else
     CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
+    ssize_t pixelCount = (ssize_t)_width * _height;
+    ssize_t done = PixelConvert::premultiplyAlpha(_data, pixelCount * 4) / 4;
     unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
+    for(ssize_t i = done; i < pixelCount; i++)
     {
         unsigned char* p = _data + i * 4;
         fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
@@ -2473,6 +2832,29 @@ void Image::premultiplyAlpha()
 #endif
 }
 
+bool Image::convertToFormat(Texture2D::PixelFormat format)
+{
+    if (format == Texture2D::PixelFormat::NONE || format == Texture2D::PixelFormat::AUTO || format == _renderFormat)
+        return true;
+
+    // compressed data and mipmap chains are uploaded as they are
+    if (_data == nullptr || _unpack || _numberOfMipmaps > 1 || isCompressed())
+        return false;
+
+    unsigned char* outData = nullptr;
+    ssize_t outDataLen = 0;
+    Texture2D::PixelFormat converted = Texture2D::convertDataToFormat(_data, _dataLen, _renderFormat, format, &outData, &outDataLen);
+    if (outData != _data)
+    {
+        free(_data);
+        _data = outData;
+        _dataLen = outDataLen;
+    }
+    _renderFormat = converted;
+
+    return converted == format;
+}
+
 static inline unsigned char clamp(int x) {
     return (unsigned char)(x >= 0 ? (x < 255 ? x : 255) : 0);
 }
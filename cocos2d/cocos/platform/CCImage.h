@@ -29,6 +29,7 @@ THE SOFTWARE.
 /// @cond DO_NOT_SHOW
 
 #include "base/CCRef.h"
+#include "base/CCData.h"
 #include "renderer/CCTexture2D.h"
 
 #if CC_USE_WIC
@@ -93,6 +94,8 @@ public:
         S3TC,
         //! ATITC
         ATITC,
+        //! KTX and KTX2 with ETC1, ETC2 or ASTC data
+        KTX,
         //! TGA
         TGA,
         //! Raw Data
@@ -163,6 +166,14 @@ public:
     void premultiplyAlpha();
     void reversePremultipliedAlpha();
 
+    /**
+     @brief    Converts the pixels to another uncompressed format, so Texture2D::initWithImage can upload them as they are.
+               It is thread safe, the texture cache calls it on its loading threads.
+     @param    format    the format the pixels are converted to.
+     @return   true if the pixels are in that format afterwards.
+     */
+    bool convertToFormat(Texture2D::PixelFormat format);
+
 protected:
 #if CC_USE_WIC
     bool encodeWithWIC(const std::string& filePath, bool isToRGB, GUID containerFormat);
@@ -178,6 +189,7 @@ protected:
     bool initWithETCData(const unsigned char * data, ssize_t dataLen);
     bool initWithS3TCData(const unsigned char * data, ssize_t dataLen);
     bool initWithATITCData(const unsigned char *data, ssize_t dataLen);
+    bool initWithKTXData(const unsigned char *data, ssize_t dataLen, bool inPlace = false);
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
 
@@ -196,6 +208,8 @@ protected:
     static bool PNG_PREMULTIPLIED_ALPHA_ENABLED;
     unsigned char *_data;
     ssize_t _dataLen;
+    // file contents kept by the image when the mipmaps point into them
+    Data _fileData;
     int _width;
     int _height;
     bool _unpack;
@@ -221,6 +235,7 @@ protected:
      @return  true if loaded correctly.
      */
     bool initWithImageFileThreadSafe(const std::string& fullpath);
+    bool initWithImageFileData(Data& data);
     
     Format detectFormat(const unsigned char * data, ssize_t dataLen);
     bool isPng(const unsigned char * data, ssize_t dataLen);
@@ -231,6 +246,7 @@ protected:
     bool isEtc(const unsigned char * data, ssize_t dataLen);
     bool isS3TC(const unsigned char * data,ssize_t dataLen);
     bool isATITC(const unsigned char *data, ssize_t dataLen);
+    bool isKtx(const unsigned char *data, ssize_t dataLen);
 };
 
 // end of platform group
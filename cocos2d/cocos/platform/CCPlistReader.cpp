@@ -0,0 +1,626 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCPlistReader.h"
+
+#include <cstdlib>
+
+NS_CC_BEGIN
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool isNameChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    const char* findString(const char* begin, const char* end, const char* str, size_t length)
+    {
+        for (; begin + length <= end; ++begin)
+        {
+            begin = static_cast<const char*>(memchr(begin, str[0], end - begin));
+            if (!begin || begin + length > end)
+                return nullptr;
+            if (memcmp(begin, str, length) == 0)
+                return begin;
+        }
+        return nullptr;
+    }
+
+    void appendUTF8(unsigned long codePoint, std::string& out)
+    {
+        if (codePoint < 0x80)
+        {
+            out += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x110000)
+        {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    // decodes the entities and turns "\r\n" and "\r" into "\n", like tinyxml2
+    void decodeText(const char* text, size_t length, std::string& out)
+    {
+        static const struct
+        {
+            const char* name;
+            size_t length;
+            char value;
+        } entities[] = {
+            { "lt;", 3, '<' },
+            { "gt;", 3, '>' },
+            { "amp;", 4, '&' },
+            { "quot;", 5, '"' },
+            { "apos;", 5, '\'' },
+        };
+
+        out.clear();
+        out.reserve(length);
+        const char* end = text + length;
+        while (text < end)
+        {
+            char c = *text++;
+            if (c == '\r')
+            {
+                if (text < end && *text == '\n')
+                    ++text;
+                out += '\n';
+                continue;
+            }
+            if (c != '&')
+            {
+                out += c;
+                continue;
+            }
+
+            const char* semicolon = static_cast<const char*>(memchr(text, ';', end - text));
+            if (semicolon && text < semicolon && *text == '#')
+            {
+                char* numberEnd = nullptr;
+                unsigned long codePoint = (text[1] == 'x' || text[1] == 'X') ? strtoul(text + 2, &numberEnd, 16) : strtoul(text + 1, &numberEnd, 10);
+                if (numberEnd == semicolon)
+                {
+                    appendUTF8(codePoint, out);
+                    text = semicolon + 1;
+                    continue;
+                }
+            }
+            else if (semicolon)
+            {
+                bool decoded = false;
+                for (const auto& entity : entities)
+                {
+                    if (static_cast<size_t>(semicolon + 1 - text) == entity.length && memcmp(text, entity.name, entity.length) == 0)
+                    {
+                        out += entity.value;
+                        text = semicolon + 1;
+                        decoded = true;
+                        break;
+                    }
+                }
+                if (decoded)
+                    continue;
+            }
+            // unknown entities are kept as they are
+            out += c;
+        }
+    }
+
+    // the text is always followed by the '<' of its closing tag, which stops the conversions
+    long parseLong(const char* text, size_t length)
+    {
+        return length > 0 ? strtol(text, nullptr, 10) : 0;
+    }
+
+    double parseDouble(const char* text, size_t length)
+    {
+        return length > 0 ? strtod(text, nullptr) : 0.0;
+    }
+}
+
+PlistReader::PlistReader(const char* data, size_t size)
+: _cursor(data)
+, _end(data + size)
+, _token(Token::END)
+, _text(nullptr)
+, _textLength(0)
+, _needsDecoding(false)
+, _isEmptyContainer(false)
+{
+    // UTF-8 byte order mark
+    if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+        _cursor += 3;
+}
+
+PlistReader::Token PlistReader::fail()
+{
+    _cursor = _end;
+    _token = Token::INVALID;
+    return _token;
+}
+
+bool PlistReader::readTextAfterOpening(const char* name, size_t nameLength, bool isEmpty)
+{
+    _text = _cursor;
+    _textLength = 0;
+    _needsDecoding = false;
+    if (isEmpty)
+        return true;
+
+    const char* textEnd = static_cast<const char*>(memchr(_cursor, '<', _end - _cursor));
+    // the closing tag, CDATA sections are not supported
+    if (!textEnd || _end - textEnd < static_cast<ptrdiff_t>(nameLength + 3) || textEnd[1] != '/' || memcmp(textEnd + 2, name, nameLength) != 0)
+        return false;
+
+    const char* closeEnd = textEnd + 2 + nameLength;
+    while (closeEnd < _end && isSpace(*closeEnd))
+        ++closeEnd;
+    if (closeEnd >= _end || *closeEnd != '>')
+        return false;
+
+    _textLength = textEnd - _text;
+    _needsDecoding = memchr(_text, '&', _textLength) || memchr(_text, '\r', _textLength);
+    _cursor = closeEnd + 1;
+    return true;
+}
+
+PlistReader::Token PlistReader::next()
+{
+    if (_token == Token::INVALID)
+        return _token;
+
+    if (_isEmptyContainer)
+    {
+        _isEmptyContainer = false;
+        _token = _token == Token::DICT_BEGIN ? Token::DICT_END : Token::ARRAY_END;
+        return _token;
+    }
+
+    _text = nullptr;
+    _textLength = 0;
+    _needsDecoding = false;
+
+    for (;;)
+    {
+        while (_cursor < _end && isSpace(*_cursor))
+            ++_cursor;
+        if (_cursor >= _end)
+        {
+            _token = Token::END;
+            return _token;
+        }
+        if (*_cursor != '<')
+            return fail();
+
+        const char* tag = _cursor + 1;
+        if (tag < _end && (*tag == '?' || *tag == '!'))
+        {
+            // declaration, comment or DOCTYPE
+            const char* close = nullptr;
+            if (_end - tag >= 3 && memcmp(tag, "!--", 3) == 0)
+            {
+                close = findString(tag + 3, _end, "-->", 3);
+                _cursor = close ? close + 3 : nullptr;
+            }
+            else
+            {
+                close = static_cast<const char*>(memchr(tag, '>', _end - tag));
+                _cursor = close ? close + 1 : nullptr;
+            }
+            if (!close)
+                return fail();
+            continue;
+        }
+
+        const char* tagEnd = static_cast<const char*>(memchr(tag, '>', _end - tag));
+        if (!tagEnd)
+            return fail();
+        _cursor = tagEnd + 1;
+
+        const bool isClosing = *tag == '/';
+        if (isClosing)
+            ++tag;
+        const char* nameEnd = tag;
+        while (nameEnd < tagEnd && isNameChar(*nameEnd))
+            ++nameEnd;
+        const size_t nameLength = nameEnd - tag;
+        const bool isEmpty = !isClosing && tagEnd[-1] == '/';
+
+#define CC_PLIST_TAG_IS(str) (nameLength == sizeof(str) - 1 && memcmp(tag, str, nameLength) == 0)
+        if (CC_PLIST_TAG_IS("plist"))
+            continue;
+
+        if (isClosing)
+        {
+            if (CC_PLIST_TAG_IS("dict"))
+                _token = Token::DICT_END;
+            else if (CC_PLIST_TAG_IS("array"))
+                _token = Token::ARRAY_END;
+            else
+                return fail();
+            return _token;
+        }
+
+        if (CC_PLIST_TAG_IS("dict") || CC_PLIST_TAG_IS("array"))
+        {
+            _token = CC_PLIST_TAG_IS("dict") ? Token::DICT_BEGIN : Token::ARRAY_BEGIN;
+            _isEmptyContainer = isEmpty;
+            return _token;
+        }
+
+        Token token;
+        if (CC_PLIST_TAG_IS("key"))
+            token = Token::KEY;
+        else if (CC_PLIST_TAG_IS("string"))
+            token = Token::STRING;
+        else if (CC_PLIST_TAG_IS("integer"))
+            token = Token::INTEGER;
+        else if (CC_PLIST_TAG_IS("real"))
+            token = Token::REAL;
+        else if (CC_PLIST_TAG_IS("true"))
+            token = Token::TRUE_VALUE;
+        else if (CC_PLIST_TAG_IS("false"))
+            token = Token::FALSE_VALUE;
+        else if (CC_PLIST_TAG_IS("data"))
+            token = Token::DATA;
+        else if (CC_PLIST_TAG_IS("date"))
+            token = Token::DATE;
+        else
+            return fail();
+#undef CC_PLIST_TAG_IS
+
+        if (!readTextAfterOpening(tag, nameLength, isEmpty))
+            return fail();
+        _token = token;
+        return _token;
+    }
+}
+
+bool PlistReader::isText(const char* str, size_t length) const
+{
+    if (!_needsDecoding)
+        return _textLength == length && memcmp(_text, str, length) == 0;
+
+    std::string text;
+    decodeText(_text, _textLength, text);
+    return text.size() == length && memcmp(text.data(), str, length) == 0;
+}
+
+bool PlistReader::skipValue()
+{
+    switch (_token)
+    {
+    case Token::DICT_BEGIN:
+    case Token::ARRAY_BEGIN:
+    {
+        int depth = 1;
+        while (depth > 0)
+        {
+            switch (next())
+            {
+            case Token::DICT_BEGIN:
+            case Token::ARRAY_BEGIN:
+                ++depth;
+                break;
+            case Token::DICT_END:
+            case Token::ARRAY_END:
+                --depth;
+                break;
+            case Token::END:
+            case Token::INVALID:
+                fail();
+                return false;
+            default:
+                break;
+            }
+        }
+        return true;
+    }
+    case Token::STRING:
+    case Token::INTEGER:
+    case Token::REAL:
+    case Token::TRUE_VALUE:
+    case Token::FALSE_VALUE:
+    case Token::DATA:
+    case Token::DATE:
+        return true;
+    default:
+        fail();
+        return false;
+    }
+}
+
+bool PlistReader::readString(std::string& value)
+{
+    switch (_token)
+    {
+    case Token::KEY:
+    case Token::STRING:
+        if (_needsDecoding)
+            decodeText(_text, _textLength, value);
+        else
+            value.assign(_text, _textLength);
+        return true;
+    case Token::INTEGER:
+    case Token::REAL:
+        value.assign(_text, _textLength);
+        return true;
+    case Token::TRUE_VALUE:
+        value = "true";
+        return true;
+    case Token::FALSE_VALUE:
+        value = "false";
+        return true;
+    default:
+        return skipValue();
+    }
+}
+
+bool PlistReader::readInt(int& value)
+{
+    switch (_token)
+    {
+    case Token::STRING:
+    case Token::INTEGER:
+        value = static_cast<int>(parseLong(_text, _textLength));
+        return true;
+    case Token::REAL:
+        value = static_cast<int>(parseDouble(_text, _textLength));
+        return true;
+    case Token::TRUE_VALUE:
+    case Token::FALSE_VALUE:
+        value = _token == Token::TRUE_VALUE ? 1 : 0;
+        return true;
+    default:
+        return skipValue();
+    }
+}
+
+bool PlistReader::readFloat(float& value)
+{
+    double number = value;
+    if (!readDouble(number))
+        return false;
+    value = static_cast<float>(number);
+    return true;
+}
+
+bool PlistReader::readDouble(double& value)
+{
+    switch (_token)
+    {
+    case Token::STRING:
+    case Token::INTEGER:
+    case Token::REAL:
+        value = parseDouble(_text, _textLength);
+        return true;
+    case Token::TRUE_VALUE:
+    case Token::FALSE_VALUE:
+        value = _token == Token::TRUE_VALUE ? 1.0 : 0.0;
+        return true;
+    default:
+        return skipValue();
+    }
+}
+
+bool PlistReader::readBool(bool& value)
+{
+    switch (_token)
+    {
+    case Token::STRING:
+        // like Value::asBool
+        value = !isText("0") && !isText("false");
+        return true;
+    case Token::INTEGER:
+    case Token::REAL:
+        value = parseDouble(_text, _textLength) != 0.0;
+        return true;
+    case Token::TRUE_VALUE:
+    case Token::FALSE_VALUE:
+        value = _token == Token::TRUE_VALUE;
+        return true;
+    default:
+        return skipValue();
+    }
+}
+
+bool PlistReader::parseNumbers(float* numbers, int count) const
+{
+    const char* cursor = _text;
+    const char* end = _text + _textLength;
+    for (int i = 0; i < count; ++i)
+    {
+        while (cursor < end && (*cursor == '{' || *cursor == '}' || *cursor == ',' || isSpace(*cursor)))
+            ++cursor;
+        if (cursor >= end)
+            return false;
+
+        char* numberEnd = nullptr;
+        numbers[i] = static_cast<float>(strtod(cursor, &numberEnd));
+        if (numberEnd == cursor || numberEnd > end)
+            return false;
+        cursor = numberEnd;
+    }
+    return true;
+}
+
+bool PlistReader::readVec2(Vec2& value)
+{
+    if (_token != Token::STRING)
+        return skipValue();
+
+    float numbers[2];
+    value = parseNumbers(numbers, 2) ? Vec2(numbers[0], numbers[1]) : Vec2::ZERO;
+    return true;
+}
+
+bool PlistReader::readSize(Size& value)
+{
+    if (_token != Token::STRING)
+        return skipValue();
+
+    float numbers[2];
+    value = parseNumbers(numbers, 2) ? Size(numbers[0], numbers[1]) : Size::ZERO;
+    return true;
+}
+
+bool PlistReader::readRect(Rect& value)
+{
+    if (_token != Token::STRING)
+        return skipValue();
+
+    float numbers[4];
+    value = parseNumbers(numbers, 4) ? Rect(numbers[0], numbers[1], numbers[2], numbers[3]) : Rect::ZERO;
+    return true;
+}
+
+bool PlistReader::readIntegerList(std::vector<int>& value)
+{
+    if (_token != Token::STRING)
+        return skipValue();
+
+    value.clear();
+    const char* cursor = _text;
+    const char* end = _text + _textLength;
+    while (cursor < end)
+    {
+        char* numberEnd = nullptr;
+        long number = strtol(cursor, &numberEnd, 10);
+        if (numberEnd == cursor || numberEnd > end)
+            break;
+        value.push_back(static_cast<int>(number));
+        cursor = numberEnd;
+    }
+    return true;
+}
+
+bool PlistReader::readStringArray(std::vector<std::string>& value)
+{
+    if (_token != Token::ARRAY_BEGIN)
+        return skipValue();
+
+    value.clear();
+    while (next() != Token::ARRAY_END)
+    {
+        if (_token == Token::END || _token == Token::INVALID)
+            return false;
+
+        std::string element;
+        if (!readString(element))
+            return false;
+        if (_token == Token::STRING || _token == Token::INTEGER || _token == Token::REAL || _token == Token::TRUE_VALUE || _token == Token::FALSE_VALUE)
+            value.push_back(std::move(element));
+    }
+    return true;
+}
+
+bool PlistReader::readValue(Value& value)
+{
+    switch (_token)
+    {
+    case Token::DICT_BEGIN:
+    {
+        ValueMap map;
+        std::string key;
+        while (next() == Token::KEY)
+        {
+            readString(key);
+            next();
+            Value element;
+            if (!readValue(element))
+                return false;
+            // like the SAX parser, <data> and <date> values are dropped
+            if (!element.isNull())
+                map[key] = std::move(element);
+        }
+        if (_token != Token::DICT_END)
+        {
+            fail();
+            return false;
+        }
+        value = Value(std::move(map));
+        return true;
+    }
+    case Token::ARRAY_BEGIN:
+    {
+        ValueVector vector;
+        while (next() != Token::ARRAY_END)
+        {
+            Value element;
+            if (!readValue(element))
+                return false;
+            if (!element.isNull())
+                vector.push_back(std::move(element));
+        }
+        value = Value(std::move(vector));
+        return true;
+    }
+    case Token::STRING:
+    {
+        std::string str;
+        readString(str);
+        value = Value(std::move(str));
+        return true;
+    }
+    case Token::INTEGER:
+        value = Value(static_cast<int>(parseLong(_text, _textLength)));
+        return true;
+    case Token::REAL:
+        value = Value(parseDouble(_text, _textLength));
+        return true;
+    case Token::TRUE_VALUE:
+    case Token::FALSE_VALUE:
+        value = Value(_token == Token::TRUE_VALUE);
+        return true;
+    case Token::DATA:
+    case Token::DATE:
+        value = Value::Null;
+        return true;
+    default:
+        fail();
+        return false;
+    }
+}
+
+NS_CC_END
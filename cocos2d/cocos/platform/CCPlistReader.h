@@ -0,0 +1,251 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_PLIST_READER_H__
+#define __CC_PLIST_READER_H__
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCValue.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** Pull parser for XML property lists.
+ *
+ * The reader walks the buffer one element at a time and never copies it: the text of keys and values points into
+ * the buffer and is only converted when it is read, so stepping over the document doesn't allocate. The buffer
+ * must outlive the reader. Entities and line breaks are decoded like tinyxml2 does when a string is read.
+ *
+ * FileUtils builds its ValueMap on top of it, consumers that know the layout of their plist can fill their own
+ * structs with a PlistSchema instead and skip the ValueMap.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL PlistReader
+{
+public:
+    enum class Token
+    {
+        DICT_BEGIN,
+        DICT_END,
+        ARRAY_BEGIN,
+        ARRAY_END,
+        KEY,
+        STRING,
+        INTEGER,
+        REAL,
+        TRUE_VALUE,
+        FALSE_VALUE,
+        DATA,
+        DATE,
+        END,
+        INVALID,
+    };
+
+    PlistReader(const char* data, size_t size);
+
+    /** Moves to the next element. The <?xml?>, <!DOCTYPE> and <plist> elements and comments are skipped.
+     * @return Token::END at the end of the document and Token::INVALID, from then on, if the document is malformed.
+     */
+    Token next();
+
+    /** Element the reader is on. */
+    Token getToken() const { return _token; }
+
+    /** Raw text of a key or a value, as it is in the buffer. */
+    const char* getText() const { return _text; }
+    size_t getTextLength() const { return _textLength; }
+
+    /** Whether the text of the current key or value is a string, compares the decoded text. */
+    bool isText(const char* str, size_t length) const;
+    bool isText(const char* str) const { return isText(str, strlen(str)); }
+
+    /** Moves past the current value, including every element of a dictionary or an array.
+     * @return false if the document is malformed.
+     */
+    bool skipValue();
+
+    /** Reads the current value, then the reader is on its last element.
+     * Scalars are converted the way Value converts them, a value of another type is skipped and leaves the output
+     * unchanged.
+     * @return false if the document is malformed.
+     */
+    bool readString(std::string& value);
+    bool readInt(int& value);
+    bool readFloat(float& value);
+    bool readDouble(double& value);
+    bool readBool(bool& value);
+    /** Reads a string of the form "{x,y}", like PointFromString. */
+    bool readVec2(Vec2& value);
+    /** Reads a string of the form "{w,h}", like SizeFromString. */
+    bool readSize(Size& value);
+    /** Reads a string of the form "{{x,y},{w,h}}", like RectFromString. */
+    bool readRect(Rect& value);
+    /** Reads a string of integers separated by spaces, like utils::parseIntegerList. */
+    bool readIntegerList(std::vector<int>& value);
+    /** Reads an array of strings. */
+    bool readStringArray(std::vector<std::string>& value);
+
+    /** Reads the current value into a Value. <data> and <date> values are not supported and read as Value::Null.
+     * @return false if the document is malformed.
+     */
+    bool readValue(Value& value);
+
+private:
+    Token fail();
+    bool parseNumbers(float* numbers, int count) const;
+    bool readTextAfterOpening(const char* name, size_t nameLength, bool isEmpty);
+
+    const char* _cursor;
+    const char* _end;
+    Token _token;
+    const char* _text;
+    size_t _textLength;
+    bool _needsDecoding;
+    bool _isEmptyContainer;
+};
+
+/** Binds the keys of a plist dictionary to the fields of a struct, so the struct is filled straight from a
+ * PlistReader. Keys without a field are skipped. Build a schema once and keep it, for example in a function static.
+ *
+ * @code
+ * static const PlistSchema<Frame> schema = PlistSchema<Frame>()
+ *     .field("frame", &Frame::rect)
+ *     .field("rotated", &Frame::rotated);
+ * @endcode
+ * @js NA
+ * @lua NA
+ */
+template <typename T>
+class PlistSchema
+{
+public:
+    /** Reads the current value of the reader into the object. */
+    typedef std::function<bool(PlistReader& reader, T& object)> FieldReader;
+
+    PlistSchema& field(const char* key, FieldReader reader)
+    {
+        _fields.push_back(Field{key, strlen(key), std::move(reader)});
+        return *this;
+    }
+
+    PlistSchema& field(const char* key, std::string T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readString(object.*member); });
+    }
+
+    PlistSchema& field(const char* key, int T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readInt(object.*member); });
+    }
+
+    PlistSchema& field(const char* key, float T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readFloat(object.*member); });
+    }
+
+    PlistSchema& field(const char* key, bool T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readBool(object.*member); });
+    }
+
+    PlistSchema& field(const char* key, Vec2 T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readVec2(object.*member); });
+    }
+
+    PlistSchema& field(const char* key, Size T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readSize(object.*member); });
+    }
+
+    PlistSchema& field(const char* key, Rect T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readRect(object.*member); });
+    }
+
+    PlistSchema& field(const char* key, std::vector<int> T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readIntegerList(object.*member); });
+    }
+
+    PlistSchema& field(const char* key, std::vector<std::string> T::*member)
+    {
+        return field(key, [member](PlistReader& reader, T& object) { return reader.readStringArray(object.*member); });
+    }
+
+    /** Reads the dictionary the reader is on into the object, then the reader is on its end.
+     * @return false if the reader is not on a dictionary or the document is malformed.
+     */
+    bool read(PlistReader& reader, T& object) const
+    {
+        if (reader.getToken() != PlistReader::Token::DICT_BEGIN)
+            return false;
+
+        while (reader.next() == PlistReader::Token::KEY)
+        {
+            const Field* found = nullptr;
+            for (const auto& field : _fields)
+            {
+                if (reader.isText(field.key, field.keyLength))
+                {
+                    found = &field;
+                    break;
+                }
+            }
+
+            reader.next();
+            if (!(found ? found->reader(reader, object) : reader.skipValue()))
+                return false;
+        }
+        return reader.getToken() == PlistReader::Token::DICT_END;
+    }
+
+private:
+    struct Field
+    {
+        const char* key;
+        size_t keyLength;
+        FieldReader reader;
+    };
+
+    std::vector<Field> _fields;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_PLIST_READER_H__
@@ -25,6 +25,12 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "platform/CCThread.h"
+#include <new>
+#include "base/ccMacros.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+#include <windows.h>
+#endif
 
 NS_CC_BEGIN
 
@@ -44,4 +50,87 @@ void ThreadHelper::releaseAutoreleasePool(void* /*autoreleasePool*/)
 
 #endif
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+
+namespace
+{
+    // fiber local storage callbacks don't get the destructor, so it is kept with the value
+    struct ThreadLocalSlot
+    {
+        void* value;
+        ThreadLocalPointer::Destructor destructor;
+        DWORD key;
+    };
+
+    void WINAPI destroyThreadLocalSlot(void* data)
+    {
+        // like pthread keys, the value reads as nullptr in the destructor and can be set again
+        auto slot = static_cast<ThreadLocalSlot*>(data);
+        void* value = slot->value;
+        slot->value = nullptr;
+        FlsSetValue(slot->key, slot);
+        if (value && slot->destructor)
+            slot->destructor(value);
+        FlsSetValue(slot->key, nullptr);
+        delete slot;
+    }
+}
+
+ThreadLocalPointer::ThreadLocalPointer(Destructor destructor)
+: _destructor(destructor)
+{
+    _key = FlsAlloc(destroyThreadLocalSlot);
+    CCASSERT(_key != FLS_OUT_OF_INDEXES, "Out of thread local storage indexes!");
+}
+
+ThreadLocalPointer::~ThreadLocalPointer()
+{
+    FlsFree(_key);
+}
+
+void* ThreadLocalPointer::get() const
+{
+    auto slot = static_cast<ThreadLocalSlot*>(FlsGetValue(_key));
+    return slot ? slot->value : nullptr;
+}
+
+void ThreadLocalPointer::set(void* value)
+{
+    auto slot = static_cast<ThreadLocalSlot*>(FlsGetValue(_key));
+    if (!slot)
+    {
+        slot = new (std::nothrow) ThreadLocalSlot();
+        slot->destructor = _destructor;
+        slot->key = _key;
+        FlsSetValue(_key, slot);
+    }
+    slot->value = value;
+}
+
+#else
+
+ThreadLocalPointer::ThreadLocalPointer(Destructor destructor)
+{
+    int ret = pthread_key_create(&_key, destructor);
+    CCASSERT(ret == 0, "Out of thread local storage keys!");
+    (void)ret;
+}
+
+ThreadLocalPointer::~ThreadLocalPointer()
+{
+    pthread_key_delete(_key);
+}
+
+void* ThreadLocalPointer::get() const
+{
+    return pthread_getspecific(_key);
+}
+
+void ThreadLocalPointer::set(void* value)
+{
+    pthread_setspecific(_key, value);
+}
+
+#endif
+
 NS_CC_END
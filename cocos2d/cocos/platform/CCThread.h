@@ -30,6 +30,10 @@ THE SOFTWARE.
 
 #include "platform/CCPlatformMacros.h"
 
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <pthread.h>
+#endif
+
 NS_CC_BEGIN
 
 /**
@@ -58,6 +62,35 @@ public:
     static void releaseAutoreleasePool(void *autoreleasePool);
 };
 
+/* A pointer with a value for each thread, since thread_local isn't available on every
+ * supported platform (iOS 6). The destructor is called with the value a thread leaves
+ * when it exits, values left on the main thread are not destroyed. The value of the
+ * exiting thread reads as nullptr in the destructor until it is set again.
+ */
+class CC_DLL ThreadLocalPointer
+{
+public:
+    typedef void (*Destructor)(void* value);
+
+    explicit ThreadLocalPointer(Destructor destructor = nullptr);
+    ~ThreadLocalPointer();
+
+    /** Gets the value of the current thread, nullptr if it didn't set one. */
+    void* get() const;
+    /** Sets the value of the current thread. */
+    void set(void* value);
+
+private:
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    unsigned long _key;
+    Destructor _destructor;
+#else
+    pthread_key_t _key;
+#endif
+
+    CC_DISALLOW_COPY_AND_ASSIGN(ThreadLocalPointer);
+};
+
 // end of platform group
 /// @}
 
@@ -360,6 +360,10 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
 
     string fullPath = fullPathForFilename(filename);
 
+    FileUtils::Status status;
+    if (getContentsFromAssetPack(fullPath, buffer, &status))
+        return status;
+
     if (fullPath[0] == '/')
         return FileUtils::getContents(fullPath, buffer);
 
@@ -409,7 +409,11 @@ bool FileUtils::writeValueMapToFile(const ValueMap& dict, const std::string& ful
 
     NSString *file = [NSString stringWithUTF8String:fullPath.c_str()];
     // do it atomically
-    return [nsDict writeToFile:file atomically:YES];
+    if (![nsDict writeToFile:file atomically:YES])
+        return false;
+
+    clearMissingFileCache();
+    return true;
 }
 
 void FileUtilsApple::valueMapCompact(ValueMap& valueMap) const
@@ -476,6 +480,7 @@ bool FileUtils::writeValueVectorToFile(const ValueVector& vecData, const std::st
 
     [array writeToFile:path atomically:YES];
 
+    clearMissingFileCache();
     return true;
 }
 ValueVector FileUtilsApple::getValueVectorFromFile(const std::string& filename) const
@@ -180,6 +180,10 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    FileUtils::Status status;
+    if (getContentsFromAssetPack(fullPath, buffer, &status))
+        return status;
+
     HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
@@ -276,12 +280,19 @@ void FileUtilsWin32::listFilesRecursively(const std::string& dirPath, std::vecto
 
 long FileUtilsWin32::getFileSize(const std::string &filepath) const
 {
+    std::string entryPath;
+    if (auto pack = getAssetPackForPath(filepath, &entryPath))
+    {
+        const AssetPack::Entry* entry = pack->find(entryPath);
+        return entry ? (long)entry->size : -1;
+    }
+
     struct _stat tmp;
     if (_stat(filepath.c_str(), &tmp) == 0)
     {
         return (long)tmp.st_size;
     }
-    return 0;
+    return -1;
 }
 
 std::vector<std::string> FileUtilsWin32::listFiles(const std::string& dirPath) const
@@ -385,16 +396,10 @@ bool FileUtilsWin32::renameFile(const std::string &oldfullpath, const std::strin
     std::wstring _wNew = StringUtf8ToWideChar(newfullpath);
     std::wstring _wOld = StringUtf8ToWideChar(oldfullpath);
 
-    if (FileUtils::getInstance()->isFileExist(newfullpath))
-    {
-        if (!DeleteFile(_wNew.c_str()))
-        {
-            CCLOGERROR("Fail to delete file %s !Error code is 0x%x", newfullpath.c_str(), GetLastError());
-        }
-    }
-
-    if (MoveFile(_wOld.c_str(), _wNew.c_str()))
+    // replaces an existing file in one step, a reader never sees the new path missing
+    if (MoveFileExW(_wOld.c_str(), _wNew.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
     {
+        clearMissingFileCache();
         return true;
     }
     else
@@ -481,6 +486,7 @@ bool FileUtilsWin32::removeFile(const std::string &filepath) const
 
     if (DeleteFile(StringUtf8ToWideChar(win32path).c_str()))
     {
+        clearMissingFileCache();
         return true;
     }
     else
@@ -72,6 +72,8 @@ void GroupCommandManager::releaseGroupID(int groupID)
     _unusedIDs.push_back(groupID);
 }
 
+CC_DEFINE_ALLOCATOR_POOL(GroupCommand, 32);
+
 GroupCommand::GroupCommand()
 {
     _type = RenderCommand::Type::GROUP_COMMAND;
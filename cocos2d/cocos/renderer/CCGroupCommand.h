@@ -32,6 +32,7 @@
 
 #include "base/CCRef.h"
 #include "renderer/CCRenderCommand.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 /**
  * @addtogroup renderer
@@ -63,6 +64,8 @@ protected:
 class CC_DLL GroupCommand : public RenderCommand
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(GroupCommand);
+
     /**@{
      Constructor and Destructor.
      */
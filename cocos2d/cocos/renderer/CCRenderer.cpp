@@ -45,6 +45,7 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCFrameArena.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
 
@@ -61,6 +62,33 @@ static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
     return  a->getDepth() > b->getDepth();
 }
 
+// std::stable_sort gets its merge buffer from the heap on every call, this bottom up merge sort
+// takes it from the frame arena since the queues are sorted every frame
+template <typename Compare>
+static void stableSortCommands(std::vector<RenderCommand*>& commands, Compare compare)
+{
+    size_t count = commands.size();
+    if (count < 2 || std::is_sorted(commands.begin(), commands.end(), compare))
+        return;
+
+    FrameVector<RenderCommand*> buffer(count);
+    RenderCommand** from = commands.data();
+    RenderCommand** to = buffer.data();
+    for (size_t width = 1; width < count; width *= 2)
+    {
+        for (size_t begin = 0; begin < count; begin += 2 * width)
+        {
+            size_t middle = std::min(begin + width, count);
+            size_t end = std::min(begin + 2 * width, count);
+            std::merge(from + begin, from + middle, from + middle, from + end, to + begin, compare);
+        }
+        std::swap(from, to);
+    }
+
+    if (from != commands.data())
+        std::copy(from, from + count, commands.data());
+}
+
 // queue
 RenderQueue::RenderQueue()
 {
@@ -112,9 +140,9 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    stableSortCommands(_commands[QUEUE_GROUP::TRANSPARENT_3D], compare3DCommand);
+    stableSortCommands(_commands[QUEUE_GROUP::GLOBALZ_NEG], compareRenderCommand);
+    stableSortCommands(_commands[QUEUE_GROUP::GLOBALZ_POS], compareRenderCommand);
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -46,8 +46,10 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/ccPixelConvert.h"
 #include "renderer/CCGLProgramCache.h"
 #include "base/CCNinePatchImageParser.h"
+#include "base/etc2.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     #include "renderer/CCTextureCache.h"
@@ -108,6 +110,15 @@ namespace {
         PixelFormatInfoMapValue(Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA, Texture2D::PixelFormatInfo(GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD,
             0xFFFFFFFF, 0xFFFFFFFF, 8, true, false)),
 #endif
+        
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGB, Texture2D::PixelFormatInfo(CC_GL_COMPRESSED_RGB8_ETC2, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, false)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGBA, Texture2D::PixelFormatInfo(CC_GL_COMPRESSED_RGBA8_ETC2_EAC, 0xFFFFFFFF, 0xFFFFFFFF, 8, true, true)),
+        
+#ifdef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_4x4, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 8, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_6x6, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_6x6_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_8x8, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_8x8_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 2, true, true)),
+#endif
     };
 }
 
@@ -149,7 +160,9 @@ void Texture2D::convertAI88ToRGB888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0; i < dataLen; ++i)
+    ssize_t done = PixelConvert::convertI8ToRGBA8888(data, dataLen, outData);
+    outData += done * 4;
+    for (ssize_t i = done; i < dataLen; ++i)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -161,7 +174,9 @@ void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    ssize_t done = PixelConvert::convertAI88ToRGBA8888(data, dataLen, outData);
+    outData += done / 2 * 4;
+    for (ssize_t i = done, l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -249,8 +264,9 @@ void Texture2D::convertAI88ToRGB5A1(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> IIIIIIIIAAAAAAAA
 void Texture2D::convertI8ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0; i < dataLen; ++i)
+    ssize_t done = PixelConvert::convertI8ToAI88(data, dataLen, outData);
+    unsigned short* out16 = (unsigned short*)(outData + done * 2);
+    for (ssize_t i = done; i < dataLen; ++i)
     {
         *out16++ = 0xFF00     //A
         | data[i];            //I
@@ -260,7 +276,9 @@ void Texture2D::convertI8ToAI88(const unsigned char* data, ssize_t dataLen, unsi
 // IIIIIIIIAAAAAAAA -> AAAAAAAA
 void Texture2D::convertAI88ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 1; i < dataLen; i += 2)
+    ssize_t done = PixelConvert::convertAI88ToA8(data, dataLen, outData);
+    outData += done / 2;
+    for (ssize_t i = done + 1; i < dataLen; i += 2)
     {
         *outData++ = data[i]; //A
     }
@@ -269,7 +287,9 @@ void Texture2D::convertAI88ToA8(const unsigned char* data, ssize_t dataLen, unsi
 // IIIIIIIIAAAAAAAA -> IIIIIIII
 void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    ssize_t done = PixelConvert::convertAI88ToI8(data, dataLen, outData);
+    outData += done / 2;
+    for (ssize_t i = done, l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i]; //R
     }
@@ -278,7 +298,9 @@ void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsi
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t done = PixelConvert::convertRGB888ToRGBA8888(data, dataLen, outData);
+    outData += done / 3 * 4;
+    for (ssize_t i = done, l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -290,7 +312,9 @@ void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
 void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t done = PixelConvert::convertRGBA8888ToRGB888(data, dataLen, outData);
+    outData += done / 4 * 3;
+    for (ssize_t i = done, l = dataLen - 3; i < l; i += 4)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -301,8 +325,9 @@ void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t done = PixelConvert::convertRGB888ToRGB565(data, dataLen, outData);
+    unsigned short* out16 = (unsigned short*)(outData + done / 3 * 2);
+    for (ssize_t i = done, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -313,8 +338,9 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t done = PixelConvert::convertRGBA8888ToRGB565(data, dataLen, outData);
+    unsigned short* out16 = (unsigned short*)(outData + done / 4 * 2);
+    for (ssize_t i = done, l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -352,7 +378,9 @@ void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen,
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
 void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
+    ssize_t done = PixelConvert::convertRGBA8888ToA8(data, dataLen, outData);
+    outData += done / 4;
+    for (ssize_t i = done, l = dataLen -3; i < l; i += 4)
     {
         *outData++ = data[i + 3]; //A
     }
@@ -382,8 +410,9 @@ void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t done = PixelConvert::convertRGB888ToRGBA4444(data, dataLen, outData);
+    unsigned short* out16 = (unsigned short*)(outData + done / 3 * 2);
+    for (ssize_t i = done, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = ((data[i] & 0x00F0) << 8           //R
                     | (data[i + 1] & 0x00F0) << 4     //G
@@ -395,8 +424,9 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t done = PixelConvert::convertRGBA8888ToRGBA4444(data, dataLen, outData);
+    unsigned short* out16 = (unsigned short*)(outData + done / 4 * 2);
+    for (ssize_t i = done, l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F0) << 8    //R
         | (data[i + 1] & 0x00F0) << 4         //G
@@ -408,8 +438,9 @@ void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dat
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t done = PixelConvert::convertRGB888ToRGB5A1(data, dataLen, outData);
+    unsigned short* out16 = (unsigned short*)(outData + done / 3 * 2);
+    for (ssize_t i = done, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -421,8 +452,9 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+    ssize_t done = PixelConvert::convertRGBA8888ToRGB5A1(data, dataLen, outData);
+    unsigned short* out16 = (unsigned short*)(outData + done / 4 * 2);
+    for (ssize_t i = done, l = dataLen - 2; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -437,6 +469,7 @@ Texture2D::Texture2D()
 : _pixelFormat(Texture2D::PixelFormat::DEFAULT)
 , _pixelsWide(0)
 , _pixelsHigh(0)
+, _memorySize(0)
 , _name(0)
 , _maxS(0.0)
 , _maxT(0.0)
@@ -447,6 +480,7 @@ Texture2D::Texture2D()
 , _ninePatchInfo(nullptr)
 , _valid(true)
 , _alphaTexture(nullptr)
+, _lastUsedFrame(0)
 {
 }
 
@@ -493,6 +527,11 @@ int Texture2D::getPixelsHigh() const
     return _pixelsHigh;
 }
 
+size_t Texture2D::getMemorySize() const
+{
+    return _memorySize;
+}
+
 GLuint Texture2D::getName() const
 {
     return _name;
@@ -589,7 +628,9 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     if (info.compressed && !Configuration::getInstance()->supportsPVRTC()
                         && !Configuration::getInstance()->supportsETC()
                         && !Configuration::getInstance()->supportsS3TC()
-                        && !Configuration::getInstance()->supportsATITC())
+                        && !Configuration::getInstance()->supportsATITC()
+                        && !Configuration::getInstance()->supportsETC2()
+                        && !Configuration::getInstance()->supportsASTC())
     {
         CCLOG("cocos2d: WARNING: PVRTC/ETC images are not supported");
         return false;
@@ -665,11 +706,13 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     // Specify OpenGL texture image
     int width = pixelsWide;
     int height = pixelsHigh;
+    size_t memorySize = 0;
     
     for (int i = 0; i < mipmapsNum; ++i)
     {
         unsigned char *data = mipmaps[i].address;
         GLsizei datalen = mipmaps[i].len;
+        memorySize += datalen;
 
         if (info.compressed)
         {
@@ -699,6 +742,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     _contentSize = Size((float)pixelsWide, (float)pixelsHigh);
     _pixelsWide = pixelsWide;
     _pixelsHigh = pixelsHigh;
+    _memorySize = memorySize;
     _pixelFormat = pixelFormat;
     _maxS = 1;
     _maxT = 1;
@@ -1380,6 +1424,21 @@ const char* Texture2D::getStringForFormat() const
 
         case Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA:
             return "ATC_INTERPOLATED_ALPHA";
+
+        case Texture2D::PixelFormat::ETC2_RGB:
+            return "ETC2_RGB";
+
+        case Texture2D::PixelFormat::ETC2_RGBA:
+            return "ETC2_RGBA";
+
+        case Texture2D::PixelFormat::ASTC_4x4:
+            return "ASTC_4x4";
+
+        case Texture2D::PixelFormat::ASTC_6x6:
+            return "ASTC_6x6";
+
+        case Texture2D::PixelFormat::ASTC_8x8:
+            return "ASTC_8x8";
             
         default:
             CCASSERT(false , "unrecognized pixel format");
@@ -115,6 +115,16 @@ public:
         ATC_EXPLICIT_ALPHA,
         //! ATITC-compressed texture: ATC_INTERPOLATED_ALPHA
         ATC_INTERPOLATED_ALPHA,
+        //! ETC2-compressed texture: ETC2_RGB8
+        ETC2_RGB,
+        //! ETC2-compressed texture: ETC2_RGBA8_EAC
+        ETC2_RGBA,
+        //! ASTC-compressed texture: 4x4 blocks, 8 bits per pixel
+        ASTC_4x4,
+        //! ASTC-compressed texture: 6x6 blocks, 3.56 bits per pixel
+        ASTC_6x6,
+        //! ASTC-compressed texture: 8x8 blocks, 2 bits per pixel
+        ASTC_8x8,
         //! Default texture format: AUTO
         DEFAULT = AUTO,
         
@@ -386,6 +396,9 @@ public:
     /** Gets the height of the texture in pixels. */
     int getPixelsHigh() const;
     
+    /** Gets the size in bytes of the data uploaded for all the mipmap levels, compressed formats included. */
+    size_t getMemorySize() const;
+    
     /** Gets the texture name. */
     GLuint getName() const;
     
@@ -523,6 +536,9 @@ protected:
     /** height in pixels */
     int _pixelsHigh;
 
+    /** bytes uploaded for all the mipmap levels */
+    size_t _memorySize;
+
     /** texture name */
     GLuint _name;
 
@@ -548,6 +564,7 @@ protected:
 
     bool _antialiasEnabled;
     NinePatchInfo* _ninePatchInfo;
+    friend class Image;
     friend class SpriteFrameCache;
     friend class TextureCache;
     friend class ui::Scale9Sprite;
@@ -556,6 +573,9 @@ protected:
     std::string _filePath;
 
     Texture2D* _alphaTexture;
+
+    /** last frame the texture was used in, the TextureCache evicts the least recently used textures first */
+    unsigned int _lastUsedFrame;
 };
 
 
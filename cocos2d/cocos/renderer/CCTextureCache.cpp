@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -68,10 +70,17 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
+: _asyncWorkerCount(0)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _asyncUploadBytesPerFrame(0)
+, _asyncUploadSecondsPerFrame(0)
+, _memoryBudget(0)
+, _evictedCount(0)
+, _reloadedCount(0)
 {
+    setAsyncWorkerCount(0);
+    setMemoryBudget(CC_TEXTURE_CACHE_MEMORY_BUDGET);
 }
 
 TextureCache::~TextureCache()
@@ -81,7 +90,8 @@ TextureCache::~TextureCache()
     for (auto& texture : _textures)
         texture.second->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    for (auto thread : _loadingThreads)
+        delete thread;
 }
 
 void TextureCache::destroyInstance()
@@ -110,7 +120,9 @@ public:
       const std::string& key )
       : filename(fn), callback(f),callbackKey( key ),
         pixelFormat(Texture2D::getDefaultAlphaPixelFormat()),
-        loadSuccess(false)
+        priority(0),
+        loadSuccess(false),
+        cancelled(false)
     {}
 
     std::string filename;
@@ -119,14 +131,16 @@ public:
     Image image;
     Image imageAlpha;
     Texture2D::PixelFormat pixelFormat;
+    int priority;
     bool loadSuccess;
+    bool cancelled;
 };
 
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads)
+ - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture within the upload budget, then delete AsyncStruct (GL thread)
 
  the Critical Area include these members:
  - _requestQueue: locked by _requestMutex
@@ -134,10 +148,11 @@ public:
 
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in Load threads, delete in GL thread(by Image instance)
 
  Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - all AsyncStruct referenced in _asyncStructQueue, for unbind and cancel functions use.
+ - _requestQueue is sorted by priority, responses come in the order the Load threads finish.
 
  How to deal add image many times?
  - At first, this situation is abnormal, we only ensure the logic is correct.
@@ -146,8 +161,8 @@ public:
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
 
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - It does when many images finish at once, setAsyncUploadBudget spreads the
+ textures over several frames.
 
  Call unbindImageAsync(path) to prevent the call to the callback when the
  texture is loaded.
@@ -160,8 +175,8 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads)
+ - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture within the upload budget, then delete AsyncStruct (GL thread)
  
  the Critical Area include these members:
  - _requestQueue: locked by _requestMutex
@@ -169,10 +184,11 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in Load threads, delete in GL thread(by Image instance)
  
  Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - all AsyncStruct referenced in _asyncStructQueue, for unbind and cancel functions use.
+ - _requestQueue is sorted by priority, responses come in the order the Load threads finish.
  
  How to deal add image many times?
  - At first, this situation is abnormal, we only ensure the logic is correct.
@@ -181,8 +197,8 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
  
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - It does when many images finish at once, setAsyncUploadBudget spreads the
+ textures over several frames.
 
  The callbackKey allows to unbind the callback in cases where the loading of
  path is requested by several sources simultaneously. Each source can then
@@ -190,6 +206,11 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  unbindImageAsync(path) would be ambiguous.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey)
+{
+    addImageAsync(path, callback, callbackKey, 0);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -201,6 +222,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     if (texture != nullptr)
     {
+        markTextureUsed(texture);
         if (callback) callback(texture);
         return;
     }
@@ -212,12 +234,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     }
 
     // lazy init
-    if (_loadingThread == nullptr)
-    {
-        // create a new thread to load images
-        _needQuit = false;
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
-    }
+    startLoadingThreads();
 
     if (0 == _asyncRefCount)
     {
@@ -229,14 +246,116 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     // generate async struct
     AsyncStruct *data =
       new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey);
+    data->priority = priority;
     
-    // add async struct into queue
+    // add async struct into queue, after the requests of the same or a higher priority
     _asyncStructQueue.push_back(data);
     std::unique_lock<std::mutex> ul(_requestMutex);
-    _requestQueue.push_back(data);
+    auto position = std::find_if(_requestQueue.begin(), _requestQueue.end(), [priority](AsyncStruct* request) {
+        return request->priority < priority;
+    });
+    _requestQueue.insert(position, data);
     _sleepCondition.notify_one();
 }
 
+void TextureCache::cancelImageAsync(const std::string& callbackKey)
+{
+    // the requests being decoded are only marked, they are released in addImageAsyncCallBack
+    for (auto& asyncStruct : _asyncStructQueue)
+    {
+        if (asyncStruct->callbackKey == callbackKey)
+        {
+            asyncStruct->callback = nullptr;
+            asyncStruct->cancelled = true;
+        }
+    }
+
+    std::vector<AsyncStruct*> pending;
+    _requestMutex.lock();
+    for (auto it = _requestQueue.begin(); it != _requestQueue.end();)
+    {
+        if ((*it)->callbackKey == callbackKey)
+        {
+            pending.push_back(*it);
+            it = _requestQueue.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    _requestMutex.unlock();
+
+    for (auto asyncStruct : pending)
+    {
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+        delete asyncStruct;
+        --_asyncRefCount;
+    }
+
+    if (!pending.empty() && 0 == _asyncRefCount)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+    }
+}
+
+void TextureCache::setAsyncWorkerCount(unsigned int count)
+{
+    if (0 == count)
+        count = CC_TEXTURE_CACHE_ASYNC_WORKERS;
+    if (0 == count)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        count = cores > 1 ? std::min(4u, cores - 1) : 1;
+    }
+
+    if (count == _asyncWorkerCount)
+        return;
+    _asyncWorkerCount = count;
+
+    // restart the threads with the new count, if any
+    if (!_loadingThreads.empty())
+    {
+        stopLoadingThreads();
+        startLoadingThreads();
+    }
+}
+
+void TextureCache::setAsyncUploadBudget(size_t bytesPerFrame, float secondsPerFrame)
+{
+    _asyncUploadBytesPerFrame = bytesPerFrame;
+    _asyncUploadSecondsPerFrame = secondsPerFrame;
+}
+
+void TextureCache::startLoadingThreads()
+{
+    if (!_loadingThreads.empty())
+        return;
+
+    // create the threads to load images
+    _needQuit = false;
+    for (unsigned int i = 0; i < _asyncWorkerCount; ++i)
+    {
+        _loadingThreads.push_back(new (std::nothrow) std::thread(&TextureCache::loadImage, this));
+    }
+}
+
+void TextureCache::stopLoadingThreads()
+{
+    // notify sub threads to quit, the requests they haven't taken stay in the queue
+    std::unique_lock<std::mutex> ul(_requestMutex);
+    _needQuit = true;
+    _sleepCondition.notify_all();
+    ul.unlock();
+
+    for (auto thread : _loadingThreads)
+    {
+        thread->join();
+        delete thread;
+    }
+    _loadingThreads.clear();
+}
+
 void TextureCache::unbindImageAsync(const std::string& callbackKey)
 {
     if (_asyncStructQueue.empty())
@@ -269,9 +388,13 @@ void TextureCache::unbindAllImageAsync()
 void TextureCache::loadImage()
 {
     AsyncStruct *asyncStruct = nullptr;
-    while (!_needQuit)
+    while (true)
     {
         std::unique_lock<std::mutex> ul(_requestMutex);
+        if (_needQuit) {
+            break;
+        }
+
         // pop an AsyncStruct from request queue
         if (_requestQueue.empty())
         {
@@ -284,9 +407,6 @@ void TextureCache::loadImage()
         }
 
         if (nullptr == asyncStruct) {
-            if (_needQuit) {
-                break;
-            }
             _sleepCondition.wait(ul);
             continue;
         }
@@ -295,6 +415,10 @@ void TextureCache::loadImage()
         // load image
         asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
 
+        // convert the pixels here so the main thread only uploads them, nine patch images are parsed as RGBA8888
+        if (asyncStruct->loadSuccess && !NinePatchImageParser::isNinePatchImage(asyncStruct->filename))
+            asyncStruct->image.convertToFormat(asyncStruct->pixelFormat);
+
         // ETC1 ALPHA supports.
         if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
         { // check whether alpha texture exists & load it
@@ -313,8 +437,21 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
+    auto uploadStart = std::chrono::steady_clock::now();
+    size_t uploadedBytes = 0;
+    bool uploaded = false;
     while (true)
     {
+        // the textures over the budget of this frame are created in the next ones
+        if (uploaded)
+        {
+            if (_asyncUploadBytesPerFrame > 0 && uploadedBytes >= _asyncUploadBytesPerFrame)
+                break;
+            if (_asyncUploadSecondsPerFrame > 0
+                && std::chrono::duration<float>(std::chrono::steady_clock::now() - uploadStart).count() >= _asyncUploadSecondsPerFrame)
+                break;
+        }
+
         // pop an AsyncStruct from response queue
         _responseMutex.lock();
         if (_responseQueue.empty())
@@ -325,10 +462,6 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         {
             asyncStruct = _responseQueue.front();
             _responseQueue.pop_front();
-
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
         }
         _responseMutex.unlock();
 
@@ -336,17 +469,28 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             break;
         }
 
+        // the Load threads finish in any order
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
-        if (it != _textures.end())
+        if (asyncStruct->cancelled)
+        {
+            texture = nullptr;
+        }
+        else if (it != _textures.end())
         {
             texture = it->second;
+            markTextureUsed(texture);
         }
         else
         {
             // convert image to texture
             if (asyncStruct->loadSuccess)
             {
+                uploaded = true;
+                uploadedBytes += (size_t)(asyncStruct->image.getDataLen() + asyncStruct->imageAlpha.getDataLen());
+
                 Image* image = &(asyncStruct->image);
                 // generate texture in render thread
                 texture = new (std::nothrow) Texture2D();
@@ -359,7 +503,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                 VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
 #endif
                 // cache the texture. retain it, since it is added in the map
-                _textures.emplace(asyncStruct->filename, texture);
+                addTextureToCache(asyncStruct->filename, texture);
                 texture->retain();
 
                 texture->autorelease();
@@ -410,7 +554,10 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if (it != _textures.end())
+    {
         texture = it->second;
+        markTextureUsed(texture);
+    }
 
     if (!texture)
     {
@@ -432,7 +579,7 @@ Texture2D * TextureCache::addImage(const std::string &path)
                 VolatileTextureMgr::addImageTexture(texture, fullpath);
 #endif
                 // texture already retained, no need to re-retain it
-                _textures.emplace(fullpath, texture);
+                addTextureToCache(fullpath, texture);
 
                 //-- ANDROID ETC1 ALPHA SUPPORTS.
                 std::string alphaFullPath = path + s_etc1AlphaFileSuffix;
@@ -489,6 +636,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if (it != _textures.end()) {
             texture = it->second;
+            markTextureUsed(texture);
             break;
         }
 
@@ -498,7 +646,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         {
             if (texture->initWithImage(image))
             {
-                _textures.emplace(key, texture);
+                addTextureToCache(key, texture);
             }
             else
             {
@@ -632,7 +780,10 @@ Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) con
     }
 
     if (it != _textures.end())
+    {
+        markTextureUsed(it->second);
         return it->second;
+    }
     return nullptr;
 }
 
@@ -659,12 +810,111 @@ std::string TextureCache::getTextureFilePath(cocos2d::Texture2D* texture) const
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    std::unique_lock<std::mutex> ul(_requestMutex);
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    ul.unlock();
-    if (_loadingThread) _loadingThread->join();
+    stopLoadingThreads();
+
+    if (_memoryBudget > 0)
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::updateMemoryBudget), this);
+}
+
+void TextureCache::addTextureToCache(const std::string& key, Texture2D* texture)
+{
+    _textures.emplace(key, texture);
+    markTextureUsed(texture);
+
+    if (!_evictedKeys.empty() && _evictedKeys.erase(key) > 0)
+        ++_reloadedCount;
+}
+
+void TextureCache::markTextureUsed(Texture2D* texture) const
+{
+    texture->_lastUsedFrame = Director::getInstance()->getTotalFrames();
+}
+
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    if (bytes == _memoryBudget)
+        return;
+
+    // the textures in use are marked and the budget enforced once per frame
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (0 == _memoryBudget)
+        scheduler->schedule(CC_SCHEDULE_SELECTOR(TextureCache::updateMemoryBudget), this, 0, false);
+    else if (0 == bytes)
+        scheduler->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::updateMemoryBudget), this);
+
+    _memoryBudget = bytes;
+}
+
+size_t TextureCache::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (auto& item : _textures)
+    {
+        Texture2D* texture = item.second;
+        bytes += texture->getMemorySize();
+        if (texture->getAlphaTexture())
+            bytes += texture->getAlphaTexture()->getMemorySize();
+    }
+    return bytes;
+}
+
+void TextureCache::updateMemoryBudget(float /*dt*/)
+{
+    evictUnusedTextures(_memoryBudget);
+}
+
+int TextureCache::evictUnusedTextures(size_t maxBytes)
+{
+    typedef std::unordered_map<std::string, Texture2D*>::iterator TextureIterator;
+
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+    size_t bytes = 0;
+    std::vector<TextureIterator> candidates;
+
+    for (auto it = _textures.begin(); it != _textures.end(); ++it)
+    {
+        Texture2D* texture = it->second;
+        size_t textureBytes = texture->getMemorySize();
+        if (texture->getAlphaTexture())
+            textureBytes += texture->getAlphaTexture()->getMemorySize();
+        bytes += textureBytes;
+
+        // a texture retained by anyone else is in use, only the ones loaded from their file can be loaded again
+        if (texture->getReferenceCount() > 1)
+            texture->_lastUsedFrame = frame;
+        else if (texture->_lastUsedFrame != frame && texture->_filePath == it->first)
+            candidates.push_back(it);
+    }
+
+    if (bytes <= maxBytes || candidates.empty())
+        return 0;
+
+    std::sort(candidates.begin(), candidates.end(), [](const TextureIterator& a, const TextureIterator& b) {
+        return a->second->_lastUsedFrame < b->second->_lastUsedFrame;
+    });
+
+    int evicted = 0;
+    for (auto& it : candidates)
+    {
+        if (bytes <= maxBytes)
+            break;
+
+        Texture2D* texture = it->second;
+        size_t textureBytes = texture->getMemorySize();
+        if (texture->getAlphaTexture())
+            textureBytes += texture->getAlphaTexture()->getMemorySize();
+        bytes -= textureBytes;
+
+        CCLOG("cocos2d: TextureCache: evicting texture: %s, unused for %u frames", it->first.c_str(), frame - texture->_lastUsedFrame);
+
+        _evictedKeys.insert(it->first);
+        texture->release();
+        _textures.erase(it);
+        ++evicted;
+    }
+
+    _evictedCount += evicted;
+    return evicted;
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -673,7 +923,8 @@ std::string TextureCache::getCachedTextureInfo() const
     char buftmp[4096];
 
     unsigned int count = 0;
-    unsigned int totalBytes = 0;
+    size_t totalBytes = 0;
+    unsigned int frame = Director::getInstance()->getTotalFrames();
 
     for (auto& texture : _textures) {
 
@@ -682,18 +933,23 @@ std::string TextureCache::getCachedTextureInfo() const
 
         Texture2D* tex = texture.second;
         unsigned int bpp = tex->getBitsPerPixelForFormat();
-        // Each texture takes up width * height * bytesPerPixel bytes.
-        auto bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
+        // the uploaded size, it covers the mipmap levels and the block sizes of compressed formats
+        size_t bytes = tex->getMemorySize();
+        if (tex->getAlphaTexture())
+            bytes += tex->getAlphaTexture()->getMemorySize();
         totalBytes += bytes;
         count++;
-        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB\n",
+        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp%s%s => %lu KB, used %u frames ago\n",
             texture.first.c_str(),
             (long)tex->getReferenceCount(),
             (long)tex->getName(),
             (long)tex->getPixelsWide(),
             (long)tex->getPixelsHigh(),
             (long)bpp,
-            (long)bytes / 1024);
+            tex->hasMipmaps() ? " mipmaps" : "",
+            tex->getAlphaTexture() ? " +alpha" : "",
+            (long)bytes / 1024,
+            frame - tex->_lastUsedFrame);
 
         buffer += buftmp;
     }
@@ -701,6 +957,13 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_memoryBudget > 0)
+    {
+        snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache budget: %lu KB (%.2f MB), %u textures evicted, %u loaded again\n",
+            (long)_memoryBudget / 1024, _memoryBudget / (1024.0f*1024.0f), _evictedCount, _reloadedCount);
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
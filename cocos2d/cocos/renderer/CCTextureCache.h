@@ -35,7 +35,9 @@ THE SOFTWARE.
 #include <queue>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
@@ -127,6 +129,45 @@ public:
     
     void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey );
 
+    /** Loads a texture asynchronously like addImageAsync, with a priority.
+     * Pending requests with a higher priority are decoded first, requests of the same priority in order.
+     * Requests are decoded by several threads, so callbacks may be called in another order than the requests.
+     * @param path The file path.
+     * @param callback A callback function would be invoked after the image is loaded.
+     * @param callbackKey The key used to unbind or cancel the request.
+     * @param priority The priority of the request, 0 for the other overloads.
+     */
+    void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, int priority);
+
+    /** Cancels the asynchronous loads bound to a key.
+     * Requests which aren't being decoded yet are dropped, the others are decoded but neither turned into a texture
+     * nor passed to their callback.
+     * @param callbackKey The key of the requests, the file path if they were added without a key.
+     */
+    void cancelImageAsync(const std::string &callbackKey);
+
+    /** Sets the number of threads decoding the images of the asynchronous loads.
+     * Running threads finish the image they are decoding and are replaced, pending requests are kept.
+     * @param count The number of threads, 0 to use CC_TEXTURE_CACHE_ASYNC_WORKERS.
+     */
+    void setAsyncWorkerCount(unsigned int count);
+
+    /** Gets the number of threads decoding the images of the asynchronous loads. */
+    unsigned int getAsyncWorkerCount() const { return _asyncWorkerCount; }
+
+    /** Limits the work done per frame to turn decoded images into textures.
+     * The textures over the budget are created in the next frames, at least one texture is created per frame.
+     * @param bytesPerFrame The size of the image data uploaded per frame, 0 for no limit.
+     * @param secondsPerFrame The time spent creating textures per frame, 0 for no limit.
+     */
+    void setAsyncUploadBudget(size_t bytesPerFrame, float secondsPerFrame);
+
+    /** Gets the size of the image data uploaded per frame by the asynchronous loads, 0 for no limit. */
+    size_t getAsyncUploadBytesPerFrame() const { return _asyncUploadBytesPerFrame; }
+
+    /** Gets the time spent per frame creating the textures of the asynchronous loads, 0 for no limit. */
+    float getAsyncUploadSecondsPerFrame() const { return _asyncUploadSecondsPerFrame; }
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
@@ -189,6 +230,28 @@ public:
     */
     void removeTextureForKey(const std::string &key);
 
+    /** Sets the memory the cached textures may take.
+    * Once per frame, while the textures take more than the budget, the textures only retained by the cache are
+    * removed, least recently used first. Textures used by a node or a sprite frame are never evicted, and an evicted
+    * texture is loaded again by the next addImage or addImageAsync of its file.
+    * @param bytes The budget in bytes, 0 for no limit.
+    * @since v3.17
+    */
+    void setMemoryBudget(size_t bytes);
+
+    /** Gets the memory the cached textures may take, 0 for no limit. */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Gets the memory taken by the cached textures, as uploaded, alpha textures included. */
+    size_t getMemoryUsage() const;
+
+    /** Removes the textures only retained by the cache, least recently used first, until the cached textures take
+    * at most a number of bytes. Textures used in the current frame are kept.
+    * @param maxBytes The memory the cached textures may take after the eviction.
+    * @return The number of textures removed.
+    */
+    int evictUnusedTextures(size_t maxBytes);
+
     /** Output to CCLOG the current contents of this TextureCache.
     * This will attempt to calculate the size of each texture, and the total texture memory in use.
     *
@@ -223,12 +286,18 @@ public:
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
+    void startLoadingThreads();
+    void stopLoadingThreads();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    void updateMemoryBudget(float dt);
+    void markTextureUsed(Texture2D* texture) const;
+    void addTextureToCache(const std::string& key, Texture2D* texture);
 public:
 protected:
     struct AsyncStruct;
     
-    std::thread* _loadingThread;
+    std::vector<std::thread*> _loadingThreads;
+    unsigned int _asyncWorkerCount;
 
     std::deque<AsyncStruct*> _asyncStructQueue;
     std::deque<AsyncStruct*> _requestQueue;
@@ -243,8 +312,17 @@ protected:
 
     int _asyncRefCount;
 
+    size_t _asyncUploadBytesPerFrame;
+    float _asyncUploadSecondsPerFrame;
+
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    size_t _memoryBudget;
+    // keys of the evicted textures, to count the ones loaded again
+    std::unordered_set<std::string> _evictedKeys;
+    unsigned int _evictedCount;
+    unsigned int _reloadedCount;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
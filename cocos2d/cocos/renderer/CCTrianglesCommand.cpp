@@ -33,6 +33,8 @@
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(TrianglesCommand, 32);
+
 TrianglesCommand::TrianglesCommand()
 :_materialID(0)
 ,_textureID(0)
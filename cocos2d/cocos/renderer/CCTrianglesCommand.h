@@ -28,6 +28,7 @@
 
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgramState.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 /**
  * @addtogroup renderer
@@ -43,6 +44,8 @@ NS_CC_BEGIN
 class CC_DLL TrianglesCommand : public RenderCommand
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(TrianglesCommand);
+
     /**The structure of Triangles. */
     struct Triangles
     {
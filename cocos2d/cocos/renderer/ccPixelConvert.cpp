@@ -0,0 +1,767 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/ccPixelConvert.h"
+
+#include <atomic>
+#include <cstring>
+
+//#define INCLUDE_SSE2      : SSE2 kernels included, always usable
+//#define INCLUDE_AVX2      : AVX2 kernels included, used when the cpu supports them
+//#define INCLUDE_NEON      : NEON kernels included, always usable
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INCLUDE_SSE2
+    #if defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+    #define INCLUDE_AVX2
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define INCLUDE_NEON
+#endif
+
+#ifdef INCLUDE_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef INCLUDE_AVX2
+#include <immintrin.h>
+    #ifdef _MSC_VER
+    #include <intrin.h>
+    #define TARGET_AVX2
+    #else
+    #include <cpuid.h>
+    #define TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+#ifdef INCLUDE_NEON
+#include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace PixelConvert {
+
+typedef ssize_t (*ConvertKernel)(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+typedef ssize_t (*PremultiplyKernel)(unsigned char* data, ssize_t dataLen);
+
+namespace {
+
+struct KernelTable
+{
+    ConvertKernel i8ToRGBA8888;
+    ConvertKernel i8ToAI88;
+    ConvertKernel ai88ToRGBA8888;
+    ConvertKernel ai88ToA8;
+    ConvertKernel ai88ToI8;
+    ConvertKernel rgb888ToRGBA8888;
+    ConvertKernel rgb888ToRGB565;
+    ConvertKernel rgb888ToRGBA4444;
+    ConvertKernel rgb888ToRGB5A1;
+    ConvertKernel rgba8888ToRGB888;
+    ConvertKernel rgba8888ToRGB565;
+    ConvertKernel rgba8888ToA8;
+    ConvertKernel rgba8888ToRGBA4444;
+    ConvertKernel rgba8888ToRGB5A1;
+    PremultiplyKernel premultiplyAlpha;
+};
+
+const KernelTable s_scalarKernels = {};
+
+#ifdef INCLUDE_SSE2
+
+namespace sse2 {
+
+// 32 bit lanes holding values up to 0xFFFF -> 16 bit lanes, packs_epi32 saturates signed values
+inline __m128i pack32To16(__m128i lo, __m128i hi)
+{
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    return _mm_packs_epi32(lo, hi);
+}
+
+// a pixel is the little endian word AAAAAAAABBBBBBBBGGGGGGGGRRRRRRRR
+inline __m128i packRGBA4444(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF0)), 8);
+    __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF000)), 4);
+    __m128i b = _mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0xF0));
+    __m128i a = _mm_srli_epi32(p, 28);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+inline __m128i packRGB565(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+    __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xFC00)), 5);
+    __m128i b = _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x1F));
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+inline __m128i packRGB5A1(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+    __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 5);
+    __m128i b = _mm_and_si128(_mm_srli_epi32(p, 18), _mm_set1_epi32(0x3E));
+    __m128i a = _mm_srli_epi32(p, 31);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+template <__m128i (*PACK)(__m128i)>
+ssize_t convertRGBA8888To16(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        __m128i lo = PACK(_mm_loadu_si128((const __m128i*)(data + i)));
+        __m128i hi = PACK(_mm_loadu_si128((const __m128i*)(data + i + 16)));
+        _mm_storeu_si128((__m128i*)(outData + i / 2), pack32To16(lo, hi));
+    }
+    return i;
+}
+
+ssize_t convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i iiLo = _mm_unpacklo_epi8(v, v);
+        __m128i iiHi = _mm_unpackhi_epi8(v, v);
+        __m128i iaLo = _mm_unpacklo_epi8(v, alpha);
+        __m128i iaHi = _mm_unpackhi_epi8(v, alpha);
+        __m128i* out = (__m128i*)(outData + i * 4);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(iiLo, iaLo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(iiLo, iaLo));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(iiHi, iaHi));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(iiHi, iaHi));
+    }
+    return i;
+}
+
+ssize_t convertI8ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i* out = (__m128i*)(outData + i * 2);
+        _mm_storeu_si128(out, _mm_unpacklo_epi8(v, alpha));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(v, alpha));
+    }
+    return i;
+}
+
+ssize_t convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    const __m128i intensityMask = _mm_set1_epi16(0x00FF);
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        __m128i ia = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i ii = _mm_and_si128(ia, intensityMask);
+        ii = _mm_or_si128(ii, _mm_slli_epi16(ii, 8));
+        __m128i* out = (__m128i*)(outData + i * 2);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(ii, ia));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(ii, ia));
+    }
+    return i;
+}
+
+ssize_t convertAI88ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        __m128i lo = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(data + i)), 8);
+        __m128i hi = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(data + i + 16)), 8);
+        _mm_storeu_si128((__m128i*)(outData + i / 2), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+ssize_t convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    const __m128i intensityMask = _mm_set1_epi16(0x00FF);
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        __m128i lo = _mm_and_si128(_mm_loadu_si128((const __m128i*)(data + i)), intensityMask);
+        __m128i hi = _mm_and_si128(_mm_loadu_si128((const __m128i*)(data + i + 16)), intensityMask);
+        _mm_storeu_si128((__m128i*)(outData + i / 2), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+ssize_t convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 64 <= dataLen; i += 64)
+    {
+        const __m128i* in = (const __m128i*)(data + i);
+        __m128i a0 = _mm_srli_epi32(_mm_loadu_si128(in), 24);
+        __m128i a1 = _mm_srli_epi32(_mm_loadu_si128(in + 1), 24);
+        __m128i a2 = _mm_srli_epi32(_mm_loadu_si128(in + 2), 24);
+        __m128i a3 = _mm_srli_epi32(_mm_loadu_si128(in + 3), 24);
+        __m128i a = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+        _mm_storeu_si128((__m128i*)(outData + i / 4), a);
+    }
+    return i;
+}
+
+// c * (a + 1) >> 8 for the color channels, the alpha channel is multiplied by 256 to keep it
+inline __m128i premultiply(__m128i rgba16)
+{
+    const __m128i colorMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alphaFactor = _mm_set_epi16(256, 0, 0, 0, 256, 0, 0, 0);
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(rgba16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i factor = _mm_or_si128(_mm_and_si128(_mm_add_epi16(alpha, _mm_set1_epi16(1)), colorMask), alphaFactor);
+    return _mm_srli_epi16(_mm_mullo_epi16(rgba16, factor), 8);
+}
+
+ssize_t premultiplyAlpha(unsigned char* data, ssize_t dataLen)
+{
+    const __m128i zero = _mm_setzero_si128();
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        __m128i* p = (__m128i*)(data + i);
+        __m128i v = _mm_loadu_si128(p);
+        __m128i lo = premultiply(_mm_unpacklo_epi8(v, zero));
+        __m128i hi = premultiply(_mm_unpackhi_epi8(v, zero));
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+} // namespace sse2
+
+const KernelTable s_sse2Kernels = {
+    sse2::convertI8ToRGBA8888,
+    sse2::convertI8ToAI88,
+    sse2::convertAI88ToRGBA8888,
+    sse2::convertAI88ToA8,
+    sse2::convertAI88ToI8,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    sse2::convertRGBA8888To16<sse2::packRGB565>,
+    sse2::convertRGBA8888ToA8,
+    sse2::convertRGBA8888To16<sse2::packRGBA4444>,
+    sse2::convertRGBA8888To16<sse2::packRGB5A1>,
+    sse2::premultiplyAlpha,
+};
+
+#endif // INCLUDE_SSE2
+
+#ifdef INCLUDE_AVX2
+
+namespace avx2 {
+
+// The RGB888 kernels only need the SSSE3 byte shuffle, they are compiled for AVX2 because every
+// AVX2 cpu has it and that keeps a single runtime check.
+
+TARGET_AVX2 inline __m128i expandRGB888(const unsigned char* data)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    return _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data), shuffle), alpha);
+}
+
+TARGET_AVX2 ssize_t convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    // every step reads 16 bytes and converts 12 of them
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 12)
+    {
+        _mm_storeu_si128((__m128i*)(outData + i / 3 * 4), expandRGB888(data + i));
+    }
+    return i;
+}
+
+template <__m128i (*PACK)(__m128i)>
+TARGET_AVX2 ssize_t convertRGB888To16(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 28 <= dataLen; i += 24)
+    {
+        __m128i lo = PACK(expandRGB888(data + i));
+        __m128i hi = PACK(expandRGB888(data + i + 12));
+        _mm_storeu_si128((__m128i*)(outData + i / 3 * 2), sse2::pack32To16(lo, hi));
+    }
+    return i;
+}
+
+TARGET_AVX2 ssize_t convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        __m128i rgb = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i)), shuffle);
+        unsigned char* out = outData + i / 4 * 3;
+        _mm_storel_epi64((__m128i*)out, rgb);
+        int last = _mm_cvtsi128_si32(_mm_srli_si128(rgb, 8));
+        memcpy(out + 8, &last, 4);
+    }
+    return i;
+}
+
+TARGET_AVX2 inline __m256i pack32To16(__m256i lo, __m256i hi)
+{
+    lo = _mm256_srai_epi32(_mm256_slli_epi32(lo, 16), 16);
+    hi = _mm256_srai_epi32(_mm256_slli_epi32(hi, 16), 16);
+    // packs works per 128 bit lane, put the quarters back in order
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+TARGET_AVX2 inline __m256i packRGBA4444(__m256i p)
+{
+    __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF0)), 8);
+    __m256i g = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF000)), 4);
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 16), _mm256_set1_epi32(0xF0));
+    __m256i a = _mm256_srli_epi32(p, 28);
+    return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+}
+
+TARGET_AVX2 inline __m256i packRGB565(__m256i p)
+{
+    __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF8)), 8);
+    __m256i g = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xFC00)), 5);
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 19), _mm256_set1_epi32(0x1F));
+    return _mm256_or_si256(_mm256_or_si256(r, g), b);
+}
+
+TARGET_AVX2 inline __m256i packRGB5A1(__m256i p)
+{
+    __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF8)), 8);
+    __m256i g = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF800)), 5);
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 18), _mm256_set1_epi32(0x3E));
+    __m256i a = _mm256_srli_epi32(p, 31);
+    return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+}
+
+template <__m256i (*PACK)(__m256i)>
+TARGET_AVX2 ssize_t convertRGBA8888To16(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 64 <= dataLen; i += 64)
+    {
+        __m256i lo = PACK(_mm256_loadu_si256((const __m256i*)(data + i)));
+        __m256i hi = PACK(_mm256_loadu_si256((const __m256i*)(data + i + 32)));
+        _mm256_storeu_si256((__m256i*)(outData + i / 2), pack32To16(lo, hi));
+    }
+    return i;
+}
+
+TARGET_AVX2 inline __m256i premultiply(__m256i rgba16)
+{
+    const __m256i colorMask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+    const __m256i alphaFactor = _mm256_set_epi16(256, 0, 0, 0, 256, 0, 0, 0, 256, 0, 0, 0, 256, 0, 0, 0);
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(rgba16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i factor = _mm256_or_si256(_mm256_and_si256(_mm256_add_epi16(alpha, _mm256_set1_epi16(1)), colorMask), alphaFactor);
+    return _mm256_srli_epi16(_mm256_mullo_epi16(rgba16, factor), 8);
+}
+
+TARGET_AVX2 ssize_t premultiplyAlpha(unsigned char* data, ssize_t dataLen)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        // unpack and pack both work per 128 bit lane, so the pixel order survives the round trip
+        __m256i* p = (__m256i*)(data + i);
+        __m256i v = _mm256_loadu_si256(p);
+        __m256i lo = premultiply(_mm256_unpacklo_epi8(v, zero));
+        __m256i hi = premultiply(_mm256_unpackhi_epi8(v, zero));
+        _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+} // namespace avx2
+
+const KernelTable s_avx2Kernels = {
+    sse2::convertI8ToRGBA8888,
+    sse2::convertI8ToAI88,
+    sse2::convertAI88ToRGBA8888,
+    sse2::convertAI88ToA8,
+    sse2::convertAI88ToI8,
+    avx2::convertRGB888ToRGBA8888,
+    avx2::convertRGB888To16<sse2::packRGB565>,
+    avx2::convertRGB888To16<sse2::packRGBA4444>,
+    avx2::convertRGB888To16<sse2::packRGB5A1>,
+    avx2::convertRGBA8888ToRGB888,
+    avx2::convertRGBA8888To16<avx2::packRGB565>,
+    sse2::convertRGBA8888ToA8,
+    avx2::convertRGBA8888To16<avx2::packRGBA4444>,
+    avx2::convertRGBA8888To16<avx2::packRGB5A1>,
+    avx2::premultiplyAlpha,
+};
+
+bool isAVX2Supported()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const int osxsaveAndAVX = (1 << 27) | (1 << 28);
+    if ((info[2] & osxsaveAndAVX) != osxsaveAndAVX)
+        return false;
+    // the os has to save the ymm registers on context switches
+    if ((_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid(1, eax, ebx, ecx, edx);
+    const unsigned int osxsaveAndAVX = (1u << 27) | (1u << 28);
+    if ((ecx & osxsaveAndAVX) != osxsaveAndAVX)
+        return false;
+    // the os has to save the ymm registers on context switches
+    unsigned int xcr0Low, xcr0High;
+    __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    if ((xcr0Low & 6) != 6)
+        return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1u << 5)) != 0;
+#endif
+}
+
+#endif // INCLUDE_AVX2
+
+#ifdef INCLUDE_NEON
+
+namespace neon {
+
+ssize_t convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(data + i);
+        uint8x16x4_t rgba = {{ v, v, v, vdupq_n_u8(0xFF) }};
+        vst4q_u8(outData + i * 4, rgba);
+    }
+    return i;
+}
+
+ssize_t convertI8ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        uint8x16x2_t ia = {{ vld1q_u8(data + i), vdupq_n_u8(0xFF) }};
+        vst2q_u8(outData + i * 2, ia);
+    }
+    return i;
+}
+
+ssize_t convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        uint8x16x2_t ia = vld2q_u8(data + i);
+        uint8x16x4_t rgba = {{ ia.val[0], ia.val[0], ia.val[0], ia.val[1] }};
+        vst4q_u8(outData + i * 2, rgba);
+    }
+    return i;
+}
+
+ssize_t convertAI88ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        vst1q_u8(outData + i / 2, vld2q_u8(data + i).val[1]);
+    }
+    return i;
+}
+
+ssize_t convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        vst1q_u8(outData + i / 2, vld2q_u8(data + i).val[0]);
+    }
+    return i;
+}
+
+ssize_t convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 48 <= dataLen; i += 48)
+    {
+        uint8x16x3_t rgb = vld3q_u8(data + i);
+        uint8x16x4_t rgba = {{ rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xFF) }};
+        vst4q_u8(outData + i / 3 * 4, rgba);
+    }
+    return i;
+}
+
+ssize_t convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 64 <= dataLen; i += 64)
+    {
+        uint8x16x4_t rgba = vld4q_u8(data + i);
+        uint8x16x3_t rgb = {{ rgba.val[0], rgba.val[1], rgba.val[2] }};
+        vst3q_u8(outData + i / 4 * 3, rgb);
+    }
+    return i;
+}
+
+ssize_t convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 64 <= dataLen; i += 64)
+    {
+        vst1q_u8(outData + i / 4, vld4q_u8(data + i).val[3]);
+    }
+    return i;
+}
+
+inline uint16x8_t packRGBA4444(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+{
+    const uint8x8_t mask = vdup_n_u8(0xF0);
+    uint16x8_t out = vshll_n_u8(vand_u8(r, mask), 8);
+    out = vorrq_u16(out, vshll_n_u8(vand_u8(g, mask), 4));
+    out = vorrq_u16(out, vmovl_u8(vand_u8(b, mask)));
+    return vorrq_u16(out, vmovl_u8(vshr_n_u8(a, 4)));
+}
+
+inline uint16x8_t packRGB565(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t /*a*/)
+{
+    uint16x8_t out = vshll_n_u8(vand_u8(r, vdup_n_u8(0xF8)), 8);
+    out = vorrq_u16(out, vshll_n_u8(vand_u8(g, vdup_n_u8(0xFC)), 3));
+    return vorrq_u16(out, vmovl_u8(vshr_n_u8(b, 3)));
+}
+
+inline uint16x8_t packRGB5A1(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+{
+    const uint8x8_t mask = vdup_n_u8(0xF8);
+    uint16x8_t out = vshll_n_u8(vand_u8(r, mask), 8);
+    out = vorrq_u16(out, vshll_n_u8(vand_u8(g, mask), 3));
+    out = vorrq_u16(out, vmovl_u8(vshl_n_u8(vshr_n_u8(b, 3), 1)));
+    return vorrq_u16(out, vmovl_u8(vshr_n_u8(a, 7)));
+}
+
+template <uint16x8_t (*PACK)(uint8x8_t, uint8x8_t, uint8x8_t, uint8x8_t)>
+ssize_t convertRGBA8888To16(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        uint8x8x4_t rgba = vld4_u8(data + i);
+        vst1q_u16((uint16_t*)(outData + i / 2), PACK(rgba.val[0], rgba.val[1], rgba.val[2], rgba.val[3]));
+    }
+    return i;
+}
+
+template <uint16x8_t (*PACK)(uint8x8_t, uint8x8_t, uint8x8_t, uint8x8_t)>
+ssize_t convertRGB888To16(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    const uint8x8_t alpha = vdup_n_u8(0xFF);
+    ssize_t i = 0;
+    for (; i + 24 <= dataLen; i += 24)
+    {
+        uint8x8x3_t rgb = vld3_u8(data + i);
+        vst1q_u16((uint16_t*)(outData + i / 3 * 2), PACK(rgb.val[0], rgb.val[1], rgb.val[2], alpha));
+    }
+    return i;
+}
+
+ssize_t premultiplyAlpha(unsigned char* data, ssize_t dataLen)
+{
+    ssize_t i = 0;
+    for (; i + 32 <= dataLen; i += 32)
+    {
+        uint8x8x4_t rgba = vld4_u8(data + i);
+        uint16x8_t factor = vaddw_u8(vdupq_n_u16(1), rgba.val[3]);
+        rgba.val[0] = vshrn_n_u16(vmulq_u16(vmovl_u8(rgba.val[0]), factor), 8);
+        rgba.val[1] = vshrn_n_u16(vmulq_u16(vmovl_u8(rgba.val[1]), factor), 8);
+        rgba.val[2] = vshrn_n_u16(vmulq_u16(vmovl_u8(rgba.val[2]), factor), 8);
+        vst4_u8(data + i, rgba);
+    }
+    return i;
+}
+
+} // namespace neon
+
+const KernelTable s_neonKernels = {
+    neon::convertI8ToRGBA8888,
+    neon::convertI8ToAI88,
+    neon::convertAI88ToRGBA8888,
+    neon::convertAI88ToA8,
+    neon::convertAI88ToI8,
+    neon::convertRGB888ToRGBA8888,
+    neon::convertRGB888To16<neon::packRGB565>,
+    neon::convertRGB888To16<neon::packRGBA4444>,
+    neon::convertRGB888To16<neon::packRGB5A1>,
+    neon::convertRGBA8888ToRGB888,
+    neon::convertRGBA8888To16<neon::packRGB565>,
+    neon::convertRGBA8888ToA8,
+    neon::convertRGBA8888To16<neon::packRGBA4444>,
+    neon::convertRGBA8888To16<neon::packRGB5A1>,
+    neon::premultiplyAlpha,
+};
+
+#endif // INCLUDE_NEON
+
+SIMDLevel detectSIMDLevel()
+{
+#if defined(INCLUDE_AVX2)
+    return isAVX2Supported() ? SIMDLevel::AVX2 : SIMDLevel::SSE2;
+#elif defined(INCLUDE_SSE2)
+    return SIMDLevel::SSE2;
+#elif defined(INCLUDE_NEON)
+    return SIMDLevel::NEON;
+#else
+    return SIMDLevel::NONE;
+#endif
+}
+
+// the converters may run on the texture cache workers while the level is changed
+std::atomic<const KernelTable*> s_kernels(nullptr);
+std::atomic<int> s_level(-1);
+
+const KernelTable* kernelsForLevel(SIMDLevel level)
+{
+    switch (level)
+    {
+#ifdef INCLUDE_SSE2
+    case SIMDLevel::SSE2:
+        return &s_sse2Kernels;
+#endif
+#ifdef INCLUDE_AVX2
+    case SIMDLevel::AVX2:
+        return &s_avx2Kernels;
+#endif
+#ifdef INCLUDE_NEON
+    case SIMDLevel::NEON:
+        return &s_neonKernels;
+#endif
+    default:
+        return &s_scalarKernels;
+    }
+}
+
+const KernelTable& kernels()
+{
+    const KernelTable* table = s_kernels.load(std::memory_order_acquire);
+    if (table == nullptr)
+    {
+        SIMDLevel level = getSupportedSIMDLevel();
+        s_level.store((int)level, std::memory_order_relaxed);
+        table = kernelsForLevel(level);
+        s_kernels.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+} // namespace
+
+SIMDLevel getSupportedSIMDLevel()
+{
+    static const SIMDLevel supported = detectSIMDLevel();
+    return supported;
+}
+
+SIMDLevel getSIMDLevel()
+{
+    kernels();
+    return (SIMDLevel)s_level.load(std::memory_order_relaxed);
+}
+
+void setSIMDLevel(SIMDLevel level)
+{
+    SIMDLevel supported = getSupportedSIMDLevel();
+    if (level != SIMDLevel::NONE && level != supported)
+    {
+        // SSE2 is the only level below another one
+        level = (level == SIMDLevel::SSE2 && supported == SIMDLevel::AVX2) ? level : supported;
+    }
+    s_level.store((int)level, std::memory_order_relaxed);
+    s_kernels.store(kernelsForLevel(level), std::memory_order_release);
+}
+
+const char* getSIMDLevelName(SIMDLevel level)
+{
+    switch (level)
+    {
+    case SIMDLevel::SSE2:
+        return "SSE2";
+    case SIMDLevel::AVX2:
+        return "AVX2";
+    case SIMDLevel::NEON:
+        return "NEON";
+    default:
+        return "scalar";
+    }
+}
+
+#define PIXEL_CONVERT_KERNEL(name, kernel) \
+ssize_t name(const unsigned char* data, ssize_t dataLen, unsigned char* outData) \
+{ \
+    ConvertKernel function = kernels().kernel; \
+    return function ? function(data, dataLen, outData) : 0; \
+}
+
+PIXEL_CONVERT_KERNEL(convertI8ToRGBA8888, i8ToRGBA8888)
+PIXEL_CONVERT_KERNEL(convertI8ToAI88, i8ToAI88)
+PIXEL_CONVERT_KERNEL(convertAI88ToRGBA8888, ai88ToRGBA8888)
+PIXEL_CONVERT_KERNEL(convertAI88ToA8, ai88ToA8)
+PIXEL_CONVERT_KERNEL(convertAI88ToI8, ai88ToI8)
+PIXEL_CONVERT_KERNEL(convertRGB888ToRGBA8888, rgb888ToRGBA8888)
+PIXEL_CONVERT_KERNEL(convertRGB888ToRGB565, rgb888ToRGB565)
+PIXEL_CONVERT_KERNEL(convertRGB888ToRGBA4444, rgb888ToRGBA4444)
+PIXEL_CONVERT_KERNEL(convertRGB888ToRGB5A1, rgb888ToRGB5A1)
+PIXEL_CONVERT_KERNEL(convertRGBA8888ToRGB888, rgba8888ToRGB888)
+PIXEL_CONVERT_KERNEL(convertRGBA8888ToRGB565, rgba8888ToRGB565)
+PIXEL_CONVERT_KERNEL(convertRGBA8888ToA8, rgba8888ToA8)
+PIXEL_CONVERT_KERNEL(convertRGBA8888ToRGBA4444, rgba8888ToRGBA4444)
+PIXEL_CONVERT_KERNEL(convertRGBA8888ToRGB5A1, rgba8888ToRGB5A1)
+
+#undef PIXEL_CONVERT_KERNEL
+
+ssize_t premultiplyAlpha(unsigned char* data, ssize_t dataLen)
+{
+    PremultiplyKernel function = kernels().premultiplyAlpha;
+    return function ? function(data, dataLen) : 0;
+}
+
+} // namespace PixelConvert
+
+NS_CC_END
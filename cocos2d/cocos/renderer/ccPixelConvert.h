@@ -0,0 +1,97 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCPIXELCONVERT_H__
+#define __CCPIXELCONVERT_H__
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/** Vectorized kernels behind the Texture2D pixel format converters and Image::premultiplyAlpha.
+ *
+ * Every kernel converts the largest prefix of the input it can handle with vector instructions and
+ * returns how many input bytes it consumed; the caller finishes the remaining pixels with its scalar
+ * loop, which is also the reference implementation. A kernel returns 0 when the selected SIMD level
+ * has no implementation for it. The kernels have no state, so they can run on the decode workers.
+ * @js NA
+ * @lua NA
+ */
+namespace PixelConvert {
+
+/** Instruction sets the kernels are written for. */
+enum class SIMDLevel
+{
+    NONE,
+    SSE2,
+    AVX2,
+    NEON,
+};
+
+/** Best level this build and this CPU support, detected once at first use. */
+SIMDLevel CC_DLL getSupportedSIMDLevel();
+
+/** Level the kernels currently use. Defaults to getSupportedSIMDLevel(). */
+SIMDLevel CC_DLL getSIMDLevel();
+
+/** Selects the level the kernels use, clamped to the supported one. SIMDLevel::NONE forces the scalar converters. */
+void CC_DLL setSIMDLevel(SIMDLevel level);
+
+/** Name of a level, for logs and benchmarks. */
+const char* CC_DLL getSIMDLevelName(SIMDLevel level);
+
+ssize_t CC_DLL convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertI8ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertAI88ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+ssize_t CC_DLL convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+
+/** Premultiplies RGBA8888 pixels in place with the rounding of CC_RGB_PREMULTIPLY_ALPHA.
+ * @return The number of bytes processed.
+ */
+ssize_t CC_DLL premultiplyAlpha(unsigned char* data, ssize_t dataLen);
+
+} // namespace PixelConvert
+
+// end of renderer group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPIXELCONVERT_H__
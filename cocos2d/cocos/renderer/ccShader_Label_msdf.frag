@@ -0,0 +1,51 @@
+const char* ccLabelMSDF_frag = R"(
+
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+
+uniform vec4 u_textColor;
+uniform vec4 u_effectColor;
+// distances are in texture values: 0.5 on the outline, 0.0 and 1.0 at the ends of the field
+uniform float u_effectWidth;
+uniform float u_smoothing;
+
+#ifdef GL_ES
+uniform lowp int u_effectType; // 0: None (Draw text), 1: Outline, 2: Glow
+#else
+uniform int u_effectType;
+#endif
+
+float median(float r, float g, float b)
+{
+    return max(min(r, g), min(max(r, g), b));
+}
+
+void main()
+{
+    vec3 msd = texture2D(CC_Texture0, v_texCoord).rgb;
+    float dist = median(msd.r, msd.g, msd.b);
+    float alpha = smoothstep(0.5 - u_smoothing, 0.5 + u_smoothing, dist);
+
+    if (u_effectType == 1) // outline
+    {
+        float edge = 0.5 - u_effectWidth;
+        float outlineAlpha = smoothstep(edge - u_smoothing, edge + u_smoothing, dist);
+        vec4 color = mix(u_effectColor, u_textColor, alpha);
+        gl_FragColor = v_fragmentColor * vec4(color.rgb, color.a * outlineAlpha);
+    }
+    else if (u_effectType == 2) // glow
+    {
+        float glow = smoothstep(0.0, 0.5, dist);
+        vec4 color = mix(u_effectColor, u_textColor, alpha);
+        gl_FragColor = v_fragmentColor * vec4(color.rgb, max(alpha, glow) * color.a);
+    }
+    else
+    {
+        gl_FragColor = v_fragmentColor * vec4(u_textColor.rgb, u_textColor.a * alpha);
+    }
+}
+)";
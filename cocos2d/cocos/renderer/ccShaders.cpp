@@ -76,6 +76,7 @@ NS_CC_BEGIN
 #include "renderer/ccShader_Label_df_glow.frag"
 #include "renderer/ccShader_Label_normal.frag"
 #include "renderer/ccShader_Label_outline.frag"
+#include "renderer/ccShader_Label_msdf.frag"
 
 //
 #include "renderer/ccShader_3D_PositionTex.vert"
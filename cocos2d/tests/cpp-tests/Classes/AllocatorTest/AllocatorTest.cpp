@@ -35,6 +35,7 @@ using namespace cocos2d::ui;
 AllocatorTests::AllocatorTests()
 {
     ADD_TEST_CASE(AllocatorTest);
+    ADD_TEST_CASE(AllocatorPoolTest);
 }
 
 #define kNumberOfInstances 100000
@@ -160,3 +161,57 @@ std::string AllocatorTest::title() const
 {
     return "Allocator Test";
 }
+
+//
+// AllocatorPoolTest
+//
+
+#define kNumberOfPooledObjects 2000
+
+AllocatorPoolTest::AllocatorPoolTest()
+{
+    // create engine objects which come from type specific pools and keep every other one,
+    // the rest are freed with the local autorelease pool so live counts drop below the high-water marks
+    Vector<Ref*> survivors;
+    {
+        AutoreleasePool pool;
+        for (int i = 0; i < kNumberOfPooledObjects; ++i)
+        {
+            Ref* objects[] = {
+                Node::create(),
+                Sprite::create(),
+                MoveTo::create(1, Vec2::ZERO),
+                CallFunc::create(nullptr),
+                EventListenerTouchOneByOne::create()
+            };
+            if (i % 2 == 0)
+            {
+                for (auto object : objects)
+                    survivors.pushBack(object);
+            }
+        }
+    }
+
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+    std::string info = cocos2d::allocator::AllocatorDiagnostics::instance()->diagnostics();
+#else
+    std::string info = "allocator diagnostics not available.\nCC_ENABLE_ALLOCATOR_DIAGNOSTICS must be set to 1 in ccConfig.h";
+#endif
+    CCLOG("%s", info.c_str());
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithSystemFont(info, "Helvetica", 8);
+    label->setDimensions(s.width - 20, 0);
+    label->setPosition(s.width / 2, s.height / 2);
+    addChild(label);
+}
+
+std::string AllocatorPoolTest::title() const
+{
+    return "Allocator Pool Test";
+}
+
+std::string AllocatorPoolTest::subtitle() const
+{
+    return "Live count, high-water mark and fragmentation per pool";
+}
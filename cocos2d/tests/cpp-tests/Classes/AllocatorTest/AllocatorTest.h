@@ -41,3 +41,14 @@ public:
 
     virtual std::string title() const override;
 };
+
+class AllocatorPoolTest : public TestCase
+{
+public:
+    CREATE_FUNC(AllocatorPoolTest);
+
+    AllocatorPoolTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
@@ -49,6 +49,7 @@ ClippingNodeTests::ClippingNodeTests()
     ADD_TEST_CASE(HoleDemo);
     ADD_TEST_CASE(ShapeTest);
     ADD_TEST_CASE(ShapeInvertedTest);
+    ADD_TEST_CASE(FastClippingOverlapTest);
     ADD_TEST_CASE(SpriteTest);
     ADD_TEST_CASE(SpriteNoAlphaTest);
     ADD_TEST_CASE(SpriteInvertedTest);
@@ -223,6 +224,36 @@ ClippingNode* ShapeInvertedTest::clipper()
     return clipper;
 }
 
+// FastClippingOverlapTest
+
+std::string FastClippingOverlapTest::title() const
+{
+    return "Fast Clipping Overlap Test";
+}
+
+std::string FastClippingOverlapTest::subtitle() const
+{
+    return "Two overlapping triangles with the area of their square,\nthe top quarter of the square should stay empty";
+}
+
+Node* FastClippingOverlapTest::stencil()
+{
+    // the triangles overlap in the bottom quarter of the square and leave a hole of the same area at the top,
+    // the stencil isn't convex and must be drawn into the stencil buffer
+    auto shape = DrawNode::create();
+    Color4F green(0, 1, 0, 1);
+    shape->drawTriangle(Vec2(-100, -100), Vec2(100, -100), Vec2(-100, 100), green);
+    shape->drawTriangle(Vec2(-100, -100), Vec2(100, -100), Vec2(100, 100), green);
+    return shape;
+}
+
+ClippingNode* FastClippingOverlapTest::clipper()
+{
+    auto clipper = ShapeTest::clipper();
+    clipper->setFastClippingEnabled(true);
+    return clipper;
+}
+
 // SpriteTest
 
 std::string SpriteTest::title() const
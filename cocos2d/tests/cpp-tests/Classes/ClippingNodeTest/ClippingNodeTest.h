@@ -85,6 +85,18 @@ public:
     virtual cocos2d::ClippingNode* clipper() override;
 };
 
+class FastClippingOverlapTest : public ShapeTest
+{
+public:
+    CREATE_FUNC(FastClippingOverlapTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual cocos2d::Node* stencil() override;
+    virtual cocos2d::ClippingNode* clipper() override;
+};
+
 class SpriteTest : public BasicTest
 {
 public:
@@ -44,6 +44,7 @@ DrawPrimitivesTests::DrawPrimitivesTests()
     ADD_TEST_CASE(PrimitivesCommandTest);
     ADD_TEST_CASE(Issue11942Test);
     ADD_TEST_CASE(Issue19641Test);
+    ADD_TEST_CASE(DrawNodeStaticLayerTest);
 }
 
 string DrawPrimitivesBaseTest::title() const
@@ -461,6 +462,49 @@ string Issue19641Test::subtitle() const
     return "draw a concave polygon";
 }
 
+//
+// DrawNodeStaticLayerTest
+//
+DrawNodeStaticLayerTest::DrawNodeStaticLayerTest()
+: _time(0.0f)
+{
+    _drawNode = DrawNode::create();
+    addChild(_drawNode, 10);
+
+    // a grid that never changes, kept by the static layer
+    auto s = Director::getInstance()->getWinSize();
+    for (float x = 0; x <= s.width; x += 40)
+        _drawNode->drawSegment(Vec2(x, 0), Vec2(x, s.height), 1, Color4F(0.3f, 0.3f, 0.3f, 1));
+    for (float y = 0; y <= s.height; y += 40)
+        _drawNode->drawLine(Vec2(0, y), Vec2(s.width, y), Color4F(0.3f, 0.3f, 0.3f, 1));
+    _drawNode->drawSolidCircle(VisibleRect::center(), 60, 0, 30, Color4F(0, 0, 1, 1));
+    _drawNode->freezeStaticLayer();
+
+    schedule(CC_SCHEDULE_SELECTOR(DrawNodeStaticLayerTest::redraw));
+}
+
+void DrawNodeStaticLayerTest::redraw(float dt)
+{
+    _time += dt;
+
+    // only the moving shapes are drawn again, the grid and the blue circle stay
+    _drawNode->clear();
+    Vec2 pos = VisibleRect::center() + Vec2(cosf(_time), sinf(_time)) * 100;
+    _drawNode->drawSolidCircle(pos, 20, _time, 6, Color4F(1, 0, 0, 1));
+    _drawNode->drawCircle(pos, 30, _time, 6, true, Color4F(1, 1, 0, 1));
+    _drawNode->drawDot(VisibleRect::center(), 5, Color4F(0, 1, 0, 1));
+}
+
+string DrawNodeStaticLayerTest::title() const
+{
+    return "DrawNode static layer";
+}
+
+string DrawNodeStaticLayerTest::subtitle() const
+{
+    return "grid and blue circle frozen, red hexagon redrawn every frame";
+}
+
 
 #if defined(__GNUC__) && ((__GNUC__ >= 4) || ((__GNUC__ == 3) && (__GNUC_MINOR__ >= 1)))
 #pragma GCC diagnostic warning "-Wdeprecated-declarations"
@@ -108,4 +108,21 @@ public:
     
 };
 
+class DrawNodeStaticLayerTest : public DrawPrimitivesBaseTest
+{
+public:
+    CREATE_FUNC(DrawNodeStaticLayerTest);
+
+    DrawNodeStaticLayerTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void redraw(float dt);
+
+private:
+    cocos2d::DrawNode* _drawNode;
+    float _time;
+};
+
 #endif
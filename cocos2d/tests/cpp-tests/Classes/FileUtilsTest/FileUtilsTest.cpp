@@ -49,6 +49,9 @@ FileUtilsTests::FileUtilsTests()
     ADD_TEST_CASE(TestWriteDataAsync);
     ADD_TEST_CASE(TestListFiles);
     ADD_TEST_CASE(TestIsFileExistRejectFolder);
+    ADD_TEST_CASE(TestMissingFileCache);
+    ADD_TEST_CASE(TestAssetPack);
+    ADD_TEST_CASE(TestPlistReader);
 }
 
 // TestResolutionDirectories
@@ -1484,3 +1487,211 @@ std::string TestIsFileExistRejectFolder::subtitle() const
 {
     return "";
 }
+
+// TestMissingFileCache
+
+void TestMissingFileCache::onEnter()
+{
+    FileUtilsDemo::onEnter();
+
+    auto winSize = Director::getInstance()->getWinSize();
+    auto fileUtils = FileUtils::getInstance();
+    _searchPaths = fileUtils->getSearchPaths();
+
+    std::string writablePath = fileUtils->getWritablePath();
+    std::string filename = "missing-file-cache-test.txt";
+    fileUtils->removeFile(writablePath + filename);
+    fileUtils->addSearchPath(writablePath);
+
+    // the miss is cached, writing the file has to forget it
+    bool before = fileUtils->isFileExist(filename);
+    bool cachedMiss = fileUtils->isFileExist(filename);
+    fileUtils->writeStringToFile("found", writablePath + filename);
+    bool after = fileUtils->isFileExist(filename);
+    std::string content = fileUtils->getStringFromFile(filename);
+    fileUtils->removeFile(writablePath + filename);
+
+    // like a download, written to a temporary name first and renamed once complete
+    std::string temporaryName = filename + ".tmp";
+    fileUtils->writeStringToFile("renamed", writablePath + temporaryName);
+    bool beforeRename = fileUtils->isFileExist(filename);
+    fileUtils->renameFile(writablePath, temporaryName, filename);
+    bool afterRename = fileUtils->isFileExist(filename);
+    fileUtils->removeFile(writablePath + filename);
+
+    bool ok = !before && !cachedMiss && after && content == "found" && !beforeRename && afterRename;
+    auto label = Label::createWithTTF(StringUtils::format("before write: %s, after write: %s, content: %s, after rename: %s => %s",
+                                                          before ? "found" : "missing", after ? "found" : "missing",
+                                                          content.c_str(), afterRename ? "found" : "missing", ok ? "OK" : "FAILED"),
+                                      "fonts/Thonburi.ttf", 18);
+    label->setPosition(winSize.width / 2, winSize.height / 2);
+    this->addChild(label);
+}
+
+void TestMissingFileCache::onExit()
+{
+    FileUtils::getInstance()->setSearchPaths(_searchPaths);
+    FileUtilsDemo::onExit();
+}
+
+std::string TestMissingFileCache::title() const
+{
+    return "FileUtils: missing file cache";
+}
+
+std::string TestMissingFileCache::subtitle() const
+{
+    return "A file written or renamed after a failed lookup must be found";
+}
+
+// TestAssetPack
+
+void TestAssetPack::onEnter()
+{
+    FileUtilsDemo::onEnter();
+
+    auto winSize = Director::getInstance()->getWinSize();
+    auto fileUtils = FileUtils::getInstance();
+
+    // assetpack/test.pack holds packed/hello.txt, deflated, and a stored copy of Images/grossini.png
+    bool before = fileUtils->isFileExist("packed/hello.txt");
+    bool added = fileUtils->addAssetPack("assetpack/test.pack");
+    std::string fullPath = fileUtils->fullPathForFilename("packed/hello.txt");
+    std::string content = fileUtils->getStringFromFile("packed/hello.txt");
+    long size = fileUtils->getFileSize("packed/hello.txt");
+    Data packedImage = fileUtils->getDataFromFile("packed/grossini.png");
+    Data looseImage = fileUtils->getDataFromFile("Images/grossini.png");
+    auto sprite = Sprite::create("packed/grossini.png");
+    fileUtils->removeAssetPack("assetpack/test.pack");
+    bool after = fileUtils->isFileExist("packed/hello.txt");
+
+    // resetting the search paths drops the pack, adding it again restores its search path
+    auto searchPaths = fileUtils->getSearchPaths();
+    fileUtils->addAssetPack("assetpack/test.pack");
+    fileUtils->setSearchPaths(searchPaths);
+    bool afterReset = fileUtils->isFileExist(fullPath);
+    bool readded = fileUtils->addAssetPack("assetpack/test.pack") && fileUtils->isFileExist("packed/hello.txt");
+    fileUtils->removeAssetPack("assetpack/test.pack");
+
+    std::string expected;
+    for (int i = 0; i < 20; ++i)
+        expected += "Hello from an asset pack.\n";
+    bool sameImage = packedImage.getSize() == looseImage.getSize() && !packedImage.isNull()
+        && memcmp(packedImage.getBytes(), looseImage.getBytes(), looseImage.getSize()) == 0;
+
+    bool ok = !before && added && !after && !afterReset && readded && content == expected && size == (long)expected.size() && sameImage && sprite
+        && fullPath.find("test.pack/packed/hello.txt") != std::string::npos;
+    auto label = Label::createWithTTF(StringUtils::format("text: %s, image: %s, removed: %s, search paths reset: %s => %s",
+                                                          content == expected ? "OK" : "wrong", sameImage ? "OK" : "wrong",
+                                                          after ? "no" : "yes", !afterReset && readded ? "OK" : "wrong", ok ? "OK" : "FAILED"),
+                                      "fonts/Thonburi.ttf", 18);
+    label->setPosition(winSize.width / 2, winSize.height / 2);
+    this->addChild(label);
+
+    if (sprite)
+    {
+        sprite->setPosition(winSize.width / 2, winSize.height / 3);
+        this->addChild(sprite);
+    }
+}
+
+void TestAssetPack::onExit()
+{
+    FileUtils::getInstance()->removeAssetPack("assetpack/test.pack");
+    FileUtilsDemo::onExit();
+}
+
+std::string TestAssetPack::title() const
+{
+    return "FileUtils: asset pack";
+}
+
+std::string TestAssetPack::subtitle() const
+{
+    return "Files of an added pack are found like loose files";
+}
+
+// TestPlistReader
+
+namespace
+{
+    struct PlistReaderTestObject
+    {
+        std::string name;
+        int count = 0;
+        float scale = 0;
+        bool enabled = false;
+        Rect rect;
+        std::vector<std::string> tags;
+    };
+}
+
+void TestPlistReader::onEnter()
+{
+    FileUtilsDemo::onEnter();
+
+    auto winSize = Director::getInstance()->getWinSize();
+
+    static const char plist[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+        "<plist version=\"1.0\">\n"
+        "<dict>\n"
+        "    <!-- a comment -->\n"
+        "    <key>name</key><string>a &amp; b &lt;c&gt;</string>\n"
+        "    <key>count</key><integer>42</integer>\n"
+        "    <key>scale</key><real>0.5</real>\n"
+        "    <key>enabled</key><true/>\n"
+        "    <key>rect</key><string>{{1,2},{3,4}}</string>\n"
+        "    <key>tags</key><array><string>x</string><string/></array>\n"
+        "    <key>unknown</key><dict><key>nested</key><array><dict/><array/></array></dict>\n"
+        "    <key>empty</key><dict/>\n"
+        "</dict>\n"
+        "</plist>\n";
+
+    // the generic ValueMap path
+    ValueMap dict = FileUtils::getInstance()->getValueMapFromData(plist, sizeof(plist) - 1);
+    bool mapOk = dict["name"].asString() == "a & b <c>" && dict["count"].asInt() == 42
+        && dict["scale"].asFloat() == 0.5f && dict["enabled"].asBool()
+        && dict["tags"].asValueVector().size() == 2 && dict["unknown"].asValueMap()["nested"].asValueVector().size() == 2
+        && dict["empty"].getType() == Value::Type::MAP && dict["empty"].asValueMap().empty();
+
+    // the same document read into a struct, unknown keys are skipped
+    static const PlistSchema<PlistReaderTestObject> schema = PlistSchema<PlistReaderTestObject>()
+        .field("name", &PlistReaderTestObject::name)
+        .field("count", &PlistReaderTestObject::count)
+        .field("scale", &PlistReaderTestObject::scale)
+        .field("enabled", &PlistReaderTestObject::enabled)
+        .field("rect", &PlistReaderTestObject::rect)
+        .field("tags", &PlistReaderTestObject::tags);
+
+    PlistReaderTestObject object;
+    PlistReader reader(plist, sizeof(plist) - 1);
+    bool read = reader.next() == PlistReader::Token::DICT_BEGIN && schema.read(reader, object)
+        && reader.next() == PlistReader::Token::END;
+    bool structOk = read && object.name == "a & b <c>" && object.count == 42 && object.scale == 0.5f && object.enabled
+        && object.rect.equals(Rect(1, 2, 3, 4)) && object.tags.size() == 2 && object.tags[0] == "x" && object.tags[1].empty();
+
+    // a truncated document is reported, not half read
+    PlistReader truncated(plist, sizeof(plist) / 2);
+    PlistReaderTestObject ignored;
+    bool truncatedOk = !(truncated.next() == PlistReader::Token::DICT_BEGIN && schema.read(truncated, ignored));
+
+    bool ok = mapOk && structOk && truncatedOk;
+    auto label = Label::createWithTTF(StringUtils::format("ValueMap: %s, struct: %s, truncated: %s => %s",
+                                                          mapOk ? "OK" : "wrong", structOk ? "OK" : "wrong",
+                                                          truncatedOk ? "rejected" : "accepted", ok ? "OK" : "FAILED"),
+                                      "fonts/Thonburi.ttf", 18);
+    label->setPosition(winSize.width / 2, winSize.height / 2);
+    this->addChild(label);
+}
+
+std::string TestPlistReader::title() const
+{
+    return "FileUtils: plist reader";
+}
+
+std::string TestPlistReader::subtitle() const
+{
+    return "Reads a plist into a ValueMap and into a struct";
+}
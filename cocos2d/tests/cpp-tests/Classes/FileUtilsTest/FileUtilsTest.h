@@ -280,4 +280,39 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class TestMissingFileCache : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestMissingFileCache);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    std::vector<std::string> _searchPaths;
+};
+
+class TestAssetPack : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestAssetPack);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class TestPlistReader : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestPlistReader);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif /* __FILEUTILSTEST_H__ */
@@ -27,6 +27,7 @@
 #include "../testResource.h"
 #include "renderer/CCRenderer.h"
 #include "2d/CCFontAtlasCache.h"
+#include "2d/CCFontAtlas.h"
 
 USING_NS_CC;
 using namespace ui;
@@ -144,6 +145,8 @@ NewLabelTests::NewLabelTests()
     ADD_TEST_CASE(LabelIssueLineGap);
     ADD_TEST_CASE(LabelIssue17902);
     ADD_TEST_CASE(LabelLetterColorsTest);
+    ADD_TEST_CASE(LabelTTFPrecacheGlyphs);
+    ADD_TEST_CASE(LabelTTFMultiChannelDistanceField);
 }
 
 LabelFNTColorAndOpacity::LabelFNTColorAndOpacity()
@@ -3654,3 +3657,155 @@ void LabelLetterColorsTest::setLetterColors(cocos2d::Label* label, const cocos2d
             letter->setColor(color);
     }
 }
+
+//
+// LabelTTFPrecacheGlyphs
+//
+LabelTTFPrecacheGlyphs::LabelTTFPrecacheGlyphs()
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    TTFConfig ttfConfig("fonts/HKYuanMini.ttf", 20);
+    auto label = Label::createWithTTF(ttfConfig, "中国上海, rendered while the charset is cached");
+    label->setPosition(size.width / 2, size.height * 0.75f);
+    addChild(label);
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _infoLabel->setPosition(size.width / 2, size.height * 0.65f);
+    addChild(_infoLabel);
+
+    // the first page, scaled down to fit the screen
+    _pageSprite = Sprite::create();
+    _pageSprite->setPosition(size.width / 2, size.height * 0.3f);
+    addChild(_pageSprite);
+
+    // kept until the charset is in the atlas, the test may be left before
+    retain();
+    bool precaching = FontAtlasCache::precacheGlyphs(&ttfConfig, "fonts/HKYuanMini.charset.txt", [this](FontAtlas* atlas) {
+        updateInfo(atlas);
+        release();
+    });
+    if (!precaching)
+        release();
+
+    auto atlas = FontAtlasCache::getFontAtlasTTF(&ttfConfig);
+    schedule([this, atlas](float) {
+        updateInfo(atlas);
+    }, 0.1f, "update_info");
+}
+
+void LabelTTFPrecacheGlyphs::updateInfo(FontAtlas* atlas)
+{
+    _infoLabel->setString(StringUtils::format("pages: %d, fill: %.1f%%, rasterized in %.1f ms, pending letters: %d",
+        atlas->getPageCount(), atlas->getFillRatio() * 100, atlas->getRasterizationTime() * 1000,
+        atlas->getPendingLetterCount()));
+
+    auto texture = atlas->getTexture(0);
+    if (texture && _pageSprite->getTexture() != texture)
+    {
+        _pageSprite->setTexture(texture);
+        _pageSprite->setTextureRect(Rect(Vec2::ZERO, texture->getContentSize()));
+        _pageSprite->setScale(Director::getInstance()->getWinSize().height * 0.35f / texture->getContentSize().height);
+    }
+}
+
+std::string LabelTTFPrecacheGlyphs::title() const
+{
+    return "Precache glyphs of a TTF font";
+}
+
+std::string LabelTTFPrecacheGlyphs::subtitle() const
+{
+    return "The charset is rasterized in the background and packed into the first page";
+}
+
+//
+// LabelTTFMultiChannelDistanceField
+//
+static size_t getFontAtlasMemory(FontAtlas* atlas)
+{
+    size_t memory = 0;
+    for (const auto& texture : atlas->getTextures())
+    {
+        memory += (size_t)texture.second->getPixelsWide() * texture.second->getPixelsHigh() * texture.second->getBitsPerPixelForFormat() / 8;
+    }
+    return memory;
+}
+
+LabelTTFMultiChannelDistanceField::LabelTTFMultiChannelDistanceField()
+{
+    auto size = Director::getInstance()->getWinSize();
+    const float fontSizes[] = {12, 20, 32, 48, 72};
+    const char* text = "Score: 1024";
+
+    // the same sizes, one atlas per size on the left, one atlas for all of them on the right
+    std::vector<FontAtlas*> atlases;
+    FontAtlas* msdfAtlas = nullptr;
+    float y = size.height * 0.8f;
+    for (auto fontSize : fontSizes)
+    {
+        TTFConfig ttfConfig("fonts/arial.ttf", fontSize);
+        auto label = Label::createWithTTF(ttfConfig, text);
+        label->setPosition(size.width * 0.25f, y);
+        addChild(label);
+        atlases.push_back(label->getFontAtlas());
+
+        ttfConfig.multiChannelDistanceFieldEnabled = true;
+        auto msdfLabel = Label::createWithTTF(ttfConfig, text);
+        msdfLabel->setPosition(size.width * 0.75f, y);
+        addChild(msdfLabel);
+        msdfAtlas = msdfLabel->getFontAtlas();
+
+        y -= fontSize * 0.6f + 14;
+    }
+
+    // outlines and glows need atlases of their own, unless they come from the field
+    TTFConfig outlineConfig("fonts/arial.ttf", 32, GlyphCollection::DYNAMIC, nullptr, false, 2);
+    auto outlineLabel = Label::createWithTTF(outlineConfig, text);
+    outlineLabel->setPosition(size.width * 0.25f, y);
+    outlineLabel->enableOutline(Color4B::RED);
+    addChild(outlineLabel);
+    atlases.push_back(outlineLabel->getFontAtlas());
+
+    auto glowLabel = Label::createWithTTF(TTFConfig("fonts/arial.ttf", 32), text);
+    glowLabel->setPosition(size.width * 0.25f, y - 40);
+    glowLabel->enableGlow(Color4B::YELLOW);
+    addChild(glowLabel);
+    atlases.push_back(glowLabel->getFontAtlas());
+
+    outlineConfig.multiChannelDistanceFieldEnabled = true;
+    auto msdfOutlineLabel = Label::createWithTTF(outlineConfig, text);
+    msdfOutlineLabel->setPosition(size.width * 0.75f, y);
+    msdfOutlineLabel->enableOutline(Color4B::RED);
+    addChild(msdfOutlineLabel);
+
+    TTFConfig glowConfig("fonts/arial.ttf", 32);
+    glowConfig.multiChannelDistanceFieldEnabled = true;
+    auto msdfGlowLabel = Label::createWithTTF(glowConfig, text);
+    msdfGlowLabel->setPosition(size.width * 0.75f, y - 40);
+    msdfGlowLabel->enableGlow(Color4B::YELLOW);
+    addChild(msdfGlowLabel);
+
+    CCASSERT(msdfOutlineLabel->getFontAtlas() == msdfAtlas && msdfGlowLabel->getFontAtlas() == msdfAtlas,
+        "every size and effect should share the atlas");
+
+    size_t memory = 0;
+    for (auto atlas : atlases)
+    {
+        memory += getFontAtlasMemory(atlas);
+    }
+    auto info = Label::createWithTTF(StringUtils::format("per size: %d atlases, %d KB\nMSDF: 1 atlas, %d KB",
+        (int)atlases.size(), (int)(memory / 1024), (int)(getFontAtlasMemory(msdfAtlas) / 1024)), "fonts/arial.ttf", 14);
+    info->setPosition(size.width / 2, y - 80);
+    addChild(info);
+}
+
+std::string LabelTTFMultiChannelDistanceField::title() const
+{
+    return "Multi-channel distance field atlas";
+}
+
+std::string LabelTTFMultiChannelDistanceField::subtitle() const
+{
+    return "Left: an atlas per size and effect. Right: one MSDF atlas for all";
+}
@@ -1014,4 +1014,32 @@ private:
     static void setLetterColors(cocos2d::Label* label, const cocos2d::Color3B& color);
 };
 
+class LabelTTFPrecacheGlyphs : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelTTFPrecacheGlyphs);
+
+    LabelTTFPrecacheGlyphs();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    void updateInfo(cocos2d::FontAtlas* atlas);
+
+    cocos2d::Label* _infoLabel;
+    cocos2d::Sprite* _pageSprite;
+};
+
+class LabelTTFMultiChannelDistanceField : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelTTFMultiChannelDistanceField);
+
+    LabelTTFMultiChannelDistanceField();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif
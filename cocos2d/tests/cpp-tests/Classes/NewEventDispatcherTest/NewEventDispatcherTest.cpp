@@ -58,6 +58,7 @@ EventDispatcherTests::EventDispatcherTests()
     ADD_TEST_CASE(WindowEventsTest);
     ADD_TEST_CASE(Issue8194);
     ADD_TEST_CASE(Issue9898)
+    ADD_TEST_CASE(TouchSpatialIndexTest);
 }
 
 std::string EventDispatcherTestDemo::title() const
@@ -1687,3 +1688,62 @@ std::string Issue9898::subtitle() const
 {
     return  "Should not crash if dispatch event after remove\n event listener in callback";
 }
+
+// TouchSpatialIndexTest
+void TouchSpatialIndexTest::onEnter()
+{
+    EventDispatcherTestDemo::onEnter();
+
+    _wasSpatialIndexEnabled = _eventDispatcher->isTouchSpatialIndexEnabled();
+    _eventDispatcher->setTouchSpatialIndexEnabled(true);
+
+    auto origin = Director::getInstance()->getVisibleOrigin();
+    auto size = Director::getInstance()->getVisibleSize();
+
+    auto node = LayerColor::create(Color4B(0, 0, 255, 255), 80, 80);
+    node->setPosition(origin);
+    addChild(node);
+
+    auto touched = std::make_shared<bool>(false);
+    auto listener = EventListenerTouchOneByOne::create();
+    listener->setBoundsCheckEnabled(true);
+    listener->onTouchBegan = [touched](Touch* touch, Event* event){
+        *touched = true;
+        return false;
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, node);
+
+    // The node was visited in the corner, it's moved into the cell of the touch right before the touch.
+    scheduleOnce([=](float dt){
+        Vec2 center = origin + size / 2;
+        node->setPosition(center - node->getContentSize() / 2);
+
+        Touch* touch = new (std::nothrow) Touch();
+        touch->autorelease();
+        Vec2 location = Director::getInstance()->convertToUI(center);
+        touch->setTouchInfo(0, location.x, location.y);
+
+        EventTouch event;
+        event.setEventCode(EventTouch::EventCode::BEGAN);
+        event.setTouches({ touch });
+        _eventDispatcher->dispatchEvent(&event);
+
+        _subtitleLabel->setString(*touched ? "Passed: the moved node got the touch" : "Failed: the moved node missed the touch");
+    }, 0.5f, "touch");
+}
+
+void TouchSpatialIndexTest::onExit()
+{
+    _eventDispatcher->setTouchSpatialIndexEnabled(_wasSpatialIndexEnabled);
+    EventDispatcherTestDemo::onExit();
+}
+
+std::string TouchSpatialIndexTest::title() const
+{
+    return "Touch spatial index";
+}
+
+std::string TouchSpatialIndexTest::subtitle() const
+{
+    return "A node moved between the visit and the touch should get it";
+}
@@ -310,4 +310,18 @@ private:
     cocos2d::EventListenerCustom* _listener;
 };
 
+class TouchSpatialIndexTest : public EventDispatcherTestDemo
+{
+public:
+    CREATE_FUNC(TouchSpatialIndexTest);
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    bool _wasSpatialIndexEnabled;
+};
+
 #endif /* defined(__samples__NewEventDispatcherTest__) */
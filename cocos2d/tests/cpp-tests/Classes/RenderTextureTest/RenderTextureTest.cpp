@@ -64,10 +64,11 @@ RenderTextureSave::RenderTextureSave()
     MenuItemFont::setFontSize(16);
     auto item1 = MenuItemFont::create("Save Image PMA", CC_CALLBACK_1(RenderTextureSave::saveImageWithPremultipliedAlpha, this));
     auto item2 = MenuItemFont::create("Save Image Non-PMA", CC_CALLBACK_1(RenderTextureSave::saveImageWithNonPremultipliedAlpha, this));
-    auto item3 = MenuItemFont::create("Add Image", CC_CALLBACK_1(RenderTextureSave::addImage, this));
-    auto item4 = MenuItemFont::create("Clear to Random", CC_CALLBACK_1(RenderTextureSave::clearImage, this));
-    auto item5 = MenuItemFont::create("Clear to Transparent", CC_CALLBACK_1(RenderTextureSave::clearImageTransparent, this));
-    auto menu = Menu::create(item1, item2, item3, item4, item5, nullptr);
+    auto item3 = MenuItemFont::create("Save Image Async", CC_CALLBACK_1(RenderTextureSave::saveImageAsync, this));
+    auto item4 = MenuItemFont::create("Add Image", CC_CALLBACK_1(RenderTextureSave::addImage, this));
+    auto item5 = MenuItemFont::create("Clear to Random", CC_CALLBACK_1(RenderTextureSave::clearImage, this));
+    auto item6 = MenuItemFont::create("Clear to Transparent", CC_CALLBACK_1(RenderTextureSave::clearImageTransparent, this));
+    auto menu = Menu::create(item1, item2, item3, item4, item5, item6, nullptr);
     this->addChild(menu);
     menu->alignItemsVertically();
     menu->setPosition(Vec2(VisibleRect::rightTop().x - 80, VisibleRect::rightTop().y - 100));
@@ -141,6 +142,35 @@ void RenderTextureSave::saveImageWithNonPremultipliedAlpha(cocos2d::Ref *sender)
     counter++;
 }
 
+void RenderTextureSave::saveImageAsync(cocos2d::Ref* sender)
+{
+    static int counter = 0;
+
+    char png[24];
+    sprintf(png, "image-async-%d.png", counter);
+
+    // the file is written on a worker thread a few frames later, the scene may be gone by then
+    // but the render texture is kept alive until the callback is called
+    int rotation = counter * 3;
+    auto callback = [rotation](RenderTexture* rt, const std::string& path)
+    {
+        auto parent = rt->getParent();
+        if (parent)
+        {
+            auto sprite = Sprite::create(path);
+            parent->addChild(sprite);
+            sprite->setScale(0.3f);
+            sprite->setPosition(Vec2(40, 40));
+            sprite->setRotation(rotation);
+        }
+        CCLOG("Image saved %s", path.c_str());
+    };
+
+    _target->saveToFileAsync(png, Image::Format::PNG, true, callback);
+
+    counter++;
+}
+
 void RenderTextureSave::addImage(cocos2d::Ref* sender)
 {
     auto s = Director::getInstance()->getWinSize();
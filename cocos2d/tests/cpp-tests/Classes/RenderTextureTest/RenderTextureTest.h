@@ -47,6 +47,7 @@ public:
     void clearImageTransparent(cocos2d::Ref* sender);
     void saveImageWithPremultipliedAlpha(cocos2d::Ref* pSender);
     void saveImageWithNonPremultipliedAlpha(cocos2d::Ref* pSender);
+    void saveImageAsync(cocos2d::Ref* sender);
 
     void addImage(cocos2d::Ref* sender);
 
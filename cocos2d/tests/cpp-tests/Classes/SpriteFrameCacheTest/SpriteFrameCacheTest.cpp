@@ -38,6 +38,7 @@ SpriteFrameCacheTests::SpriteFrameCacheTests()
     ADD_TEST_CASE(SpriteFrameCachePixelFormatTest);
     ADD_TEST_CASE(SpriteFrameCacheLoadMultipleTimes);
     ADD_TEST_CASE(SpriteFrameCacheFullCheck);
+    ADD_TEST_CASE(SpriteFrameCacheBinaryTest);
 }
 
 SpriteFrameCachePixelFormatTest::SpriteFrameCachePixelFormatTest()
@@ -140,3 +141,52 @@ void SpriteFrameCacheFullCheck::loadSpriteFrames(const std::string &file, cocos2
     cache->addSpriteFramesWithFile(file);
     CCASSERT(cache->isSpriteFramesWithFileLoaded(file) == true, "Plist should be full after reloaded");
 }
+
+SpriteFrameCacheBinaryTest::SpriteFrameCacheBinaryTest()
+{
+    const Size screenSize = Director::getInstance()->getWinSize();
+    auto cache = SpriteFrameCache::getInstance();
+
+    // issue_17116.ccsf is issue_17116.plist converted by tools/sprite-sheet/convert_sprite_sheet.py,
+    // it has polygons, anchors and a pixel format
+    const std::string plist = "Images/issue_17116.plist";
+    const std::string binary = "Images/issue_17116.ccsf";
+
+    std::vector<std::string> names;
+    for (const auto& iter : FileUtils::getInstance()->getValueMapFromFile(plist)["frames"].asValueMap())
+        names.push_back(iter.first);
+
+    cache->addSpriteFramesWithFile(plist);
+    Vector<SpriteFrame*> plistFrames;
+    for (const auto& name : names)
+        plistFrames.pushBack(cache->getSpriteFrameByName(name)->clone());
+    cache->removeSpriteFramesFromFile(plist);
+
+    cache->addSpriteFramesWithFile(binary);
+    bool loaded = cache->isSpriteFramesWithFileLoaded(binary);
+    int matching = 0;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        SpriteFrame* expected = plistFrames.at(i);
+        SpriteFrame* frame = cache->getSpriteFrameByName(names[i]);
+        if (frame && frame->getRectInPixels().equals(expected->getRectInPixels())
+            && frame->isRotated() == expected->isRotated()
+            && frame->getOffsetInPixels().equals(expected->getOffsetInPixels())
+            && frame->getOriginalSizeInPixels().equals(expected->getOriginalSizeInPixels())
+            && frame->hasAnchorPoint() == expected->hasAnchorPoint()
+            && frame->getAnchorPoint().equals(expected->getAnchorPoint())
+            && frame->hasPolygonInfo() == expected->hasPolygonInfo()
+            && frame->getPolygonInfo().getTrianglesCount() == expected->getPolygonInfo().getTrianglesCount()
+            && frame->getTexture()->getPixelFormat() == expected->getTexture()->getPixelFormat())
+        {
+            ++matching;
+        }
+    }
+    cache->removeSpriteFramesFromFile(binary);
+    bool removed = !cache->isSpriteFramesWithFileLoaded(binary);
+
+    bool ok = loaded && removed && !names.empty() && matching == (int)names.size();
+    auto label = Label::createWithSystemFont(StringUtils::format("%d of %d frames match => %s", matching, (int)names.size(), ok ? "OK" : "FAILED"), "", 20);
+    label->setPosition(screenSize.width * 0.5f, screenSize.height * 0.5f);
+    addChild(label);
+}
@@ -76,4 +76,15 @@ public:
 private:
     void loadSpriteFrames(const std::string &file, cocos2d::Texture2D::PixelFormat expectedFormat);
 
-};
\ No newline at end of file
+};
+
+class SpriteFrameCacheBinaryTest : public TestCase
+{
+public:
+    CREATE_FUNC(SpriteFrameCacheBinaryTest);
+
+    virtual std::string title() const override { return "Binary sprite sheet"; }
+    virtual std::string subtitle() const override { return "The frames must match the ones of the plist"; }
+
+    SpriteFrameCacheBinaryTest();
+};
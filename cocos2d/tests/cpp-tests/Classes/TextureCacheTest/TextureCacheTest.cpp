@@ -33,6 +33,7 @@ TextureCacheTests::TextureCacheTests()
 {
     ADD_TEST_CASE(TextureCacheTest);
     ADD_TEST_CASE(TextureCacheUnbindTest);
+    ADD_TEST_CASE(TextureCacheBudgetTest);
 }
 
 TextureCacheTest::TextureCacheTest()
@@ -204,3 +205,61 @@ void TextureCacheUnbindTest::textureLoadedB(Texture2D* texture)
   s->setPosition(3 * size.width / 4, size.height / 2);
   this->addChild(s);
 }
+
+TextureCacheBudgetTest::TextureCacheBudgetTest()
+{
+    auto size = Director::getInstance()->getWinSize();
+    auto cache = Director::getInstance()->getTextureCache();
+    _budget = cache->getMemoryBudget();
+
+    // only the sprite retains its texture, the backgrounds are the only unused textures of the cache
+    cache->removeUnusedTextures();
+    cache->addImage("Images/background1.png");
+    cache->addImage("Images/background2.png");
+    cache->addImage("Images/background3.png");
+
+    auto sprite = Sprite::create("Images/grossini.png");
+    sprite->setPosition(size.width / 2, size.height / 2);
+    this->addChild(sprite);
+
+    // textures used in the current frame are kept, the eviction is checked in the next ones
+    this->scheduleOnce(CC_SCHEDULE_SELECTOR(TextureCacheBudgetTest::checkEviction), 0.1f);
+}
+
+void TextureCacheBudgetTest::checkEviction(float /*dt*/)
+{
+    auto size = Director::getInstance()->getWinSize();
+    auto cache = Director::getInstance()->getTextureCache();
+
+    // background1 is the least recently used, it goes first
+    cache->getTextureForKey("Images/background2.png");
+    cache->getTextureForKey("Images/background3.png");
+    size_t background3 = cache->getTextureForKey("Images/background3.png")->getMemorySize();
+    size_t usage = cache->getMemoryUsage();
+
+    // leave room for one more background only
+    cache->setMemoryBudget(usage - background3);
+    int evicted = cache->evictUnusedTextures(cache->getMemoryBudget());
+    bool spriteKept = cache->getTextureForKey("Images/grossini.png") != nullptr;
+    bool lruEvicted = cache->getTextureForKey("Images/background1.png") == nullptr;
+    bool recentKept = cache->getTextureForKey("Images/background3.png") != nullptr;
+
+    // an evicted texture is loaded again on demand
+    bool reloaded = cache->addImage("Images/background1.png") != nullptr;
+
+    bool ok = evicted == 1 && spriteKept && lruEvicted && recentKept && reloaded;
+    auto label = Label::createWithTTF(StringUtils::format("evicted: %d, in use kept: %s, reloaded: %s => %s", evicted,
+                                                          spriteKept ? "yes" : "no", reloaded ? "yes" : "no",
+                                                          ok ? "OK" : "FAILED"),
+                                      "fonts/arial.ttf", 15);
+    label->setPosition(size.width / 2, size.height / 4);
+    this->addChild(label);
+
+    log("%s\n", cache->getCachedTextureInfo().c_str());
+}
+
+void TextureCacheBudgetTest::onExit()
+{
+    Director::getInstance()->getTextureCache()->setMemoryBudget(_budget);
+    TestCase::onExit();
+}
@@ -61,4 +61,21 @@ private:
     void textureLoadedB(cocos2d::Texture2D* texture);
 };
 
+class TextureCacheBudgetTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureCacheBudgetTest);
+
+    TextureCacheBudgetTest();
+
+    virtual void onExit() override;
+    virtual std::string title() const override { return "TextureCache memory budget"; }
+    virtual std::string subtitle() const override { return "Unused textures are evicted, least recently used first"; }
+
+private:
+    void checkEviction(float dt);
+
+    size_t _budget;
+};
+
 #endif // _TEXTURECACHE_TEST_H_
@@ -27,6 +27,7 @@
 
 #include "2d/CCFastTMXLayer.h"
 #include "2d/CCFastTMXTiledMap.h"
+#include <chrono>
 
 USING_NS_CC;
 
@@ -66,6 +67,8 @@ FastTileMapTests::FastTileMapTests()
     ADD_TEST_CASE(TMXBug987New);
     ADD_TEST_CASE(TMXBug787New);
     ADD_TEST_CASE(TMXGIDObjectsTestNew);
+    ADD_TEST_CASE(TMXLargeTileDataTestNew);
+    ADD_TEST_CASE(TMXMapCacheTestNew);
 }
 
 TileDemoNew::TileDemoNew()
@@ -1379,3 +1382,179 @@ std::string TMXGIDObjectsTestNew::subtitle() const
 {
     return "Tiles are created from an object group";
 }
+
+//------------------------------------------------------------------
+//
+// TMXLargeTileDataTestNew
+//
+//------------------------------------------------------------------
+TMXLargeTileDataTestNew::TMXLargeTileDataTestNew()
+{
+    const int mapSize = 2048;
+    std::string tileDataPath = FileUtils::getInstance()->getWritablePath() + "large-map.tiles";
+
+    // 2048x2048 tiles, 16MB of gids: a diagonal stripe pattern with holes
+    if (!FileUtils::getInstance()->isFileExist(tileDataPath))
+    {
+        auto layerInfo = new (std::nothrow) TMXLayerInfo();
+        layerInfo->_layerSize = Size(mapSize, mapSize);
+        layerInfo->_tiles = (uint32_t*)malloc(mapSize * mapSize * sizeof(uint32_t));
+        for (int y = 0; y < mapSize; ++y)
+        {
+            for (int x = 0; x < mapSize; ++x)
+            {
+                int stripe = (x + y) / 8;
+                layerInfo->_tiles[x + y * mapSize] = (x % 16 == 0 && y % 16 == 0) ? 0 : 1 + stripe % 48;
+            }
+        }
+        bool CC_UNUSED saved = layerInfo->saveTileData(tileDataPath);
+        CCASSERT(saved, "Unable to write the tile data");
+        layerInfo->release();
+    }
+
+    // the layer has no data element, its gids come from the mapped tile data file
+    auto xml = StringUtils::format(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+        "<map version=\"1.0\" orientation=\"orthogonal\" width=\"%d\" height=\"%d\" tilewidth=\"32\" tileheight=\"32\">"
+        " <tileset firstgid=\"1\" name=\"tile 0\" tilewidth=\"32\" tileheight=\"32\" spacing=\"2\" margin=\"2\">"
+        "  <image source=\"fixed-ortho-test2.png\" width=\"640\" height=\"400\"/>"
+        " </tileset>"
+        " <layer name=\"Layer 0\" width=\"%d\" height=\"%d\">"
+        "  <properties>"
+        "   <property name=\"cc_tile_data\" value=\"%s\"/>"
+        "  </properties>"
+        " </layer>"
+        "</map>", mapSize, mapSize, mapSize, mapSize, tileDataPath.c_str());
+
+    auto map = cocos2d::experimental::TMXTiledMap::createWithXML(xml, "TileMaps");
+    addChild(map, 0, kTagTileMap);
+
+    auto layer = map->getLayer("Layer 0");
+    CCLOG("tile at 100,100: %d", layer->getTileGIDAt(Vec2(100, 100)));
+
+    // change a tile of the mapped file, the mapping is private so the file is not modified
+    layer->setTileGID(0, Vec2(mapSize - 1, mapSize - 2));
+
+    auto s = map->getContentSize();
+    auto action = MoveBy::create(60, Vec2(-(s.width - 480), s.height - 320));
+    map->setPosition(0, -(s.height - 320));
+    map->runAction(action);
+}
+
+std::string TMXLargeTileDataTestNew::title() const
+{
+    return "TMX large map from tile data";
+}
+
+std::string TMXLargeTileDataTestNew::subtitle() const
+{
+    return "2048x2048 mapped tiles, built in chunks";
+}
+
+//------------------------------------------------------------------
+//
+// TMXMapCacheTestNew
+//
+//------------------------------------------------------------------
+TMXMapCacheTestNew::TMXMapCacheTestNew()
+{
+    const int kRepeat = 10;
+    auto fileUtils = FileUtils::getInstance();
+
+    std::vector<std::string> files;
+    for (const auto& path : fileUtils->listFiles("TileMaps"))
+    {
+        if (path.size() > 4 && path.compare(path.size() - 4, 4, ".tmx") == 0)
+            files.push_back("TileMaps/" + path.substr(path.find_last_of('/') + 1));
+    }
+
+    auto loadAll = [&files](Vector<TMXMapInfo*>* maps) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& file : files)
+        {
+            auto mapInfo = TMXMapInfo::create(file);
+            if (maps && mapInfo)
+                maps->pushBack(mapInfo);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return elapsed.count();
+    };
+
+    std::string oldCacheDirectory = TMXMapInfo::getCacheDirectory();
+    std::string cacheDirectory = fileUtils->getWritablePath() + "tmx-cache/";
+    fileUtils->removeDirectory(cacheDirectory);
+
+    TMXMapInfo::setCacheDirectory("");
+    Vector<TMXMapInfo*> parsedMaps;
+    double parse = loadAll(&parsedMaps);
+    for (int i = 1; i < kRepeat; ++i)
+        parse += loadAll(nullptr);
+
+    TMXMapInfo::setCacheDirectory(cacheDirectory);
+    double save = loadAll(nullptr);
+    Vector<TMXMapInfo*> cachedMaps;
+    double cached = loadAll(&cachedMaps);
+    for (int i = 1; i < kRepeat; ++i)
+        cached += loadAll(nullptr);
+
+    TMXMapInfo::setCacheDirectory(oldCacheDirectory);
+
+    // the cached maps must have the same layers as the parsed ones
+    int mismatches = parsedMaps.size() == cachedMaps.size() ? 0 : 1;
+    for (ssize_t i = 0; i < parsedMaps.size() && i < cachedMaps.size(); ++i)
+    {
+        auto& parsedLayers = parsedMaps.at(i)->getLayers();
+        auto& cachedLayers = cachedMaps.at(i)->getLayers();
+        if (parsedLayers.size() != cachedLayers.size()
+            || parsedMaps.at(i)->getTilesets().size() != cachedMaps.at(i)->getTilesets().size()
+            || parsedMaps.at(i)->getObjectGroups().size() != cachedMaps.at(i)->getObjectGroups().size())
+        {
+            ++mismatches;
+            continue;
+        }
+        for (ssize_t j = 0; j < parsedLayers.size(); ++j)
+        {
+            auto parsed = parsedLayers.at(j);
+            auto cached = cachedLayers.at(j);
+            size_t tilesSize = (size_t)(parsed->_layerSize.width * parsed->_layerSize.height) * sizeof(uint32_t);
+            if (parsed->_name != cached->_name || parsed->_layerSize.equals(cached->_layerSize) == false
+                || (parsed->_tiles && (!cached->_tiles || memcmp(parsed->_tiles, cached->_tiles, tilesSize) != 0)))
+            {
+                CCLOG("TMX cache: layer '%s' differs", parsed->_name.c_str());
+                ++mismatches;
+            }
+        }
+    }
+
+    // dragged like the maps of the other tests
+    auto results = Node::create();
+    addChild(results, 0, kTagTileMap);
+
+    auto s = Director::getInstance()->getWinSize();
+    std::string lines[] = {
+        StringUtils::format("%d maps loaded %d times", (int)files.size(), kRepeat),
+        StringUtils::format("parse: %.2f ms per pass", parse / kRepeat),
+        StringUtils::format("parse and save cache: %.2f ms", save),
+        StringUtils::format("load cache: %.2f ms per pass", cached / kRepeat),
+        StringUtils::format("%d mismatches", mismatches),
+    };
+    float y = s.height / 2 + 40;
+    for (const auto& line : lines)
+    {
+        CCLOG("TMX cache: %s", line.c_str());
+        auto label = Label::createWithSystemFont(line, "Helvetica", 14);
+        label->setPosition(s.width / 2, y);
+        results->addChild(label);
+        y -= 20;
+    }
+}
+
+std::string TMXMapCacheTestNew::title() const
+{
+    return "TMX map cache";
+}
+
+std::string TMXMapCacheTestNew::subtitle() const
+{
+    return "Loads every map of TileMaps parsed and cached";
+}
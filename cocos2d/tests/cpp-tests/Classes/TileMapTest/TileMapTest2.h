@@ -334,4 +334,22 @@ public:
     virtual std::string subtitle() const override;   
 };
 
+class TMXLargeTileDataTestNew : public TileDemoNew
+{
+public:
+    CREATE_FUNC(TMXLargeTileDataTestNew);
+    TMXLargeTileDataTestNew();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class TMXMapCacheTestNew : public TileDemoNew
+{
+public:
+    CREATE_FUNC(TMXMapCacheTestNew);
+    TMXMapCacheTestNew();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif
@@ -28,6 +28,7 @@
 #include <vector>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
 
 using namespace std;
 
@@ -40,6 +41,7 @@ USING_NS_CC;
 UserDefaultTests::UserDefaultTests()
 {
     ADD_TEST_CASE(UserDefaultTest);
+    ADD_TEST_CASE(UserDefaultReloadTest);
 }
 
 UserDefaultTest::UserDefaultTest()
@@ -200,4 +202,35 @@ UserDefaultTest::~UserDefaultTest()
 {
 }
 
+UserDefaultReloadTest::UserDefaultReloadTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // the setters only update memory, the file is written in the background
+    const int writeCount = 1000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < writeCount; i++)
+    {
+        UserDefault::getInstance()->setIntegerForKey("reload_integer", i);
+    }
+    auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
 
+    UserDefault::getInstance()->setStringForKey("reload_string", "<value & value>");
+    UserDefault::getInstance()->setBoolForKey("reload_bool", true);
+    UserDefault::getInstance()->flush();
+
+    // a new instance reads the file again
+    UserDefault::destroyInstance();
+    bool ok = UserDefault::getInstance()->getIntegerForKey("reload_integer") == writeCount - 1
+        && UserDefault::getInstance()->getStringForKey("reload_string") == "<value & value>"
+        && UserDefault::getInstance()->getBoolForKey("reload_bool");
+
+    UserDefault::getInstance()->deleteValueForKey("reload_integer");
+    UserDefault::getInstance()->deleteValueForKey("reload_string");
+    UserDefault::getInstance()->deleteValueForKey("reload_bool");
+    UserDefault::getInstance()->flush();
+
+    auto label = Label::createWithTTF(StringUtils::format("%d writes took %.2fms\nreloaded values: %s", writeCount, elapsed, ok ? "OK" : "FAILED"), "fonts/arial.ttf", 20);
+    label->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(label);
+}
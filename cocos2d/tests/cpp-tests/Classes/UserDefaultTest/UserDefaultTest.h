@@ -44,4 +44,14 @@ private:
     cocos2d::Label* _label;
 };
 
+class UserDefaultReloadTest : public TestCase
+{
+public:
+    CREATE_FUNC(UserDefaultReloadTest);
+    UserDefaultReloadTest();
+
+    virtual std::string title() const override { return "UserDefault reload"; }
+    virtual std::string subtitle() const override { return "Values must survive flush() and a new instance"; }
+};
+
 #endif // _USERDEFAULT_TEST_H_
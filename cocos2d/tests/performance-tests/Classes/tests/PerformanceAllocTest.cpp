@@ -64,6 +64,7 @@ PerformceAllocTests::PerformceAllocTests()
 {
     ADD_TEST_CASE(NodeCreateTest);
     ADD_TEST_CASE(NodeDeallocTest);
+    ADD_TEST_CASE(NodeRetainReleaseTest);
     ADD_TEST_CASE(SpriteCreateEmptyTest);
     ADD_TEST_CASE(SpriteCreateTest);
     ADD_TEST_CASE(SpriteDeallocTest);
@@ -356,6 +357,63 @@ const char*  NodeDeallocTest::testName()
     return "Node::~Node()";
 }
 
+////////////////////////////////////////////////////////
+//
+// NodeRetainReleaseTest
+//
+////////////////////////////////////////////////////////
+void NodeRetainReleaseTest::updateQuantityOfNodes()
+{
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void NodeRetainReleaseTest::initWithQuantityOfNodes(unsigned int nNodes)
+{
+    PerformceAllocScene::initWithQuantityOfNodes(nNodes);
+
+    log("Atomic reference count: %s\n", CC_ENABLE_ATOMIC_REFERENCE_COUNT ? "enabled" : "disabled");
+
+    scheduleUpdate();
+}
+
+void NodeRetainReleaseTest::update(float dt)
+{
+    // iterate using fast enumeration protocol
+
+    Node **nodes = new (std::nothrow) Node*[quantityOfNodes];
+
+    for( int i=0; i<quantityOfNodes; ++i)
+        nodes[i] = Node::create();
+
+    // retain/release pairs only, the nodes are released by the autorelease pool
+    CC_PROFILER_START(this->profilerName());
+    for( int j=0; j<10; ++j)
+    {
+        for( int i=0; i<quantityOfNodes; ++i)
+            nodes[i]->retain();
+        for( int i=0; i<quantityOfNodes; ++i)
+            nodes[i]->release();
+    }
+    CC_PROFILER_STOP(this->profilerName());
+
+    delete [] nodes;
+}
+
+std::string NodeRetainReleaseTest::title() const
+{
+    return "Node Retain/Release Perf test.";
+}
+
+std::string NodeRetainReleaseTest::subtitle() const
+{
+    return CC_ENABLE_ATOMIC_REFERENCE_COUNT ? "10 pairs per node, atomic. See console" : "10 pairs per node, non atomic. See console";
+}
+
+const char*  NodeRetainReleaseTest::testName()
+{
+    return "Ref::retain()/release()";
+}
+
 ////////////////////////////////////////////////////////
 //
 // SpriteCreateEmptyTest
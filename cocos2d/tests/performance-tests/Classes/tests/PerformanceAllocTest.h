@@ -94,6 +94,20 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class NodeRetainReleaseTest : public PerformceAllocScene
+{
+public:
+    CREATE_FUNC(NodeRetainReleaseTest);
+
+    virtual void updateQuantityOfNodes() override;
+    virtual void initWithQuantityOfNodes(unsigned int nNodes) override;
+    virtual void update(float dt) override;
+    virtual const char* testName() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 class SpriteCreateEmptyTest : public PerformceAllocScene
 {
 public:
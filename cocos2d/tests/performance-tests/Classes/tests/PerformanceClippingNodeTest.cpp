@@ -0,0 +1,373 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "PerformanceClippingNodeTest.h"
+#include "Profile.h"
+
+USING_NS_CC;
+
+#define DELAY_TIME              1
+#define STAT_TIME               3
+
+enum {
+    kMaxNodes = 400,
+    kInitNodeCount = 100,
+    kNodesIncrease = 20,
+    kSpritesPerNode = 4,
+};
+
+enum {
+    kTagInfoLayer = 1,
+};
+
+enum {
+    kCaseRectSprites = 0,
+    kCaseCircleSprites,
+    kCaseRectLabels,
+
+    kCaseCount
+};
+
+static int _curTestCase = kCaseRectSprites;
+
+// every node count is measured with the stencil buffer, then with the fast paths
+static const struct {
+    int nodeCount;
+    bool fastClipping;
+} _autoTestConfigs[] = {
+    { 50, false }, { 50, true },
+    { 200, false }, { 200, true },
+};
+
+PerformceClippingNodeTests::PerformceClippingNodeTests()
+{
+    _curTestCase = kCaseRectSprites;
+    addTestCase("ClippingNode rect stencil with sprites", [](){ return ClippingNodeMainScene::create(); });
+    addTestCase("ClippingNode circle stencil with sprites", [](){ return ClippingNodeMainScene::create(); });
+    addTestCase("ClippingNode rect stencil with labels", [](){ return ClippingNodeMainScene::create(); });
+}
+
+////////////////////////////////////////////////////////
+//
+// ClippingNodeMainScene
+//
+////////////////////////////////////////////////////////
+bool ClippingNodeMainScene::init()
+{
+    if (!TestCase::init())
+    {
+        return false;
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _quantityNodes = kInitNodeCount;
+    _fastClippingEnabled = true;
+    _accumulativeTime = 0.0f;
+    isStating = false;
+
+    _clippingNodes = Node::create();
+    addChild(_clippingNodes);
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", CC_CALLBACK_1(ClippingNodeMainScene::onDecrease, this));
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", CC_CALLBACK_1(ClippingNodeMainScene::onIncrease, this));
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, nullptr);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height-65));
+    addChild(menu, 1);
+
+    MenuItemFont::setFontSize(24);
+    _fastClippingToggle = MenuItemToggle::createWithCallback(CC_CALLBACK_1(ClippingNodeMainScene::onToggleFastClipping, this),
+                                                             MenuItemFont::create("fast clipping: on"),
+                                                             MenuItemFont::create("fast clipping: off"),
+                                                             nullptr);
+    _fastClippingToggle->setColor(Color3B(0,200,20));
+    auto toggleMenu = Menu::create(_fastClippingToggle, nullptr);
+    toggleMenu->setPosition(Vec2(s.width/2, 60));
+    addChild(toggleMenu, 1);
+
+    auto infoLabel = Label::createWithTTF("0 nodes", "fonts/Marker Felt.ttf", 30);
+    infoLabel->setColor(Color3B(0,200,20));
+    infoLabel->setPosition(Vec2(s.width/2, s.height-90));
+    addChild(infoLabel, 1, kTagInfoLayer);
+
+    updateNodes();
+
+    return true;
+}
+
+std::string ClippingNodeMainScene::title() const
+{
+    switch (_curTestCase)
+    {
+    case kCaseRectSprites:
+        return "Testing ClippingNode Rect Stencil";
+    case kCaseCircleSprites:
+        return "Testing ClippingNode Circle Stencil";
+    case kCaseRectLabels:
+        return "Testing ClippingNode Rect Stencil Labels";
+    default:
+        break;
+    }
+    return "No title";
+}
+
+std::string ClippingNodeMainScene::subtitle() const
+{
+    if (_curTestCase == kCaseRectLabels)
+        return "The fast path clips with the scissor test";
+    return "The fast path cuts the triangles of the sprites";
+}
+
+ClippingNode* ClippingNodeMainScene::createClippingNode(int index)
+{
+    // lay the clipping nodes out on a grid, their content moves across the stencil edges
+    auto s = Director::getInstance()->getWinSize();
+    const int columns = 20;
+    float cellWidth = s.width / columns;
+    float cellHeight = s.height / (kMaxNodes / columns);
+    float size = MIN(cellWidth, cellHeight) * 0.8f;
+
+    Node* stencil = nullptr;
+    if (_curTestCase == kCaseCircleSprites)
+    {
+        auto drawNode = DrawNode::create();
+        drawNode->drawSolidCircle(Vec2::ZERO, size / 2, 0, 24, Color4F::WHITE);
+        stencil = drawNode;
+    }
+    else
+    {
+        auto drawNode = DrawNode::create();
+        drawNode->drawSolidRect(Vec2(-size / 2, -size / 2), Vec2(size / 2, size / 2), Color4F::WHITE);
+        stencil = drawNode;
+    }
+
+    auto clippingNode = ClippingNode::create(stencil);
+    clippingNode->setFastClippingEnabled(_fastClippingEnabled);
+    clippingNode->setPosition(Vec2((index % columns + 0.5f) * cellWidth, (index / columns + 0.5f) * cellHeight));
+
+    for (int i = 0; i < kSpritesPerNode; i++)
+    {
+        Node* content = nullptr;
+        if (_curTestCase == kCaseRectLabels)
+        {
+            auto label = Label::createWithTTF("clip", "fonts/arial.ttf", size / 3);
+            content = label;
+        }
+        else
+        {
+            auto sprite = Sprite::create("Images/grossini.png");
+            sprite->setScale(size / sprite->getContentSize().height);
+            content = sprite;
+        }
+        content->setTag(i);
+        clippingNode->addChild(content);
+    }
+
+    return clippingNode;
+}
+
+void ClippingNodeMainScene::updateNodes()
+{
+    auto infoLabel = (Label *) getChildByTag(kTagInfoLayer);
+    char str[32] = {0};
+    sprintf(str, "%d nodes", _quantityNodes);
+    infoLabel->setString(str);
+
+    _clippingNodes->removeAllChildren();
+    for (int i = 0; i < _quantityNodes; i++)
+    {
+        _clippingNodes->addChild(createClippingNode(i));
+    }
+}
+
+void ClippingNodeMainScene::onIncrease(Ref* sender)
+{
+    if( _quantityNodes >= kMaxNodes)
+        return;
+
+    _quantityNodes += kNodesIncrease;
+    updateNodes();
+}
+
+void ClippingNodeMainScene::onDecrease(Ref* sender)
+{
+    if( _quantityNodes <= kNodesIncrease )
+        return;
+
+    _quantityNodes -= kNodesIncrease;
+    updateNodes();
+}
+
+void ClippingNodeMainScene::onToggleFastClipping(Ref* sender)
+{
+    _fastClippingEnabled = _fastClippingToggle->getSelectedIndex() == 0;
+    for (const auto& child : _clippingNodes->getChildren())
+    {
+        static_cast<ClippingNode*>(child)->setFastClippingEnabled(_fastClippingEnabled);
+    }
+}
+
+void ClippingNodeMainScene::update(float dt)
+{
+    if (isStating)
+    {
+        totalStatTime += dt;
+        statCount++;
+        totalDrawnBatches += Director::getInstance()->getRenderer()->getDrawnBatches();
+
+        auto curFrameRate = Director::getInstance()->getFrameRate();
+        if (maxFrameRate < 0 || curFrameRate > maxFrameRate)
+            maxFrameRate = curFrameRate;
+
+        if (minFrameRate < 0 || curFrameRate < minFrameRate)
+            minFrameRate = curFrameRate;
+    }
+
+    _accumulativeTime += dt;
+    for (const auto& clippingNode : _clippingNodes->getChildren())
+    {
+        float size = clippingNode->getChildren().front()->getBoundingBox().size.height;
+        for (const auto& child : clippingNode->getChildren())
+        {
+            float angle = _accumulativeTime + child->getTag() * (float)M_PI_2;
+            child->setPosition(Vec2(cosf(angle), sinf(angle)) * size * 0.4f);
+        }
+    }
+}
+
+void ClippingNodeMainScene::onEnter()
+{
+    Scene::onEnter();
+
+    scheduleUpdate();
+
+    if (this->isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("ClippingNodeTest",
+                                              genStrVector("Type", "NodeCount", "FastClipping", nullptr),
+                                              genStrVector("Avg", "Min", "Max", "DrawCalls", nullptr));
+        autoTestIndex = 0;
+        doAutoTest();
+    }
+}
+
+void ClippingNodeMainScene::onExit()
+{
+    auto director = Director::getInstance();
+    auto sched = director->getScheduler();
+    sched->unscheduleAllForTarget(this);
+
+    Scene::onExit();
+}
+
+void ClippingNodeMainScene::doAutoTest()
+{
+    isStating = false;
+    statCount = 0;
+    totalStatTime = 0.0f;
+    minFrameRate = -1.0f;
+    maxFrameRate = -1.0f;
+    totalDrawnBatches = 0;
+
+    _quantityNodes = _autoTestConfigs[autoTestIndex].nodeCount;
+    _fastClippingToggle->setSelectedIndex(_autoTestConfigs[autoTestIndex].fastClipping ? 0 : 1);
+    _fastClippingEnabled = _autoTestConfigs[autoTestIndex].fastClipping;
+    updateNodes();
+
+    schedule(CC_SCHEDULE_SELECTOR(ClippingNodeMainScene::beginStat), DELAY_TIME);
+    schedule(CC_SCHEDULE_SELECTOR(ClippingNodeMainScene::endStat), DELAY_TIME + STAT_TIME);
+}
+
+void ClippingNodeMainScene::beginStat(float dt)
+{
+    unschedule(CC_SCHEDULE_SELECTOR(ClippingNodeMainScene::beginStat));
+    isStating = true;
+}
+
+void ClippingNodeMainScene::endStat(float dt)
+{
+    unschedule(CC_SCHEDULE_SELECTOR(ClippingNodeMainScene::endStat));
+    isStating = false;
+
+    // record test data
+    std::string tf;
+    switch (_curTestCase)
+    {
+        case kCaseRectSprites:
+            tf = "RectSprites";
+            break;
+        case kCaseCircleSprites:
+            tf = "CircleSprites";
+            break;
+        case kCaseRectLabels:
+            tf = "RectLabels";
+            break;
+        default:
+            tf = "unknown";
+            break;
+    }
+    auto avgStr = genStr("%.2f", (float) statCount / totalStatTime);
+    auto drawCallsStr = genStr("%d", statCount > 0 ? (int)(totalDrawnBatches / statCount) : 0);
+    Profile::getInstance()->addTestResult(genStrVector(tf.c_str(), genStr("%d", _quantityNodes).c_str(),
+                                                       _fastClippingEnabled ? "on" : "off", nullptr),
+                                          genStrVector(avgStr.c_str(), genStr("%.2f", minFrameRate).c_str(),
+                                                       genStr("%.2f", maxFrameRate).c_str(), drawCallsStr.c_str(), nullptr));
+
+    // check the auto test is end or not
+    int autoTestCount = sizeof(_autoTestConfigs) / sizeof(_autoTestConfigs[0]);
+    if (autoTestIndex >= (autoTestCount - 1))
+    {
+        // auto test end
+        Profile::getInstance()->testCaseEnd();
+        _curTestCase++;
+        setAutoTesting(false);
+        return;
+    }
+
+    autoTestIndex++;
+    doAutoTest();
+}
+
+void ClippingNodeMainScene::nextTestCallback(cocos2d::Ref* sender)
+{
+    _curTestCase = (_curTestCase + 1) % kCaseCount;
+    TestCase::nextTestCallback(sender);
+}
+
+void ClippingNodeMainScene::priorTestCallback(cocos2d::Ref* sender)
+{
+    if (_curTestCase > 0)
+    {
+        _curTestCase -= 1;
+    }
+    else
+    {
+        _curTestCase = kCaseCount - 1;
+    }
+    TestCase::priorTestCallback(sender);
+}
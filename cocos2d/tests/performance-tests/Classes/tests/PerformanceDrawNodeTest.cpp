@@ -0,0 +1,362 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "PerformanceDrawNodeTest.h"
+#include "Profile.h"
+
+USING_NS_CC;
+
+#define DELAY_TIME              1
+#define STAT_TIME               3
+
+enum {
+    kMaxPrimitives = 20000,
+    kInitPrimitiveCount = 10000,
+    kPrimitivesIncrease = 1000,
+    // primitives kept by the static layer case, only the rest is redrawn every frame
+    kStaticPrimitives = 9000,
+};
+
+enum {
+    kTagInfoLayer = 1,
+};
+
+enum {
+    kCaseSolidCircles = 0,
+    kCaseSegments,
+    kCaseDots,
+    kCaseLines,
+    kCaseCircles,
+    kCaseStaticLayer,
+
+    kCaseCount
+};
+
+static int _curTestCase = kCaseSolidCircles;
+static int _autoTestPrimitiveCounts[] = {
+    5000, 10000
+};
+
+PerformceDrawNodeTests::PerformceDrawNodeTests()
+{
+    _curTestCase = kCaseSolidCircles;
+    addTestCase("DrawNode solid circles", [](){ return DrawNodeMainScene::create(); });
+    addTestCase("DrawNode segments", [](){ return DrawNodeMainScene::create(); });
+    addTestCase("DrawNode dots", [](){ return DrawNodeMainScene::create(); });
+    addTestCase("DrawNode lines", [](){ return DrawNodeMainScene::create(); });
+    addTestCase("DrawNode circles", [](){ return DrawNodeMainScene::create(); });
+    addTestCase("DrawNode static layer", [](){ return DrawNodeMainScene::create(); });
+}
+
+////////////////////////////////////////////////////////
+//
+// DrawNodeMainScene
+//
+////////////////////////////////////////////////////////
+bool DrawNodeMainScene::init()
+{
+    if (!TestCase::init())
+    {
+        return false;
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _lastRenderedCount = 0;
+    _quantityPrimitives = kInitPrimitiveCount;
+    _accumulativeTime = 0.0f;
+    isStating = false;
+
+    _drawNode = DrawNode::create();
+    addChild(_drawNode);
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", CC_CALLBACK_1(DrawNodeMainScene::onDecrease, this));
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", CC_CALLBACK_1(DrawNodeMainScene::onIncrease, this));
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, nullptr);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height-65));
+    addChild(menu, 1);
+
+    auto infoLabel = Label::createWithTTF("0 primitives", "fonts/Marker Felt.ttf", 30);
+    infoLabel->setColor(Color3B(0,200,20));
+    infoLabel->setPosition(Vec2(s.width/2, s.height-90));
+    addChild(infoLabel, 1, kTagInfoLayer);
+
+    updateNodes();
+
+    return true;
+}
+
+std::string DrawNodeMainScene::title() const
+{
+    switch (_curTestCase)
+    {
+    case kCaseSolidCircles:
+        return "Testing DrawNode Solid Circles";
+    case kCaseSegments:
+        return "Testing DrawNode Segments";
+    case kCaseDots:
+        return "Testing DrawNode Dots";
+    case kCaseLines:
+        return "Testing DrawNode Lines";
+    case kCaseCircles:
+        return "Testing DrawNode Circles";
+    case kCaseStaticLayer:
+        return "Testing DrawNode Static Layer";
+    default:
+        break;
+    }
+    return "No title";
+}
+
+std::string DrawNodeMainScene::subtitle() const
+{
+    if (_curTestCase == kCaseStaticLayer)
+        return "Most solid circles are frozen, the rest is redrawn every frame";
+    return "All the primitives are cleared and redrawn every frame";
+}
+
+void DrawNodeMainScene::updateNodes()
+{
+    if( _quantityPrimitives != _lastRenderedCount )
+    {
+        auto infoLabel = (Label *) getChildByTag(kTagInfoLayer);
+        char str[32] = {0};
+        sprintf(str, "%d primitives", _quantityPrimitives);
+        infoLabel->setString(str);
+
+        _lastRenderedCount = _quantityPrimitives;
+    }
+
+    _drawNode->clearStaticLayer();
+    if (_curTestCase == kCaseStaticLayer)
+    {
+        int staticCount = MIN(kStaticPrimitives, _quantityPrimitives);
+        for (int i = 0; i < staticCount; i++)
+            drawPrimitive(i, 0.0f);
+        _drawNode->freezeStaticLayer();
+    }
+}
+
+void DrawNodeMainScene::onIncrease(Ref* sender)
+{
+    if( _quantityPrimitives >= kMaxPrimitives)
+        return;
+
+    _quantityPrimitives += kPrimitivesIncrease;
+    updateNodes();
+}
+
+void DrawNodeMainScene::onDecrease(Ref* sender)
+{
+    if( _quantityPrimitives <= kPrimitivesIncrease )
+        return;
+
+    _quantityPrimitives -= kPrimitivesIncrease;
+    updateNodes();
+}
+
+void DrawNodeMainScene::drawPrimitive(int index, float offset)
+{
+    static const Color4F colors[] = {
+        Color4F::RED, Color4F::GREEN, Color4F::BLUE, Color4F::YELLOW, Color4F::MAGENTA, Color4F::ORANGE,
+    };
+
+    // lay the primitives out on a grid, the offset makes them move
+    auto s = Director::getInstance()->getWinSize();
+    const int columns = 125;
+    float cellWidth = s.width / columns;
+    float cellHeight = s.height / (kMaxPrimitives / columns);
+    Vec2 pos((index % columns + 0.5f) * cellWidth + offset, (index / columns + 0.5f) * cellHeight);
+    const Color4F& color = colors[index % (sizeof(colors) / sizeof(colors[0]))];
+
+    switch (_curTestCase)
+    {
+    case kCaseSolidCircles:
+    case kCaseStaticLayer:
+        _drawNode->drawSolidCircle(pos, cellWidth / 2, offset, 12, color);
+        break;
+    case kCaseSegments:
+        _drawNode->drawSegment(pos, pos + Vec2(cellWidth, cellHeight), 1.5f, color);
+        break;
+    case kCaseDots:
+        _drawNode->drawDot(pos, cellWidth / 2, color);
+        break;
+    case kCaseLines:
+        _drawNode->drawLine(pos, pos + Vec2(cellWidth, cellHeight), color);
+        break;
+    case kCaseCircles:
+        _drawNode->drawCircle(pos, cellWidth / 2, offset, 12, false, color);
+        break;
+    default:
+        break;
+    }
+}
+
+void DrawNodeMainScene::redraw(float dt)
+{
+    if (isStating)
+    {
+        totalStatTime += dt;
+        statCount++;
+
+        auto curFrameRate = Director::getInstance()->getFrameRate();
+        if (maxFrameRate < 0 || curFrameRate > maxFrameRate)
+            maxFrameRate = curFrameRate;
+
+        if (minFrameRate < 0 || curFrameRate < minFrameRate)
+            minFrameRate = curFrameRate;
+    }
+
+    _accumulativeTime += dt;
+    float offset = sinf(_accumulativeTime * 2.0f) * 4.0f;
+
+    _drawNode->clear();
+    int first = _drawNode->hasStaticLayer() ? MIN(kStaticPrimitives, _quantityPrimitives) : 0;
+    for (int i = first; i < _quantityPrimitives; i++)
+    {
+        drawPrimitive(i, offset);
+    }
+}
+
+void DrawNodeMainScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto director = Director::getInstance();
+    auto sched = director->getScheduler();
+    sched->schedule(CC_SCHEDULE_SELECTOR(DrawNodeMainScene::redraw), this, 0.0f, false);
+
+    if (this->isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("DrawNodeTest",
+                                              genStrVector("Type", "PrimitiveCount", nullptr),
+                                              genStrVector("Avg", "Min", "Max", nullptr));
+        autoTestIndex = 0;
+        doAutoTest();
+    }
+}
+
+void DrawNodeMainScene::onExit()
+{
+    auto director = Director::getInstance();
+    auto sched = director->getScheduler();
+    sched->unscheduleAllForTarget(this);
+
+    Scene::onExit();
+}
+
+void DrawNodeMainScene::doAutoTest()
+{
+    isStating = false;
+    statCount = 0;
+    totalStatTime = 0.0f;
+    minFrameRate = -1.0f;
+    maxFrameRate = -1.0f;
+
+    _quantityPrimitives = _autoTestPrimitiveCounts[autoTestIndex];
+    updateNodes();
+
+    schedule(CC_SCHEDULE_SELECTOR(DrawNodeMainScene::beginStat), DELAY_TIME);
+    schedule(CC_SCHEDULE_SELECTOR(DrawNodeMainScene::endStat), DELAY_TIME + STAT_TIME);
+}
+
+void DrawNodeMainScene::beginStat(float dt)
+{
+    unschedule(CC_SCHEDULE_SELECTOR(DrawNodeMainScene::beginStat));
+    isStating = true;
+}
+
+void DrawNodeMainScene::endStat(float dt)
+{
+    unschedule(CC_SCHEDULE_SELECTOR(DrawNodeMainScene::endStat));
+    isStating = false;
+
+    // record test data
+    std::string tf;
+    switch (_curTestCase)
+    {
+        case kCaseSolidCircles:
+            tf = "SolidCircles";
+            break;
+        case kCaseSegments:
+            tf = "Segments";
+            break;
+        case kCaseDots:
+            tf = "Dots";
+            break;
+        case kCaseLines:
+            tf = "Lines";
+            break;
+        case kCaseCircles:
+            tf = "Circles";
+            break;
+        case kCaseStaticLayer:
+            tf = "StaticLayer";
+            break;
+        default:
+            tf = "unknown";
+            break;
+    }
+    auto avgStr = genStr("%.2f", (float) statCount / totalStatTime);
+    Profile::getInstance()->addTestResult(genStrVector(tf.c_str(), genStr("%d", _quantityPrimitives).c_str(), nullptr),
+                                          genStrVector(avgStr.c_str(), genStr("%.2f", minFrameRate).c_str(),
+                                                       genStr("%.2f", maxFrameRate).c_str(), nullptr));
+
+    // check the auto test is end or not
+    int autoTestCount = sizeof(_autoTestPrimitiveCounts) / sizeof(int);
+    if (autoTestIndex >= (autoTestCount - 1))
+    {
+        // auto test end
+        Profile::getInstance()->testCaseEnd();
+        _curTestCase++;
+        setAutoTesting(false);
+        return;
+    }
+
+    autoTestIndex++;
+    doAutoTest();
+}
+
+void DrawNodeMainScene::nextTestCallback(cocos2d::Ref* sender)
+{
+    _curTestCase = (_curTestCase + 1) % kCaseCount;
+    TestCase::nextTestCallback(sender);
+}
+
+void DrawNodeMainScene::priorTestCallback(cocos2d::Ref* sender)
+{
+    if (_curTestCase > 0)
+    {
+        _curTestCase -= 1;
+    }
+    else
+    {
+        _curTestCase = kCaseCount - 1;
+    }
+    TestCase::priorTestCallback(sender);
+}
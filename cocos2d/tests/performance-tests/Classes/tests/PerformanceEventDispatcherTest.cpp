@@ -284,6 +284,8 @@ void PerformanceEventDispatcherScene::reset()
         Director::getInstance()->getEventDispatcher()->removeEventListener(listener);
     }
     
+    Director::getInstance()->getEventDispatcher()->setTouchSpatialIndexEnabled(false);
+    
     this->_lastRenderedCount = 0;
 }
 
@@ -431,6 +433,60 @@ void TouchEventDispatchingPerfTest::generateTestFunctions()
             CC_PROFILER_STOP(this->profilerName());
         } } ,
         
+        { "OneByOne-spatialindex",    [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            if (quantityOfNodes != _lastRenderedCount)
+            {
+                dispatcher->setTouchSpatialIndexEnabled(true);
+                
+                auto listener = EventListenerTouchOneByOne::create();
+                listener->onTouchBegan = [](Touch* touch, Event* event){
+                    return false;
+                };
+                
+                listener->onTouchMoved = [](Touch* touch, Event* event){};
+                listener->onTouchEnded = [](Touch* touch, Event* event){};
+                listener->setBoundsCheckEnabled(true);
+                
+                // Create new touchable nodes spread over the screen
+                Size size = Director::getInstance()->getWinSize();
+                for (int i = 0; i < this->quantityOfNodes; ++i)
+                {
+                    auto node = Node::create();
+                    node->setTag(1000 + i);
+                    node->setContentSize(Size(40, 40));
+                    node->setPosition(rand() % (int)size.width, rand() % (int)size.height);
+                    this->addChild(node);
+                    this->_nodes.push_back(node);
+                    dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+                }
+                
+                _lastRenderedCount = quantityOfNodes;
+            }
+            
+            Size size = Director::getInstance()->getWinSize();
+            EventTouch touchEvent;
+            touchEvent.setEventCode(EventTouch::EventCode::BEGAN);
+            std::vector<Touch*> touches;
+            
+            for (int i = 0; i < 4; ++i)
+            {
+                Touch* touch = new (std::nothrow) Touch();
+                touch->autorelease();
+                touch->setTouchInfo(i, rand() % (int)size.width, rand() % (int)size.height);
+                touches.push_back(touch);
+            }
+            touchEvent.setTouches(touches);
+            
+            CC_PROFILER_START(this->profilerName());
+            dispatcher->dispatchEvent(&touchEvent);
+            CC_PROFILER_STOP(this->profilerName());
+            
+            auto index = dispatcher->getTouchSpatialIndex();
+            _subtitleLabel->setString(StringUtils::format("%d of %d nodes tested for the last touch",
+                                                          (int)index->getLastCandidatesTested(), (int)index->getNodeCount()));
+        } } ,
+        
         { "OneByOne-fixed",    [=](){
             auto dispatcher = Director::getInstance()->getEventDispatcher();
             if (quantityOfNodes != _lastRenderedCount)
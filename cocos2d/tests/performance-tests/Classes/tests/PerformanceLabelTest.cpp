@@ -47,6 +47,7 @@ enum {
     kCaseLabelTTFUpdate = 0,
     kCaseLabelBMFontUpdate,
     kCaseLabelUpdate,
+    kCaseLabelCounterUpdate,
     kCaseLabelBMFontBigLabels,
     kCaseLabelBigLabels,
     
@@ -68,6 +69,7 @@ PerformceLabelTests::PerformceLabelTests()
     addTestCase("LabelTTF Performance Test", [](){ return LabelMainScene::create(); });
     addTestCase("LabelBMFont Performance Test", [](){ return LabelMainScene::create(); });
     addTestCase("Label Performance Test", [](){ return LabelMainScene::create(); });
+    addTestCase("Label counter Performance Test", [](){ return LabelMainScene::create(); });
     addTestCase("LabelBMFont large text Performance", [](){ return LabelMainScene::create(); });
     addTestCase("Label large text Performance", [](){ return LabelMainScene::create(); });
 }
@@ -126,6 +128,8 @@ std::string LabelMainScene::title() const
         return "Testing LabelBMFont Update";
     case kCaseLabelUpdate:
         return "Testing Label Update";
+    case kCaseLabelCounterUpdate:
+        return "Testing Label Counter Update";
     case kCaseLabelBMFontBigLabels:
         return "Testing LabelBMFont Big Labels";
     case kCaseLabelBigLabels:
@@ -195,6 +199,21 @@ void LabelMainScene::onIncrease(Ref* sender)
             }
             break;
         }        
+    case kCaseLabelCounterUpdate:
+        {
+            // a score: the prefix never changes and only the last digits do most of the time
+            TTFConfig ttfConfig("fonts/arial.ttf", 30, GlyphCollection::DYNAMIC);
+            for( int i=0;i< kNodesIncrease;i++)
+            {
+                auto label = Label::createWithTTF(ttfConfig, "Score: 0", TextHAlignment::LEFT);
+                label->setAnchorPoint(Vec2::ANCHOR_MIDDLE_LEFT);
+                label->setPosition(Vec2((size.width/3 + rand() % 50), ((int)size.height/2 + rand() % 50)));
+                _labelContainer->addChild(label, 1, _quantityNodes);
+
+                _quantityNodes++;
+            }
+            break;
+        }
     case kCaseLabelBMFontBigLabels:
         for( int i=0;i< kNodesIncrease;i++)
         {
@@ -254,12 +273,15 @@ void LabelMainScene::updateText(float dt)
             minFrameRate = curFrameRate;
     }
 
-    if(_curTestCase > kCaseLabelUpdate)
+    if(_curTestCase > kCaseLabelCounterUpdate)
         return;
 
     _accumulativeTime += dt;
-    char text[20];
-    sprintf(text,"%.2f",_accumulativeTime);
+    char text[32];
+    if (_curTestCase == kCaseLabelCounterUpdate)
+        sprintf(text, "Score: %d", (int)(_accumulativeTime * 1000));
+    else
+        sprintf(text,"%.2f",_accumulativeTime);
 
     auto& children = _labelContainer->getChildren();
     switch (_curTestCase)
@@ -277,6 +299,7 @@ void LabelMainScene::updateText(float dt)
         }
         break;
     case kCaseLabelUpdate:
+    case kCaseLabelCounterUpdate:
         for(const auto &child : children) {
             Label* label = (Label*)child;
             label->setString(text);
@@ -359,6 +382,9 @@ void LabelMainScene::endStat(float dt)
         case kCaseLabelUpdate:
             tf = "Label";
             break;
+        case kCaseLabelCounterUpdate:
+            tf = "Label Counter";
+            break;
         case kCaseLabelBMFontBigLabels:
             tf = "LabelBMFont Big Labels";
             break;
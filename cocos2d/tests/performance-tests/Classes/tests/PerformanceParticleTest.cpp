@@ -25,6 +25,8 @@
 #include "PerformanceParticleTest.h"
 #include "Profile.h"
 
+#include <thread>
+
 USING_NS_CC;
 
 #define MAX_SUB_TEST_NUM        3
@@ -60,6 +62,8 @@ PerformceParticleTests::PerformceParticleTests()
     ADD_TEST_CASE(ParticlePerformTest2);
     ADD_TEST_CASE(ParticlePerformTest3);
     ADD_TEST_CASE(ParticlePerformTest4);
+    ADD_TEST_CASE(ParticleSimulationPerformTest);
+    ADD_TEST_CASE(ParticleKernelsPerformTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -522,3 +526,358 @@ void ParticlePerformTest4::initWithSubTest(int subtest, int particles)
     particleSize = 64;
     ParticleMainScene::initWithSubTest(subtest, particles);
 }
+
+////////////////////////////////////////////////////////
+//
+// ParticleSimulationPerformTest
+//
+////////////////////////////////////////////////////////
+namespace
+{
+    // exposes the quads, to check every thread count builds the same ones
+    class ChecksumParticleSystem : public ParticleSystemQuad
+    {
+    public:
+        static ChecksumParticleSystem* create(const std::string& file)
+        {
+            auto system = new (std::nothrow) ChecksumParticleSystem();
+            if (system && system->initWithFile(file))
+            {
+                system->autorelease();
+                return system;
+            }
+            CC_SAFE_DELETE(system);
+            return nullptr;
+        }
+
+        unsigned int getChecksum() const
+        {
+            // FNV-1a over the quads of the living particles
+            unsigned int hash = 2166136261u;
+            auto bytes = reinterpret_cast<const unsigned char*>(_quads);
+            for (size_t i = 0; i < sizeof(_quads[0]) * _particleCount; ++i)
+                hash = (hash ^ bytes[i]) * 16777619u;
+            return hash;
+        }
+    };
+}
+
+void ParticleSimulationPerformTest::onEnter()
+{
+    TestCase::onEnter();
+
+    _threadCount = ParticleSystem::getSimulationThreadCount();
+
+    // the emitters of a combo on a board clear, radius and gravity modes mixed
+    const int systemCount = 48;
+    const int warmFrames = 120;
+    const int timedFrames = 120;
+    const float dt = 1.0f / 60;
+    const char* files[] = { "Particles/Galaxy.plist", "Particles/Flower.plist", "Particles/debian.plist", "Particles/Phoenix.plist" };
+
+    auto s = Director::getInstance()->getWinSize();
+    std::vector<ChecksumParticleSystem*> systems;
+    for (int i = 0; i < systemCount; ++i)
+    {
+        auto system = ChecksumParticleSystem::create(files[i % 4]);
+        system->setPosition(s.width * (i % 8 + 0.5f) / 8, s.height * (i / 8 + 0.5f) / 6);
+        system->setScale(0.25f);
+        addChild(system);
+        systems.push_back(system);
+    }
+
+    std::vector<unsigned int> threadCounts = { 1, 2, 4 };
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores > 4)
+        threadCounts.push_back(std::min(cores, 8u));
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("ParticleSimulationTest",
+                                              genStrVector("Threads", nullptr),
+                                              genStrVector("Frame", "Speedup", nullptr));
+    }
+
+    std::string results = StringUtils::format("%d systems, %d cores\n", systemCount, cores);
+    float serialMs = 0;
+    unsigned int serialChecksum = 0;
+    for (auto threadCount : threadCounts)
+    {
+        ParticleSystem::setSimulationThreadCount(threadCount);
+
+        // same emission for every thread count, the buffers aren't uploaded so only the simulation is timed
+        srand(1);
+        for (auto system : systems)
+        {
+            system->setVisible(false);
+            system->resetSystem();
+        }
+        for (int frame = 0; frame < warmFrames; ++frame)
+        {
+            for (auto system : systems)
+                system->update(dt);
+            ParticleSystem::runSimulationStage();
+        }
+
+        int particleCount = 0;
+        auto start = utils::gettime();
+        for (int frame = 0; frame < timedFrames; ++frame)
+        {
+            for (auto system : systems)
+                system->update(dt);
+            ParticleSystem::runSimulationStage();
+        }
+        float frameMs = static_cast<float>(utils::gettime() - start) * 1000 / timedFrames;
+
+        unsigned int checksum = 0;
+        for (auto system : systems)
+        {
+            checksum = checksum * 31 + system->getChecksum();
+            particleCount += system->getParticleCount();
+        }
+        if (threadCount == 1)
+        {
+            serialMs = frameMs;
+            serialChecksum = checksum;
+        }
+
+        float speedup = frameMs > 0 ? serialMs / frameMs : 0;
+        results += StringUtils::format("%u threads: %.3fms per frame, x%.2f, %d particles%s\n", threadCount, frameMs, speedup,
+                                       particleCount, checksum == serialChecksum ? "" : ", RESULTS DIFFER");
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector(genStr("%u", threadCount).c_str(), nullptr),
+                                                  genStrVector(genStr("%fms", frameMs).c_str(), genStr("%f", speedup).c_str(), nullptr));
+    }
+
+    for (auto system : systems)
+        system->setVisible(true);
+    ParticleSystem::setSimulationThreadCount(_threadCount);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    log("%s", results.c_str());
+    _subtitleLabel->setString(results);
+}
+
+void ParticleSimulationPerformTest::onExit()
+{
+    ParticleSystem::setSimulationThreadCount(_threadCount);
+    TestCase::onExit();
+}
+
+std::string ParticleSimulationPerformTest::title() const
+{
+    return "Particle Simulation Threads";
+}
+
+std::string ParticleSimulationPerformTest::subtitle() const
+{
+    return "Simulates 48 systems on 1 to N threads";
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleKernelsPerformTest
+//
+////////////////////////////////////////////////////////
+namespace
+{
+    // exposes the particle arrays, to compare the SIMD levels with the scalar loops
+    class InspectableParticleSystem : public ParticleSystemQuad
+    {
+    public:
+        static InspectableParticleSystem* create(int totalParticles)
+        {
+            auto system = new (std::nothrow) InspectableParticleSystem();
+            if (system && system->initWithTotalParticles(totalParticles))
+            {
+                system->autorelease();
+                return system;
+            }
+            CC_SAFE_DELETE(system);
+            return nullptr;
+        }
+
+        std::vector<float> getState() const
+        {
+            const float* arrays[] = { _particleData.posx, _particleData.posy, _particleData.colorR, _particleData.colorG,
+                                      _particleData.colorB, _particleData.colorA, _particleData.size, _particleData.rotation };
+            std::vector<float> state;
+            for (auto array : arrays)
+                state.insert(state.end(), array, array + _particleCount);
+            return state;
+        }
+    };
+}
+
+void ParticleKernelsPerformTest::onEnter()
+{
+    TestCase::onEnter();
+
+    typedef ParticleKernels::SIMDLevel SIMDLevel;
+
+    // a board full of 100k particles, the emitters refill it as fast as the particles die
+    const int totalParticles = 100000;
+    const int warmFrames = 240;
+    const int timedFrames = 60;
+    const float dt = 1.0f / 60;
+    const float life = 3.0f;
+
+    auto s = Director::getInstance()->getWinSize();
+    auto system = InspectableParticleSystem::create(totalParticles);
+    system->setTexture(Director::getInstance()->getTextureCache()->addImage("Images/fire.png"));
+    system->setPosition(s.width / 2, s.height / 2);
+    system->setDuration(ParticleSystem::DURATION_INFINITY);
+    system->setLife(life);
+    system->setLifeVar(0.5f);
+    system->setEmissionRate(totalParticles / (life + 0.5f));
+    system->setAngle(90);
+    system->setAngleVar(360);
+    system->setStartSize(12);
+    system->setStartSizeVar(4);
+    system->setEndSize(2);
+    system->setEndSizeVar(1);
+    system->setStartSpin(0);
+    system->setStartSpinVar(90);
+    system->setEndSpin(180);
+    system->setEndSpinVar(90);
+    system->setStartColor(Color4F(0.8f, 0.4f, 0.2f, 1));
+    system->setStartColorVar(Color4F(0.2f, 0.2f, 0.2f, 0));
+    system->setEndColor(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+    system->setEndColorVar(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+    system->setPosVar(Vec2(20, 20));
+    system->setScale(0.5f);
+    addChild(system);
+
+    auto configure = [system](ParticleSystem::Mode mode) {
+        system->setEmitterMode(mode);
+        if (mode == ParticleSystem::Mode::GRAVITY)
+        {
+            system->setGravity(Vec2(0, -40));
+            system->setSpeed(80);
+            system->setSpeedVar(20);
+            system->setRadialAccel(-60);
+            system->setRadialAccelVar(10);
+            system->setTangentialAccel(60);
+            system->setTangentialAccelVar(10);
+        }
+        else
+        {
+            system->setStartRadius(10);
+            system->setStartRadiusVar(5);
+            system->setEndRadius(250);
+            system->setEndRadiusVar(50);
+            system->setRotatePerSecond(90);
+            system->setRotatePerSecondVar(45);
+        }
+    };
+
+    std::vector<SIMDLevel> levels = { SIMDLevel::NONE };
+    SIMDLevel supported = PixelConvert::getSupportedSIMDLevel();
+    if (supported == SIMDLevel::AVX2)
+        levels.push_back(SIMDLevel::SSE2);
+    if (supported != SIMDLevel::NONE)
+        levels.push_back(supported);
+
+    SIMDLevel previousLevel = ParticleKernels::getSIMDLevel();
+    unsigned int previousThreads = ParticleSystem::getSimulationThreadCount();
+    // one thread, so only the kernels change between the runs
+    ParticleSystem::setSimulationThreadCount(1);
+    system->setVisible(false);
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("ParticleKernelsTest",
+                                              genStrVector("Mode", "Level", nullptr),
+                                              genStrVector("Frame", "Speedup", "Error", nullptr));
+    }
+
+    std::string results;
+    int mismatches = 0;
+    const ParticleSystem::Mode modes[] = { ParticleSystem::Mode::GRAVITY, ParticleSystem::Mode::RADIUS };
+    for (auto mode : modes)
+    {
+        const char* modeName = mode == ParticleSystem::Mode::GRAVITY ? "gravity" : "radius";
+        configure(mode);
+
+        std::vector<float> reference;
+        float scalarMs = 0;
+        for (auto level : levels)
+        {
+            ParticleKernels::setSIMDLevel(level);
+
+            // same emission for every level, the random numbers don't depend on it
+            srand(1);
+            system->resetSystem();
+            for (int frame = 0; frame < warmFrames; ++frame)
+                system->update(dt);
+
+            auto start = utils::gettime();
+            for (int frame = 0; frame < timedFrames; ++frame)
+                system->update(dt);
+            float frameMs = static_cast<float>(utils::gettime() - start) * 1000 / timedFrames;
+
+            // the sines of the vector paths are approximations, so the positions are compared with a tolerance
+            auto state = system->getState();
+            float error = 0;
+            if (level == SIMDLevel::NONE)
+            {
+                reference = state;
+                scalarMs = frameMs;
+            }
+            else if (state.size() != reference.size())
+            {
+                error = INFINITY;
+            }
+            else
+            {
+                for (size_t i = 0; i < state.size(); ++i)
+                    error = std::max(error, std::abs(state[i] - reference[i]) / std::max(1.0f, std::abs(reference[i])));
+            }
+            bool match = error < 1e-3f;
+            if (!match)
+                ++mismatches;
+
+            float speedup = frameMs > 0 ? scalarMs / frameMs : 0;
+            results += StringUtils::format("%s %s: %.3fms per frame, x%.2f, error %g, %d particles%s\n", modeName,
+                                           PixelConvert::getSIMDLevelName(level), frameMs, speedup, error,
+                                           system->getParticleCount(), match ? "" : ", MISMATCH");
+            if (isAutoTesting())
+                Profile::getInstance()->addTestResult(genStrVector(modeName, PixelConvert::getSIMDLevelName(level), nullptr),
+                                                      genStrVector(genStr("%fms", frameMs).c_str(), genStr("%f", speedup).c_str(),
+                                                                   genStr("%g", error).c_str(), nullptr));
+        }
+    }
+
+    ParticleKernels::setSIMDLevel(previousLevel);
+    ParticleSystem::setSimulationThreadCount(previousThreads);
+    system->setVisible(true);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    results += StringUtils::format("%d mismatches with the scalar loops", mismatches);
+    log("%s", results.c_str());
+    _subtitleLabel->setString(results);
+}
+
+void ParticleKernelsPerformTest::onExit()
+{
+    ParticleKernels::setSIMDLevel(PixelConvert::getSupportedSIMDLevel());
+    TestCase::onExit();
+}
+
+std::string ParticleKernelsPerformTest::title() const
+{
+    return "Particle SIMD Kernels";
+}
+
+std::string ParticleKernelsPerformTest::subtitle() const
+{
+    return "Updates 100k particles with every SIMD level";
+}
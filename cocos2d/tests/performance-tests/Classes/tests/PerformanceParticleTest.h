@@ -100,4 +100,29 @@ public:
     virtual void initWithSubTest(int subtest, int particles) override;
 };
 
+class ParticleSimulationPerformTest : public TestCase
+{
+public:
+    CREATE_FUNC(ParticleSimulationPerformTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+private:
+    unsigned int _threadCount;
+};
+
+class ParticleKernelsPerformTest : public TestCase
+{
+public:
+    CREATE_FUNC(ParticleKernelsPerformTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+};
+
 #endif
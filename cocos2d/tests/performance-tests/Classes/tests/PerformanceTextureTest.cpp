@@ -25,11 +25,22 @@
 #include "PerformanceTextureTest.h"
 #include "Profile.h"
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 USING_NS_CC;
 
 PerformceTextureTests::PerformceTextureTests()
 {
     ADD_TEST_CASE(TexturePerformceTest);
+    ADD_TEST_CASE(TextureAsyncLoadPerformceTest);
+    ADD_TEST_CASE(TexturePixelConvertPerformceTest);
+    ADD_TEST_CASE(FileReadPerformceTest);
+    ADD_TEST_CASE(AssetPackReadPerformceTest);
+    ADD_TEST_CASE(SpriteSheetLoadPerformceTest);
+    ADD_TEST_CASE(RenderTextureReadbackPerformceTest);
 }
 
 static float calculateDeltaTime( struct timeval *lastUpdate )
@@ -356,3 +367,702 @@ std::string TexturePerformceTest::subtitle() const
 {
     return "See console for results";
 }
+
+////////////////////////////////////////////////////////
+//
+// TextureAsyncLoadPerformceTest
+//
+////////////////////////////////////////////////////////
+void TextureAsyncLoadPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    auto fileUtils = FileUtils::getInstance();
+    for (const auto& path : fileUtils->listFiles(fileUtils->fullPathForFilename("Images")))
+    {
+        if (fileUtils->getFileExtension(path) == ".png")
+            _files.push_back(path);
+    }
+
+    auto cache = Director::getInstance()->getTextureCache();
+    _previousWorkerCount = cache->getAsyncWorkerCount();
+    _workerCounts = {1, 2, 4, 8};
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("TextureAsyncLoadTest",
+                                              genStrVector("Images", "Workers", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    startRun();
+}
+
+void TextureAsyncLoadPerformceTest::onExit()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    for (const auto& file : _files)
+        cache->cancelImageAsync(file);
+    cache->setAsyncWorkerCount(_previousWorkerCount);
+
+    TestCase::onExit();
+}
+
+void TextureAsyncLoadPerformceTest::startRun()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    if (_currentRun >= _workerCounts.size() || _files.empty())
+    {
+        log("%s", _results.c_str());
+        if (isAutoTesting())
+        {
+            Profile::getInstance()->testCaseEnd();
+            setAutoTesting(false);
+        }
+        return;
+    }
+
+    // decode every image again, nothing comes from the cache
+    for (const auto& file : _files)
+        cache->removeTextureForKey(file);
+
+    cache->setAsyncWorkerCount(_workerCounts[_currentRun]);
+    _loadedCount = 0;
+    gettimeofday(&_runStart, nullptr);
+    for (const auto& file : _files)
+        cache->addImageAsync(file, CC_CALLBACK_1(TextureAsyncLoadPerformceTest::onTextureLoaded, this));
+}
+
+void TextureAsyncLoadPerformceTest::onTextureLoaded(Texture2D* /*texture*/)
+{
+    if (++_loadedCount < _files.size())
+        return;
+
+    auto dt = calculateDeltaTime(&_runStart);
+    unsigned int workers = _workerCounts[_currentRun];
+    _results += StringUtils::format("%d images, %u workers: %.1fms\n", (int)_files.size(), workers, dt * 1000);
+    if (isAutoTesting())
+        Profile::getInstance()->addTestResult(genStrVector(genStr("%d", (int)_files.size()).c_str(), genStr("%u", workers).c_str(), nullptr),
+                                              genStrVector(genStr("%fms", dt * 1000).c_str(), nullptr));
+    _subtitleLabel->setString(_results);
+
+    // the next run starts from a clean state in the next frame
+    ++_currentRun;
+    scheduleOnce([this](float) { startRun(); }, 0, "next_run");
+}
+
+std::string TextureAsyncLoadPerformceTest::title() const
+{
+    return "Async Texture Load Performance Test";
+}
+
+std::string TextureAsyncLoadPerformceTest::subtitle() const
+{
+    return "Loads the PNG files of Images with 1, 2, 4 and 8 workers";
+}
+
+////////////////////////////////////////////////////////
+//
+// TexturePixelConvertPerformceTest
+//
+////////////////////////////////////////////////////////
+static const char* pixelFormatName(Texture2D::PixelFormat format)
+{
+    switch (format)
+    {
+        case Texture2D::PixelFormat::RGBA8888: return "RGBA8888";
+        case Texture2D::PixelFormat::RGB888: return "RGB888";
+        case Texture2D::PixelFormat::RGB565: return "RGB565";
+        case Texture2D::PixelFormat::A8: return "A8";
+        case Texture2D::PixelFormat::I8: return "I8";
+        case Texture2D::PixelFormat::AI88: return "AI88";
+        case Texture2D::PixelFormat::RGBA4444: return "RGBA4444";
+        case Texture2D::PixelFormat::RGB5A1: return "RGB5A1";
+        default: return "unknown";
+    }
+}
+
+void TexturePixelConvertPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    typedef Texture2D::PixelFormat PixelFormat;
+    typedef PixelConvert::SIMDLevel SIMDLevel;
+
+    // odd size, so every kernel leaves a tail to the scalar loop
+    const int width = 1021;
+    const int height = 1021;
+    std::vector<unsigned char> pixels(width * height * 4);
+    for (auto& byte : pixels)
+        byte = (unsigned char)RandomHelper::random_int(0, 255);
+
+    SIMDLevel previousLevel = PixelConvert::getSIMDLevel();
+    SIMDLevel simdLevel = PixelConvert::getSupportedSIMDLevel();
+
+    // converts the random pixels to origin with the scalar code, then to target with the given level
+    auto convert = [&](PixelFormat origin, PixelFormat target, SIMDLevel level, float* ms) {
+        std::vector<unsigned char> result;
+        PixelConvert::setSIMDLevel(SIMDLevel::NONE);
+        auto image = new (std::nothrow) Image();
+        if (image && image->initWithRawData(pixels.data(), (ssize_t)pixels.size(), width, height, 8, false)
+            && image->convertToFormat(origin))
+        {
+            PixelConvert::setSIMDLevel(level);
+            struct timeval now;
+            gettimeofday(&now, nullptr);
+            if (target == PixelFormat::NONE)
+                image->premultiplyAlpha();
+            else
+                image->convertToFormat(target);
+            *ms = calculateDeltaTime(&now) * 1000;
+            result.assign(image->getData(), image->getData() + image->getDataLen());
+        }
+        CC_SAFE_RELEASE(image);
+        return result;
+    };
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("TexturePixelConvertTest",
+                                              genStrVector("Origin", "Target", nullptr),
+                                              genStrVector("Scalar", PixelConvert::getSIMDLevelName(simdLevel), "Match", nullptr));
+    }
+
+    const PixelFormat origins[] = { PixelFormat::I8, PixelFormat::AI88, PixelFormat::RGB888, PixelFormat::RGBA8888 };
+    const PixelFormat targets[] = { PixelFormat::RGBA8888, PixelFormat::RGB888, PixelFormat::RGB565, PixelFormat::A8,
+                                    PixelFormat::I8, PixelFormat::AI88, PixelFormat::RGBA4444, PixelFormat::RGB5A1 };
+
+    std::vector<std::pair<PixelFormat, PixelFormat>> pairs;
+    for (auto origin : origins)
+        for (auto target : targets)
+            if (origin != target)
+                pairs.push_back(std::make_pair(origin, target));
+    // premultiplyAlpha is listed as RGBA8888 -> NONE
+    pairs.push_back(std::make_pair(PixelFormat::RGBA8888, PixelFormat::NONE));
+
+    int mismatches = 0;
+    for (const auto& pair : pairs)
+    {
+        float scalarMs = 0, simdMs = 0;
+        auto reference = convert(pair.first, pair.second, SIMDLevel::NONE, &scalarMs);
+        auto vectorized = convert(pair.first, pair.second, simdLevel, &simdMs);
+        bool match = !reference.empty() && reference == vectorized;
+        if (!match)
+            ++mismatches;
+
+        const char* target = pair.second == PixelFormat::NONE ? "premultiplied" : pixelFormatName(pair.second);
+        auto line = StringUtils::format("%s -> %s: %.2fms / %.2fms%s", pixelFormatName(pair.first), target, scalarMs, simdMs, match ? "" : " MISMATCH");
+        log("%s", line.c_str());
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector(pixelFormatName(pair.first), target, nullptr),
+                                                  genStrVector(genStr("%fms", scalarMs).c_str(), genStr("%fms", simdMs).c_str(), match ? "yes" : "no", nullptr));
+    }
+    PixelConvert::setSIMDLevel(previousLevel);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    log("%d conversions, %d mismatches between scalar and %s", (int)pairs.size(), mismatches, PixelConvert::getSIMDLevelName(simdLevel));
+    _subtitleLabel->setString(StringUtils::format("%d mismatches, scalar / %s times in the log", mismatches, PixelConvert::getSIMDLevelName(simdLevel)));
+}
+
+std::string TexturePixelConvertPerformceTest::title() const
+{
+    return "Pixel Format Conversion Performance Test";
+}
+
+std::string TexturePixelConvertPerformceTest::subtitle() const
+{
+    return "Compares every conversion with its scalar reference";
+}
+
+////////////////////////////////////////////////////////
+//
+// FileReadPerformceTest
+//
+////////////////////////////////////////////////////////
+static void dropFileCache(const std::string& path)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    CC_UNUSED_PARAM(path);
+#endif
+}
+
+// reads one byte of every page, a mapping is only loaded when it is accessed
+static unsigned int touchPages(const Data& data)
+{
+    unsigned int sum = 0;
+    for (ssize_t i = 0; i < data.getSize(); i += 4096)
+        sum += data.getBytes()[i];
+    return sum;
+}
+
+void FileReadPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    auto fileUtils = FileUtils::getInstance();
+    std::vector<std::string> files;
+    ssize_t totalSize = 0;
+    for (const auto& path : fileUtils->listFiles(fileUtils->fullPathForFilename("Images")))
+    {
+        if (!fileUtils->isDirectoryExist(path) && fileUtils->getFileSize(path) >= CC_FILEUTILS_MMAP_THRESHOLD)
+        {
+            files.push_back(path);
+            totalSize += fileUtils->getFileSize(path);
+        }
+    }
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("FileReadTest",
+                                              genStrVector("Mode", nullptr),
+                                              genStrVector("First load", "Warm load", nullptr));
+    }
+
+    const int warmRuns = 5;
+    volatile unsigned int sink = 0;
+    std::string results = StringUtils::format("%d files, %d KB\n", (int)files.size(), (int)(totalSize / 1024));
+    for (bool mapped : { false, true })
+    {
+        auto load = [&](const std::string& path) {
+            Data data;
+            if (!mapped || !data.mapFile(path))
+                fileUtils->getContents(path, &data);
+            sink += touchPages(data);
+        };
+
+        struct timeval now;
+        for (const auto& path : files)
+            dropFileCache(path);
+        gettimeofday(&now, nullptr);
+        for (const auto& path : files)
+            load(path);
+        float firstMs = calculateDeltaTime(&now) * 1000;
+
+        gettimeofday(&now, nullptr);
+        for (int run = 0; run < warmRuns; ++run)
+            for (const auto& path : files)
+                load(path);
+        float warmMs = calculateDeltaTime(&now) * 1000 / warmRuns;
+
+        const char* mode = mapped ? "mmap" : "read";
+        results += StringUtils::format("%s: first %.2fms, warm %.2fms\n", mode, firstMs, warmMs);
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector(mode, nullptr),
+                                                  genStrVector(genStr("%fms", firstMs).c_str(), genStr("%fms", warmMs).c_str(), nullptr));
+    }
+    (void)sink;
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    log("%s", results.c_str());
+    _subtitleLabel->setString(results);
+}
+
+std::string FileReadPerformceTest::title() const
+{
+    return "File Read Performance Test";
+}
+
+std::string FileReadPerformceTest::subtitle() const
+{
+    return "Reads and maps the large files of Images";
+}
+
+void AssetPackReadPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    // the files of Resources/assetpack/images.pack and images.zip
+    std::vector<std::string> files;
+    for (int x = 0; x < 8; ++x)
+        for (int y = 0; y < 8; ++y)
+            files.push_back(StringUtils::format("Images/sprites_test/sprite-%d-%d.png", x, y));
+    for (const char* plist : { "Images/grossini_polygon.plist", "Images/grossini_quad.plist", "Images/grossinis_sister1_sp.plist", "Images/grossinis_sister2_sp.plist" })
+        files.push_back(plist);
+
+    auto fileUtils = FileUtils::getInstance();
+    const std::string zipPath = fileUtils->fullPathForFilename("assetpack/images.zip");
+    const std::string packPath = fileUtils->fullPathForFilename("assetpack/images.pack");
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("AssetPackReadTest",
+                                              genStrVector("Source", nullptr),
+                                              genStrVector("First load", "Warm load", nullptr));
+    }
+
+    const int warmRuns = 10;
+    volatile unsigned int sink = 0;
+    std::string results = StringUtils::format("%d files\n", (int)files.size());
+    for (const char* source : { "loose", "zip", "pack" })
+    {
+        const bool fromZip = strcmp(source, "zip") == 0;
+        const bool fromPack = strcmp(source, "pack") == 0;
+
+        // opens the archive and reads every file
+        auto loadAll = [&]() -> bool {
+            if (fromZip)
+            {
+                ZipFile zip(zipPath);
+                for (const auto& file : files)
+                {
+                    ssize_t size = 0;
+                    unsigned char* bytes = zip.getFileData(file, &size);
+                    if (!bytes)
+                        return false;
+                    sink += bytes[0];
+                    free(bytes);
+                }
+                return true;
+            }
+
+            if (fromPack && !fileUtils->addAssetPack(packPath, true))
+                return false;
+            bool loaded = true;
+            for (const auto& file : files)
+            {
+                Data data = fileUtils->getDataFromFile(file);
+                if (data.isNull())
+                {
+                    loaded = false;
+                    break;
+                }
+                sink += touchPages(data);
+            }
+            if (fromPack)
+                fileUtils->removeAssetPack(packPath);
+            return loaded;
+        };
+
+        if (fromZip)
+            dropFileCache(zipPath);
+        else if (fromPack)
+            dropFileCache(packPath);
+        else
+            for (const auto& file : files)
+                dropFileCache(fileUtils->fullPathForFilename(file));
+
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        bool loaded = loadAll();
+        float firstMs = calculateDeltaTime(&now) * 1000;
+
+        gettimeofday(&now, nullptr);
+        for (int run = 0; loaded && run < warmRuns; ++run)
+            loaded = loadAll();
+        float warmMs = calculateDeltaTime(&now) * 1000 / warmRuns;
+
+        if (!loaded)
+        {
+            // zip files inside the APK can't be opened by path
+            results += StringUtils::format("%s: can't read the files\n", source);
+            continue;
+        }
+
+        results += StringUtils::format("%s: first %.2fms, warm %.2fms\n", source, firstMs, warmMs);
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector(source, nullptr),
+                                                  genStrVector(genStr("%fms", firstMs).c_str(), genStr("%fms", warmMs).c_str(), nullptr));
+    }
+    (void)sink;
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    log("%s", results.c_str());
+    _subtitleLabel->setString(results);
+}
+
+std::string AssetPackReadPerformceTest::title() const
+{
+    return "Asset Pack Read Performance Test";
+}
+
+std::string AssetPackReadPerformceTest::subtitle() const
+{
+    return "Opens and reads small files loose, from a zip and from an asset pack";
+}
+
+////////////////////////////////////////////////////////
+//
+// SpriteSheetLoadPerformceTest
+//
+////////////////////////////////////////////////////////
+// Writes a sheet of frameCount 22x22 frames on a 1024x1024 texture as a format 3 plist and as
+// the binary sheet tools/sprite-sheet/convert_sprite_sheet.py makes from it.
+static bool writeSpriteSheets(int frameCount, const std::string& plistPath, const std::string& binaryPath)
+{
+    const int frameSize = 22;
+    const int columns = 1024 / frameSize;
+
+    ValueMap frames;
+    for (int i = 0; i < frameCount; ++i)
+    {
+        const int x = (i % columns) * frameSize;
+        const int y = (i / columns) * frameSize;
+
+        ValueMap frame;
+        frame["aliases"] = ValueVector();
+        frame["spriteOffset"] = "{0,0}";
+        frame["spriteSize"] = StringUtils::format("{%d,%d}", frameSize, frameSize);
+        frame["spriteSourceSize"] = StringUtils::format("{%d,%d}", frameSize, frameSize);
+        frame["textureRect"] = StringUtils::format("{{%d,%d},{%d,%d}}", x, y, frameSize, frameSize);
+        frame["textureRotated"] = (i % 2) == 0;
+        frames[StringUtils::format("frame_%04d.png", i)] = frame;
+    }
+
+    ValueMap metadata;
+    metadata["format"] = 3;
+    metadata["pixelFormat"] = "RGBA8888";
+    metadata["premultiplyAlpha"] = false;
+    metadata["realTextureFileName"] = "texture1024x1024.png";
+    metadata["size"] = "{1024,1024}";
+    metadata["textureFileName"] = "texture1024x1024.png";
+
+    ValueMap sheet;
+    sheet["frames"] = frames;
+    sheet["metadata"] = metadata;
+    if (!FileUtils::getInstance()->writeValueMapToFile(sheet, plistPath))
+        return false;
+
+    // the binary sheet holds the same frames, as tools/sprite-sheet/convert_sprite_sheet.py would write them
+    Data data = SpriteFrameCache::createBinaryDataWithDictionary(sheet);
+    return !data.isNull() && FileUtils::getInstance()->writeDataToFile(data, binaryPath);
+}
+
+void SpriteSheetLoadPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    const int frameCount = 2000;
+    auto cache = SpriteFrameCache::getInstance();
+    auto fileUtils = FileUtils::getInstance();
+
+    const std::string plistPath = fileUtils->getWritablePath() + "sheet_2000_frames.plist";
+    const std::string binaryPath = fileUtils->getWritablePath() + "sheet_2000_frames.ccsf";
+    if (!writeSpriteSheets(frameCount, plistPath, binaryPath))
+    {
+        _subtitleLabel->setString("Can't write the sprite sheets to the writable path");
+        return;
+    }
+
+    // the texture is shared by both sheets, load it up front so only the frames are timed
+    auto texture = Director::getInstance()->getTextureCache()->addImage("Images/texture1024x1024.png");
+    texture->retain();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("SpriteSheetLoadTest",
+                                              genStrVector("Format", nullptr),
+                                              genStrVector("First load", "Warm load", nullptr));
+    }
+
+    const int warmRuns = 10;
+    std::string results = StringUtils::format("%d frames\n", frameCount);
+    for (const char* format : { "plist", "binary" })
+    {
+        const std::string& sheet = strcmp(format, "plist") == 0 ? plistPath : binaryPath;
+        dropFileCache(sheet);
+
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        cache->addSpriteFramesWithFile(sheet, texture);
+        float firstMs = calculateDeltaTime(&now) * 1000;
+        bool loaded = cache->getSpriteFrameByName(StringUtils::format("frame_%04d.png", frameCount - 1)) != nullptr;
+        cache->removeSpriteFramesFromFile(sheet);
+
+        float warmMs = 0;
+        for (int run = 0; loaded && run < warmRuns; ++run)
+        {
+            gettimeofday(&now, nullptr);
+            cache->addSpriteFramesWithFile(sheet, texture);
+            warmMs += calculateDeltaTime(&now) * 1000;
+            cache->removeSpriteFramesFromFile(sheet);
+        }
+        warmMs /= warmRuns;
+
+        if (!loaded)
+        {
+            results += StringUtils::format("%s: can't load the sheet\n", format);
+            continue;
+        }
+
+        results += StringUtils::format("%s: first %.2fms, warm %.2fms\n", format, firstMs, warmMs);
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector(format, nullptr),
+                                                  genStrVector(genStr("%fms", firstMs).c_str(), genStr("%fms", warmMs).c_str(), nullptr));
+    }
+
+    texture->release();
+    fileUtils->removeFile(plistPath);
+    fileUtils->removeFile(binaryPath);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    log("%s", results.c_str());
+    _subtitleLabel->setString(results);
+}
+
+std::string SpriteSheetLoadPerformceTest::title() const
+{
+    return "Sprite Sheet Load Performance Test";
+}
+
+std::string SpriteSheetLoadPerformceTest::subtitle() const
+{
+    return "Adds a 2000 frame sprite sheet from a plist and from its binary conversion";
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderTextureReadbackPerformceTest
+//
+////////////////////////////////////////////////////////
+enum {
+    kReadbackPhaseBaseline = 0,
+    kReadbackPhaseSync,
+    kReadbackPhaseAsync,
+    kReadbackPhaseWait,
+};
+
+static const int kReadbackWarmupFrames = 30;
+static const int kReadbackFrames = 60;
+
+void RenderTextureReadbackPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _target = RenderTexture::create(512, 512, Texture2D::PixelFormat::RGBA8888);
+    _target->retain();
+    _target->getSprite()->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(_target);
+
+    _brush = Sprite::create("Images/grossini.png");
+    _brush->retain();
+
+    _phase = kReadbackPhaseBaseline;
+    _frame = -kReadbackWarmupFrames;
+    _pending = std::make_shared<int>(0);
+    for (auto& time : _phaseTime)
+        time = 0;
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("RenderTextureReadbackTest",
+                                              genStrVector("Size", nullptr),
+                                              genStrVector("Frame", "Sync", "Async", nullptr));
+    }
+
+    scheduleUpdate();
+}
+
+void RenderTextureReadbackPerformceTest::onExit()
+{
+    unscheduleUpdate();
+    // pending captures keep the render texture alive
+    CC_SAFE_RELEASE_NULL(_target);
+    CC_SAFE_RELEASE_NULL(_brush);
+
+    TestCase::onExit();
+}
+
+void RenderTextureReadbackPerformceTest::update(float dt)
+{
+    if (_phase == kReadbackPhaseWait)
+    {
+        if (*_pending == 0)
+        {
+            unscheduleUpdate();
+            finish();
+        }
+        return;
+    }
+
+    // dt is the duration of the previous frame, which did the previous capture
+    if (_frame > 0)
+        _phaseTime[_phase] += dt;
+
+    // something to read back
+    _target->beginWithClear(0, 0, 0, 1);
+    for (int i = 0; i < 20; i++)
+    {
+        _brush->setPosition(Vec2(RandomHelper::random_int(0, 512), RandomHelper::random_int(0, 512)));
+        _brush->setRotation(RandomHelper::random_int(0, 360));
+        _brush->visit();
+    }
+    _target->end();
+
+    if (_frame >= 0)
+    {
+        if (_phase == kReadbackPhaseSync)
+        {
+            // what saveToFile() does when the renderer executes its command
+            Director::getInstance()->getRenderer()->render();
+            auto image = _target->newImage(true);
+            if (image)
+                image->saveToFile(FileUtils::getInstance()->getWritablePath() + "readback-sync.png", false);
+            CC_SAFE_RELEASE(image);
+        }
+        else if (_phase == kReadbackPhaseAsync)
+        {
+            auto pending = _pending;
+            ++*pending;
+            _target->saveToFileAsync("readback-async.png", Image::Format::PNG, true, [pending](RenderTexture*, const std::string&) {
+                --*pending;
+            });
+        }
+    }
+
+    if (++_frame > kReadbackFrames)
+    {
+        ++_phase;
+        _frame = _phase == kReadbackPhaseWait ? 0 : -kReadbackWarmupFrames;
+    }
+}
+
+void RenderTextureReadbackPerformceTest::finish()
+{
+    float baseline = _phaseTime[kReadbackPhaseBaseline] * 1000 / kReadbackFrames;
+    float sync = _phaseTime[kReadbackPhaseSync] * 1000 / kReadbackFrames - baseline;
+    float async = _phaseTime[kReadbackPhaseAsync] * 1000 / kReadbackFrames - baseline;
+
+    auto results = StringUtils::format("frame: %.2fms\nsaveToFile: +%.2fms per capture\nsaveToFileAsync: +%.2fms per capture", baseline, sync, async);
+    log("%s", results.c_str());
+    _subtitleLabel->setString(results);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->addTestResult(genStrVector("512x512", nullptr),
+                                              genStrVector(genStr("%fms", baseline).c_str(), genStr("%fms", sync).c_str(), genStr("%fms", async).c_str(), nullptr));
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+std::string RenderTextureReadbackPerformceTest::title() const
+{
+    return "RenderTexture Readback Performance Test";
+}
+
+std::string RenderTextureReadbackPerformceTest::subtitle() const
+{
+    return "Main thread time added by a PNG capture every frame";
+}
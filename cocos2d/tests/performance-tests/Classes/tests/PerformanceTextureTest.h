@@ -42,4 +42,90 @@ public:
     virtual void onEnter() override;
 };
 
+class TextureAsyncLoadPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureAsyncLoadPerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+private:
+    void startRun();
+    void onTextureLoaded(cocos2d::Texture2D* texture);
+
+    std::vector<std::string> _files;
+    std::vector<unsigned int> _workerCounts;
+    size_t _currentRun = 0;
+    size_t _loadedCount = 0;
+    unsigned int _previousWorkerCount = 0;
+    struct timeval _runStart;
+    std::string _results;
+};
+
+class TexturePixelConvertPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(TexturePixelConvertPerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class FileReadPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(FileReadPerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class AssetPackReadPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(AssetPackReadPerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class SpriteSheetLoadPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(SpriteSheetLoadPerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class RenderTextureReadbackPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(RenderTextureReadbackPerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+
+private:
+    void finish();
+
+    cocos2d::RenderTexture* _target = nullptr;
+    cocos2d::Sprite* _brush = nullptr;
+    int _phase = 0;
+    int _frame = 0;
+    // shared with the capture callbacks, which can outlive the test
+    std::shared_ptr<int> _pending;
+    float _phaseTime[3];
+};
+
 #endif
@@ -56,6 +56,8 @@ public:
         addTest("Callback Tests", []() { return new PerformceCallbackTests(); });
         addTest("Math Tests", []() { return new PerformceMathTests(); });
         addTest("Container Tests", []() { return new PerformceContainerTests(); });
+        addTest("DrawNode Tests", []() { return new PerformceDrawNodeTests(); });
+        addTest("ClippingNode Tests", []() { return new PerformceClippingNodeTests(); });
     }
 };
 
@@ -38,5 +38,7 @@
 #include "PerformanceCallbackTest.h"
 #include "PerformanceMathTest.h"
 #include "PerformanceContainerTest.h"
+#include "PerformanceDrawNodeTest.h"
+#include "PerformanceClippingNodeTest.h"
 
 #endif
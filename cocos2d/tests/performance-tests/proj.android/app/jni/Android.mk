@@ -24,6 +24,8 @@ LOCAL_SRC_FILES := hellocpp/main.cpp \
                    ../../../Classes/tests/PerformanceLabelTest.cpp \
                    ../../../Classes/tests/VisibleRect.cpp \
                    ../../../Classes/tests/PerformanceMathTest.cpp \
+                   ../../../Classes/tests/PerformanceDrawNodeTest.cpp \
+                   ../../../Classes/tests/PerformanceClippingNodeTest.cpp \
                    ../../../Classes/tests/controller.cpp \
                    ../../../Classes/tests/PerformanceNodeChildrenTest.cpp
 
@@ -0,0 +1,122 @@
+#!/usr/bin/env python
+#coding=utf-8
+#
+# Generates the asset manifest loaded by FileUtils::loadAssetManifest.
+#
+# The manifest lists every file under the resource directory with its size and CRC32,
+# in a minimal perfect hash table, see cocos/platform/CCAssetManifest.h for the layout.
+#
+# usage: gen_asset_manifest.py [-o OUTPUT] [--exclude PATTERN ...] RESOURCE_DIR
+#   python gen_asset_manifest.py -o Resources/assets.manifest Resources
+#
+# Run it whenever the resources change, for instance as a build step before the resources
+# are copied, a file missing from the manifest is reported as missing by FileUtils.
+
+import os, sys, struct, zlib, argparse, fnmatch
+
+MAGIC = b'CCAM'
+VERSION = 2
+# keys per bucket, a larger value makes the table smaller and the generation slower
+BUCKET_LOAD = 4
+
+def fnv1a(data, seed):
+    h = 0x811C9DC5 ^ seed
+    for c in bytearray(data):
+        h ^= c
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    # the low bits of FNV only depend on the low bits of the input, mix them before the modulo
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & 0xFFFFFFFF
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & 0xFFFFFFFF
+    h ^= h >> 16
+    return h
+
+def file_crc32(path):
+    crc = 0
+    with open(path, 'rb') as f:
+        while True:
+            chunk = f.read(1 << 16)
+            if not chunk:
+                break
+            crc = zlib.crc32(chunk, crc)
+    return crc & 0xFFFFFFFF
+
+def collect_files(root, excludes):
+    files = []
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+        for name in sorted(filenames):
+            full = os.path.join(dirpath, name)
+            rel = os.path.relpath(full, root).replace(os.path.sep, '/')
+            if any(fnmatch.fnmatch(rel, pattern) for pattern in excludes):
+                continue
+            files.append((rel, full))
+    return files
+
+def build_perfect_hash(keys):
+    # hash and displace: the keys of a bucket share a seed which sends all of them to free slots
+    count = len(keys)
+    bucket_count = max(1, (count + BUCKET_LOAD - 1) // BUCKET_LOAD)
+    buckets = [[] for _ in range(bucket_count)]
+    for index, key in enumerate(keys):
+        buckets[fnv1a(key, 0) % bucket_count].append(index)
+
+    seeds = [0] * bucket_count
+    slots = [None] * count
+    for bucket in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        members = buckets[bucket]
+        if not members:
+            continue
+        seed = 1
+        while True:
+            positions = [fnv1a(keys[i], seed) % count for i in members]
+            if len(set(positions)) == len(positions) and all(slots[p] is None for p in positions):
+                break
+            seed += 1
+        seeds[bucket] = seed
+        for i, p in zip(members, positions):
+            slots[p] = i
+    return seeds, slots
+
+def write_manifest(output, root, files):
+    keys = [rel.encode('utf-8') for rel, _ in files]
+    seeds, slots = build_perfect_hash(keys) if keys else ([0], [])
+
+    strings = bytearray()
+    offsets = []
+    for key in keys:
+        offsets.append(len(strings))
+        strings += key
+
+    entries = bytearray()
+    for index in slots:
+        rel, full = files[index]
+        entries += struct.pack('<IIII', offsets[index], len(keys[index]), os.path.getsize(full), file_crc32(full))
+
+    with open(output, 'wb') as f:
+        f.write(MAGIC)
+        f.write(struct.pack('<IIII', VERSION, len(keys), len(seeds), len(strings)))
+        f.write(struct.pack('<%dI' % len(seeds), *seeds))
+        f.write(entries)
+        f.write(strings)
+
+def main():
+    parser = argparse.ArgumentParser(description='Generates the asset manifest of a resource directory.')
+    parser.add_argument('root', help='the resource directory')
+    parser.add_argument('-o', '--output', help='the manifest file, RESOURCE_DIR/assets.manifest by default')
+    parser.add_argument('--exclude', action='append', default=[], help='glob of the relative paths to leave out')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.root):
+        sys.exit('%s is not a directory' % args.root)
+
+    output = args.output or os.path.join(args.root, 'assets.manifest')
+    # the manifest does not list itself
+    excludes = args.exclude + [os.path.relpath(os.path.abspath(output), os.path.abspath(args.root)).replace(os.path.sep, '/')]
+    files = collect_files(args.root, excludes)
+    write_manifest(output, args.root, files)
+    print('%s: %d files' % (output, len(files)))
+
+if __name__ == '__main__':
+    main()
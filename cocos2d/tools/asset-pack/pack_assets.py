@@ -0,0 +1,108 @@
+#!/usr/bin/env python
+#coding=utf-8
+#
+# Packs resources into an asset pack loaded by FileUtils::addAssetPack.
+#
+# The pack holds an index of the files in a minimal perfect hash table, the same one as the
+# asset manifest, followed by the aligned file contents, see cocos/platform/CCAssetPack.h for
+# the layout. A file is deflated when that saves enough space, already compressed formats are
+# stored as is so that they can be mapped without a copy at runtime.
+#
+# usage: pack_assets.py [-o OUTPUT] [--include PATTERN ...] [--exclude PATTERN ...] [--store] RESOURCE_DIR
+#   python pack_assets.py -o Resources/ui.pack --include 'ui/*' Resources
+#
+# The paths in the pack are relative to RESOURCE_DIR, once the pack is added they are found
+# with the same names as the loose files.
+
+import os, sys, struct, zlib, argparse, fnmatch
+
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'asset-manifest'))
+from gen_asset_manifest import build_perfect_hash, collect_files
+
+MAGIC = b'CCPK'
+VERSION = 1
+METHOD_STORE = 0
+METHOD_DEFLATE = 1
+# offset of the contents of every file, mapped files keep the alignment
+ALIGNMENT = 16
+# a deflated file must be at most this fraction of the original, inflating costs load time
+MAX_DEFLATE_RATIO = 0.9
+# formats which are compressed already
+STORED_EXTENSIONS = ('.png', '.jpg', '.jpeg', '.webp', '.pkm', '.ccz', '.gz', '.zip',
+                     '.mp3', '.ogg', '.m4a', '.aac', '.mp4', '.pack')
+
+def align(value):
+    return (value + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+def compress(rel, contents, store):
+    if store or not contents or rel.lower().endswith(STORED_EXTENSIONS):
+        return METHOD_STORE, contents
+    deflated = zlib.compress(contents, 9)
+    if len(deflated) > len(contents) * MAX_DEFLATE_RATIO:
+        return METHOD_STORE, contents
+    return METHOD_DEFLATE, deflated
+
+def write_pack(output, files, store):
+    keys = [rel.encode('utf-8') for rel, _ in files]
+    seeds, slots = build_perfect_hash(keys) if keys else ([0], [])
+
+    strings = bytearray()
+    offsets = []
+    for key in keys:
+        offsets.append(len(strings))
+        strings += key
+
+    index_size = 24 + 4 * len(seeds) + 28 * len(keys) + len(strings)
+    data_offset = align(index_size)
+
+    # the contents follow the index in slot order, each one aligned
+    entries = bytearray()
+    blobs = []
+    stored_total = 0
+    for index in slots:
+        rel, full = files[index]
+        with open(full, 'rb') as f:
+            contents = f.read()
+        method, stored = compress(rel, contents, store)
+        entries += struct.pack('<IIIIIII', offsets[index], len(keys[index]), data_offset,
+                               len(stored), len(contents), method, zlib.crc32(contents) & 0xFFFFFFFF)
+        blobs.append((data_offset, stored))
+        data_offset = align(data_offset + len(stored))
+        stored_total += len(stored)
+
+    with open(output, 'wb') as f:
+        f.write(MAGIC)
+        f.write(struct.pack('<IIIII', VERSION, len(keys), len(seeds), len(strings), ALIGNMENT))
+        f.write(struct.pack('<%dI' % len(seeds), *seeds))
+        f.write(entries)
+        f.write(strings)
+        for offset, stored in blobs:
+            f.write(b'\0' * (offset - f.tell()))
+            f.write(stored)
+    return stored_total
+
+def main():
+    parser = argparse.ArgumentParser(description='Packs the files of a resource directory into an asset pack.')
+    parser.add_argument('root', help='the resource directory')
+    parser.add_argument('-o', '--output', required=True, help='the pack file')
+    parser.add_argument('--include', action='append', default=[], help='glob of the relative paths to pack, all files by default')
+    parser.add_argument('--exclude', action='append', default=[], help='glob of the relative paths to leave out')
+    parser.add_argument('--store', action='store_true', help='store every file without compression')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.root):
+        sys.exit('%s is not a directory' % args.root)
+
+    # the pack does not contain itself
+    excludes = args.exclude + [os.path.relpath(os.path.abspath(args.output), os.path.abspath(args.root)).replace(os.path.sep, '/')]
+    files = collect_files(args.root, excludes)
+    if args.include:
+        files = [(rel, full) for rel, full in files if any(fnmatch.fnmatch(rel, pattern) for pattern in args.include)]
+
+    size = sum(os.path.getsize(full) for _, full in files)
+    stored = write_pack(args.output, files, args.store)
+    print('%s: %d files, %d bytes, %d stored' % (args.output, len(files), size, stored))
+
+if __name__ == '__main__':
+    main()
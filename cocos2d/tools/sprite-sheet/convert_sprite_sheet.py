@@ -0,0 +1,132 @@
+#!/usr/bin/env python
+#coding=utf-8
+#
+# Converts a sprite sheet .plist file into the binary sprite sheet loaded by SpriteFrameCache.
+#
+# All the plist formats SpriteFrameCache reads are supported (Zwoptex 0 to 2, TexturePacker 3 with
+# aliases, anchors and polygons). The binary file holds the frames in fixed size records, see
+# cocos/2d/CCSpriteFrameCache.h for the layout.
+#
+# usage: convert_sprite_sheet.py [-o OUTPUT] PLIST [PLIST ...]
+#   python convert_sprite_sheet.py -o Resources/sheet.ccsf Resources/sheet.plist
+#
+# Without -o every PLIST is written next to itself with the .ccsf extension. Load the binary file
+# with SpriteFrameCache::addSpriteFramesWithFile like the plist, the texture is found the same way.
+
+import os, sys, re, struct, plistlib, argparse
+
+MAGIC = b'CCSF'
+VERSION = 1
+FLAG_ROTATED = 1
+FLAG_HAS_ANCHOR = 2
+
+def read_plist(path):
+    with open(path, 'rb') as f:
+        if hasattr(plistlib, 'load'):
+            return plistlib.load(f)
+        return plistlib.readPlist(f)
+
+def numbers(text):
+    # "{{x,y},{w,h}}", "{x,y}" and "1 2 3" lists
+    return [float(n) for n in re.findall(r'-?\d+(?:\.\d+)?(?:[eE][-+]?\d+)?', text)]
+
+def integers(text):
+    return [int(n) for n in text.split()]
+
+class StringTable(object):
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, text):
+        key = text.encode('utf-8')
+        if key not in self.offsets:
+            self.offsets[key] = len(self.data)
+            self.data += key
+        return self.offsets[key], len(key)
+
+def convert_frame(name, frame, format):
+    # rect, rotated, offset, source size, anchor, polygon, aliases
+    if format == 0:
+        rect = [frame['x'], frame['y'], frame['width'], frame['height']]
+        return (rect, False, [frame['offsetX'], frame['offsetY']],
+                [abs(frame.get('originalWidth', 0)), abs(frame.get('originalHeight', 0))], None, None, [])
+    if format in (1, 2):
+        rotated = format == 2 and bool(frame.get('rotated', False))
+        return (numbers(frame['frame']), rotated, numbers(frame['offset']), numbers(frame['sourceSize']), None, None, [])
+
+    sprite_size = numbers(frame['spriteSize'])
+    texture_rect = numbers(frame['textureRect'])
+    rect = [texture_rect[0], texture_rect[1], sprite_size[0], sprite_size[1]]
+    anchor = numbers(frame['anchor']) if 'anchor' in frame else None
+    polygon = None
+    if 'vertices' in frame:
+        polygon = (integers(frame['vertices']), integers(frame['verticesUV']), integers(frame['triangles']))
+    return (rect, bool(frame.get('textureRotated', False)), numbers(frame['spriteOffset']),
+            numbers(frame['spriteSourceSize']), anchor, polygon, list(frame.get('aliases', [])))
+
+def convert(plist_path, output):
+    sheet = read_plist(plist_path)
+    metadata = sheet.get('metadata', {})
+    format = int(metadata.get('format', 0))
+    if format < 0 or format > 3:
+        sys.exit('%s: format %d is not supported' % (plist_path, format))
+
+    strings = StringTable()
+    texture_size = numbers(metadata['size']) if 'size' in metadata else [0, 0]
+    texture_file = strings.add(metadata.get('textureFileName', ''))
+    pixel_format = strings.add(metadata.get('pixelFormat', ''))
+
+    frames = bytearray()
+    aliases = bytearray()
+    polygon_data = []
+    names = sorted(sheet.get('frames', {}).keys())
+    for index, name in enumerate(names):
+        rect, rotated, offset, source_size, anchor, polygon, frame_aliases = convert_frame(name, sheet['frames'][name], format)
+        flags = (FLAG_ROTATED if rotated else 0) | (FLAG_HAS_ANCHOR if anchor else 0)
+        polygon_index = len(polygon_data)
+        vertex_count = index_count = 0
+        if polygon:
+            vertices, uvs, indices = polygon
+            if len(vertices) != len(uvs) or len(vertices) % 2:
+                sys.exit('%s: %s has invalid polygon vertices' % (plist_path, name))
+            vertex_count = len(vertices) // 2
+            index_count = len(indices)
+            polygon_data += vertices + uvs + indices
+        name_offset, name_length = strings.add(name)
+        frames += struct.pack('<II10fIIII', name_offset, name_length,
+                              rect[0], rect[1], rect[2], rect[3], offset[0], offset[1],
+                              source_size[0], source_size[1],
+                              anchor[0] if anchor else 0.0, anchor[1] if anchor else 0.0,
+                              flags, polygon_index, vertex_count, index_count)
+        for alias in frame_aliases:
+            alias_offset, alias_length = strings.add(alias)
+            aliases += struct.pack('<III', alias_offset, alias_length, index)
+
+    with open(output, 'wb') as f:
+        f.write(MAGIC)
+        f.write(struct.pack('<5I2f4I', VERSION, len(names), len(aliases) // 12, len(polygon_data), len(strings.data),
+                            texture_size[0], texture_size[1],
+                            texture_file[0], texture_file[1], pixel_format[0], pixel_format[1]))
+        f.write(frames)
+        f.write(aliases)
+        f.write(struct.pack('<%di' % len(polygon_data), *polygon_data))
+        f.write(strings.data)
+    return len(names)
+
+def main():
+    parser = argparse.ArgumentParser(description='Converts sprite sheet plists into binary sprite sheets.')
+    parser.add_argument('plists', nargs='+', help='the sprite sheet plist files')
+    parser.add_argument('-o', '--output', help='the binary file, PLIST with the .ccsf extension by default')
+    args = parser.parse_args()
+
+    if args.output and len(args.plists) > 1:
+        sys.exit('-o needs a single PLIST')
+
+    for plist_path in args.plists:
+        output = args.output or os.path.splitext(plist_path)[0] + '.ccsf'
+        count = convert(plist_path, output)
+        print('%s: %d frames' % (output, count))
+
+if __name__ == '__main__':
+    main()